@@ -0,0 +1,39 @@
+// Verifies that mongod services many concurrent connections correctly when started with
+// --transportMode asynchronous.
+(function() {
+    "use strict";
+
+    var conn = MongoRunner.runMongod({transportMode: "asynchronous",
+                                      asyncIOThreads: 1,
+                                      asyncWorkerThreads: 2});
+    assert.neq(null, conn, "mongod failed to start with transportMode asynchronous");
+
+    // Open more connections than there are worker threads and interleave requests on them, so
+    // that each connection's requests are run by different workers.
+    var conns = [];
+    for (var i = 0; i < 10; i++) {
+        conns.push(new Mongo(conn.host));
+    }
+
+    for (var round = 0; round < 5; round++) {
+        conns.forEach(function(c, i) {
+            var coll = c.getDB("test").async_transport_mode;
+            assert.writeOK(coll.insert({conn: i, round: round}));
+            assert.eq(round + 1, coll.count({conn: i}));
+        });
+    }
+
+    // getLastError state must follow the connection rather than the worker thread.
+    conns.forEach(function(c, i) {
+        var db = c.getDB("test");
+        db.async_transport_mode.insert({_id: i});
+        db.async_transport_mode.insert({_id: i});
+    });
+    conns.forEach(function(c) {
+        assert.neq(null, c.getDB("test").getLastError());
+    });
+
+    assert.eq(60, conn.getDB("test").async_transport_mode.count());
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,49 @@
+// Checks that queries filtering fetched documents, and $match stages of aggregations, return the
+// same results whether or not their filters are compiled.
+(function() {
+    "use strict";
+
+    var conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, "mongod failed to start");
+    var db = conn.getDB("test");
+    var coll = db.compiled_match_expressions;
+    coll.drop();
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 1000; i++) {
+        bulk.insert({_id: i, a: i % 10, b: {c: i % 7, d: [i % 3, i % 5]}, s: "x" + (i % 13)});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.ensureIndex({a: 1}));
+
+    var filters = [
+        {a: 3},
+        {a: {$gt: 2, $lte: 6}, "b.c": {$ne: 4}},
+        {$or: [{a: 1}, {"b.d": 4}]},
+        {a: {$in: [2, 5]}, s: /^x1/},
+        {"b.d": {$all: [1, 2]}},
+        {$and: [{a: {$nin: [0, 9]}}, {"b.c": {$exists: true}}, {s: {$type: 2}}]},
+    ];
+
+    function run() {
+        return filters.map(function(filter) {
+            // The $project keeps the $match out of the query, so that it uses a Matcher.
+            var pipeline = [{$project: {a: 1, b: 1, s: 1}}, {$match: filter}, {$sort: {_id: 1}}];
+            return {find: coll.find(filter).sort({_id: 1}).toArray(),
+                    aggregate: coll.aggregate(pipeline).toArray()};
+        });
+    }
+
+    var interpreted = run();
+
+    assert.commandWorked(db.adminCommand({setParameter: 1,
+                                          internalQueryCompileMatchExpressions: true}));
+    var compiled = run();
+
+    for (var i = 0; i < filters.length; i++) {
+        assert.eq(interpreted[i], compiled[i], tojson(filters[i]));
+        assert.eq(interpreted[i].find, interpreted[i].aggregate, tojson(filters[i]));
+    }
+
+    MongoRunner.stopMongod(conn);
+})();
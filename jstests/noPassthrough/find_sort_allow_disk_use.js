@@ -0,0 +1,65 @@
+// Checks that a blocking sort in find spills to disk with allowDiskUse instead of failing.
+(function() {
+    "use strict";
+
+    var conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, "mongod failed to start");
+    var db = conn.getDB("test");
+    var coll = db.find_sort_allow_disk_use;
+    coll.drop();
+
+    var N = 2000;
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < N; i++) {
+        bulk.insert({_id: i, a: (i * 7919) % N, pad: new Array(1000).join("x")});
+    }
+    assert.writeOK(bulk.execute());
+
+    // Make the in-memory limit small enough that the sort has to spill.
+    assert.commandWorked(db.adminCommand({setParameter: 1,
+                                          internalQueryExecMaxBlockingSortBytes: 100 * 1024}));
+
+    // Without allowDiskUse the sort still fails.
+    assert.commandFailed(db.runCommand({find: coll.getName(), sort: {a: 1}}));
+
+    function checkSorted(cmd, expected) {
+        var res = db.runCommand(cmd);
+        assert.commandWorked(res);
+        var docs = res.cursor.firstBatch;
+        var cursorId = res.cursor.id;
+        while (cursorId != 0) {
+            res = db.runCommand({getMore: cursorId, collection: coll.getName()});
+            assert.commandWorked(res);
+            docs = docs.concat(res.cursor.nextBatch);
+            cursorId = res.cursor.id;
+        }
+
+        assert.eq(expected, docs.length);
+        for (var i = 0; i < docs.length; i++) {
+            assert.eq(i, docs[i].a, tojson(docs[i]));
+        }
+    }
+
+    checkSorted({find: coll.getName(), sort: {a: 1}, allowDiskUse: true, batchSize: 100}, N);
+
+    // With a limit the spilled sort only keeps the top documents.
+    checkSorted({find: coll.getName(), sort: {a: 1}, limit: 500, allowDiskUse: true}, 500);
+
+    // The legacy query path accepts $allowDiskUse as a modifier.
+    var legacy = coll.find().sort({a: 1})._addSpecial("$allowDiskUse", true).toArray();
+    assert.eq(N, legacy.length);
+    assert.eq(0, legacy[0].a);
+    assert.eq(N - 1, legacy[N - 1].a);
+
+    // Explain reports that the sort went to disk.
+    var explain = db.runCommand({explain: {find: coll.getName(), sort: {a: 1}, allowDiskUse: true},
+                                 verbosity: "executionStats"});
+    assert.commandWorked(explain);
+    var stage = explain.executionStats.executionStages;
+    while (stage.stage != "SORT") {
+        stage = stage.inputStage;
+    }
+    assert(stage.usedDisk, tojson(stage));
+
+    MongoRunner.stopMongod(conn);
+})();
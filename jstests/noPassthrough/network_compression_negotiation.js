@@ -0,0 +1,61 @@
+// Checks that isMaster negotiates wire protocol compression, that compressed messages are then
+// exchanged, and that serverStatus reports them.
+(function() {
+    "use strict";
+
+    var conn = MongoRunner.runMongod({networkMessageCompressors: "snappy"});
+    assert.neq(null, conn, "mongod failed to start with networkMessageCompressors");
+    var admin = conn.getDB("admin");
+
+    // Only compressors enabled on the server are agreed to, in the client's order.
+    var res = admin.runCommand({isMaster: 1, compression: ["zlib", "lz4", "snappy"]});
+    assert.commandWorked(res);
+    assert.eq(["snappy"], res.compression);
+
+    // Clients which do not ask for compression do not get the field.
+    res = admin.runCommand({isMaster: 1});
+    assert.commandWorked(res);
+    assert(!res.hasOwnProperty("compression"), tojson(res));
+
+    var network = admin.serverStatus().network;
+    assert(network.hasOwnProperty("compression"), tojson(network));
+    assert(network.compression.hasOwnProperty("snappy"), tojson(network));
+    assert(network.compression.hasOwnProperty("zlib"), tojson(network));
+
+    MongoRunner.stopMongod(conn);
+
+    // Replication connects through DBClientConnection, which negotiates compression, so the
+    // members of a replica set exchange compressed messages once there is data to replicate.
+    var replTest = new ReplSetTest({name: "network_compression_negotiation",
+                                    nodes: 2,
+                                    nodeOptions: {networkMessageCompressors: "snappy"}});
+    replTest.startSet();
+    replTest.initiate();
+    var primary = replTest.getMaster();
+
+    function snappyStats() {
+        return primary.getDB("admin").serverStatus().network.compression.snappy;
+    }
+
+    var before = snappyStats();
+    var bulk = primary.getDB("test").network_compression.initializeUnorderedBulkOp();
+    for (var i = 0; i < 1000; i++) {
+        bulk.insert({_id: i, pad: new Array(200).join("x")});
+    }
+    assert.writeOK(bulk.execute({w: 2}));
+    var after = snappyStats();
+
+    // The secondary's requests arrived compressed, and the oplog entries it fetched were sent
+    // compressed, and smaller.
+    assert.gt(after.decompressor.bytesIn, before.decompressor.bytesIn, tojson(after));
+    var compressedIn = after.compressor.bytesIn - before.compressor.bytesIn;
+    var compressedOut = after.compressor.bytesOut - before.compressor.bytesOut;
+    assert.gt(compressedIn, 1000 * 200, tojson(after));
+    assert.lt(compressedOut, compressedIn, tojson(after));
+
+    replTest.stopSet();
+
+    // Unknown compressors are rejected at startup.
+    conn = MongoRunner.runMongod({networkMessageCompressors: "lz4"});
+    assert.eq(null, conn, "mongod should not start with an unknown compressor");
+})();
@@ -0,0 +1,63 @@
+// Checks that collection scans split across threads return the same documents as serial ones.
+(function() {
+    "use strict";
+
+    var conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, "mongod failed to start");
+    var db = conn.getDB("test");
+    var coll = db.parallel_collscan;
+    coll.drop();
+
+    var N = 20000;
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < N; i++) {
+        bulk.insert({_id: i, a: i % 10, pad: new Array(100).join("x")});
+    }
+    assert.writeOK(bulk.execute());
+
+    function sortedIds(cursor) {
+        return cursor.map(function(doc) { return doc._id; }).sort(function(a, b) { return a - b; });
+    }
+
+    var serialAll = sortedIds(coll.find({}, {_id: 1}));
+    var serialFiltered = sortedIds(coll.find({a: 3}, {_id: 1}));
+    var serialAgg = coll.aggregate([{$match: {a: {$lt: 5}}},
+                                    {$group: {_id: null, n: {$sum: 1}}}]).toArray();
+    assert.eq(N, serialAll.length);
+    assert.eq(N / 10, serialFiltered.length);
+
+    assert.commandWorked(db.adminCommand({setParameter: 1,
+                                          internalQueryExecParallelCollScanThreads: 4}));
+    assert.commandWorked(db.adminCommand({setParameter: 1,
+                                          internalQueryExecParallelCollScanMinRecords: 1000}));
+
+    // Small batches make the scan yield and resume between getMores.
+    assert.eq(serialAll, sortedIds(coll.find({}, {_id: 1}).batchSize(7)));
+    assert.eq(serialFiltered, sortedIds(coll.find({a: 3}, {_id: 1})));
+    assert.eq(serialAgg, coll.aggregate([{$match: {a: {$lt: 5}}},
+                                         {$group: {_id: null, n: {$sum: 1}}}]).toArray());
+
+    // Scans which depend on order or stop early are never split.
+    assert.eq(5, coll.find().limit(5).itcount());
+    assert.eq(serialAll, coll.find({}, {_id: 1}).hint({$natural: 1}).map(function(doc) {
+        return doc._id;
+    }));
+
+    // Only storage engines which can split a table into ranges run the parallel stage.
+    var explain = coll.find({a: 3}).explain("executionStats");
+    var stage = explain.executionStats.executionStages;
+    if (db.serverStatus().storageEngine.name == "wiredTiger") {
+        assert.eq("PARALLEL_COLLSCAN", stage.stage, tojson(explain));
+        assert.eq(N, stage.docsExamined, tojson(stage));
+        assert.gt(stage.workers.length, 1, tojson(stage));
+        assert.lte(stage.workers.length, 4, tojson(stage));
+        var advanced = 0;
+        stage.workers.forEach(function(worker) { advanced += worker.advanced; });
+        assert.eq(N / 10, advanced, tojson(stage));
+    }
+    else {
+        assert.eq("COLLSCAN", stage.stage, tojson(explain));
+    }
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -27,3 +27,17 @@ function iterateSliced() {
 
 assert.eq( iterateSliced(), t.count() );
 assert.eq( iterateSliced(), i );
+
+// Storage engines which split a collection into several cursors must not let them overlap.
+var res = t.runCommand( "parallelCollectionScan", { numCursors : 3 } );
+assert.commandWorked( res );
+assert.lte( res.cursors.length, 3, tojson( res ) );
+
+var seen = {};
+res.cursors.forEach( function( c ) {
+    new DBCommandCursor( db.getMongo(), c, 100 ).forEach( function( doc ) {
+        assert( !seen.hasOwnProperty( doc.x ), "document returned twice: " + doc.x );
+        seen[doc.x] = true;
+    } );
+} );
+assert.eq( 8000, Object.keySet( seen ).length );
@@ -0,0 +1,76 @@
+// Test that a background index build on a secondary can finish while the secondary applies
+// batches which change the catalog, including a drop which waits for the build, and that reads
+// from the batch snapshot carry on meanwhile.
+(function() {
+    "use strict";
+    var name = "batch_snapshot_background_index";
+    var replTest = new ReplSetTest({name: name, nodes: 2});
+    var nodes = replTest.nodeList();
+    replTest.startSet();
+    replTest.initiate({"_id": name,
+                       "members": [
+                           { "_id": 0, "host": nodes[0], priority: 3 },
+                           { "_id": 1, "host": nodes[1], priority: 0 }],
+                      });
+
+    var primary = replTest.getMaster();
+    var secondary = replTest.liveNodes.slaves[0];
+    var primaryDB = primary.getDB("test");
+    var secondaryDB = secondary.getDB("test");
+
+    if (secondary.getDB("admin").serverStatus().storageEngine.name != "wiredTiger") {
+        print("Skipping " + name + ": the storage engine does not support batch snapshots");
+        replTest.stopSet();
+        return;
+    }
+
+    var size = 100000;
+    var bulk = primaryDB[name].initializeUnorderedBulkOp();
+    for (var i = 0; i < size; i++) {
+        bulk.insert({_id: i, i: i});
+    }
+    assert.writeOK(bulk.execute({w: 2}));
+
+    // Readers of the batch snapshot on the secondary, for as long as the test runs. Their reads
+    // may fail while the collection is dropped under them.
+    var awaitReads = startParallelShell(
+        "db.getMongo().setSlaveOk();" +
+        "var coll = db.getSiblingDB('test')." + name + ";" +
+        "while (db.getSiblingDB('test').stop_reads.count() == 0) {" +
+        "    try {" +
+        "        coll.find({i: {$gte: " + (size - 10) + "}}).itcount();" +
+        "    }" +
+        "    catch (e) {" +
+        "    }" +
+        "}",
+        secondary.port);
+
+    assert.commandWorked(primaryDB.runCommand({createIndexes: name,
+                                               indexes: [{key: {i: 1},
+                                                          name: "i_1",
+                                                          background: true}]}));
+    assert.soon(function() {
+        return secondaryDB.currentOp(true).inprog.some(function(op) {
+            return op.query && op.query.background && op.query.name == "i_1";
+        });
+    }, "the secondary did not start building the index in the background");
+
+    // Batches which change the catalog while the build runs, the last of which waits for it.
+    for (var i = 0; i < 10; i++) {
+        assert.commandWorked(primaryDB.createCollection(name + "_" + i));
+    }
+    assert(primaryDB[name].drop());
+
+    // The secondary gets through all of them, rather than the build and the applier waiting on
+    // each other.
+    replTest.awaitReplication(5 * 60 * 1000);
+    assert.eq(null, secondaryDB.getCollectionInfos({name: name})[0]);
+    for (var i = 0; i < 10; i++) {
+        assert.neq(null, secondaryDB.getCollectionInfos({name: name + "_" + i})[0]);
+    }
+
+    assert.writeOK(primaryDB.stop_reads.insert({}, {writeConcern: {w: 2}}));
+    awaitReads();
+
+    replTest.stopSet();
+})();
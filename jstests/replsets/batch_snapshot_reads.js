@@ -0,0 +1,67 @@
+// Test that reads on a secondary are served from the snapshot of the last applied batch, and so
+// are not blocked while the next batch is being applied.
+(function() {
+    "use strict";
+    var name = "batch_snapshot_reads";
+    var replTest = new ReplSetTest({name: name, nodes: 2});
+    var nodes = replTest.nodeList();
+    replTest.startSet();
+    replTest.initiate({"_id": name,
+                       "members": [
+                           { "_id": 0, "host": nodes[0], priority: 3 },
+                           { "_id": 1, "host": nodes[1], priority: 0 }],
+                      });
+
+    var primary = replTest.getMaster();
+    var secondary = replTest.liveNodes.slaves[0];
+    var primaryDB = primary.getDB("test");
+
+    if (secondary.getDB("admin").serverStatus().storageEngine.name != "wiredTiger") {
+        print("Skipping " + name + ": the storage engine does not support batch snapshots");
+        replTest.stopSet();
+        return;
+    }
+
+    assert.commandWorked(primaryDB.createCollection(name));
+    assert.writeOK(primaryDB[name].insert({_id: 0}, {writeConcern: {w: 2}}));
+
+    // Hang the secondary in the middle of applying the next batch.
+    var secondaryAdmin = secondary.getDB("admin");
+    var opsApplied = secondaryAdmin.serverStatus().metrics.repl.apply.ops;
+    assert.commandWorked(secondaryAdmin.runCommand({configureFailPoint: "hangDuringBatchApplication",
+                                                    mode: "alwaysOn"}));
+    assert.writeOK(primaryDB[name].insert({_id: 1}));
+    assert.soon(function() {
+        return secondaryAdmin.serverStatus().metrics.repl.apply.ops > opsApplied;
+    }, "secondary did not apply the batch");
+
+    // The read runs in a parallel shell, since a read which waits for the batch would block until
+    // the failpoint is turned off. It reports what it saw to the primary.
+    var awaitRead = startParallelShell(
+        "db.getMongo().setSlaveOk();" +
+        "var n = db.getSiblingDB('test')." + name + ".find().itcount();" +
+        "var primary = new Mongo('" + primary.host + "');" +
+        "assert.writeOK(primary.getDB('test').read_results.insert({n: n}));",
+        secondary.port);
+
+    try {
+        assert.soon(function() {
+            return primaryDB.read_results.count() == 1;
+        }, "read on the secondary waited for batch application", 30 * 1000);
+
+        // The read sees the previous batch, and none of the batch being applied.
+        assert.eq(1, primaryDB.read_results.findOne().n);
+    }
+    finally {
+        assert.commandWorked(secondaryAdmin.runCommand({configureFailPoint:
+                                                            "hangDuringBatchApplication",
+                                                        mode: "off"}));
+    }
+    awaitRead();
+
+    replTest.awaitReplication();
+    secondary.setSlaveOk();
+    assert.eq(2, secondary.getDB("test")[name].find().itcount());
+
+    replTest.stopSet();
+})();
@@ -0,0 +1,107 @@
+// Test that the changeFeed command returns the filtered and projected changes of each of its
+// subscriptions from a single scan of the oplog, and that a feed can be resumed.
+(function() {
+    "use strict";
+    var replTest = new ReplSetTest({name: "change_feed", nodes: 1});
+    replTest.startSet();
+    replTest.initiate();
+
+    var master = replTest.getMaster();
+    var admin = master.getDB("admin");
+    var local = master.getDB("local");
+    var test = master.getDB("test");
+    assert.writeOK(test.orders.insert({_id: "setup"}));
+
+    // Reads from the cursor of a changeFeed command until 'count' events have been returned.
+    function readEvents(res, count) {
+        assert.commandWorked(res);
+        var events = res.cursor.firstBatch;
+        var cursorId = res.cursor.id;
+        for (var tries = 0; events.length < count && tries < 20; tries++) {
+            assert.neq(0, cursorId, tojson(events));
+            res = local.runCommand({getMore: cursorId, collection: "oplog.rs"});
+            assert.commandWorked(res);
+            events = events.concat(res.cursor.nextBatch);
+            cursorId = res.cursor.id;
+        }
+        assert.eq(count, events.length, tojson(events));
+        return events;
+    }
+
+    var feed = admin.runCommand({changeFeed: 1,
+                                 subscriptions: [{name: "open",
+                                                  ns: "test.orders",
+                                                  ops: ["i", "u"],
+                                                  filter: {status: "open"},
+                                                  fields: {_id: 1, status: 1}},
+                                                 {name: "other", ns: "other", ops: ["i"]}]});
+    assert.commandWorked(feed);
+
+    assert.writeOK(test.orders.insert({_id: 1, status: "open", total: 10}));
+    assert.writeOK(test.orders.insert({_id: 2, status: "closed", total: 20}));
+    assert.writeOK(test.orders.update({_id: 2}, {$set: {status: "open", total: 30}}));
+    assert.writeOK(test.orders.remove({_id: 1}));
+    assert.writeOK(master.getDB("other").things.insert({_id: 3}));
+
+    var events = readEvents(feed, 3);
+
+    assert.eq("open", events[0].subscription);
+    assert.eq("i", events[0].op);
+    assert.eq("test.orders", events[0].ns);
+    assert.eq({_id: 1, status: "open"}, events[0].o);
+
+    // The filter and projection apply to the arguments of the modifiers.
+    assert.eq("open", events[1].subscription);
+    assert.eq("u", events[1].op);
+    assert.eq({$set: {status: "open"}}, events[1].o);
+    assert.eq({_id: 2}, events[1].o2);
+
+    assert.eq("other", events[2].subscription);
+    assert.eq("other.things", events[2].ns);
+    assert.eq({_id: 3}, events[2].o);
+
+    // Resuming after the first event returns the following ones again.
+    var resumed = admin.runCommand({changeFeed: 1,
+                                    ns: ["test.orders", "other.things"],
+                                    resumeAfter: events[0]._id});
+    var resumedEvents = readEvents(resumed, 4);
+    assert.eq(["i", "u", "d", "i"], resumedEvents.map(function(e) { return e.op; }));
+    assert.eq(events[2]._id.ts, resumedEvents[3]._id.ts);
+    // The unnamed subscription does not report its name.
+    assert(!resumedEvents[0].hasOwnProperty("subscription"), tojson(resumedEvents[0]));
+
+    // An entry selected by several subscriptions gives an event with its own _id to each, and
+    // resuming after one of them returns those of the following subscriptions.
+    var twoSubscriptions = [{name: "first", ns: "test.orders", ops: ["i"]},
+                            {name: "second", ns: "test", ops: ["i"]}];
+    var both = admin.runCommand({changeFeed: 1, subscriptions: twoSubscriptions});
+    assert.writeOK(test.orders.insert({_id: 4}));
+    var bothEvents = readEvents(both, 2);
+    assert.eq(["first", "second"], bothEvents.map(function(e) { return e.subscription; }));
+    assert.eq(bothEvents[0]._id.ts, bothEvents[1]._id.ts);
+    assert.neq(bothEvents[0]._id, bothEvents[1]._id);
+
+    resumed = admin.runCommand({changeFeed: 1,
+                                subscriptions: twoSubscriptions,
+                                resumeAfter: bothEvents[0]._id});
+    resumedEvents = readEvents(resumed, 1);
+    assert.eq(bothEvents[1], resumedEvents[0]);
+
+    // A token without the subscription skips the whole entry, as before.
+    resumed = admin.runCommand({changeFeed: 1,
+                                subscriptions: twoSubscriptions,
+                                resumeAfter: {ts: bothEvents[0]._id.ts}});
+    assert.commandWorked(resumed);
+    assert.eq(0, resumed.cursor.firstBatch.length, tojson(resumed.cursor.firstBatch));
+
+    // A resume token older than the oplog can't be honoured.
+    assert.commandFailedWithCode(admin.runCommand({changeFeed: 1,
+                                                   resumeAfter: {ts: Timestamp(1, 1)}}),
+                                 ErrorCodes.OplogStartMissing);
+
+    // Bad subscriptions are rejected up front.
+    assert.commandFailed(admin.runCommand({changeFeed: 1, filter: {$bogus: 1}}));
+    assert.commandFailed(admin.runCommand({changeFeed: 1, fields: {"a.$": 1}}));
+
+    replTest.stopSet();
+})();
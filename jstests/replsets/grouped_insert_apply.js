@@ -0,0 +1,65 @@
+// Test that secondaries apply runs of inserts into the same collection as grouped inserts, and
+// that they end up with the same documents as the primary.
+(function() {
+    "use strict";
+    var name = "grouped_insert_apply";
+    var replTest = new ReplSetTest({name: name, nodes: 2});
+    var nodes = replTest.nodeList();
+    replTest.startSet();
+    replTest.initiate({"_id": name,
+                       "members": [
+                           { "_id": 0, "host": nodes[0], priority: 3 },
+                           { "_id": 1, "host": nodes[1], priority: 0 }],
+                      });
+
+    var primary = replTest.getMaster();
+    var secondary = replTest.liveNodes.slaves[0];
+    var primaryColl = primary.getDB("test")[name];
+    var secondaryColl = secondary.getDB("test")[name];
+    assert.commandWorked(primaryColl.getDB().createCollection(name));
+    replTest.awaitReplication();
+
+    var before = secondary.getDB("admin").serverStatus().metrics.repl.apply;
+
+    var N = 1000;
+    var bulk = primaryColl.initializeOrderedBulkOp();
+    for (var i = 0; i < N; i++) {
+        bulk.insert({_id: i, x: i});
+    }
+    // An update in the middle of the inserts splits them into separate groups.
+    bulk.find({_id: 0}).updateOne({$set: {x: -1}});
+    for (var i = N; i < 2 * N; i++) {
+        bulk.insert({_id: i, x: i});
+    }
+    assert.writeOK(bulk.execute({w: 2}));
+
+    var after = secondary.getDB("admin").serverStatus().metrics.repl.apply;
+    assert.gt(after.groupedInserts - before.groupedInserts, 0, tojson(after));
+    assert.lte(after.groupedInsertOps - before.groupedInsertOps, 2 * N, tojson(after));
+
+    secondary.setSlaveOk();
+    assert.eq(2 * N, secondaryColl.find().itcount());
+    assert.eq(-1, secondaryColl.findOne({_id: 0}).x);
+    assert.eq(primaryColl.find().sort({_id: 1}).toArray(),
+              secondaryColl.find().sort({_id: 1}).toArray());
+
+    // Without an _id index a replayed insert could not be detected, so inserts into such a
+    // collection are never grouped.
+    var noIdIndexName = name + "_no_id_index";
+    assert.commandWorked(primaryColl.getDB().createCollection(noIdIndexName,
+                                                              {autoIndexId: false}));
+    replTest.awaitReplication();
+
+    before = secondary.getDB("admin").serverStatus().metrics.repl.apply;
+    bulk = primary.getDB("test")[noIdIndexName].initializeOrderedBulkOp();
+    for (var i = 0; i < N; i++) {
+        bulk.insert({_id: i, x: i});
+    }
+    assert.writeOK(bulk.execute({w: 2}));
+
+    after = secondary.getDB("admin").serverStatus().metrics.repl.apply;
+    assert.eq(before.groupedInserts, after.groupedInserts, tojson(after));
+    assert.eq(N, secondary.getDB("test")[noIdIndexName].find().itcount());
+
+    replTest.stopSet();
+}());
@@ -0,0 +1,66 @@
+// Test that initial sync clones collections split into _id ranges on several threads, including
+// collections whose _ids are of mixed types, and ends up with the same documents and indexes.
+(function() {
+    "use strict";
+    var name = "initial_sync_parallel_clone";
+    var replTest = new ReplSetTest({name: name, nodes: 1});
+    replTest.startSet();
+    replTest.initiate();
+
+    var primary = replTest.getMaster();
+    var db = primary.getDB("test");
+
+    var N = 5000;
+    var bulk = db.big.initializeUnorderedBulkOp();
+    for (var i = 0; i < N; i++) {
+        // Mix numbers, strings and objects so the ranges span values of different types.
+        var id = (i % 3 == 0) ? i : ((i % 3 == 1) ? "s" + i : {n: i});
+        bulk.insert({_id: id, x: i, pad: new Array(200).join("x")});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(db.big.ensureIndex({x: 1}, {unique: true}));
+
+    for (var c = 0; c < 5; c++) {
+        var coll = db["small" + c];
+        for (var i = 0; i < 10; i++) {
+            assert.writeOK(coll.insert({_id: i, c: c}));
+        }
+        assert.commandWorked(coll.ensureIndex({c: 1}));
+    }
+
+    assert.commandWorked(db.createCollection("capped", {capped: true, size: 64 * 1024}));
+    for (var i = 0; i < 100; i++) {
+        assert.writeOK(db.capped.insert({i: i}));
+    }
+
+    // Add a node which splits every collection above 64KB into ranges.
+    var secondary = replTest.add({setParameter: {initialSyncCloneThreads: 4,
+                                                 initialSyncCloneRangeBytes: 64 * 1024}});
+    replTest.reInitiate();
+    replTest.awaitSecondaryNodes();
+    replTest.awaitReplication();
+
+    secondary.setSlaveOk();
+    var secondaryDB = secondary.getDB("test");
+    var collNames = ["big", "capped", "small0", "small1", "small2", "small3", "small4"];
+    collNames.forEach(function(collName) {
+        assert.eq(db[collName].count(), secondaryDB[collName].count(), collName);
+        assert.eq(db[collName].getIndexes().length, secondaryDB[collName].getIndexes().length,
+                  collName);
+    });
+
+    // The documents of the split collection are all there, whatever the type of their _id.
+    assert.eq(db.big.find({}, {_id: 1}).sort({_id: 1}).toArray(),
+              secondaryDB.big.find({}, {_id: 1}).sort({_id: 1}).toArray());
+
+    // The capped collection keeps its insertion order.
+    assert.eq(db.capped.find().sort({$natural: 1}).toArray(),
+              secondaryDB.capped.find().sort({$natural: 1}).toArray());
+
+    // No initial sync is running any more.
+    var status = secondary.getDB("admin").runCommand({replSetGetStatus: 1});
+    assert.commandWorked(status);
+    assert(!status.hasOwnProperty("initialSyncStatus"), tojson(status));
+
+    replTest.stopSet();
+}());
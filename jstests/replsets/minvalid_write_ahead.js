@@ -0,0 +1,53 @@
+// Test that secondaries only write minValid when a batch goes past it, and report the time spent
+// in each phase of applying a batch.
+(function() {
+    "use strict";
+    var name = "minvalid_write_ahead";
+    var replTest = new ReplSetTest({name: name, nodes: 2});
+    var nodes = replTest.nodeList();
+    replTest.startSet();
+    replTest.initiate({"_id": name,
+                       "members": [
+                           { "_id": 0, "host": nodes[0], priority: 3 },
+                           { "_id": 1, "host": nodes[1], priority: 0 }],
+                      });
+
+    var master = replTest.getMaster();
+    var slave = replTest.liveNodes.slaves[0];
+    var coll = master.getDB("test").minvalid_write_ahead;
+
+    // Lots of small writes make lots of small batches.
+    for (var i = 0; i < 2000; i++) {
+        assert.writeOK(coll.insert({_id: i}));
+    }
+    replTest.awaitReplication();
+
+    var metrics = slave.getDB("admin").serverStatus().metrics.repl.apply;
+    jsTestLog("Apply metrics: " + tojson(metrics));
+    ["fetch", "prefetch", "apply", "marker"].forEach(function(phase) {
+        assert(metrics.phases.hasOwnProperty(phase), tojson(metrics));
+    });
+    assert.gt(metrics.phases.apply.num, 0, tojson(metrics));
+    assert.eq(metrics.phases.fetch.num, metrics.phases.marker.num, tojson(metrics));
+    assert.gt(metrics.minValidWritesSkipped, 0, tojson(metrics));
+
+    // minValid never trails what the secondary has applied.
+    var minValid = slave.getDB("local").replset.minvalid.findOne();
+    var lastApplied = slave.getDB("local").oplog.rs.find().sort({$natural: -1}).limit(1).next();
+    assert.lte(bsonWoCompare({ts: minValid.ts}, {ts: lastApplied.ts}), 0, tojson(minValid));
+
+    // Writing minValid for every batch still works.
+    assert.commandWorked(slave.getDB("admin").runCommand({setParameter: 1,
+                                                          replMinValidWriteAhead: false}));
+    var skipped = metrics.minValidWritesSkipped;
+    for (var i = 2000; i < 2100; i++) {
+        assert.writeOK(coll.insert({_id: i}));
+    }
+    replTest.awaitReplication();
+    slave.setSlaveOk();
+    assert.eq(2100, slave.getDB("test").minvalid_write_ahead.count());
+    assert.eq(skipped,
+              slave.getDB("admin").serverStatus().metrics.repl.apply.minValidWritesSkipped);
+
+    replTest.stopSet();
+})();
@@ -0,0 +1,42 @@
+// Test that a multi-document insert reserves the oplog entries for all of its documents at once,
+// and that each document still gets its own, distinct and ordered, oplog entry.
+(function() {
+    "use strict";
+    var name = "oplog_slot_reservation";
+    var replTest = new ReplSetTest({name: name, nodes: 1});
+    replTest.startSet();
+    replTest.initiate();
+
+    var primary = replTest.getMaster();
+    var db = primary.getDB("test");
+    var coll = db[name];
+    assert.commandWorked(db.createCollection(name));
+
+    var N = 100;
+    var docs = [];
+    for (var i = 0; i < N; i++) {
+        docs.push({_id: i});
+    }
+
+    var before = db.serverStatus().metrics.repl.oplog;
+    assert.writeOK(coll.insert(docs));
+    var after = db.serverStatus().metrics.repl.oplog;
+
+    assert.gte(after.slotsReserved - before.slotsReserved, N, tojson(after));
+    assert.lt(after.slotReservations - before.slotReservations, N, tojson(after));
+
+    var entries = primary.getDB("local").oplog.rs.find({ns: coll.getFullName(), op: "i"})
+                                                .sort({$natural: 1}).toArray();
+    assert.eq(N, entries.length);
+    for (var i = 0; i < N; i++) {
+        assert.eq(i, entries[i].o._id, tojson(entries[i]));
+        if (i > 0) {
+            // Timestamps don't compare numerically in the shell, so compare them as BSON.
+            assert.lt(bsonWoCompare({ts: entries[i - 1].ts}, {ts: entries[i].ts}), 0,
+                      tojson(entries[i]));
+            assert.neq(entries[i - 1].h, entries[i].h, tojson(entries[i]));
+        }
+    }
+
+    replTest.stopSet();
+}());
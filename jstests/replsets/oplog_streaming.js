@@ -0,0 +1,64 @@
+// Test that a secondary fetching the oplog through a streaming (exhaust) cursor keeps up with
+// the primary, and goes back to streaming after it changes sync source.
+(function() {
+    "use strict";
+    var name = "oplog_streaming";
+    var replTest = new ReplSetTest({name: name,
+                                    nodes: 3,
+                                    oplogSize: 5,
+                                    nodeOptions: {setParameter: "bgSyncOplogStreaming=true"}});
+    var nodes = replTest.nodeList();
+    replTest.startSet();
+    replTest.initiate({"_id": name,
+                       "members": [
+                           { "_id": 0, "host": nodes[0], priority: 3 },
+                           { "_id": 1, "host": nodes[1], priority: 0 },
+                           { "_id": 2, "host": nodes[2], priority: 0 }],
+                      });
+
+    var master = replTest.getMaster();
+    var coll = master.getDB("test").oplog_streaming;
+
+    function insertBatches(start, count) {
+        for (var batch = 0; batch < 10; batch++) {
+            var bulk = coll.initializeUnorderedBulkOp();
+            for (var i = 0; i < count; i++) {
+                bulk.insert({_id: start + batch * count + i, pad: new Array(200).join("x")});
+            }
+            assert.writeOK(bulk.execute());
+        }
+    }
+
+    insertBatches(0, 500);
+    replTest.awaitReplication();
+
+    var slaves = replTest.liveNodes.slaves;
+    slaves.forEach(function(slave) {
+        slave.setSlaveOk();
+        assert.eq(5000, slave.getDB("test").oplog_streaming.count());
+        var metrics = slave.getDB("admin").serverStatus().metrics.repl.network;
+        assert.gt(metrics.streamedBatches, 0, tojson(metrics));
+    });
+
+    // Switching sync source drops the stream, and a new one is opened on the new source.
+    assert.commandWorked(slaves[1].getDB("admin").runCommand({replSetSyncFrom: slaves[0].name}));
+    assert.soon(function() {
+        coll.insert({_id: "syncFrom"});
+        return replTest.status().members[2].syncingTo === slaves[0].name;
+    }, "sync source did not change");
+
+    insertBatches(10000, 100);
+    replTest.awaitReplication();
+    assert.eq(coll.count(), slaves[1].getDB("test").oplog_streaming.count());
+
+    // Turning streaming off goes back to a getMore per batch.
+    slaves.forEach(function(slave) {
+        assert.commandWorked(slave.adminCommand({setParameter: 1, bgSyncOplogStreaming: false}));
+    });
+    assert.commandWorked(slaves[1].getDB("admin").runCommand({replSetSyncFrom: master.name}));
+    insertBatches(20000, 100);
+    replTest.awaitReplication();
+    assert.eq(coll.count(), slaves[1].getDB("test").oplog_streaming.count());
+
+    replTest.stopSet();
+}());
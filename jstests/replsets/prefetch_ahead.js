@@ -0,0 +1,64 @@
+// Test that a WiredTiger secondary reads the documents and index entries of updates and deletes
+// ahead of the writers applying them, unless replIndexPrefetch is "none".
+(function() {
+    "use strict";
+    var name = "prefetch_ahead";
+    var replTest = new ReplSetTest({name: name, nodes: 2});
+    var nodes = replTest.nodeList();
+    replTest.startSet();
+    replTest.initiate({"_id": name,
+                       "members": [
+                           { "_id": 0, "host": nodes[0], priority: 3 },
+                           { "_id": 1, "host": nodes[1], priority: 0 }],
+                      });
+
+    var primary = replTest.getMaster();
+    var secondary = replTest.liveNodes.slaves[0];
+    var coll = primary.getDB("test")[name];
+    var secondaryAdmin = secondary.getDB("admin");
+
+    if (secondaryAdmin.serverStatus().storageEngine.name != "wiredTiger") {
+        print("Skipping " + name + ": only engines other than mmapv1 prefetch alongside writers");
+        replTest.stopSet();
+        return;
+    }
+
+    assert.commandWorked(coll.ensureIndex({a: 1}));
+    var N = 2000;
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < N; i++) {
+        bulk.insert({_id: i, a: i});
+    }
+    assert.writeOK(bulk.execute({w: 2}));
+
+    function preload() {
+        return secondaryAdmin.serverStatus().metrics.repl.preload;
+    }
+
+    function updateAndDelete(from) {
+        var bulk = coll.initializeUnorderedBulkOp();
+        for (var i = from; i < from + N / 4; i++) {
+            bulk.find({_id: i}).updateOne({$set: {a: -i - 1}});
+            bulk.find({_id: i + N / 4}).removeOne();
+        }
+        assert.writeOK(bulk.execute({w: 2}));
+    }
+
+    // Inserts are not prefetched, updates and deletes are.
+    var before = preload();
+    updateAndDelete(0);
+    var after = preload();
+    assert.gt(after.docs.num, before.docs.num, tojson(after));
+    assert.gt(after.indexes.num, before.indexes.num, tojson(after));
+
+    assert.commandWorked(secondaryAdmin.runCommand({setParameter: 1, replIndexPrefetch: "none"}));
+    before = preload();
+    updateAndDelete(N / 2);
+    after = preload();
+    assert.eq(before.docs.num, after.docs.num, tojson(after));
+    assert.eq(before.indexes.num, after.indexes.num, tojson(after));
+
+    secondary.setSlaveOk();
+    assert.eq(0, secondary.getDB("test")[name].find({a: {$gte: 0}}).itcount());
+    replTest.stopSet();
+})();
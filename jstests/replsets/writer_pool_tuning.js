@@ -0,0 +1,82 @@
+// Test that the number of writer threads and the batch limits of a secondary can be changed at
+// runtime, and that the secondary reports how busy each writer has been.
+(function() {
+    "use strict";
+    var name = "writer_pool_tuning";
+    var replTest = new ReplSetTest({name: name,
+                                    nodes: 2,
+                                    nodeOptions: {setParameter: "replWriterThreadCount=4"}});
+    var nodes = replTest.nodeList();
+    replTest.startSet();
+    replTest.initiate({"_id": name,
+                       "members": [
+                           { "_id": 0, "host": nodes[0], priority: 3 },
+                           { "_id": 1, "host": nodes[1], priority: 0 }],
+                      });
+
+    var master = replTest.getMaster();
+    var slave = replTest.liveNodes.slaves[0];
+    var slaveAdmin = slave.getDB("admin");
+    var coll = master.getDB("test").writer_pool_tuning;
+    var next = 0;
+
+    function insertBatch() {
+        var bulk = coll.initializeUnorderedBulkOp();
+        for (var i = 0; i < 1000; i++) {
+            bulk.insert({_id: next++});
+        }
+        assert.writeOK(bulk.execute());
+        replTest.awaitReplication();
+    }
+
+    function writerStats() {
+        return slaveAdmin.serverStatus().metrics.repl.apply.writers;
+    }
+
+    insertBatch();
+    var stats = writerStats();
+    assert.eq(4, stats.poolSize, tojson(stats));
+    assert.eq(4, stats.inUse, tojson(stats));
+    assert.eq(false, stats.autoTune, tojson(stats));
+    assert.lte(stats.perWriter.length, 4, tojson(stats));
+    var ops = 0;
+    stats.perWriter.forEach(function(writer) {
+        ops += writer.ops;
+        assert.gte(writer.utilization, 0, tojson(stats));
+        assert.lte(writer.utilization, 1, tojson(stats));
+    });
+    assert.gte(ops, 1000, tojson(stats));
+
+    // The pool size is fixed at startup, but batches can use fewer of its writers.
+    assert.commandFailed(slaveAdmin.runCommand({setParameter: 1, replWriterThreadCount: 8}));
+    assert.commandWorked(slaveAdmin.runCommand({setParameter: 1, replBatchWriterCount: 2}));
+    insertBatch();
+    assert.eq(2, writerStats().inUse, tojson(writerStats()));
+
+    // Asking for more writers than there are uses all of them.
+    assert.commandWorked(slaveAdmin.runCommand({setParameter: 1, replBatchWriterCount: 100}));
+    insertBatch();
+    assert.eq(4, writerStats().inUse, tojson(writerStats()));
+
+    // The tuner keeps the count within the pool.
+    assert.commandWorked(slaveAdmin.runCommand({setParameter: 1, replWriterAutoTune: true}));
+    for (var i = 0; i < 20; i++) {
+        insertBatch();
+    }
+    stats = writerStats();
+    assert.eq(true, stats.autoTune, tojson(stats));
+    assert.gte(stats.inUse, 1, tojson(stats));
+    assert.lte(stats.inUse, 4, tojson(stats));
+
+    // Batch limits can be changed at runtime, within bounds.
+    assert.commandWorked(slaveAdmin.runCommand({setParameter: 1, replBatchLimitOperations: 10}));
+    assert.commandFailed(slaveAdmin.runCommand({setParameter: 1, replBatchLimitOperations: 0}));
+    assert.commandWorked(slaveAdmin.runCommand({setParameter: 1,
+                                                replBatchLimitBytes: 16 * 1024 * 1024}));
+    assert.commandFailed(slaveAdmin.runCommand({setParameter: 1, replBatchLimitBytes: 1}));
+    insertBatch();
+    slave.setSlaveOk();
+    assert.eq(next, slave.getDB("test").writer_pool_tuning.count());
+
+    replTest.stopSet();
+})();
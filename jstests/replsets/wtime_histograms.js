@@ -0,0 +1,48 @@
+// Test that the time spent waiting for write concern is reported in serverStatus broken down by
+// the "w" value it was waiting for.
+(function() {
+    "use strict";
+    var name = "wtime_histograms";
+    var replTest = new ReplSetTest({name: name, nodes: 3});
+    replTest.startSet();
+    replTest.initiate();
+
+    var primary = replTest.getMaster();
+    var db = primary.getDB("test");
+    var coll = db[name];
+
+    function histograms() {
+        return db.serverStatus().metrics.getLastError.wtimeHistograms;
+    }
+
+    function count(h, w) {
+        return h[w] ? h[w].count : 0;
+    }
+
+    var before = histograms();
+    var N = 10;
+    for (var i = 0; i < N; i++) {
+        assert.writeOK(coll.insert({_id: i}, {writeConcern: {w: 2, wtimeout: 60 * 1000}}));
+        assert.writeOK(coll.insert({_id: -i - 1},
+                                   {writeConcern: {w: "majority", wtimeout: 60 * 1000}}));
+    }
+    var after = histograms();
+
+    ["2", "majority"].forEach(function(w) {
+        assert.eq(N, count(after, w) - count(before, w), tojson(after));
+
+        var h = after[w];
+        var bucketed = 0;
+        for (var bucket in h.buckets) {
+            bucketed += h.buckets[bucket];
+        }
+        assert.eq(h.count, bucketed, tojson(h));
+        assert.gte(h.totalMillis, 0, tojson(h));
+    });
+
+    // w:1 does not wait for replication at all.
+    assert.writeOK(coll.insert({_id: "w1"}, {writeConcern: {w: 1}}));
+    assert.eq(count(after, "1"), count(histograms(), "1"));
+
+    replTest.stopSet();
+})();
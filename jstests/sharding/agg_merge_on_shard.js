@@ -0,0 +1,90 @@
+//
+// Checks that mongos can run the merging half of a split aggregation on the participating shards
+// instead of the primary shard, and that the results are the same either way.
+//
+
+var st = new ShardingTest({shards : 2,
+                           mongos : 1,
+                           verbose : 0});
+
+var mongos = st.s0;
+var admin = mongos.getDB("admin");
+var db = mongos.getDB("foo");
+var coll = db.bar;
+
+assert.commandWorked(admin.runCommand({enableSharding : "foo"}));
+st.ensurePrimaryShard("foo", "shard0000");
+assert.commandWorked(admin.runCommand({shardCollection : coll.toString(), key : {_id : 1}}));
+assert.commandWorked(admin.runCommand({split : coll.toString(), middle : {_id : 500}}));
+assert.commandWorked(admin.runCommand({moveChunk : coll.toString(),
+                                       find : {_id : 500},
+                                       to : "shard0001"}));
+
+var N = 1000;
+var bulk = coll.initializeUnorderedBulkOp();
+for (var i = 0; i < N; i++) {
+    bulk.insert({_id : i, a : i % 10, b : (i * 7) % N});
+}
+assert.writeOK(bulk.execute());
+
+function checkResults() {
+    var groups = coll.aggregate([{$group : {_id : "$a", n : {$sum : 1}}},
+                                 {$sort : {_id : 1}}]).toArray();
+    assert.eq(10, groups.length, tojson(groups));
+    for (var i = 0; i < groups.length; i++) {
+        assert.eq({_id : i, n : N / 10}, groups[i]);
+    }
+
+    var sorted = coll.aggregate([{$sort : {b : 1}}, {$project : {b : 1}}],
+                                {allowDiskUse : true, cursor : {batchSize : 50}}).toArray();
+    assert.eq(N, sorted.length);
+    for (var i = 0; i < sorted.length; i++) {
+        assert.eq(i, sorted[i].b, tojson(sorted[i]));
+    }
+}
+
+// Counts the merges each shard has run since profiling was turned on.
+function countMerges(shardDB) {
+    return shardDB.system.profile.find({"command.pipeline.0.$mergeCursors" : {$exists : true}})
+                                 .itcount();
+}
+
+var shardDBs = [st.shard0.getDB("foo"), st.shard1.getDB("foo")];
+function resetProfiling() {
+    shardDBs.forEach(function(shardDB) {
+        shardDB.setProfilingLevel(0);
+        shardDB.system.profile.drop();
+        shardDB.setProfilingLevel(2);
+    });
+}
+
+// By default every merge runs on the primary shard.
+resetProfiling();
+checkResults();
+assert.eq(2, countMerges(shardDBs[0]));
+assert.eq(0, countMerges(shardDBs[1]));
+
+// With the parameter set the merges are spread over both shards.
+assert.commandWorked(admin.runCommand({setParameter : 1,
+                                       internalAggMergeOnParticipatingShard : true}));
+resetProfiling();
+checkResults();
+checkResults();
+assert.eq(2, countMerges(shardDBs[0]));
+assert.eq(2, countMerges(shardDBs[1]));
+
+// $out still has to be merged on the primary shard.
+resetProfiling();
+for (var i = 0; i < 4; i++) {
+    coll.aggregate([{$group : {_id : "$a", n : {$sum : 1}}}, {$out : "out"}]);
+    assert.eq(10, db.out.find().itcount());
+}
+assert.eq(4, countMerges(shardDBs[0]));
+assert.eq(0, countMerges(shardDBs[1]));
+
+assert.commandWorked(admin.runCommand({setParameter : 1,
+                                       internalAggMergeOnParticipatingShard : false}));
+
+jsTest.log("DONE!");
+
+st.stop();
@@ -0,0 +1,109 @@
+//
+// Checks that the balancer evens out the sampled operation load of chunks when its mode is set
+// to "load": it moves hot chunks even though the chunk counts are even, and splits a chunk
+// which has all of the load.
+//
+
+var st = new ShardingTest({shards : 2,
+                           mongos : 1,
+                           other : {chunksize : 1}});
+
+var mongos = st.s0;
+var admin = mongos.getDB("admin");
+var config = mongos.getDB("config");
+var db = mongos.getDB("test");
+
+st.stopBalancer();
+
+assert.commandWorked(admin.runCommand({enableSharding : "test"}));
+st.ensurePrimaryShard("test", "shard0000");
+
+// Record every operation, so that the rates don't depend on sampling.
+[st.shard0, st.shard1].forEach(function(shard) {
+    assert.commandWorked(shard.adminCommand({setParameter : 1, internalChunkLoadSampleRate : 1}));
+});
+
+function chunkShard(ns, key) {
+    return config.chunks.find({ns : ns, min : {$lte : key}}).sort({min : -1}).limit(1).next().shard;
+}
+
+// test.foo has two chunks on each shard, but both of the ones which get used are on shard0000.
+var foo = db.foo;
+assert.commandWorked(admin.runCommand({shardCollection : foo.toString(), key : {_id : 1}}));
+[0, 100, 200].forEach(function(middle) {
+    assert.commandWorked(admin.runCommand({split : foo.toString(), middle : {_id : middle}}));
+});
+[MinKey, 200].forEach(function(key) {
+    assert.commandWorked(admin.runCommand({moveChunk : foo.toString(),
+                                           find : {_id : key},
+                                           to : "shard0001"}));
+});
+
+var bulk = foo.initializeUnorderedBulkOp();
+for (var i = 0; i < 200; i++) {
+    bulk.insert({_id : i, n : 0});
+}
+assert.writeOK(bulk.execute());
+
+function generateLoad(coll, min, max) {
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = min; i < max; i++) {
+        bulk.find({_id : i}).upsert().updateOne({$inc : {n : 1}});
+    }
+    assert.writeOK(bulk.execute());
+    assert.eq(max - min, coll.find({_id : {$gte : min, $lt : max}}).itcount());
+}
+
+// The shard reports the load of the chunks it owns.
+generateLoad(foo, 0, 200);
+var load = st.shard0.adminCommand({_getChunkLoad : foo.getFullName()});
+assert.commandWorked(load);
+printjson(load);
+assert.eq(2, load.chunks.length, tojson(load));
+load.chunks.forEach(function(chunk) {
+    assert.gt(chunk.readsPerSec, 0, tojson(chunk));
+    assert.gt(chunk.writesPerSec, 0, tojson(chunk));
+});
+load = st.shard1.adminCommand({_getChunkLoad : foo.getFullName()});
+assert.commandWorked(load);
+assert.eq(0, load.chunks.length, tojson(load));
+
+assert.writeOK(config.settings.update({_id : "balancer"},
+                                      {$set : {mode : "load"}},
+                                      {upsert : true}));
+st.startBalancer();
+
+// Balancing by chunk count would leave test.foo alone, by load one of its hot chunks moves.
+assert.soon(function() {
+                generateLoad(foo, 0, 200);
+                return chunkShard(foo.getFullName(), {_id : 0}) !=
+                       chunkShard(foo.getFullName(), {_id : 100});
+            },
+            "hot chunk of test.foo was not moved",
+            5 * 60 * 1000,
+            100);
+
+st.stopBalancer();
+
+// test.bar has all of its load on a single chunk, which is split so that it can be balanced.
+var bar = db.bar;
+assert.commandWorked(admin.runCommand({shardCollection : bar.toString(), key : {_id : 1}}));
+assert.commandWorked(admin.runCommand({split : bar.toString(), middle : {_id : 0}}));
+assert.commandWorked(admin.runCommand({moveChunk : bar.toString(),
+                                       find : {_id : 0},
+                                       to : "shard0001"}));
+st.startBalancer();
+
+assert.soon(function() {
+                generateLoad(bar, 0, 1000);
+                return config.chunks.count({ns : bar.getFullName()}) > 2;
+            },
+            "hot chunk of test.bar was not split",
+            5 * 60 * 1000,
+            100);
+
+st.stopBalancer();
+
+jsTest.log("DONE!");
+
+st.stop();
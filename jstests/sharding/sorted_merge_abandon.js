@@ -0,0 +1,85 @@
+//
+// Checks that abandoning a sorted mongos cursor while it has getMores in flight to the shards
+// leaves no unread replies on the shard connections it gives back to the pool.
+//
+
+var st = new ShardingTest({shards : 3,
+                           mongos : 1,
+                           verbose : 0});
+
+var mongos = st.s0;
+var admin = mongos.getDB("admin");
+var coll = mongos.getCollection("foo.bar");
+
+assert.commandWorked(admin.runCommand({enableSharding : "foo"}));
+st.ensurePrimaryShard("foo", "shard0000");
+assert.commandWorked(admin.runCommand({shardCollection : coll.toString(), key : {_id : 1}}));
+assert.commandWorked(admin.runCommand({split : coll.toString(), middle : {_id : 1000}}));
+assert.commandWorked(admin.runCommand({split : coll.toString(), middle : {_id : 2000}}));
+assert.commandWorked(admin.runCommand({moveChunk : coll.toString(),
+                                       find : {_id : 1000},
+                                       to : "shard0001"}));
+assert.commandWorked(admin.runCommand({moveChunk : coll.toString(),
+                                       find : {_id : 2000},
+                                       to : "shard0002"}));
+
+var N = 3000;
+var bulk = coll.initializeUnorderedBulkOp();
+for (var i = 0; i < N; i++) {
+    bulk.insert({_id : i, a : (i * 7) % N});
+}
+assert.writeOK(bulk.execute());
+
+// Readers which check every result they get, while the cursors below are being abandoned. A
+// reply stolen from, or left on, a pooled connection shows up as a wrong or failed result.
+var checkResults =
+    "var coll = db.getSiblingDB('foo').bar;" +
+    "for (var i = 0; i < 50; i++) {" +
+    "    var last = -1;" +
+    "    var count = 0;" +
+    "    coll.find({a : {$lt : 600}}).sort({a : 1}).batchSize(13).forEach(function(doc) {" +
+    "        assert.gt(doc.a, last, tojson(doc));" +
+    "        last = doc.a;" +
+    "        count++;" +
+    "    });" +
+    "    assert.eq(600, count);" +
+    "    assert.eq(" + N + ", coll.find().itcount());" +
+    "}";
+var readers = [];
+for (var i = 0; i < 3; i++) {
+    readers.push(startParallelShell(checkResults, mongos.port));
+}
+
+// Each mongos batch ends with the getMores for the shards whose batches ran out already sent,
+// and their replies unread until the next batch is asked for. Stop there and drop the cursors.
+// The $where slows the shards down so that the replies are still on their way.
+for (var round = 0; round < 10; round++) {
+    var cursors = [];
+    for (var i = 0; i < 10; i++) {
+        var cursor = coll.find({$where : "sleep(1); return true;"}).sort({a : 1}).batchSize(5);
+        for (var j = 0; j < 5 * (i + 1); j++) {
+            cursor.next();
+        }
+        cursors.push(cursor);
+    }
+    cursors = null;
+    gc(); // The shell kills the mongos cursors when cleaning up the underlying cursors.
+}
+
+readers.forEach(function(join) {
+    assert.eq(0, join(), "a reader got wrong results");
+});
+
+// The connections given back by the abandoned cursors are still usable.
+var last = -1;
+var count = 0;
+coll.find().sort({a : 1}).batchSize(7).forEach(function(doc) {
+    assert.gt(doc.a, last, tojson(doc));
+    last = doc.a;
+    count++;
+});
+assert.eq(N, count);
+
+jsTest.log("DONE!");
+
+st.stop();
@@ -0,0 +1,74 @@
+//
+// Checks that mongos merges sorted results correctly when it sends the getMores for all the
+// shards which ran out of results at once, and that the shard connections stay usable.
+//
+
+var st = new ShardingTest({shards : 3,
+                           mongos : 1,
+                           verbose : 0});
+
+var mongos = st.s0;
+var admin = mongos.getDB("admin");
+var coll = mongos.getCollection("foo.bar");
+
+assert.commandWorked(admin.runCommand({enableSharding : "foo"}));
+st.ensurePrimaryShard("foo", "shard0000");
+assert.commandWorked(admin.runCommand({shardCollection : coll.toString(), key : {_id : 1}}));
+assert.commandWorked(admin.runCommand({split : coll.toString(), middle : {_id : 1000}}));
+assert.commandWorked(admin.runCommand({split : coll.toString(), middle : {_id : 2000}}));
+assert.commandWorked(admin.runCommand({moveChunk : coll.toString(),
+                                       find : {_id : 1000},
+                                       to : "shard0001"}));
+assert.commandWorked(admin.runCommand({moveChunk : coll.toString(),
+                                       find : {_id : 2000},
+                                       to : "shard0002"}));
+
+// Every shard holds values of 'a' from the whole range, so a sort on 'a' interleaves them.
+var N = 3000;
+var bulk = coll.initializeUnorderedBulkOp();
+for (var i = 0; i < N; i++) {
+    bulk.insert({_id : i, a : (i * 7) % N});
+}
+assert.writeOK(bulk.execute());
+
+function checkSorted(cursor, expected) {
+    var count = 0;
+    var last = -1;
+    while (cursor.hasNext()) {
+        var doc = cursor.next();
+        assert.gt(doc.a, last, tojson(doc));
+        last = doc.a;
+        count++;
+    }
+    assert.eq(expected, count);
+}
+
+// Small batches make every shard need many getMores.
+checkSorted(coll.find().sort({a : 1}).batchSize(7), N);
+checkSorted(coll.find().sort({a : -1}).batchSize(50), N);
+checkSorted(coll.find({a : {$lt : 1000}}).sort({a : 1}).batchSize(3), 1000);
+checkSorted(coll.find().sort({a : 1}).limit(500).batchSize(20), 500);
+
+// Unsorted queries get every document once.
+var seen = {};
+var count = 0;
+coll.find().batchSize(11).forEach(function(doc) {
+    assert(!seen[doc._id], tojson(doc));
+    seen[doc._id] = true;
+    count++;
+});
+assert.eq(N, count);
+
+// Leave cursors part way through, then check that the connections they used still work.
+for (var i = 0; i < 20; i++) {
+    var cursor = coll.find().sort({a : 1}).batchSize(5);
+    for (var j = 0; j < 12; j++) {
+        cursor.next();
+    }
+}
+checkSorted(coll.find().sort({a : 1}).batchSize(100), N);
+assert.eq(N, coll.find().itcount());
+
+jsTest.log("DONE!");
+
+st.stop();
@@ -56,6 +56,7 @@
 #include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/debug_util.h"
 #include "mongo/util/log.h"
+#include "mongo/util/net/message_compressor.h"
 #include "mongo/util/net/ssl_manager.h"
 #include "mongo/util/net/ssl_options.h"
 #include "mongo/util/password_digest.h"
@@ -945,13 +946,46 @@ namespace {
         int sslModeVal = sslGlobalParams.sslMode.load();
         if (sslModeVal == SSLParams::SSLMode_preferSSL ||
             sslModeVal == SSLParams::SSLMode_requireSSL) {
-            return p->secure( sslManager(), _server.host() );
+            if (!p->secure( sslManager(), _server.host() )) {
+                return false;
+            }
         }
 #endif
 
+        _negotiateCompression();
         return true;
     }
 
+    void DBClientConnection::_negotiateCompression() {
+        BSONObjBuilder isMasterCmd;
+        isMasterCmd.append("isMaster", 1);
+        appendRequestedCompressors(&isMasterCmd);
+        if (isMasterCmd.asTempObj().nFields() == 1) {
+            // Compression is disabled, so there is nothing to negotiate.
+            return;
+        }
+
+        try {
+            BSONObj info;
+            if (!DBClientWithCommands::runCommand("admin", isMasterCmd.obj(), info)) {
+                LOG(_logLevel) << "could not negotiate compression with " << toString()
+                               << causedBy(getStatusFromCommandResult(info));
+                return;
+            }
+
+            const MessageCompressor compressor = getNegotiatedCompressor(info);
+            p->setCompressor(compressor);
+            if (compressor != MessageCompressor::kNoop) {
+                LOG(1) << "compressing messages to " << toString() << " with "
+                       << getMessageCompressorName(compressor);
+            }
+        }
+        catch (const DBException& ex) {
+            LOG(_logLevel) << "could not negotiate compression with " << toString()
+                           << causedBy(ex);
+        }
+    }
+
     void DBClientConnection::logout(const string& dbname, BSONObj& info){
         authCache.erase(dbname);
         runCommand(dbname, BSON("logout" << 1), info);
@@ -153,7 +153,7 @@ namespace mongo {
         return ok;
     }
 
-    void DBClientCursor::requestMore() {
+    void DBClientCursor::_assembleGetMore( Message& toSend ) {
         verify( cursorId && batch.pos == batch.nReturned );
 
         if (haveLimit) {
@@ -166,8 +166,17 @@ namespace mongo {
         b.appendNum(nextBatchSize());
         b.appendNum(cursorId);
 
-        Message toSend;
         toSend.setData(dbGetMore, b.buf(), b.len());
+    }
+
+    void DBClientCursor::requestMore() {
+        if ( _moreRequested ) {
+            _receiveMore();
+            return;
+        }
+
+        Message toSend;
+        _assembleGetMore( toSend );
         auto_ptr<Message> response(new Message());
 
         if ( _client ) {
@@ -187,6 +196,69 @@ namespace mongo {
         }
     }
 
+    void DBClientCursor::requestMoreLazy() {
+        if ( _moreRequested || !_putBack.empty() || batch.pos < batch.nReturned || !cursorId )
+            return;
+
+        if ( haveLimit && batch.pos >= nToReturn )
+            return;
+
+        // Exhaust cursors are sent their batches without asking.
+        if ( opts & QueryOption_Exhaust )
+            return;
+
+        if ( _client && !_client->lazySupported() )
+            return;
+
+        Message toSend;
+        _assembleGetMore( toSend );
+
+        if ( _client ) {
+            _client->say( toSend );
+        }
+        else {
+            verify( _scopedHost.size() );
+            // Held until the reply is read, so that nobody else uses the connection meanwhile.
+            boost::shared_ptr<ScopedDbConnection> conn(new ScopedDbConnection(_scopedHost));
+            (*conn)->say( toSend );
+            _moreConn = conn;
+        }
+        _moreRequested = true;
+    }
+
+    void DBClientCursor::finishLazyMore() {
+        if ( _moreRequested ) {
+            _receiveMore();
+        }
+    }
+
+    void DBClientCursor::_receiveMore() {
+        verify( _moreRequested );
+        _moreRequested = false;
+
+        // If the reply can't be read the connection is not returned to the pool.
+        boost::shared_ptr<ScopedDbConnection> conn;
+        conn.swap( _moreConn );
+
+        DBClientBase* client = conn ? conn->get() : _client;
+        auto_ptr<Message> response(new Message());
+        if ( !client->recv( *response ) ) {
+            uasserted( 28686, str::stream() << "recv failed while getting more results from "
+                                            << client->getServerAddress() );
+        }
+        batch.m = response;
+
+        if ( conn ) {
+            _client = client;
+            dataReceived();
+            _client = 0;
+            conn->done();
+        }
+        else {
+            dataReceived();
+        }
+    }
+
     /** with QueryOption_Exhaust, the server just blasts data at us (marked at end with cursorid==0). */
     void DBClientCursor::exhaustReceiveMore() {
         verify( cursorId && batch.pos == batch.nReturned );
@@ -261,7 +333,13 @@ namespace mongo {
         if ( cursorId == 0 )
             return false;
 
-        requestMore();
+        if ( opts & QueryOption_Exhaust ) {
+            // The server sends the next batch without being asked.
+            exhaustReceiveMore();
+        }
+        else {
+            requestMore();
+        }
         return batch.pos < batch.nReturned;
     }
 
@@ -363,6 +441,12 @@ namespace mongo {
     DBClientCursor::~DBClientCursor() {
         DESTRUCTOR_GUARD (
 
+        // Read the reply to a lazy getMore so that it isn't left on the connection, and so that
+        // the cursor isn't killed if that was its last batch.
+        if ( ! inShutdown() ) {
+            finishLazyMore();
+        }
+
         if ( cursorId && _ownCursor && ! inShutdown() ) {
             BufBuilder b;
             b.appendNum( (int)0 ); // reserved
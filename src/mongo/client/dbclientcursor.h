@@ -30,6 +30,7 @@
 #pragma once
 
 #include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
 #include <stack>
 
 #include "mongo/client/dbclientinterface.h"
@@ -40,6 +41,7 @@
 namespace mongo {
 
     class AScopedConnection;
+    class ScopedDbConnection;
 
     /** for mock purposes only -- do not create variants of DBClientCursor, nor hang code here
         @see DBClientMockCursor
@@ -60,6 +62,21 @@ namespace mongo {
         /** If true, safe to call next().  Requests more from server if necessary. */
         bool more();
 
+        /**
+         * If the current batch is used up and the cursor is still open on the server, sends the
+         * request for the next batch without waiting for the reply, which the next call to more()
+         * reads instead of making a round trip of its own. This lets a caller holding cursors on
+         * several servers have a getMore in flight on all of them at once.
+         */
+        void requestMoreLazy();
+
+        /**
+         * Reads the reply to the getMore sent by requestMoreLazy(), if it hasn't been read yet, so
+         * that nothing is left on the connection. Must be called before the connection is given
+         * back while the cursor is still open. If this throws, the connection must not be reused.
+         */
+        void finishLazyMore();
+
         /** If true, there is more in our local buffers to be fetched via next(). Returns
             false when a getMore request back to server would be required.  You can use this
             if you want to exhaust whatever data has been fetched to the client already but
@@ -149,7 +166,8 @@ namespace mongo {
             resultFlags(0),
             cursorId(),
             _ownCursor( true ),
-            wasError( false ) {
+            wasError( false ),
+            _moreRequested(false) {
             _finishConsInit();
         }
 
@@ -165,7 +183,8 @@ namespace mongo {
             resultFlags(0),
             cursorId(_cursorId),
             _ownCursor(true),
-            wasError(false) {
+            wasError(false),
+            _moreRequested(false) {
             _finishConsInit();
         }
 
@@ -240,11 +259,24 @@ namespace mongo {
         std::string _lazyHost;
         bool wasError;
 
+        // Set by requestMoreLazy() until the reply to its getMore has been read.
+        bool _moreRequested;
+
+        // The connection a lazy getMore was sent on, if the cursor is attached to a host rather
+        // than a client.
+        boost::shared_ptr<ScopedDbConnection> _moreConn;
+
         void dataReceived() { bool retry; std::string lazyHost; dataReceived( retry, lazyHost ); }
         void dataReceived( bool& retry, std::string& lazyHost );
         void requestMore();
         void exhaustReceiveMore(); // for exhaust
 
+        // Builds the getMore for the next batch.
+        void _assembleGetMore( Message& toSend );
+
+        // Reads the reply to the getMore sent by requestMoreLazy().
+        void _receiveMore();
+
         // Don't call from a virtual function
         void _assertIfNull() const { uassert(13348, "connection died", this); }
 
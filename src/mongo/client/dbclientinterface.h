@@ -789,6 +789,12 @@ namespace mongo {
                                       BSONObj& info,
                                       int options=0);
 
+        /**
+         * Look up the options available on this client.  Caches the answer from
+         * _lookupAvailableOptions(), below.
+         */
+        QueryOptions availableOptions();
+
     protected:
         /** if the result of a command is ok*/
         bool isOk(const BSONObj&);
@@ -798,12 +804,6 @@ namespace mongo {
 
         BSONObj _countCmd(const std::string &ns, const BSONObj& query, int options, int limit, int skip );
 
-        /**
-         * Look up the options available on this client.  Caches the answer from
-         * _lookupAvailableOptions(), below.
-         */
-        QueryOptions availableOptions();
-
         virtual QueryOptions _lookupAvailableOptions();
 
         virtual void _auth(const BSONObj& params);
@@ -1128,6 +1128,12 @@ namespace mongo {
         double _so_timeout;
         bool _connect( std::string& errmsg );
 
+        /**
+         * Agrees on a wire protocol compressor with the server through isMaster, if this
+         * process has compression enabled. Failures leave the connection uncompressed.
+         */
+        void _negotiateCompression();
+
         static AtomicInt32 _numConnections;
         static bool _lazyKillCursor; // lazy means we piggy back kill cursors on next op
 
@@ -414,7 +414,27 @@ namespace mongo {
 
             // Double-check conn is closed
             if( pcState->conn ){
-                pcState->conn->done();
+                // Once back in the pool the connection may be used by another thread, so any
+                // getMore reply still due is read, and the cursor killed, before that.
+                bool connUsable = true;
+                if( pcState->cursor ){
+                    try{
+                        pcState->cursor->finishLazyMore();
+                    }
+                    catch( std::exception& e ){
+                        warning() << "exception reading getMore reply while closing cursor"
+                                  << causedBy( e ) << endl;
+                        connUsable = false;
+                    }
+                    pcState->cursor.reset();
+                }
+
+                if( connUsable ){
+                    pcState->conn->done();
+                }
+                else{
+                    pcState->conn->kill();
+                }
             }
 
             pcState.reset();
@@ -1502,6 +1522,13 @@ namespace mongo {
         }
     }
 
+    void ParallelSortClusteredCursor::_requestMoreFromExhaustedCursors() {
+        for ( int i=0; i<_numServers; i++ ) {
+            if (_cursors[i].get())
+                _cursors[i].get()->requestMoreLazy();
+        }
+    }
+
     bool ParallelSortClusteredCursor::more() {
 
         if ( _needToSkip > 0 ) {
@@ -1516,6 +1543,8 @@ namespace mongo {
             _needToSkip = n;
         }
 
+        _requestMoreFromExhaustedCursors();
+
         for ( int i=0; i<_numServers; i++ ) {
             if (_cursors[i].get() && _cursors[i].get()->more())
                 return true;
@@ -1527,6 +1556,8 @@ namespace mongo {
         BSONObj best = BSONObj();
         int bestFrom = -1;
 
+        _requestMoreFromExhaustedCursors();
+
         for( int j = 0; j < _numServers; j++ ){
 
             // Iterate _numServers times, starting one past the last server we used.
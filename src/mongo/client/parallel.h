@@ -209,6 +209,13 @@ namespace mongo {
 
         void _explain( std::map< std::string,std::list<BSONObj> >& out );
 
+        /**
+         * Sends a getMore on every cursor which has used up its batch, without waiting for the
+         * replies, so that the shards are asked for their next batches all at once rather than
+         * one after the other as the merge reaches them.
+         */
+        void _requestMoreFromExhaustedCursors();
+
         void _markStaleNS( const NamespaceString& staleNS, const StaleConfigException& e, bool& forceReload, bool& fullReload );
         void _handleStaleNS( const NamespaceString& staleNS, bool forceReload, bool fullReload );
 
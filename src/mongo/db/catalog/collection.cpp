@@ -210,10 +210,11 @@ namespace {
         return _recordStore->getCursor(txn, forward);
     }
 
-    vector<std::unique_ptr<RecordCursor>> Collection::getManyCursors(OperationContext* txn) const {
+    vector<std::unique_ptr<RecordCursor>> Collection::getManyCursors(OperationContext* txn,
+                                                                     size_t numCursors) const {
         dassert(txn->lockState()->isCollectionLockedForMode(ns().toString(), MODE_IS));
 
-        return _recordStore->getManyCursors(txn);
+        return _recordStore->getManyCursors(txn, numCursors);
     }
 
     Snapshotted<BSONObj> Collection::docFor(OperationContext* txn, const RecordId& loc) const {
@@ -333,6 +334,40 @@ namespace {
         return res;
     }
 
+    Status Collection::insertDocuments(OperationContext* txn,
+                                       std::vector<BSONObj>::const_iterator begin,
+                                       std::vector<BSONObj>::const_iterator end,
+                                       bool enforceQuota,
+                                       bool fromMigrate) {
+        const bool hasIdIndex = _indexCatalog.findIdIndex( txn );
+        for (auto it = begin; it != end; ++it) {
+            auto status = checkValidation(txn, *it);
+            if (!status.isOK())
+                return status;
+
+            if ( hasIdIndex && (*it)["_id"].eoo() ) {
+                return Status( ErrorCodes::InternalError,
+                               str::stream() << "Collection::insertDocuments got "
+                               "document without _id for ns:" << _ns.ns() );
+            }
+        }
+
+        const SnapshotId sid = txn->recoveryUnit()->getSnapshotId();
+
+        Status status = _insertDocuments( txn, begin, end, enforceQuota );
+        if (!status.isOK())
+            return status;
+        invariant( sid == txn->recoveryUnit()->getSnapshotId() );
+
+        getGlobalServiceContext()->getOpObserver()->onInserts(txn, ns(), begin, end, fromMigrate);
+
+        if (_cappedNotifier && !_cappedNotifier.unique()) {
+            _cappedNotifier->notifyOfInsert();
+        }
+
+        return Status::OK();
+    }
+
     StatusWith<RecordId> Collection::insertDocument(OperationContext* txn,
                                                     const BSONObj& doc,
                                                     MultiIndexBlock* indexBlock,
@@ -397,6 +432,50 @@ namespace {
         return loc;
     }
 
+    Status Collection::_insertDocuments( OperationContext* txn,
+                                         std::vector<BSONObj>::const_iterator begin,
+                                         std::vector<BSONObj>::const_iterator end,
+                                         bool enforceQuota ) {
+        dassert(txn->lockState()->isCollectionLockedForMode(ns().toString(), MODE_IX));
+
+        if ( isCapped() && _indexCatalog.haveAnyIndexes() ) {
+            // Capped deletes triggered by the record store unindex the documents they remove, so
+            // every document must be indexed before the next insert can roll it out.
+            for (auto it = begin; it != end; ++it) {
+                StatusWith<RecordId> loc = _insertDocument( txn, *it, enforceQuota );
+                if ( !loc.isOK() )
+                    return loc.getStatus();
+            }
+            return Status::OK();
+        }
+
+        std::vector<Record> records;
+        records.reserve( std::distance( begin, end ) );
+        for (auto it = begin; it != end; ++it) {
+            Record record = { RecordId(), RecordData( it->objdata(), it->objsize() ) };
+            records.push_back( record );
+        }
+
+        Status status = _recordStore->insertRecords( txn, &records, _enforceQuota( enforceQuota ) );
+        if ( !status.isOK() )
+            return status;
+
+        _infoCache.notifyOfWriteOp();
+
+        size_t i = 0;
+        for (auto it = begin; it != end; ++it, ++i) {
+            const RecordId& loc = records[i].id;
+            invariant( RecordId::min() < loc );
+            invariant( loc < RecordId::max() );
+
+            Status s = _indexCatalog.indexRecord( txn, *it, loc );
+            if ( !s.isOK() )
+                return s;
+        }
+
+        return Status::OK();
+    }
+
     Status Collection::aboutToDeleteCapped( OperationContext* txn,
                                             const RecordId& loc,
                                             RecordData data ) {
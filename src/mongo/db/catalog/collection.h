@@ -32,6 +32,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "mongo/base/status.h"
 #include "mongo/base/status_with.h"
@@ -188,9 +189,11 @@ namespace mongo {
 
         /**
          * Returns many cursors that partition the Collection into many disjoint sets. Iterating
-         * all returned cursors is equivalent to iterating the full collection.
+         * all returned cursors is equivalent to iterating the full collection. 'numCursors' is a
+         * hint, see RecordStore::getManyCursors.
          */
-        std::vector<std::unique_ptr<RecordCursor>> getManyCursors(OperationContext* txn) const;
+        std::vector<std::unique_ptr<RecordCursor>> getManyCursors(OperationContext* txn,
+                                                                  size_t numCursors) const;
 
         void deleteDocument( OperationContext* txn,
                              const RecordId& loc,
@@ -209,6 +212,19 @@ namespace mongo {
                                             bool enforceQuota,
                                             bool fromMigrate = false);
 
+        /**
+         * Inserts the documents in [begin, end) as insertDocument would, but with a single call
+         * into the RecordStore so that the fixed costs of an insert are paid once per batch.
+         * Either all of the documents are inserted or the caller's WriteUnitOfWork must be
+         * rolled back, so callers wanting to know which document failed should retry one at a
+         * time with insertDocument.
+         */
+        Status insertDocuments( OperationContext* txn,
+                                std::vector<BSONObj>::const_iterator begin,
+                                std::vector<BSONObj>::const_iterator end,
+                                bool enforceQuota,
+                                bool fromMigrate = false );
+
         /**
          * Callers must ensure no document validation is performed for this collection when calling
          * this method.
@@ -360,6 +376,11 @@ namespace mongo {
                                              const BSONObj& doc,
                                              bool enforceQuota );
 
+        Status _insertDocuments( OperationContext* txn,
+                                 std::vector<BSONObj>::const_iterator begin,
+                                 std::vector<BSONObj>::const_iterator end,
+                                 bool enforceQuota );
+
         bool _enforceQuota( bool userEnforeQuota ) const;
 
         int _magic;
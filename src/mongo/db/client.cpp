@@ -89,6 +89,17 @@ namespace mongo {
         *currentClient.get() = service->makeClient(fullDesc, mp);
     }
 
+    ServiceContext::UniqueClient Client::releaseCurrent() {
+        return std::move(*currentClient.getMake());
+    }
+
+    void Client::setCurrent(ServiceContext::UniqueClient client) {
+        invariant(currentClient.getMake()->get() == nullptr);
+        invariant(client);
+        setThreadName(client->desc().c_str());
+        *currentClient.get() = std::move(client);
+    }
+
     Client::Client(std::string desc,
                    ServiceContext* serviceContext,
                    AbstractMessagingPort *p)
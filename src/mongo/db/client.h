@@ -76,6 +76,19 @@ namespace mongo {
          */
         static void initThreadIfNotAlready();
 
+        /**
+         * Detaches the Client attached to the current thread, if any, and returns it. Used by
+         * servers which multiplex many connections over a pool of threads, so that a connection's
+         * Client can follow its requests from one worker thread to the next.
+         */
+        static ServiceContext::UniqueClient releaseCurrent();
+
+        /**
+         * Attaches "client" to the current thread, which must not already have a Client, and
+         * names the thread after it.
+         */
+        static void setCurrent(ServiceContext::UniqueClient client);
+
         std::string clientAddress(bool includePort = false) const;
         const std::string& desc() const { return _desc; }
 
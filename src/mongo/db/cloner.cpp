@@ -126,22 +126,56 @@ namespace mongo {
         void operator()( DBClientCursorBatchIterator &i ) {
             invariant(from_collection.coll() != "system.indexes");
 
-            // XXX: can probably take dblock instead
-            scoped_ptr<ScopedTransaction> scopedXact(new ScopedTransaction(txn, MODE_X));
-            scoped_ptr<Lock::GlobalWrite> globalWriteLock(new Lock::GlobalWrite(txn->lockState()));
+            // Documents are inserted under the global lock in MODE_X or, if only collection locks
+            // were requested, under the database and collection locks in MODE_IX.
+            scoped_ptr<ScopedTransaction> scopedXact;
+            scoped_ptr<Lock::GlobalWrite> globalWriteLock;
+            scoped_ptr<Lock::DBLock> dbLock;
+            scoped_ptr<Lock::CollectionLock> collectionLock;
+            auto lock = [&]() {
+                if (_collectionLocksOnly) {
+                    scopedXact.reset(new ScopedTransaction(txn, MODE_IX));
+                    dbLock.reset(new Lock::DBLock(txn->lockState(), _dbName, MODE_IX));
+                    collectionLock.reset(new Lock::CollectionLock(txn->lockState(),
+                                                                  to_collection.ns(),
+                                                                  MODE_IX));
+                }
+                else {
+                    // XXX: can probably take dblock instead
+                    scopedXact.reset(new ScopedTransaction(txn, MODE_X));
+                    globalWriteLock.reset(new Lock::GlobalWrite(txn->lockState()));
+                }
+            };
+            auto unlock = [&]() {
+                collectionLock.reset();
+                dbLock.reset();
+                globalWriteLock.reset();
+                scopedXact.reset();
+            };
+
+            lock();
             uassert(ErrorCodes::NotMaster,
                     str::stream() << "Not primary while cloning collection " << from_collection.ns()
                                   << " to " << to_collection.ns(),
                     !txn->writesAreReplicated() ||
                     repl::getGlobalReplicationCoordinator()->canAcceptWritesForDatabase(_dbName));
 
-            // Make sure database still exists after we resume from the temp release
-            Database* db = dbHolder().openDb(txn, _dbName);
+            // Make sure database still exists after we resume from the temp release. The
+            // collection must already exist if only collection locks are held.
+            Database* db = _collectionLocksOnly ? dbHolder().get(txn, _dbName)
+                                                : dbHolder().openDb(txn, _dbName);
+            uassert(28683,
+                    str::stream() << "Database " << _dbName << " dropped while cloning",
+                    db != NULL);
 
             bool createdCollection = false;
             Collection* collection = NULL;
 
             collection = db->getCollection( to_collection );
+            uassert(28684,
+                    str::stream() << "Collection " << to_collection.ns()
+                                  << " dropped while cloning",
+                    collection || !_collectionLocksOnly);
             if ( !collection ) {
                 massert( 17321,
                          str::stream()
@@ -156,8 +190,13 @@ namespace mongo {
                 } MONGO_WRITE_CONFLICT_RETRY_LOOP_END(txn, "createCollection", to_collection.ns());
             }
 
+            // Documents are inserted in groups, which are flushed before every yield point and
+            // at the end of each batch received from the source.
+            std::vector<BSONObj> docs;
             while( i.moreInCurrentBatch() ) {
                 if ( numSeen % 128 == 127 ) {
+                    insertDocuments(collection, &docs);
+
                     time_t now = time(0);
                     if( now - lastLog >= 60 ) {
                         // report progress
@@ -171,13 +210,11 @@ namespace mongo {
                     }
 
                     if (_mayYield) {
-                        scopedXact.reset();
-                        globalWriteLock.reset();
+                        unlock();
 
                         CurOp::get(txn)->yielded();
 
-                        scopedXact.reset(new ScopedTransaction(txn, MODE_X));
-                        globalWriteLock.reset(new Lock::GlobalWrite(txn->lockState()));
+                        lock();
 
                         // Check if everything is still all right.
                         if (txn->writesAreReplicated()) {
@@ -219,23 +256,58 @@ namespace mongo {
                 }
 
                 ++numSeen;
-                MONGO_WRITE_CONFLICT_RETRY_LOOP_BEGIN {
-                    WriteUnitOfWork wunit(txn);
-
-                    BSONObj doc = tmp;
-                    StatusWith<RecordId> loc = collection->insertDocument( txn, doc, true );
-                    if ( !loc.isOK() ) {
-                        error() << "error: exception cloning object in " << from_collection
-                                << ' ' << loc.getStatus() << " obj:" << doc;
-                    }
-                    uassertStatusOK( loc.getStatus() );
-                    wunit.commit();
-                } MONGO_WRITE_CONFLICT_RETRY_LOOP_END(txn, "cloner insert", to_collection.ns());
+                docs.push_back(tmp);
                 RARELY if ( time( 0 ) - saveLast > 60 ) {
                     log() << numSeen << " objects cloned so far from collection " << from_collection;
                     saveLast = time( 0 );
                 }
             }
+
+            insertDocuments(collection, &docs);
+        }
+
+        /**
+         * Inserts and clears "docs". If the group as a whole fails, the documents are inserted
+         * one at a time so that the offending one can be reported.
+         */
+        void insertDocuments(Collection* collection, std::vector<BSONObj>* docs) {
+            if (docs->empty())
+                return;
+
+            long long numBytes = 0;
+            for (const BSONObj& doc : *docs) {
+                numBytes += doc.objsize();
+            }
+
+            bool inserted = false;
+            MONGO_WRITE_CONFLICT_RETRY_LOOP_BEGIN {
+                WriteUnitOfWork wunit(txn);
+                if (collection->insertDocuments(txn, docs->begin(), docs->end(), true).isOK()) {
+                    wunit.commit();
+                    inserted = true;
+                }
+            } MONGO_WRITE_CONFLICT_RETRY_LOOP_END(txn, "cloner insert", to_collection.ns());
+
+            if (!inserted) {
+                for (const BSONObj& doc : *docs) {
+                    MONGO_WRITE_CONFLICT_RETRY_LOOP_BEGIN {
+                        WriteUnitOfWork wunit(txn);
+
+                        StatusWith<RecordId> loc = collection->insertDocument( txn, doc, true );
+                        if ( !loc.isOK() ) {
+                            error() << "error: exception cloning object in " << from_collection
+                                    << ' ' << loc.getStatus() << " obj:" << doc;
+                        }
+                        uassertStatusOK( loc.getStatus() );
+                        wunit.commit();
+                    } MONGO_WRITE_CONFLICT_RETRY_LOOP_END(txn, "cloner insert", to_collection.ns());
+                }
+            }
+
+            if (_onInsert) {
+                _onInsert(docs->size(), numBytes);
+            }
+            docs->clear();
         }
 
         time_t lastLog;
@@ -248,6 +320,8 @@ namespace mongo {
         time_t saveLast;
         bool _mayYield;
         bool _mayBeInterrupted;
+        bool _collectionLocksOnly;
+        Cloner::InsertProgressFn _onInsert;
     };
 
     /* copy the specified collection
@@ -260,7 +334,9 @@ namespace mongo {
                       bool slaveOk,
                       bool mayYield,
                       bool mayBeInterrupted,
-                      Query query) {
+                      Query query,
+                      bool collectionLocksOnly,
+                      const InsertProgressFn& onInsert) {
         LOG(2) << "\t\tcloning collection " << from_collection << " to " << to_collection << " on " << _conn->getServerAddress() << " with filter " << query.toString() << endl;
 
         Fun f(txn, toDBName);
@@ -270,6 +346,8 @@ namespace mongo {
         f.saveLast = time( 0 );
         f._mayYield = mayYield;
         f._mayBeInterrupted = mayBeInterrupted;
+        f._collectionLocksOnly = collectionLocksOnly;
+        f._onInsert = onInsert;
 
         int options = QueryOption_NoCursorTimeout | ( slaveOk ? QueryOption_SlaveOk : 0 );
         {
@@ -424,6 +502,174 @@ namespace mongo {
         return true;
     }
 
+    Status Cloner::_listCollectionsToClone(OperationContext* txn,
+                                           const CloneOptions& opts,
+                                           set<string>* clonedColls,
+                                           list<BSONObj>* toClone) {
+        if (clonedColls) {
+            clonedColls->clear();
+        }
+
+        // getCollectionInfos may make a remote call, which may block indefinitely, so release
+        // the global lock that we are entering with.
+        Lock::TempRelease tempRelease(txn->lockState());
+
+        list<BSONObj> raw = _conn->getCollectionInfos( opts.fromDB );
+        for ( list<BSONObj>::iterator it = raw.begin(); it != raw.end(); ++it ) {
+            BSONObj collection = *it;
+
+            LOG(2) << "\t cloner got " << collection << endl;
+
+            BSONElement collectionOptions = collection["options"];
+            if ( collectionOptions.isABSONObj() ) {
+                Status parseOptionsStatus = CollectionOptions().parse(collectionOptions.Obj());
+                if (!parseOptionsStatus.isOK()) {
+                    return parseOptionsStatus;
+                }
+            }
+
+            BSONElement e = collection.getField("name");
+            if ( e.eoo() ) {
+                string s = "bad collection object " + collection.toString();
+                massert( 10290 , s.c_str(), false);
+            }
+            verify( !e.eoo() );
+            verify( e.type() == String );
+
+            const NamespaceString ns(opts.fromDB, e.valuestr());
+
+            if( ns.isSystem() ) {
+                /* system.users and s.js is cloned -- but nothing else from system.
+                 * system.indexes is handled specially at the end*/
+                if( legalClientSystemNS( ns.ns() , true ) == 0 ) {
+                    LOG(2) << "\t\t not cloning because system collection" << endl;
+                    continue;
+                }
+            }
+            if( !ns.isNormal() ) {
+                LOG(2) << "\t\t not cloning because has $ ";
+                continue;
+            }
+
+            if( opts.collsToIgnore.find( ns.ns() ) != opts.collsToIgnore.end() ){
+                LOG(2) << "\t\t ignoring collection " << ns;
+                continue;
+            }
+            else {
+                LOG(2) << "\t\t not ignoring collection " << ns;
+            }
+
+            if (clonedColls) {
+                clonedColls->insert(ns.ns());
+            }
+
+            toClone->push_back( collection.getOwned() );
+        }
+
+        return Status::OK();
+    }
+
+    Status Cloner::createCollections(OperationContext* txn,
+                                     const string& toDBName,
+                                     const CloneOptions& opts,
+                                     list<BSONObj>* collections) {
+        invariant(_conn.get());
+        invariant(txn->lockState()->isDbLockedForMode(toDBName, MODE_X));
+
+        collections->clear();
+        Status status = _listCollectionsToClone(txn, opts, NULL, collections);
+        if (!status.isOK()) {
+            return status;
+        }
+
+        Database* db = dbHolder().openDb(txn, toDBName);
+        for (list<BSONObj>::const_iterator i = collections->begin(); i != collections->end(); ++i) {
+            const NamespaceString to_name(toDBName, (*i)["name"].valuestr());
+            const BSONObj options = i->getObjectField("options");
+
+            MONGO_WRITE_CONFLICT_RETRY_LOOP_BEGIN {
+                WriteUnitOfWork wunit(txn);
+
+                // The _id index is built once the documents have been copied.
+                Status createStatus = userCreateNS(txn, db, to_name.ns(), options, false);
+                if (!createStatus.isOK()) {
+                    return createStatus;
+                }
+
+                wunit.commit();
+            } MONGO_WRITE_CONFLICT_RETRY_LOOP_END(txn, "createCollection", to_name.ns());
+        }
+
+        return Status::OK();
+    }
+
+    void Cloner::copyCollectionRange(OperationContext* txn,
+                                     const NamespaceString& nss,
+                                     const Query& query,
+                                     bool slaveOk,
+                                     const InsertProgressFn& onInsert) {
+        invariant(_conn.get());
+        invariant(!txn->lockState()->isLocked());
+
+        copy(txn,
+             nss.db().toString(),
+             nss,
+             nss,
+             false,
+             slaveOk,
+             true,
+             false,
+             query,
+             true,
+             onInsert);
+    }
+
+    void Cloner::buildIdIndex(OperationContext* txn, Collection* c, bool mayBeInterrupted) {
+        if (c->getIndexCatalog()->haveIdIndex(txn)) {
+            return;
+        }
+
+        // We need to drop objects with duplicate _ids because we didn't do a true
+        // snapshot and this is before applying oplog operations that occur during the
+        // initial sync.
+        set<RecordId> dups;
+
+        MultiIndexBlock indexer(txn, c);
+        if (mayBeInterrupted)
+            indexer.allowInterruption();
+
+        uassertStatusOK(indexer.init(c->getIndexCatalog()->getDefaultIdIndexSpec()));
+        uassertStatusOK(indexer.insertAllDocumentsInCollection(&dups));
+
+        // This must be done before we commit the indexer. See the comment about
+        // dupsAllowed in IndexCatalog::_unindexRecord and SERVER-17487.
+        for (set<RecordId>::const_iterator it = dups.begin(); it != dups.end(); ++it) {
+            WriteUnitOfWork wunit(txn);
+            BSONObj id;
+
+            c->deleteDocument(txn,
+                              *it,
+                              true,
+                              true,
+                              txn->writesAreReplicated() ? &id : nullptr);
+            wunit.commit();
+        }
+
+        if (!dups.empty()) {
+            log() << "index build dropped: " << dups.size() << " dups";
+        }
+
+        WriteUnitOfWork wunit(txn);
+        indexer.commit();
+        if (txn->writesAreReplicated()) {
+            getGlobalServiceContext()->getOpObserver()->onCreateIndex(
+                    txn,
+                    c->ns().getSystemIndexesCollection().c_str(),
+                    c->getIndexCatalog()->getDefaultIdIndexSpec());
+        }
+        wunit.commit();
+    }
+
     Status Cloner::copyDb(OperationContext* txn,
                           const std::string& toDBName,
                           const string& masterHost,
@@ -488,66 +734,9 @@ namespace mongo {
 
         // Gather the list of collections to clone
         list<BSONObj> toClone;
-        if (clonedColls) {
-            clonedColls->clear();
-        }
-
-        {
-            // getCollectionInfos may make a remote call, which may block indefinitely, so release
-            // the global lock that we are entering with.
-            Lock::TempRelease tempRelease(txn->lockState());
-
-            list<BSONObj> raw = _conn->getCollectionInfos( opts.fromDB );
-            for ( list<BSONObj>::iterator it = raw.begin(); it != raw.end(); ++it ) {
-                BSONObj collection = *it;
-
-                LOG(2) << "\t cloner got " << collection << endl;
-
-                BSONElement collectionOptions = collection["options"];
-                if ( collectionOptions.isABSONObj() ) {
-                    Status parseOptionsStatus = CollectionOptions().parse(collectionOptions.Obj());
-                    if (!parseOptionsStatus.isOK()) {
-                        return parseOptionsStatus;
-                    }
-                }
-
-                BSONElement e = collection.getField("name");
-                if ( e.eoo() ) {
-                    string s = "bad collection object " + collection.toString();
-                    massert( 10290 , s.c_str(), false);
-                }
-                verify( !e.eoo() );
-                verify( e.type() == String );
-
-                const NamespaceString ns(opts.fromDB, e.valuestr());
-
-                if( ns.isSystem() ) {
-                    /* system.users and s.js is cloned -- but nothing else from system.
-                     * system.indexes is handled specially at the end*/
-                    if( legalClientSystemNS( ns.ns() , true ) == 0 ) {
-                        LOG(2) << "\t\t not cloning because system collection" << endl;
-                        continue;
-                    }
-                }
-                if( !ns.isNormal() ) {
-                    LOG(2) << "\t\t not cloning because has $ ";
-                    continue;
-                }
-
-                if( opts.collsToIgnore.find( ns.ns() ) != opts.collsToIgnore.end() ){
-                    LOG(2) << "\t\t ignoring collection " << ns;
-                    continue;
-                }
-                else {
-                    LOG(2) << "\t\t not ignoring collection " << ns;
-                }
-
-                if (clonedColls) {
-                    clonedColls->insert(ns.ns());
-                }
-
-                toClone.push_back( collection.getOwned() );
-            }
+        Status listStatus = _listCollectionsToClone(txn, opts, clonedColls, &toClone);
+        if (!listStatus.isOK()) {
+            return listStatus;
         }
 
         uassert(ErrorCodes::NotMaster,
@@ -607,46 +796,8 @@ namespace mongo {
                         db);
 
                 Collection* c = db->getCollection( to_name );
-                if ( c && !c->getIndexCatalog()->haveIdIndex( txn ) ) {
-                    // We need to drop objects with duplicate _ids because we didn't do a true
-                    // snapshot and this is before applying oplog operations that occur during the
-                    // initial sync.
-                    set<RecordId> dups;
-
-                    MultiIndexBlock indexer(txn, c);
-                    if (opts.mayBeInterrupted)
-                        indexer.allowInterruption();
-
-                    uassertStatusOK(indexer.init(c->getIndexCatalog()->getDefaultIdIndexSpec()));
-                    uassertStatusOK(indexer.insertAllDocumentsInCollection(&dups));
-
-                    // This must be done before we commit the indexer. See the comment about
-                    // dupsAllowed in IndexCatalog::_unindexRecord and SERVER-17487.
-                    for (set<RecordId>::const_iterator it = dups.begin(); it != dups.end(); ++it) {
-                        WriteUnitOfWork wunit(txn);
-                        BSONObj id;
-
-                        c->deleteDocument(txn,
-                                          *it,
-                                          true,
-                                          true,
-                                          txn->writesAreReplicated() ? &id : nullptr);
-                        wunit.commit();
-                    }
-
-                    if (!dups.empty()) {
-                        log() << "index build dropped: " << dups.size() << " dups";
-                    }
-
-                    WriteUnitOfWork wunit(txn);
-                    indexer.commit();
-                    if (txn->writesAreReplicated()) {
-                        getGlobalServiceContext()->getOpObserver()->onCreateIndex(
-                                txn,
-                                c->ns().getSystemIndexesCollection().c_str(),
-                                c->getIndexCatalog()->getDefaultIdIndexSpec());
-                    }
-                    wunit.commit();
+                if (c) {
+                    buildIdIndex(txn, c, opts.mayBeInterrupted);
                 }
             }
         }
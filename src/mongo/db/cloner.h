@@ -30,12 +30,16 @@
 
 #pragma once
 
+#include <list>
+
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/base/disallow_copying.h"
+#include "mongo/stdx/functional.h"
 
 namespace mongo {
 
     struct CloneOptions;
+    class Collection;
     class DBClientBase;
     class NamespaceString;
     class OperationContext;
@@ -44,6 +48,11 @@ namespace mongo {
     class Cloner {
         MONGO_DISALLOW_COPYING(Cloner);
     public:
+        /**
+         * Called with the number of documents and of bytes inserted after each group of inserts.
+         */
+        using InsertProgressFn = stdx::function<void (long long numDocs, long long numBytes)>;
+
         Cloner();
 
         void setConnection(DBClientBase* c) {
@@ -67,6 +76,53 @@ namespace mongo {
                             bool mayBeInterrupted,
                             bool copyIndexes = true);
 
+        /**
+         * Creates in 'toDBName' the collections of 'opts.fromDB' which copyDb() would clone,
+         * without copying their documents or building any of their indexes, and returns their
+         * listCollections entries in 'collections'. The connection must have been set and the
+         * caller must hold the database lock in MODE_X.
+         */
+        Status createCollections(OperationContext* txn,
+                                 const std::string& toDBName,
+                                 const CloneOptions& opts,
+                                 std::list<BSONObj>* collections);
+
+        /**
+         * Copies the documents of 'nss' on the source which match 'query' into the existing
+         * collection of the same name. Unlike copyDb(), only the database and the collection are
+         * locked, in MODE_IX, while the documents are inserted, so several ranges of the same or
+         * of different collections may be copied concurrently through separate Cloners.
+         *
+         * The connection must have been set and the caller must hold no locks.
+         */
+        void copyCollectionRange(OperationContext* txn,
+                                 const NamespaceString& nss,
+                                 const Query& query,
+                                 bool slaveOk,
+                                 const InsertProgressFn& onInsert);
+
+        /**
+         * Builds the _id index of 'collection', deleting the documents with duplicate _ids,
+         * which a copy without $snapshot may have left. The caller must hold the database lock in
+         * MODE_X.
+         */
+        static void buildIdIndex(OperationContext* txn,
+                                 Collection* collection,
+                                 bool mayBeInterrupted);
+
+        /**
+         * Builds on 'to_ns' the indexes of 'from_ns' on the source. The caller must hold the
+         * database lock in MODE_X, which is released while the index specs are fetched.
+         */
+        void copyIndexes(OperationContext* txn,
+                         const std::string& toDBName,
+                         const NamespaceString& from_ns,
+                         const NamespaceString& to_ns,
+                         bool masterSameProcess,
+                         bool slaveOk,
+                         bool mayYield,
+                         bool mayBeInterrupted);
+
     private:
         void copy(OperationContext* txn,
                   const std::string& toDBName,
@@ -76,16 +132,18 @@ namespace mongo {
                   bool slaveOk,
                   bool mayYield,
                   bool mayBeInterrupted,
-                  Query q);
+                  Query q,
+                  bool collectionLocksOnly = false,
+                  const InsertProgressFn& onInsert = InsertProgressFn());
 
-        void copyIndexes(OperationContext* txn,
-                         const std::string& toDBName,
-                         const NamespaceString& from_ns,
-                         const NamespaceString& to_ns,
-                         bool masterSameProcess,
-                         bool slaveOk,
-                         bool mayYield,
-                         bool mayBeInterrupted);
+        /**
+         * Lists the collections of 'opts.fromDB' on the source which should be cloned into
+         * 'toClone'. Releases the locks held by the caller while the source is queried.
+         */
+        Status _listCollectionsToClone(OperationContext* txn,
+                                       const CloneOptions& opts,
+                                       std::set<std::string>* clonedColls,
+                                       std::list<BSONObj>* toClone);
 
         struct Fun;
         std::auto_ptr<DBClientBase> _conn;
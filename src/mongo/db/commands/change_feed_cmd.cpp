@@ -0,0 +1,302 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include <memory>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/database.h"
+#include "mongo/db/client.h"
+#include "mongo/db/clientcursor.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/change_feed_request.h"
+#include "mongo/db/query/cursor_responses.h"
+#include "mongo/db/query/explain.h"
+#include "mongo/db/query/find.h"
+#include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/internal_plans.h"
+#include "mongo/db/repl/optime.h"
+#include "mongo/db/repl/replication_coordinator_global.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+namespace {
+
+    const NamespaceString kOplogNss("local.oplog.rs");
+
+    /**
+     * Returns the timestamp of the first entry in 'oplog', or a null Timestamp if it is empty.
+     */
+    Timestamp getFirstOplogTimestamp(OperationContext* txn, Collection* oplog) {
+        std::unique_ptr<PlanExecutor> exec(
+            InternalPlanner::collectionScan(txn, kOplogNss.ns(), oplog));
+        BSONObj first;
+        if (PlanExecutor::ADVANCED != exec->getNext(&first, NULL)) {
+            return Timestamp();
+        }
+        return first["ts"].timestamp();
+    }
+
+}  // namespace
+
+    /**
+     * A command for following the changes made to one or more sets of namespaces, which returns
+     * the matching oplog entries as they are written. See ChangeFeedRequest for its format.
+     *
+     * The feed is a tailable cursor over the oplog, so clients keep reading it with getMore on
+     * local.oplog.rs. Each result has an _id made from the entry and subscription it is for,
+     * which can be passed back as resumeAfter to pick up where a previous feed left off.
+     */
+    class ChangeFeedCmd : public Command {
+        MONGO_DISALLOW_COPYING(ChangeFeedCmd);
+    public:
+        ChangeFeedCmd() : Command("changeFeed") { }
+
+        bool isWriteCommandForConfigServer() const override { return false; }
+
+        bool slaveOk() const override { return true; }
+
+        bool maintenanceOk() const override { return false; }
+
+        bool adminOnly() const override { return true; }
+
+        void help(std::stringstream& help) const override {
+            help << "follow the changes made to a set of namespaces";
+        }
+
+        Status checkAuthForCommand(ClientBasic* client,
+                                   const std::string& dbname,
+                                   const BSONObj& cmdObj) override {
+            AuthorizationSession* authzSession = AuthorizationSession::get(client);
+            if (authzSession->isAuthorizedForActionsOnResource(
+                    ResourcePattern::forExactNamespace(kOplogNss), ActionType::find)) {
+                return Status::OK();
+            }
+
+            return Status(ErrorCodes::Unauthorized, "unauthorized");
+        }
+
+        bool run(OperationContext* txn,
+                 const std::string& dbname,
+                 BSONObj& cmdObj,
+                 int options,
+                 std::string& errmsg,
+                 BSONObjBuilder& result) override {
+            if (txn->getClient()->isInDirectClient()) {
+                return appendCommandStatus(result,
+                                           Status(ErrorCodes::IllegalOperation,
+                                                  "Cannot run changeFeed command from eval()"));
+            }
+
+            repl::ReplicationCoordinator* replCoord = repl::getGlobalReplicationCoordinator();
+            if (replCoord->getReplicationMode() != repl::ReplicationCoordinator::modeReplSet) {
+                return appendCommandStatus(result,
+                                           Status(ErrorCodes::NoReplicationEnabled,
+                                                  "changeFeed requires a replica set"));
+            }
+
+            StatusWith<ChangeFeedRequest> swRequest = ChangeFeedRequest::parseFromBSON(cmdObj);
+            if (!swRequest.isOK()) {
+                return appendCommandStatus(result, swRequest.getStatus());
+            }
+            const ChangeFeedRequest& request = swRequest.getValue();
+
+            // Without a resume token the feed starts after the last entry applied here.
+            const Timestamp after = request.resumeAfter ?
+                *request.resumeAfter : replCoord->getMyLastOptime().getTimestamp();
+
+            // The feed is a tailable, oplogReplay find over the oplog...
+            BSONObjBuilder findBob;
+            findBob.append("find", kOplogNss.coll());
+            findBob.append("filter", request.toOplogFilter(after));
+            findBob.append("tailable", true);
+            findBob.append("awaitData", true);
+            findBob.append("oplogReplay", true);
+            if (request.batchSize) {
+                findBob.append("batchSize", *request.batchSize);
+            }
+            const BSONElement maxTimeMS = cmdObj[LiteParsedQuery::cmdOptionMaxTimeMS];
+            if (!maxTimeMS.eoo()) {
+                findBob.append(maxTimeMS);
+            }
+            const BSONObj findCmdObj = findBob.obj();
+
+            std::unique_ptr<LiteParsedQuery> lpq;
+            {
+                LiteParsedQuery* rawLpq;
+                const bool isExplain = false;
+                Status lpqStatus = LiteParsedQuery::make(kOplogNss.ns(), findCmdObj, isExplain,
+                                                         &rawLpq);
+                if (!lpqStatus.isOK()) {
+                    return appendCommandStatus(result, lpqStatus);
+                }
+                lpq.reset(rawLpq);
+            }
+
+            int ntoreturn = lpq->getBatchSize().value_or(0);
+            beginQueryOp(txn, kOplogNss, findCmdObj, ntoreturn, lpq->getSkip());
+
+            std::unique_ptr<CanonicalQuery> cq;
+            {
+                CanonicalQuery* rawCq;
+                Status canonStatus = CanonicalQuery::canonicalize(lpq.release(), &rawCq);
+                if (!canonStatus.isOK()) {
+                    return appendCommandStatus(result, canonStatus);
+                }
+                cq.reset(rawCq);
+            }
+
+            AutoGetCollectionForRead ctx(txn, kOplogNss);
+            Collection* collection = ctx.getCollection();
+            if (!collection) {
+                return appendCommandStatus(result,
+                                           Status(ErrorCodes::NamespaceNotFound,
+                                                  "no oplog to follow"));
+            }
+
+            // ...which would quietly skip the entries between the resume token and the start of
+            // the oplog if they have already been deleted.
+            if (request.resumeAfter) {
+                const Timestamp first = getFirstOplogTimestamp(txn, collection);
+                if (first.isNull() || first > *request.resumeAfter) {
+                    return appendCommandStatus(result,
+                                               Status(ErrorCodes::OplogStartMissing,
+                                                      str::stream()
+                                                          << "cannot resume change feed after "
+                                                          << request.resumeAfter->toString()
+                                                          << " as the oplog now starts at "
+                                                          << first.toString()));
+                }
+            }
+
+            const int dbProfilingLevel = ctx.getDb() ? ctx.getDb()->getProfilingLevel() :
+                                                       serverGlobalParams.defaultProfile;
+
+            std::unique_ptr<PlanExecutor> execHolder;
+            {
+                PlanExecutor* rawExec;
+                Status execStatus = getExecutorChangeFeed(txn,
+                                                          collection,
+                                                          cq.release(),
+                                                          request,
+                                                          &rawExec);
+                if (!execStatus.isOK()) {
+                    return appendCommandStatus(result, execStatus);
+                }
+                execHolder.reset(rawExec);
+            }
+
+            const LiteParsedQuery& pq = execHolder->getCanonicalQuery()->getParsed();
+
+            // Register the executor in a ClientCursor, as the find command does, so that getMore
+            // can carry on with the feed.
+            execHolder->deregisterExec();
+            ClientCursor* cursor = new ClientCursor(collection->getCursorManager(),
+                                                    execHolder.release(),
+                                                    kOplogNss.ns(),
+                                                    pq.getOptions(),
+                                                    pq.getFilter());
+            CursorId cursorId = cursor->cursorid();
+            ClientCursorPin ccPin(collection->getCursorManager(), cursorId);
+
+            // On early return, get rid of the the cursor.
+            ScopeGuard cursorFreer = MakeGuard(&ClientCursorPin::deleteUnderlying, ccPin);
+
+            PlanExecutor* exec = cursor->getExecutor();
+
+            BSONArrayBuilder firstBatch;
+            BSONObj obj;
+            PlanExecutor::ExecState state = PlanExecutor::IS_EOF;
+            int numResults = 0;
+            while (!enoughForFirstBatch(pq, numResults, firstBatch.len())
+                    && PlanExecutor::ADVANCED == (state = exec->getNext(&obj, NULL))) {
+                if (firstBatch.len() + obj.objsize() > BSONObjMaxUserSize && numResults > 0) {
+                    exec->enqueue(obj);
+                    break;
+                }
+
+                firstBatch.append(obj);
+                numResults++;
+            }
+
+            if (PlanExecutor::FAILURE == state || PlanExecutor::DEAD == state) {
+                const std::unique_ptr<PlanStageStats> stats(exec->getStats());
+                error() << "Plan executor error during changeFeed command: "
+                        << PlanExecutor::statestr(state)
+                        << ", stats: " << Explain::statsToBSON(*stats);
+
+                return appendCommandStatus(result,
+                                           Status(ErrorCodes::OperationFailed,
+                                                  str::stream()
+                                                      << "Executor error during changeFeed "
+                                                      << "command: "
+                                                      << WorkingSetCommon::toStatusString(obj)));
+            }
+
+            if (shouldSaveCursor(txn, collection, state, exec)) {
+                // State will be restored on getMore.
+                exec->saveState();
+
+                cursor->setLeftoverMaxTimeMicros(CurOp::get(txn)->getRemainingMaxTimeMicros());
+                cursor->setPos(numResults);
+
+                // Don't stash the RU at EOF, let the next getMore get a new one.
+                if (state != PlanExecutor::IS_EOF) {
+                    txn->recoveryUnit()->abandonSnapshot();
+                    cursor->setOwnedRecoveryUnit(txn->releaseRecoveryUnit());
+                    StorageEngine* engine = getGlobalServiceContext()->getGlobalStorageEngine();
+                    txn->setRecoveryUnit(engine->newRecoveryUnit(),
+                                         OperationContext::kNotInUnitOfWork);
+                }
+            }
+            else {
+                cursorId = 0;
+            }
+
+            endQueryOp(txn, exec, dbProfilingLevel, numResults, cursorId);
+
+            appendCursorResponseObject(cursorId, kOplogNss.ns(), firstBatch.arr(), &result);
+            if (cursorId) {
+                cursorFreer.Dismiss();
+            }
+            return true;
+        }
+
+    } changeFeedCmd;
+
+} // namespace mongo
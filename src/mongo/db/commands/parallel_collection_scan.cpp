@@ -100,7 +100,7 @@ namespace mongo {
                                                     "numCursors has to be between 1 and 10000" <<
                                                     " was: " << numCursors ) );
 
-            auto iterators = collection->getManyCursors(txn);
+            auto iterators = collection->getManyCursors(txn, numCursors);
             if (iterators.size() < numCursors) {
                 numCursors = iterators.size();
             }
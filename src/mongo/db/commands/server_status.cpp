@@ -47,6 +47,7 @@
 #include "mongo/platform/process_id.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/listen.h"
+#include "mongo/util/net/message_compressor.h"
 #include "mongo/util/net/ssl_manager.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/ramlog.h"
@@ -276,6 +277,7 @@ namespace mongo {
 
                 BSONObjBuilder b;
                 networkCounter.append( b );
+                appendMessageCompressionStats(&b);
                 return b.obj();
             }
                 
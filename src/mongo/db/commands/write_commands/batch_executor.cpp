@@ -70,6 +70,7 @@
 #include "mongo/db/stats/counters.h"
 #include "mongo/db/stats/top.h"
 #include "mongo/db/write_concern.h"
+#include "mongo/s/chunk_load_tracker.h"
 #include "mongo/s/collection_metadata.h"
 #include "mongo/s/d_state.h"
 #include "mongo/s/shard_key_pattern.h"
@@ -116,6 +117,10 @@ namespace mongo {
     // TODO: Determine queueing behavior we want here
     MONGO_EXPORT_SERVER_PARAMETER( queueForMigrationCommit, bool, true );
 
+    // Maximum number of consecutive documents of an insert batch to write with a single call to
+    // Collection::insertDocuments.
+    MONGO_EXPORT_SERVER_PARAMETER( internalInsertMaxBatchSize, int, 64 );
+
     using mongoutils::str::stream;
 
     WriteBatchExecutor::WriteBatchExecutor( OperationContext* txn,
@@ -442,6 +447,51 @@ namespace mongo {
         return true;
     }
 
+    /**
+     * Samples a write to a sharded collection into the chunk load tracker. 'docOrQuery' is the
+     * inserted document, or the query of an update or delete. Writes whose shard key can't be
+     * found from it, such as multi-updates, are not attributed to any chunk.
+     */
+    static void recordWriteLoad(const string& ns, const BSONObj& docOrQuery, bool isQuery) {
+        if (!shardingState.enabled()) {
+            return;
+        }
+
+        const int numOps = chunkLoadTracker.sample();
+        if (!numOps) {
+            return;
+        }
+
+        CollectionMetadataPtr metadata = shardingState.getCollectionMetadata(ns);
+        if (!metadata) {
+            return;
+        }
+
+        ShardKeyPattern shardKeyPattern(metadata->getKeyPattern());
+        BSONObj shardKey;
+        if (isQuery) {
+            StatusWith<BSONObj> status = shardKeyPattern.extractShardKeyFromQuery(docOrQuery);
+            if (!status.isOK()) {
+                return;
+            }
+            shardKey = status.getValue();
+        }
+        else {
+            shardKey = shardKeyPattern.extractShardKeyFromDoc(docOrQuery);
+        }
+
+        if (shardKey.isEmpty()) {
+            return;
+        }
+
+        chunkLoadTracker.record(ns,
+                                *metadata,
+                                shardKey,
+                                ChunkLoadTracker::kWrite,
+                                numOps,
+                                Date_t::now());
+    }
+
     static bool checkIsMasterForDatabase(const NamespaceString& ns, WriteOpResult* result) {
         if (!repl::getGlobalReplicationCoordinator()->canAcceptWritesForDatabase(
                 ns.db())) {
@@ -826,6 +876,12 @@ namespace mongo {
         // particularly on operation interruption.  These kinds of errors necessarily prevent
         // further insertOne calls, and stop the batch.  As a result, the only expected source of
         // such exceptions are interruptions.
+        //
+        // Before falling back to insertOne, each iteration first tries to write a whole group of
+        // consecutive, well-formed documents with execInsertGroup(), which amortizes the
+        // per-insert cost of the storage engine and of stats collection over the group.  If the
+        // group fails for any reason it is abandoned and its documents are retried one at a
+        // time, so that errors are reported against the right document exactly as before.
         ExecInsertsState state(_txn, &request);
         normalizeInserts(request, &state.normalizedInserts);
 
@@ -844,13 +900,14 @@ namespace mongo {
         ElapsedTracker elapsedTracker(internalQueryExecYieldIterations,
                                       internalQueryExecYieldPeriodMS);
 
-        for (state.currIndex = 0;
-             state.currIndex < state.request->sizeWriteOps();
-             ++state.currIndex) {
+        const size_t numInserts = state.request->sizeWriteOps();
 
-            if (state.currIndex + 1 == state.request->sizeWriteOps()) {
-                setupSynchronousCommit(_txn);
-            }
+        // Inserts before this index belong to a group which failed as a whole and are retried
+        // individually.
+        size_t retryIndividuallyUntil = 0;
+
+        state.currIndex = 0;
+        while (state.currIndex < numInserts) {
 
             if (elapsedTracker.intervalHasElapsed()) {
                 // Yield between inserts.
@@ -869,6 +926,19 @@ namespace mongo {
                 elapsedTracker.resetLastTime();
             }
 
+            const size_t groupEnd = getInsertGroupEnd(state);
+            if (groupEnd == numInserts) {
+                setupSynchronousCommit(_txn);
+            }
+
+            if (state.currIndex >= retryIndividuallyUntil && groupEnd - state.currIndex > 1) {
+                if (execInsertGroup(&state, groupEnd)) {
+                    state.currIndex = groupEnd;
+                    continue;
+                }
+                retryIndividuallyUntil = groupEnd;
+            }
+
             WriteErrorDetail* error = NULL;
             execOneInsert(&state, &error);
             if (error) {
@@ -877,6 +947,7 @@ namespace mongo {
                 if (request.getOrdered())
                     return;
             }
+            ++state.currIndex;
         }
     }
 
@@ -907,6 +978,12 @@ namespace mongo {
 
         multiUpdate( _txn, updateItem, &result );
 
+        if ( !result.getError() ) {
+            recordWriteLoad( updateItem.getRequest()->getTargetingNS(),
+                             updateItem.getUpdate()->getQuery(),
+                             true );
+        }
+
         if ( !result.getStats().upsertedID.isEmpty() ) {
             *upsertedId = result.getStats().upsertedID;
         }
@@ -951,6 +1028,12 @@ namespace mongo {
 
         multiRemove( _txn, removeItem, &result );
 
+        if ( !result.getError() ) {
+            recordWriteLoad( removeItem.getRequest()->getTargetingNS(),
+                             removeItem.getDelete()->getQuery(),
+                             true );
+        }
+
         // END CURRENT OP
         incWriteStats( removeItem, result.getStats(), result.getError(), &currentOp );
         finishCurrentOp(_txn, result.getError());
@@ -1053,6 +1136,14 @@ namespace mongo {
         _dbLock.reset();
     }
 
+    static const BSONObj& getInsertDoc(const WriteBatchExecutor::ExecInsertsState& state,
+                                       size_t index) {
+        const StatusWith<BSONObj>& normalizedInsert(state.normalizedInserts[index]);
+        return normalizedInsert.getValue().isEmpty() ?
+            state.request->getInsertRequest()->getDocumentsAt(index) :
+            normalizedInsert.getValue();
+    }
+
     static void insertOne(WriteBatchExecutor::ExecInsertsState* state, WriteOpResult* result) {
         // we have to be top level so we can retry
         invariant(!state->txn->lockState()->inAWriteUnitOfWork() );
@@ -1065,9 +1156,7 @@ namespace mongo {
             return;
         }
 
-        const BSONObj& insertDoc = normalizedInsert.getValue().isEmpty() ?
-            state->request->getInsertRequest()->getDocumentsAt( state->currIndex ) :
-            normalizedInsert.getValue();
+        const BSONObj& insertDoc = getInsertDoc(*state, state->currIndex);
 
         int attempt = 0;
         while (true) {
@@ -1136,6 +1225,78 @@ namespace mongo {
         }
     }
 
+    size_t WriteBatchExecutor::getInsertGroupEnd(const ExecInsertsState& state) {
+        const size_t maxEnd = std::min(state.normalizedInserts.size(),
+                                       state.currIndex + std::max(1, internalInsertMaxBatchSize));
+        if (state.request->isInsertIndexRequest()) {
+            return std::min(maxEnd, state.currIndex + 1);
+        }
+
+        size_t end = state.currIndex;
+        while (end < maxEnd && state.normalizedInserts[end].isOK()) {
+            ++end;
+        }
+        return std::max(end, std::min(maxEnd, state.currIndex + 1));
+    }
+
+    bool WriteBatchExecutor::execInsertGroup(ExecInsertsState* state, size_t groupEnd) {
+        invariant(!_txn->lockState()->inAWriteUnitOfWork());
+
+        std::vector<BSONObj> docs;
+        docs.reserve(groupEnd - state->currIndex);
+        for (size_t i = state->currIndex; i < groupEnd; ++i) {
+            docs.push_back(getInsertDoc(*state, i));
+        }
+
+        // The whole group is reported as a single operation, with one entry per document in the
+        // op counters and last error.
+        CurOp currentOp(_txn);
+        beginCurrentOp(_txn, BatchItemRef(state->request, state->currIndex));
+
+        bool inserted = false;
+        try {
+            WriteOpResult lockResult;
+            if (state->lockAndCheck(&lockResult)) {
+                WriteUnitOfWork wunit(_txn);
+                Status status = state->getCollection()->insertDocuments(_txn,
+                                                                        docs.begin(),
+                                                                        docs.end(),
+                                                                        true);
+                if (status.isOK()) {
+                    wunit.commit();
+                    inserted = true;
+                }
+            }
+        }
+        catch (const WriteConflictException&) {
+            CurOp::get(_txn)->debug().writeConflicts++;
+        }
+        catch (const StaleConfigException&) {
+        }
+        catch (const DBException& ex) {
+            if (ErrorCodes::isInterruption(ex.toStatus().code()))
+                throw;
+        }
+
+        if (!inserted) {
+            // Leave it to insertOne to retry and attribute the error to the right document.
+            _txn->recoveryUnit()->abandonSnapshot();
+            state->unlock();
+            return false;
+        }
+
+        WriteOpResult result;
+        result.getStats().n = 1;
+        for (size_t i = state->currIndex; i < groupEnd; ++i) {
+            BatchItemRef item(state->request, i);
+            incOpStats(item);
+            incWriteStats(item, result.getStats(), NULL, &currentOp);
+        }
+        finishCurrentOp(_txn, NULL);
+
+        return true;
+    }
+
     /**
      * Perform a single insert into a collection.  Requires the insert be preprocessed and the
      * collection already has been created.
@@ -1159,6 +1320,7 @@ namespace mongo {
         else {
             result->getStats().n = 1;
             wunit.commit();
+            recordWriteLoad( insertNS, docToInsert, false );
         }
     }
 
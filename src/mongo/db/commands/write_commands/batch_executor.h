@@ -101,6 +101,19 @@ namespace mongo {
          */
         void execOneInsert( ExecInsertsState* state, WriteErrorDetail** error );
 
+        /**
+         * Returns the end of the group of inserts starting at the current insert of "state"
+         * which execInsertGroup may attempt to write at once.
+         */
+        static size_t getInsertGroupEnd( const ExecInsertsState& state );
+
+        /**
+         * Inserts the documents from the current insert of "state" up to "groupEnd" in a single
+         * WriteUnitOfWork. Returns false, without having written or recorded anything, if any of
+         * the inserts fails; the caller should then fall back to execOneInsert.
+         */
+        bool execInsertGroup( ExecInsertsState* state, size_t groupEnd );
+
         /**
          * Executes an update item (which may update many documents or upsert), and returns the
          * upserted _id on upsert or error on failure.
@@ -63,12 +63,14 @@ namespace {
     Lock::GlobalLock::GlobalLock(Locker* locker)
           : _locker(locker),
             _result(LOCK_INVALID),
-            _pbwm(locker, resourceIdParallelBatchWriterMode) { }
+            _pbwm(locker, resourceIdParallelBatchWriterMode),
+          _batchSnapshot(locker, resourceIdBatchSnapshot) { }
 
     Lock::GlobalLock::GlobalLock(Locker* locker, LockMode lockMode, unsigned timeoutMs)
           : _locker(locker),
             _result(LOCK_INVALID),
-            _pbwm(locker, resourceIdParallelBatchWriterMode) {
+            _pbwm(locker, resourceIdParallelBatchWriterMode),
+          _batchSnapshot(locker, resourceIdBatchSnapshot) {
         _lock(lockMode, timeoutMs);
     }
 
@@ -76,7 +78,12 @@ namespace {
 
     void Lock::GlobalLock::_lock(LockMode lockMode, unsigned timeoutMs) {
         if (!_locker->isBatchWriter()) {
-            _pbwm.lock(MODE_IS);
+            if (lockMode == MODE_IS && _locker->isBatchSnapshotReader()) {
+                _batchSnapshot.lock(MODE_IS);
+            }
+            else {
+                _pbwm.lock(MODE_IS);
+            }
         }
 
         _result = _locker->lockGlobalBegin(lockMode);
@@ -86,6 +93,7 @@ namespace {
 
         if (_result != LOCK_OK && !_locker->isBatchWriter()) {
             _pbwm.unlock();
+            _batchSnapshot.unlock();
         }
     }
 
@@ -206,8 +214,14 @@ namespace {
         }
     }
 
-    Lock::ParallelBatchWriterMode::ParallelBatchWriterMode(Locker* lockState)
-          : _pbwm(lockState, resourceIdParallelBatchWriterMode, MODE_X) { }
+    Lock::ParallelBatchWriterMode::ParallelBatchWriterMode(Locker* lockState,
+                                                           bool blockSnapshotReaders)
+          : _pbwm(lockState, resourceIdParallelBatchWriterMode, MODE_X),
+            _batchSnapshot(lockState, resourceIdBatchSnapshot) {
+        if (blockSnapshotReaders) {
+            _batchSnapshot.lock(MODE_X);
+        }
+    }
 
     void Lock::ResourceLock::lock(LockMode mode) {
         invariant(_result == LOCK_INVALID);
@@ -130,6 +130,7 @@ namespace mongo {
             Locker* const _locker;
             LockResult _result;
             ResourceLock _pbwm;
+            ResourceLock _batchSnapshot;
         };
 
 
@@ -271,15 +272,19 @@ namespace mongo {
          * resource in exclusive mode. This mode is off by default.
          * Note that only one thread creates a ParallelBatchWriterMode object; the other batch
          * writers just call setIsBatchWriter().
+         *
+         * Readers marked with setIsBatchSnapshotReader() are only blocked if 'blockSnapshotReaders'
+         * is true, which must be the case whenever the batch changes the catalog.
          */
         class ParallelBatchWriterMode {
             MONGO_DISALLOW_COPYING(ParallelBatchWriterMode);
 
         public:
-            explicit ParallelBatchWriterMode(Locker* lockState);
+            explicit ParallelBatchWriterMode(Locker* lockState, bool blockSnapshotReaders = true);
 
         private:
             ResourceLock _pbwm;
+            ResourceLock _batchSnapshot;
         };
     };
 }
@@ -128,6 +128,50 @@ namespace mongo {
         ASSERT(!globalWriteTry.isLocked());
     }
 
+    TEST(DConcurrency, BatchSnapshotReaderSkipsParallelBatchWriterMode) {
+        DefaultLockerImpl applier;
+        Lock::ParallelBatchWriterMode pbwm(&applier, false);
+
+        DefaultLockerImpl reader;
+        reader.setIsBatchSnapshotReader(true);
+        Lock::GlobalLock globalRead(&reader, MODE_IS, 0);
+        ASSERT(globalRead.isLocked());
+        ASSERT_EQUALS(MODE_IS, reader.getLockMode(resourceIdBatchSnapshot));
+        ASSERT_EQUALS(MODE_NONE, reader.getLockMode(resourceIdParallelBatchWriterMode));
+    }
+
+    TEST(DConcurrency, BatchSnapshotReaderTakesParallelBatchWriterModeForWrites) {
+        DefaultLockerImpl ls;
+        ls.setIsBatchSnapshotReader(true);
+        Lock::GlobalLock globalWrite(&ls, MODE_IX, 0);
+        ASSERT(globalWrite.isLocked());
+        ASSERT_EQUALS(MODE_IS, ls.getLockMode(resourceIdParallelBatchWriterMode));
+        ASSERT_EQUALS(MODE_NONE, ls.getLockMode(resourceIdBatchSnapshot));
+    }
+
+    TEST(DConcurrency, ParallelBatchWriterModeBlocksSnapshotReaders) {
+        DefaultLockerImpl applier;
+        Lock::ParallelBatchWriterMode pbwm(&applier, true);
+
+        DefaultLockerImpl reader;
+        ASSERT_EQUALS(LOCK_TIMEOUT, reader.lock(resourceIdBatchSnapshot, MODE_IS, 0));
+    }
+
+    TEST(DConcurrency, BatchSnapshotReaderSaveAndRestore) {
+        DefaultLockerImpl ls;
+        ls.setIsBatchSnapshotReader(true);
+        Lock::DBLock dbRead(&ls, "db", MODE_IS);
+
+        Locker::LockSnapshot snapshot;
+        ASSERT(ls.saveLockStateAndUnlock(&snapshot));
+        ASSERT(!ls.isLocked());
+        ASSERT_EQUALS(MODE_NONE, ls.getLockMode(resourceIdBatchSnapshot));
+
+        ls.restoreLockState(snapshot);
+        ASSERT(ls.isDbLockedForMode("db", MODE_IS));
+        ASSERT_EQUALS(MODE_IS, ls.getLockMode(resourceIdBatchSnapshot));
+    }
+
     TEST(DConcurrency, TempReleaseGlobalWrite) {
         MMAPV1LockerImpl ls;
         Lock::GlobalWrite globalWrite(&ls);
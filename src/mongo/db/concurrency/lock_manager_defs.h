@@ -183,6 +183,7 @@ namespace mongo {
         enum SingletonHashIds {
             SINGLETON_INVALID = 0,
             SINGLETON_PARALLEL_BATCH_WRITER_MODE,
+            SINGLETON_BATCH_SNAPSHOT,
             SINGLETON_GLOBAL,
             SINGLETON_MMAPV1_FLUSH
         };
@@ -258,6 +259,13 @@ namespace mongo {
     // TODO: Merge this with resourceIdGlobal
     extern const ResourceId resourceIdParallelBatchWriterMode;
 
+    // Hardcoded resource id taken, instead of resourceIdParallelBatchWriterMode, by readers which
+    // read from the storage engine's snapshot of the last applied replication batch and so need
+    // not wait for the batch being applied. Batches which change the catalog lock it in exclusive
+    // mode, because snapshot readers would see the new catalog with the old data. Like the PBWM
+    // resource, it must be locked before resourceIdGlobal.
+    extern const ResourceId resourceIdBatchSnapshot;
+
     /**
      * Interface on which granted lock requests will be notified. See the contract for the notify
      * method for more information and also the LockManager::lock call.
@@ -256,7 +256,8 @@ namespace {
         : _id(idCounter.addAndFetch(1)),
           _requestStartTime(0),
           _wuowNestingLevel(0),
-          _batchWriter(false) {
+          _batchWriter(false),
+          _batchSnapshotReader(false) {
     }
 
     template<bool IsForMMAPV1>
@@ -577,8 +578,11 @@ namespace {
         invariant(!inAWriteUnitOfWork());
 
         std::vector<OneLock>::const_iterator it = state.locks.begin();
-        // If we locked the PBWM, it must be locked before the resourceIdGlobal resource.
-        if (it != state.locks.end() && it->resourceId == resourceIdParallelBatchWriterMode) {
+        // If we locked the PBWM or the batch snapshot resource, they must be locked before the
+        // resourceIdGlobal resource. Sorting puts them first.
+        while (it != state.locks.end() &&
+               (it->resourceId == resourceIdParallelBatchWriterMode ||
+                it->resourceId == resourceIdBatchSnapshot)) {
             invariant(LOCK_OK == lock(it->resourceId, it->mode));
             it++;
         }
@@ -919,5 +923,7 @@ namespace {
     const ResourceId resourceIdAdminDB = ResourceId(RESOURCE_DATABASE, StringData("admin"));
     const ResourceId resourceIdParallelBatchWriterMode =
         ResourceId(RESOURCE_GLOBAL, ResourceId::SINGLETON_PARALLEL_BATCH_WRITER_MODE);
+    const ResourceId resourceIdBatchSnapshot =
+        ResourceId(RESOURCE_GLOBAL, ResourceId::SINGLETON_BATCH_SNAPSHOT);
 
 } // namespace mongo
@@ -241,10 +241,14 @@ namespace mongo {
         virtual void setIsBatchWriter(bool newValue) { _batchWriter = newValue; }
         virtual bool isBatchWriter() const { return _batchWriter; }
 
+        virtual void setIsBatchSnapshotReader(bool newValue) { _batchSnapshotReader = newValue; }
+        virtual bool isBatchSnapshotReader() const { return _batchSnapshotReader; }
+
         virtual bool hasStrongLocks() const;
 
     private:
         bool _batchWriter;
+        bool _batchSnapshotReader;
     };
 
     typedef LockerImpl<false> DefaultLockerImpl;
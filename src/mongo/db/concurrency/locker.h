@@ -283,6 +283,14 @@ namespace mongo {
         virtual void setIsBatchWriter(bool newValue) = 0;
         virtual bool isBatchWriter() const = 0;
 
+        /**
+         * Marks this locker as reading from the storage engine's snapshot of the last applied
+         * replication batch. Global intent-shared locks then take resourceIdBatchSnapshot rather
+         * than the parallel batch writer lock, so they are not blocked by batch application.
+         */
+        virtual void setIsBatchSnapshotReader(bool newValue) = 0;
+        virtual bool isBatchSnapshotReader() const = 0;
+
         /**
          * A string lock is MODE_X or MODE_S.
          * These are incompatible with other locks and therefore are strong.
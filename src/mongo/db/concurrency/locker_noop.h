@@ -166,6 +166,14 @@ namespace mongo {
             invariant(false);
         }
 
+        virtual void setIsBatchSnapshotReader(bool newValue) {
+            invariant(false);
+        }
+
+        virtual bool isBatchSnapshotReader() const {
+            return false;
+        }
+
         virtual bool hasStrongLocks() const {
             return false;
         }
@@ -33,11 +33,25 @@
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/client.h"
 #include "mongo/db/curop.h"
+#include "mongo/db/repl/optime.h"
+#include "mongo/db/repl/replication_coordinator_global.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
 #include "mongo/db/stats/top.h"
+#include "mongo/db/storage/batch_snapshot_manager.h"
+#include "mongo/db/storage/storage_engine.h"
 #include "mongo/s/d_state.h"
 
 namespace mongo {
 
+namespace {
+
+    // Lets secondaries serve reads from the snapshot of the last applied replication batch rather
+    // than waiting for the batch being applied.
+    MONGO_EXPORT_SERVER_PARAMETER(readFromBatchSnapshotOnSecondaries, bool, true);
+
+} // namespace
+
     AutoGetDb::AutoGetDb(OperationContext* txn, StringData ns, LockMode mode)
             : _dbLock(txn->lockState(), ns, mode),
               _db(dbHolder().get(txn, ns)) {
@@ -65,9 +79,6 @@ namespace mongo {
     AutoGetCollectionForRead::AutoGetCollectionForRead(OperationContext* txn,
                                                        const std::string& ns)
             : _txn(txn),
-              _transaction(txn, MODE_IS),
-              _db(_txn, nsToDatabaseSubstring(ns), MODE_IS),
-              _collLock(_txn->lockState(), ns, MODE_IS),
               _coll(NULL) {
 
         _init(ns, nsToCollectionSubstring(ns));
@@ -76,17 +87,74 @@ namespace mongo {
     AutoGetCollectionForRead::AutoGetCollectionForRead(OperationContext* txn,
                                                        const NamespaceString& nss)
             : _txn(txn),
-              _transaction(txn, MODE_IS),
-              _db(_txn, nss.db(), MODE_IS),
-              _collLock(_txn->lockState(), nss.toString(), MODE_IS),
               _coll(NULL) {
 
         _init(nss.toString(), nss.coll());
     }
 
+    void AutoGetCollectionForRead::_lock(const std::string& ns, bool tryBatchSnapshot) {
+        _batchSnapshotTimestamp = tryBatchSnapshot ? _startBatchSnapshotRead(_txn) : Timestamp();
+        _transaction.reset(new ScopedTransaction(_txn, MODE_IS));
+        _db.reset(new AutoGetDb(_txn, nsToDatabaseSubstring(ns), MODE_IS));
+        _collLock.reset(new Lock::CollectionLock(_txn->lockState(), ns, MODE_IS));
+    }
+
+    Timestamp AutoGetCollectionForRead::_startBatchSnapshotRead(OperationContext* txn) {
+        if (!readFromBatchSnapshotOnSecondaries) {
+            return Timestamp();
+        }
+
+        // Only an operation which holds no locks yet can avoid the parallel batch writer lock.
+        Locker* locker = txn->lockState();
+        if (locker->isLocked() || locker->isBatchWriter() || locker->isBatchSnapshotReader()) {
+            return Timestamp();
+        }
+
+        const BatchSnapshotManager* snapshots =
+            getGlobalServiceContext()->getGlobalStorageEngine()->getBatchSnapshotManager();
+        if (!snapshots) {
+            return Timestamp();
+        }
+
+        // The snapshot is only current if nothing was written since the last batch was applied,
+        // which is not the case after writes as primary, a rollback or an initial sync.
+        repl::ReplicationCoordinator* replCoord = repl::getGlobalReplicationCoordinator();
+        if (!replCoord->getMemberState().secondary()) {
+            return Timestamp();
+        }
+
+        if (!txn->recoveryUnit()->canReadFromBatchSnapshot()) {
+            return Timestamp();
+        }
+
+        const Timestamp snapshotTimestamp = snapshots->getSnapshotTimestamp();
+        if (snapshotTimestamp.isNull() ||
+            snapshotTimestamp != replCoord->getMyLastOptime().getTimestamp()) {
+            return Timestamp();
+        }
+
+        locker->setIsBatchSnapshotReader(true);
+        return snapshotTimestamp;
+    }
+
     void AutoGetCollectionForRead::_init(const std::string& ns, StringData coll) {
         massert(28535, "need a non-empty collection name", !coll.empty());
 
+        _lock(ns, true);
+
+        // A background index build retires the snapshot under an exclusive database lock once it
+        // has committed, as the snapshot predates the index. If that happened since the snapshot
+        // was checked, start over with the parallel batch writer lock like any other reader.
+        if (!_batchSnapshotTimestamp.isNull() &&
+            getGlobalServiceContext()->getGlobalStorageEngine()->getBatchSnapshotManager()
+                ->getSnapshotTimestamp() != _batchSnapshotTimestamp) {
+            _collLock.reset();
+            _db.reset();
+            _transaction.reset();
+            _txn->lockState()->setIsBatchSnapshotReader(false);
+            _lock(ns, false);
+        }
+
         // We have both the DB and collection locked, which the prerequisite to do a stable shard
         // version check.
         ensureShardVersionOKOrThrow(_txn->getClient(), ns);
@@ -97,17 +165,21 @@ namespace mongo {
         curOp->ensureStarted();
         curOp->setNS_inlock(ns);
 
-        // At this point, we are locked in shared mode for the database by the DB lock in the
-        // constructor, so it is safe to load the DB pointer.
-        if (_db.getDb()) {
+        // At this point, we are locked in shared mode for the database by the DB lock taken in
+        // _lock(), so it is safe to load the DB pointer.
+        if (_db->getDb()) {
             // TODO: OldClientContext legacy, needs to be removed
-            curOp->enter_inlock(ns.c_str(), _db.getDb()->getProfilingLevel());
+            curOp->enter_inlock(ns.c_str(), _db->getDb()->getProfilingLevel());
 
-            _coll = _db.getDb()->getCollection(ns);
+            _coll = _db->getDb()->getCollection(ns);
         }
     }
 
     AutoGetCollectionForRead::~AutoGetCollectionForRead() {
+        if (!_batchSnapshotTimestamp.isNull()) {
+            _txn->lockState()->setIsBatchSnapshotReader(false);
+        }
+
         // Report time spent in read lock
         auto currentOp = CurOp::get(_txn);
         Top::get(_txn->getClient()->getServiceContext()).record(
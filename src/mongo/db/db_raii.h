@@ -28,9 +28,11 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 
 #include "mongo/base/string_data.h"
+#include "mongo/bson/timestamp.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/namespace_string.h"
@@ -100,6 +102,9 @@ namespace mongo {
      *
      * It is guaranteed that locks will be released when this object goes out of scope, therefore
      * database and collection references returned by this class should not be retained.
+     *
+     * On a secondary, reads may come from the storage engine's snapshot of the last applied
+     * replication batch, in which case the locks do not wait for the batch being applied.
      */
     class AutoGetCollectionForRead {
         MONGO_DISALLOW_COPYING(AutoGetCollectionForRead);
@@ -109,7 +114,7 @@ namespace mongo {
         ~AutoGetCollectionForRead();
 
         Database* getDb() const {
-            return _db.getDb();
+            return _db->getDb();
         }
 
         Collection* getCollection() const {
@@ -120,11 +125,29 @@ namespace mongo {
         void _init(const std::string& ns,
                    StringData coll);
 
+        /**
+         * Takes the locks for reading 'ns', from the batch snapshot if 'tryBatchSnapshot' is true
+         * and the snapshot can be used.
+         */
+        void _lock(const std::string& ns, bool tryBatchSnapshot);
+
+        /**
+         * Marks the operation's Locker as a batch snapshot reader if it can read from the batch
+         * snapshot. Returns the timestamp of the snapshot if it did, and a null Timestamp if not.
+         */
+        static Timestamp _startBatchSnapshotRead(OperationContext* txn);
+
         const Timer _timer;
         OperationContext* const _txn;
-        const ScopedTransaction _transaction;
-        const AutoGetDb _db;
-        const Lock::CollectionLock _collLock;
+
+        // The timestamp of the batch snapshot this reads from, or null if it does not. Must be
+        // set before any of the locks below are taken.
+        Timestamp _batchSnapshotTimestamp;
+
+        // Taken again if the batch snapshot turns out to be unusable once they are held.
+        std::unique_ptr<ScopedTransaction> _transaction;
+        std::unique_ptr<AutoGetDb> _db;
+        std::unique_ptr<Lock::CollectionLock> _collLock;
 
         Collection* _coll;
     };
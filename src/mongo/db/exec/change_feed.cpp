@@ -0,0 +1,279 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/change_feed.h"
+
+#include "mongo/db/exec/scoped_timer.h"
+#include "mongo/db/exec/working_set_common.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+    using std::unique_ptr;
+    using std::vector;
+
+    // static
+    const char* ChangeFeedStage::kStageType = "CHANGE_FEED";
+
+namespace {
+
+    /**
+     * Is 'o' the document of an update made of modifiers rather than a replacement?
+     */
+    bool isModifierUpdate(StringData op, const BSONObj& o) {
+        return op == "u" && !o.isEmpty() && o.firstElementFieldName()[0] == '$';
+    }
+
+}  // namespace
+
+    ChangeFeedStage::ChangeFeedStage(vector<unique_ptr<ChangeFeedSubscription>> subscriptions,
+                                     const Timestamp& resumeAfter,
+                                     int resumeAfterSubscription,
+                                     WorkingSet* ws,
+                                     PlanStage* child)
+        : _subscriptions(std::move(subscriptions)),
+          _resumeAfter(resumeAfter),
+          _resumeAfterSubscription(resumeAfterSubscription),
+          _ws(ws),
+          _child(child),
+          _commonStats(kStageType) { }
+
+    ChangeFeedStage::~ChangeFeedStage() { }
+
+    bool ChangeFeedStage::isEOF() {
+        return _pending.empty() && _child->isEOF();
+    }
+
+    PlanStage::StageState ChangeFeedStage::work(WorkingSetID* out) {
+        ++_commonStats.works;
+
+        // Adds the amount of time taken by work() to executionTimeMillis.
+        ScopedTimer timer(&_commonStats.executionTimeMillis);
+
+        if (_pending.empty()) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            StageState status = _child->work(&id);
+
+            // Like the other stages over a tailable scan, we pass EOF through rather than
+            // checking isEOF() first, as the child may have more entries later on.
+            if (PlanStage::ADVANCED != status) {
+                if (PlanStage::FAILURE == status || PlanStage::DEAD == status) {
+                    *out = id;
+                    if (WorkingSet::INVALID_ID == id) {
+                        Status error(ErrorCodes::InternalError,
+                                     "change feed stage failed to read in results from child");
+                        *out = WorkingSetCommon::allocateStatusMember(_ws, error);
+                    }
+                }
+                else if (PlanStage::NEED_TIME == status) {
+                    ++_commonStats.needTime;
+                }
+                else if (PlanStage::NEED_YIELD == status) {
+                    ++_commonStats.needYield;
+                    *out = id;
+                }
+                return status;
+            }
+
+            WorkingSetMember* member = _ws->get(id);
+            invariant(member->hasObj());
+            const BSONObj entry = member->obj.value().getOwned();
+            _ws->free(id);
+
+            ++_specificStats.entriesExamined;
+
+            // Skip the events of the entry we resume in the middle of which were already seen.
+            size_t position = 0;
+            if (!_resumeAfter.isNull() && entry["ts"].timestamp() == _resumeAfter) {
+                position = _resumeAfterSubscription + 1;
+            }
+
+            for (; position < _subscriptions.size(); ++position) {
+                StatusWith<BSONObj> event = _makeEvent(*_subscriptions[position], position, entry);
+                if (!event.isOK()) {
+                    *out = WorkingSetCommon::allocateStatusMember(_ws, event.getStatus());
+                    return PlanStage::FAILURE;
+                }
+                if (event.getValue().isEmpty()) {
+                    continue;
+                }
+
+                WorkingSetID eventId = _ws->allocate();
+                WorkingSetMember* eventMember = _ws->get(eventId);
+                eventMember->obj = Snapshotted<BSONObj>(SnapshotId(), event.getValue());
+                eventMember->state = WorkingSetMember::OWNED_OBJ;
+                _pending.push_back(eventId);
+                ++_specificStats.eventsReturned;
+            }
+
+            if (_pending.empty()) {
+                ++_commonStats.needTime;
+                return PlanStage::NEED_TIME;
+            }
+        }
+
+        *out = _pending.front();
+        _pending.pop_front();
+        ++_commonStats.advanced;
+        return PlanStage::ADVANCED;
+    }
+
+    StatusWith<BSONObj> ChangeFeedStage::_makeEvent(const ChangeFeedSubscription& subscription,
+                                                    int position,
+                                                    const BSONObj& entry) const {
+        if (!subscription.entryFilter->matchesBSON(entry)) {
+            return BSONObj();
+        }
+
+        const BSONElement op = entry["op"];
+        const BSONElement o = entry["o"];
+        const bool hasDocument = (o.type() == Object) &&
+            (op.valueStringData() == "i" || op.valueStringData() == "u" ||
+             op.valueStringData() == "d");
+
+        BSONObj doc = hasDocument ? o.Obj() : BSONObj();
+        if (hasDocument && isModifierUpdate(op.valueStringData(), doc)) {
+            // Filter and project the argument of each modifier, e.g. {a: 1} in {$set: {a: 1}}.
+            bool matched = !subscription.filter;
+            BSONObjBuilder projected;
+            BSONObjIterator it(doc);
+            while (it.more()) {
+                const BSONElement modifier = it.next();
+                if (modifier.type() != Object) {
+                    projected.append(modifier);
+                    continue;
+                }
+
+                if (!matched && subscription.filter->matchesBSON(modifier.Obj())) {
+                    matched = true;
+                }
+
+                if (subscription.projection) {
+                    BSONObj arg;
+                    Status status = subscription.projection->transform(modifier.Obj(), &arg);
+                    if (!status.isOK()) {
+                        return status;
+                    }
+                    // Leave out the modifiers which only touched fields projected away.
+                    if (!arg.isEmpty()) {
+                        projected.append(modifier.fieldName(), arg);
+                    }
+                }
+                else {
+                    projected.append(modifier);
+                }
+            }
+
+            if (!matched) {
+                return BSONObj();
+            }
+            doc = projected.obj();
+        }
+        else if (hasDocument) {
+            if (subscription.filter && !subscription.filter->matchesBSON(doc)) {
+                return BSONObj();
+            }
+            if (subscription.projection) {
+                Status status = subscription.projection->transform(o.Obj(), &doc);
+                if (!status.isOK()) {
+                    return status;
+                }
+            }
+        }
+
+        BSONObjBuilder bob;
+        {
+            BSONObjBuilder idBob(bob.subobjStart("_id"));
+            idBob.append(entry["ts"]);
+            const BSONElement term = entry["t"];
+            if (!term.eoo()) {
+                idBob.append(term);
+            }
+            idBob.append("s", position);
+        }
+        if (!subscription.name.empty()) {
+            bob.append("subscription", subscription.name);
+        }
+        bob.append(op);
+        bob.append(entry["ns"]);
+        if (hasDocument) {
+            bob.append("o", doc);
+        }
+        else if (!o.eoo()) {
+            bob.append(o);
+        }
+        const BSONElement o2 = entry["o2"];
+        if (!o2.eoo()) {
+            bob.append(o2);
+        }
+        return bob.obj();
+    }
+
+    void ChangeFeedStage::saveState() {
+        ++_commonStats.yields;
+        _child->saveState();
+    }
+
+    void ChangeFeedStage::restoreState(OperationContext* opCtx) {
+        ++_commonStats.unyields;
+        _child->restoreState(opCtx);
+    }
+
+    void ChangeFeedStage::invalidate(OperationContext* txn,
+                                     const RecordId& dl,
+                                     InvalidationType type) {
+        ++_commonStats.invalidates;
+        // The pending events are owned objects with no RecordId, so only the child cares.
+        _child->invalidate(txn, dl, type);
+    }
+
+    vector<PlanStage*> ChangeFeedStage::getChildren() const {
+        vector<PlanStage*> children;
+        children.push_back(_child.get());
+        return children;
+    }
+
+    PlanStageStats* ChangeFeedStage::getStats() {
+        _commonStats.isEOF = isEOF();
+        unique_ptr<PlanStageStats> ret(new PlanStageStats(_commonStats, STAGE_CHANGE_FEED));
+        ret->specific.reset(new ChangeFeedStats(_specificStats));
+        ret->children.push_back(_child->getStats());
+        return ret.release();
+    }
+
+    const CommonStats* ChangeFeedStage::getCommonStats() const {
+        return &_commonStats;
+    }
+
+    const SpecificStats* ChangeFeedStage::getSpecificStats() const {
+        return &_specificStats;
+    }
+
+}  // namespace mongo
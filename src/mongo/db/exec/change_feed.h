@@ -0,0 +1,143 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/timestamp.h"
+#include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/exec/projection_exec.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/record_id.h"
+
+namespace mongo {
+
+    class WorkingSet;
+
+    /**
+     * A subscription to a change feed, in the compiled form used by ChangeFeedStage.
+     */
+    struct ChangeFeedSubscription {
+        // Empty for the unnamed subscription, which is not reported in the results.
+        std::string name;
+
+        // Over the whole oplog entry, selecting the namespaces and operation types.
+        std::unique_ptr<MatchExpression> entryFilter;
+
+        // Over the document of an insert, update or delete. May be NULL.
+        std::unique_ptr<MatchExpression> filter;
+
+        // Applied to the document of an insert, update or delete. May be NULL.
+        std::unique_ptr<ProjectionExec> projection;
+    };
+
+    /**
+     * Turns the oplog entries returned by its child, a tailable scan of the oplog, into change
+     * feed events for each of its subscriptions, so that one scan of the oplog serves all of
+     * them. Returns one event per entry and subscription selecting it:
+     *
+     *     {_id: {ts: <Timestamp>, t: <long>, s: <int>}, subscription: <name>, op: <string>,
+     *      ns: <string>, o: <document>, o2: <document>}
+     *
+     * where _id is the resume token of the event, made of the timestamp and term of the entry
+     * and the position 's' of the subscription among those of the feed. 't' is only present for
+     * entries which have a term, 'subscription' only for named subscriptions and 'o2' only for
+     * updates.
+     *
+     * The filter and projection of a subscription apply to the document in 'o'. For updates made
+     * of modifiers, they apply to the argument of each modifier instead: {$set: {a: 1, b: 1}}
+     * passes the filter {a: 1}, and the projection {a: 1} turns it into {$set: {a: 1}}.
+     */
+    class ChangeFeedStage : public PlanStage {
+    public:
+        /**
+         * If 'resumeAfter' is not null, the events of the entry at that timestamp are only
+         * returned to the subscriptions after position 'resumeAfterSubscription'.
+         */
+        ChangeFeedStage(std::vector<std::unique_ptr<ChangeFeedSubscription>> subscriptions,
+                        const Timestamp& resumeAfter,
+                        int resumeAfterSubscription,
+                        WorkingSet* ws,
+                        PlanStage* child);
+
+        virtual ~ChangeFeedStage();
+
+        virtual bool isEOF();
+        virtual StageState work(WorkingSetID* out);
+
+        virtual void saveState();
+        virtual void restoreState(OperationContext* opCtx);
+        virtual void invalidate(OperationContext* txn, const RecordId& dl, InvalidationType type);
+
+        virtual std::vector<PlanStage*> getChildren() const;
+
+        virtual StageType stageType() const { return STAGE_CHANGE_FEED; }
+
+        virtual PlanStageStats* getStats();
+
+        virtual const CommonStats* getCommonStats() const;
+
+        virtual const SpecificStats* getSpecificStats() const;
+
+        static const char* kStageType;
+
+    private:
+        /**
+         * Returns the event 'subscription' is sent for 'entry', or an empty object if the
+         * subscription does not select it.
+         */
+        StatusWith<BSONObj> _makeEvent(const ChangeFeedSubscription& subscription,
+                                       int position,
+                                       const BSONObj& entry) const;
+
+        const std::vector<std::unique_ptr<ChangeFeedSubscription>> _subscriptions;
+
+        // The entry the feed resumes in the middle of, and the last subscription whose event of
+        // it was already seen.
+        const Timestamp _resumeAfter;
+        const int _resumeAfterSubscription;
+
+        // Not owned here.
+        WorkingSet* _ws;
+
+        std::unique_ptr<PlanStage> _child;
+
+        // Events made from the last entry which have not been returned yet.
+        std::deque<WorkingSetID> _pending;
+
+        // Stats
+        CommonStats _commonStats;
+        ChangeFeedStats _specificStats;
+    };
+
+}  // namespace mongo
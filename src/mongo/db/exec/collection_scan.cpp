@@ -59,6 +59,7 @@ namespace mongo {
         : _txn(txn),
           _workingSet(workingSet),
           _filter(filter),
+          _compiledFilter(Filter::compile(filter)),
           _params(params),
           _isDead(false),
           _wsidForFetch(_workingSet->allocate()),
@@ -175,7 +176,7 @@ namespace mongo {
                                                           WorkingSetID* out) {
         ++_specificStats.docsTested;
 
-        if (Filter::passes(member, _filter)) {
+        if (Filter::passes(member, _filter, _compiledFilter.get())) {
             *out = memberID;
             ++_commonStats.advanced;
             return PlanStage::ADVANCED;
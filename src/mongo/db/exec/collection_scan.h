@@ -32,6 +32,7 @@
 
 #include "mongo/db/exec/collection_scan_common.h"
 #include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/record_id.h"
 
@@ -91,6 +92,9 @@ namespace mongo {
         // The filter is not owned by us.
         const MatchExpression* _filter;
 
+        // The compiled form of _filter, or NULL.
+        const std::unique_ptr<CompiledMatchExpression> _compiledFilter;
+
         std::unique_ptr<RecordCursor> _cursor;
 
         CollectionScanParams _params;
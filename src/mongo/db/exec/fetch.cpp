@@ -57,6 +57,7 @@ namespace mongo {
           _ws(ws),
           _child(child),
           _filter(filter),
+          _compiledFilter(Filter::compile(filter)),
           _idRetrying(WorkingSet::INVALID_ID),
           _commonStats(kStageType) { }
 
@@ -209,7 +210,7 @@ namespace mongo {
         // predicate.
         ++_specificStats.docsExamined;
 
-        if (Filter::passes(member, _filter)) {
+        if (Filter::passes(member, _filter, _compiledFilter.get())) {
             *out = memberID;
 
             ++_commonStats.advanced;
@@ -32,6 +32,7 @@
 
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/record_id.h"
 
@@ -100,6 +101,9 @@ namespace mongo {
         // The filter is not owned by us.
         const MatchExpression* _filter;
 
+        // The compiled form of _filter, or NULL.
+        const std::unique_ptr<CompiledMatchExpression> _compiledFilter;
+
         // If not Null, we use this rather than asking our child what to do next.
         WorkingSetID _idRetrying;
 
@@ -29,8 +29,10 @@
 #pragma once
 
 #include "mongo/db/exec/working_set.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/matcher/matchable.h"
+#include "mongo/db/query/query_knobs.h"
 
 namespace mongo {
 
@@ -158,6 +160,28 @@ namespace mongo {
             return filter->matches(&doc, NULL);
         }
 
+        /**
+         * As above, but evaluates 'compiled', if it is not NULL, when 'wsm' has a document.
+         * 'compiled' must have been compiled from 'filter'.
+         */
+        static bool passes(WorkingSetMember* wsm,
+                           const MatchExpression* filter,
+                           const CompiledMatchExpression* compiled) {
+            if (NULL != compiled && wsm->hasObj()) {
+                return compiled->matchesBSON(wsm->obj.value());
+            }
+            return passes(wsm, filter);
+        }
+
+        /**
+         * Returns the compiled form of 'filter', to be owned by the caller, or NULL if 'filter'
+         * is NULL or compilation is disabled.
+         */
+        static CompiledMatchExpression* compile(const MatchExpression* filter) {
+            if (NULL == filter || !internalQueryCompileMatchExpressions) { return NULL; }
+            return new CompiledMatchExpression(filter);
+        }
+
         static bool passes(const BSONObj& keyData,
                            const BSONObj& keyPattern,
                            const MatchExpression* filter) {
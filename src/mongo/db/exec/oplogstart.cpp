@@ -124,8 +124,9 @@ namespace mongo {
     }
 
     void OplogStart::switchToExtentHopping() {
-        // Set up our extent hopping state.
-        _subIterators = _collection->getManyCursors(_txn);
+        // Set up our extent hopping state. mmapv1 returns one cursor per extent regardless of
+        // how many are asked for.
+        _subIterators = _collection->getManyCursors(_txn, 1);
 
         // Transition from backwards scanning to extent hopping.
         _backwardsScanning = false;
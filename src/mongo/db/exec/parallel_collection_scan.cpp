@@ -0,0 +1,438 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/parallel_collection_scan.h"
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/client.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/exec/filter.h"
+#include "mongo/db/exec/scoped_timer.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/operation_context_impl.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+    using std::vector;
+
+namespace {
+
+    // Workers stop reading once this many bytes of matching documents are waiting to be returned.
+    const size_t kMaxBufferedBytes = 16 * 1024 * 1024;
+
+    // Number of records a worker reads between checks of the stage's state.
+    const size_t kRecordsPerRound = 128;
+
+    // How long work() waits for a result before returning NEED_TIME, so that the executor still
+    // gets to yield and check for interrupts while the workers are busy.
+    const Milliseconds kWorkWaitTime(10);
+
+}  // namespace
+
+    class ParallelCollectionScan::Worker {
+        MONGO_DISALLOW_COPYING(Worker);
+    public:
+        Worker(size_t index, const RecordId& rangeStart, const RecordId& rangeEnd)
+            : index(index),
+              rangeStart(rangeStart),
+              rangeEnd(rangeEnd) { }
+
+        const size_t index;
+        const RecordId rangeStart;
+        const RecordId rangeEnd;
+
+        // Only used by the worker thread, except while it is parked.
+        std::unique_ptr<RecordCursor> cursor;
+
+        // The last state this worker acknowledged. Protected by the stage's mutex.
+        State acknowledgedState = State::kRunning;
+
+        // Set once the thread no longer touches the collection. Protected by the stage's mutex.
+        bool done = false;
+
+        AtomicUInt64 works;
+        AtomicUInt64 advanced;
+
+        stdx::thread thread;
+    };
+
+    // static
+    const char* ParallelCollectionScan::kStageType = "PARALLEL_COLLSCAN";
+
+    ParallelCollectionScan::ParallelCollectionScan(OperationContext* txn,
+                                                   const CollectionScanParams& params,
+                                                   const std::vector<RecordId>& splitPoints,
+                                                   WorkingSet* workingSet,
+                                                   const MatchExpression* filter)
+        : _txn(txn),
+          _workingSet(workingSet),
+          _filter(filter),
+          _compiledFilter(Filter::compile(filter)),
+          _params(params),
+          _splitPoints(splitPoints),
+          _commonStats(kStageType) {
+        invariant(!_splitPoints.empty());
+        invariant(_params.direction == CollectionScanParams::FORWARD);
+        invariant(!_params.tailable);
+        invariant(_params.start.isNull());
+        invariant(0 == _params.maxScan);
+    }
+
+    ParallelCollectionScan::~ParallelCollectionScan() {
+        {
+            stdx::unique_lock<stdx::mutex> lk(_mutex);
+            _state = State::kShutdown;
+            _workersCond.notify_all();
+        }
+
+        for (auto&& worker : _workers) {
+            worker->thread.join();
+        }
+    }
+
+    PlanStage::StageState ParallelCollectionScan::work(WorkingSetID* out) {
+        ++_commonStats.works;
+
+        // Adds the amount of time taken by work() to executionTimeMillis.
+        ScopedTimer timer(&_commonStats.executionTimeMillis);
+
+        if (_commonStats.isEOF) { return PlanStage::IS_EOF; }
+
+        if (!_started) {
+            _started = true;
+
+            RecordId rangeStart;
+            for (size_t i = 0; i <= _splitPoints.size(); ++i) {
+                const RecordId rangeEnd = i < _splitPoints.size() ? _splitPoints[i] : RecordId();
+                _workers.emplace_back(new Worker(i, rangeStart, rangeEnd));
+                rangeStart = rangeEnd;
+            }
+
+            for (auto&& worker : _workers) {
+                worker->thread = stdx::thread(&ParallelCollectionScan::_runWorker,
+                                              this,
+                                              worker.get());
+            }
+
+            ++_commonStats.needTime;
+            return PlanStage::NEED_TIME;
+        }
+
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        if (_results.empty() && _workerStatus.isOK() && _workersDone < _workers.size()) {
+            _resultsCond.wait_for(lk, kWorkWaitTime);
+        }
+
+        if (!_workerStatus.isOK()) {
+            *out = WorkingSetCommon::allocateStatusMember(_workingSet, _workerStatus);
+            return PlanStage::DEAD;
+        }
+
+        if (!_results.empty()) {
+            Result result = _results.front();
+            _results.pop_front();
+            _resultsBytes -= result.obj.objsize();
+            _workersCond.notify_all();
+            lk.unlock();
+
+            // The document was not read from our snapshot, so it can only be returned as owned.
+            WorkingSetID id = _workingSet->allocate();
+            WorkingSetMember* member = _workingSet->get(id);
+            member->obj = Snapshotted<BSONObj>(SnapshotId(), result.obj);
+            if (result.loc.isNull()) {
+                // Deleted since the worker read it, see invalidate().
+                member->state = WorkingSetMember::OWNED_OBJ;
+            }
+            else {
+                member->loc = result.loc;
+                member->state = WorkingSetMember::LOC_AND_OWNED_OBJ;
+            }
+
+            *out = id;
+            ++_commonStats.advanced;
+            return PlanStage::ADVANCED;
+        }
+
+        if (_workersDone == _workers.size()) {
+            _commonStats.isEOF = true;
+            return PlanStage::IS_EOF;
+        }
+
+        ++_commonStats.needTime;
+        return PlanStage::NEED_TIME;
+    }
+
+    void ParallelCollectionScan::_runWorker(Worker* worker) {
+        Client::initThread(std::string(str::stream() << "parallelCollScan"
+                                                     << worker->index).c_str());
+        OperationContextImpl txn;
+        const RecordStore* recordStore = _params.collection->getRecordStore();
+
+        Status status = Status::OK();
+        bool eof = false;
+        try {
+            while (!eof) {
+                {
+                    stdx::unique_lock<stdx::mutex> lk(_mutex);
+                    while (_state != State::kShutdown) {
+                        if (_state == State::kPaused) {
+                            if (worker->acknowledgedState != State::kPaused) {
+                                if (worker->cursor) {
+                                    worker->cursor->savePositioned();
+                                }
+                                txn.recoveryUnit()->abandonSnapshot();
+                                worker->acknowledgedState = State::kPaused;
+                                _resultsCond.notify_all();
+                            }
+                        }
+                        else if (_resultsBytes < kMaxBufferedBytes) {
+                            break;
+                        }
+                        _workersCond.wait(lk);
+                    }
+
+                    if (_state == State::kShutdown) {
+                        break;
+                    }
+
+                    if (worker->acknowledgedState == State::kPaused) {
+                        worker->acknowledgedState = State::kRunning;
+                        if (worker->cursor && !worker->cursor->restore(&txn)) {
+                            uasserted(ErrorCodes::InternalError,
+                                      "collection dropped or state deleted during yield of "
+                                      "ParallelCollectionScan");
+                        }
+                    }
+                }
+
+                if (!worker->cursor) {
+                    worker->cursor = recordStore->getCursorForRange(&txn,
+                                                                    worker->rangeStart,
+                                                                    worker->rangeEnd);
+                }
+
+                vector<Result> matches;
+                size_t matchesBytes = 0;
+                for (size_t i = 0; i < kRecordsPerRound; ++i) {
+                    boost::optional<Record> record;
+                    try {
+                        record = worker->cursor->next();
+                    }
+                    catch (const WriteConflictException&) {
+                        // The position is unchanged, so start over on a new snapshot.
+                        worker->cursor->savePositioned();
+                        txn.recoveryUnit()->abandonSnapshot();
+                        if (!worker->cursor->restore(&txn)) {
+                            uasserted(ErrorCodes::InternalError,
+                                      "state deleted while retrying ParallelCollectionScan");
+                        }
+                        continue;
+                    }
+
+                    if (!record) {
+                        eof = true;
+                        break;
+                    }
+
+                    worker->works.fetchAndAdd(1);
+                    BSONObj obj = record->data.releaseToBson();
+                    if (_compiledFilter) {
+                        if (!_compiledFilter->matchesBSON(obj)) {
+                            continue;
+                        }
+                    }
+                    else if (_filter && !_filter->matchesBSON(obj)) {
+                        continue;
+                    }
+
+                    worker->advanced.fetchAndAdd(1);
+                    matches.push_back({record->id, obj.getOwned()});
+                    matchesBytes += obj.objsize();
+                }
+
+                stdx::unique_lock<stdx::mutex> lk(_mutex);
+                _results.insert(_results.end(), matches.begin(), matches.end());
+                _resultsBytes += matchesBytes;
+                _resultsCond.notify_all();
+            }
+        }
+        catch (const DBException& e) {
+            status = e.toStatus();
+        }
+        catch (const std::exception& e) {
+            status = Status(ErrorCodes::InternalError, e.what());
+        }
+
+        if (!status.isOK()) {
+            warning() << "ParallelCollectionScan worker " << worker->index << " failed: "
+                      << status;
+        }
+
+        // The cursor must go away before our OperationContext does, and under the mutex since
+        // invalidate() may be looking at it.
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        worker->cursor.reset();
+        worker->done = true;
+        if (!status.isOK() && _workerStatus.isOK()) {
+            _workerStatus = status;
+        }
+        ++_workersDone;
+        _resultsCond.notify_all();
+    }
+
+    void ParallelCollectionScan::_setState_inlock(stdx::unique_lock<stdx::mutex>& lk,
+                                                  State state) {
+        _state = state;
+        _workersCond.notify_all();
+
+        if (state != State::kPaused) {
+            return;
+        }
+
+        // Workers which already finished have nothing left to park.
+        while (true) {
+            bool allParked = true;
+            for (auto&& worker : _workers) {
+                if (!worker->done && worker->acknowledgedState != State::kPaused) {
+                    allParked = false;
+                }
+            }
+            if (allParked) {
+                return;
+            }
+            _resultsCond.wait(lk);
+        }
+    }
+
+    bool ParallelCollectionScan::isEOF() {
+        return _commonStats.isEOF;
+    }
+
+    void ParallelCollectionScan::invalidate(OperationContext* txn,
+                                            const RecordId& id,
+                                            InvalidationType type) {
+        ++_commonStats.invalidates;
+
+        // We don't care about mutations since the workers apply the filter to the version of the
+        // document they read, and the results are owned.
+        if (INVALIDATION_DELETION != type) {
+            return;
+        }
+
+        // The workers' cursors can only be used from this thread while the workers are parked.
+        // Invalidations normally arrive while the stage is saved, and so already parked, but the
+        // workers are parked here if they are running.
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        const bool wasRunning = State::kRunning == _state;
+        if (wasRunning) {
+            _setState_inlock(lk, State::kPaused);
+        }
+
+        for (auto&& worker : _workers) {
+            if (worker->cursor) {
+                worker->cursor->invalidate(id);
+            }
+        }
+
+        for (auto&& result : _results) {
+            if (result.loc == id) {
+                result.loc = RecordId();
+            }
+        }
+
+        if (wasRunning) {
+            _setState_inlock(lk, State::kRunning);
+        }
+    }
+
+    void ParallelCollectionScan::saveState() {
+        _txn = NULL;
+        ++_commonStats.yields;
+
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _setState_inlock(lk, State::kPaused);
+    }
+
+    void ParallelCollectionScan::restoreState(OperationContext* opCtx) {
+        invariant(_txn == NULL);
+        _txn = opCtx;
+        ++_commonStats.unyields;
+
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _setState_inlock(lk, State::kRunning);
+    }
+
+    vector<PlanStage*> ParallelCollectionScan::getChildren() const {
+        vector<PlanStage*> empty;
+        return empty;
+    }
+
+    PlanStageStats* ParallelCollectionScan::getStats() {
+        // Add a BSON representation of the filter to the stats tree, if there is one.
+        if (NULL != _filter) {
+            BSONObjBuilder bob;
+            _filter->toBSON(&bob);
+            _commonStats.filter = bob.obj();
+        }
+
+        _specificStats.docsTested = 0;
+        _specificStats.workers.clear();
+        for (auto&& worker : _workers) {
+            ParallelCollectionScanStats::WorkerStats workerStats;
+            workerStats.works = worker->works.load();
+            workerStats.advanced = worker->advanced.load();
+            _specificStats.docsTested += workerStats.works;
+            _specificStats.workers.push_back(workerStats);
+        }
+
+        std::unique_ptr<PlanStageStats> ret(new PlanStageStats(_commonStats,
+                                                               STAGE_PARALLEL_COLLSCAN));
+        ret->specific.reset(new ParallelCollectionScanStats(_specificStats));
+        return ret.release();
+    }
+
+    const CommonStats* ParallelCollectionScan::getCommonStats() const {
+        return &_commonStats;
+    }
+
+    const SpecificStats* ParallelCollectionScan::getSpecificStats() const {
+        return &_specificStats;
+    }
+
+}  // namespace mongo
@@ -0,0 +1,167 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "mongo/base/status.h"
+#include "mongo/db/exec/collection_scan_common.h"
+#include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/record_id.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+    class OperationContext;
+    class WorkingSet;
+
+    /**
+     * Scans a collection with one worker thread per range of RecordIds, as given by the split
+     * points of its RecordStore, and returns the documents which pass the filter in whatever
+     * order the workers find them.
+     *
+     * Each worker reads through its own OperationContext, and so from its own snapshot, and
+     * applies the filter itself; only matching documents are handed back, as owned objects, to
+     * the thread calling work(). The workers take no locks of their own. They only run between
+     * restoreState() and saveState(), while the caller holds the collection lock, and are parked
+     * with their cursors saved whenever this stage is.
+     *
+     * Because documents are not read from the caller's snapshot, this stage must only be used for
+     * read-only queries. The filter must be safe to evaluate concurrently, which rules out $where.
+     */
+    class ParallelCollectionScan : public PlanStage {
+    public:
+        /**
+         * 'splitPoints' must be the non-empty result of calling getSplitPoints() on the
+         * collection's RecordStore. One worker is started for each of the resulting ranges.
+         */
+        ParallelCollectionScan(OperationContext* txn,
+                               const CollectionScanParams& params,
+                               const std::vector<RecordId>& splitPoints,
+                               WorkingSet* workingSet,
+                               const MatchExpression* filter);
+
+        virtual ~ParallelCollectionScan();
+
+        virtual StageState work(WorkingSetID* out);
+        virtual bool isEOF();
+
+        virtual void invalidate(OperationContext* txn, const RecordId& dl, InvalidationType type);
+        virtual void saveState();
+        virtual void restoreState(OperationContext* opCtx);
+
+        virtual std::vector<PlanStage*> getChildren() const;
+
+        virtual StageType stageType() const { return STAGE_PARALLEL_COLLSCAN; }
+
+        virtual PlanStageStats* getStats();
+
+        virtual const CommonStats* getCommonStats() const;
+
+        virtual const SpecificStats* getSpecificStats() const;
+
+        static const char* kStageType;
+
+    private:
+        class Worker;
+
+        // A document which passed the filter, waiting to be returned by work().
+        struct Result {
+            RecordId loc;
+            BSONObj obj;
+        };
+
+        enum class State {
+            kRunning,
+            kPaused,
+            kShutdown,
+        };
+
+        /**
+         * Body of each worker thread.
+         */
+        void _runWorker(Worker* worker);
+
+        /**
+         * Moves the workers to 'state' and waits until they have all acknowledged it.
+         */
+        void _setState_inlock(stdx::unique_lock<stdx::mutex>& lk, State state);
+
+        // transactional context for read locks. Not owned by us
+        OperationContext* _txn;
+
+        // WorkingSet is not owned by us.
+        WorkingSet* _workingSet;
+
+        // The filter is not owned by us.
+        const MatchExpression* _filter;
+
+        // The compiled form of _filter, or NULL. Shared by all the workers.
+        const std::unique_ptr<CompiledMatchExpression> _compiledFilter;
+
+        const CollectionScanParams _params;
+
+        const std::vector<RecordId> _splitPoints;
+
+        bool _started = false;
+
+        // Protects everything below, as well as the workers' cursors and positions.
+        stdx::mutex _mutex;
+
+        // Signalled when a result is queued, a worker finishes or a worker acknowledges a state
+        // change.
+        stdx::condition_variable _resultsCond;
+
+        // Signalled when the workers should re-examine _state or room was made in _results.
+        stdx::condition_variable _workersCond;
+
+        State _state = State::kRunning;
+
+        std::vector<std::unique_ptr<Worker>> _workers;
+
+        std::deque<Result> _results;
+        size_t _resultsBytes = 0;
+
+        size_t _workersDone = 0;
+
+        // The first error hit by any worker. Once set, the stage is dead.
+        Status _workerStatus = Status::OK();
+
+        // Stats
+        CommonStats _commonStats;
+        ParallelCollectionScanStats _specificStats;
+    };
+
+}  // namespace mongo
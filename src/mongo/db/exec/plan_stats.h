@@ -219,6 +219,46 @@ namespace mongo {
         int direction;
     };
 
+    struct ParallelCollectionScanStats : public SpecificStats {
+        struct WorkerStats {
+            WorkerStats() : works(0), advanced(0) { }
+
+            // How many records did this worker read?
+            size_t works;
+
+            // How many of them passed the filter?
+            size_t advanced;
+        };
+
+        ParallelCollectionScanStats() : docsTested(0) { }
+
+        virtual SpecificStats* clone() const {
+            ParallelCollectionScanStats* specific = new ParallelCollectionScanStats(*this);
+            return specific;
+        }
+
+        // How many documents did the workers check against the filter, in total?
+        size_t docsTested;
+
+        // One entry per worker thread, in the order of the ranges they scan.
+        std::vector<WorkerStats> workers;
+    };
+
+    struct ChangeFeedStats : public SpecificStats {
+        ChangeFeedStats() : entriesExamined(0), eventsReturned(0) { }
+
+        virtual SpecificStats* clone() const {
+            ChangeFeedStats* specific = new ChangeFeedStats(*this);
+            return specific;
+        }
+
+        // How many oplog entries were checked against the subscriptions?
+        size_t entriesExamined;
+
+        // How many events were made from them, over all the subscriptions?
+        size_t eventsReturned;
+    };
+
     struct CountStats : public SpecificStats {
         CountStats() : nCounted(0), nSkipped(0), trivialCount(false) { }
 
@@ -462,7 +502,7 @@ namespace mongo {
     };
 
     struct SortStats : public SpecificStats {
-        SortStats() : forcedFetches(0), memUsage(0), memLimit(0) { }
+        SortStats() : forcedFetches(0), memUsage(0), memLimit(0), usedDisk(false) { }
 
         virtual ~SortStats() { }
 
@@ -485,6 +525,9 @@ namespace mongo {
 
         // The pattern according to which we are sorting.
         BSONObj sortPattern;
+
+        // Did we run out of memory and hand our data to the external sorter?
+        bool usedDisk;
     };
 
     struct MergeSortStats : public SpecificStats {
@@ -33,6 +33,7 @@
 #include "mongo/db/exec/filter.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/s/chunk_load_tracker.h"
 #include "mongo/s/shard_key_pattern.h"
 #include "mongo/util/log.h"
 
@@ -44,10 +45,11 @@ namespace mongo {
     // static
     const char* ShardFilterStage::kStageType = "SHARDING_FILTER";
 
-    ShardFilterStage::ShardFilterStage(const CollectionMetadataPtr& metadata,
+    ShardFilterStage::ShardFilterStage(const std::string& ns,
+                                       const CollectionMetadataPtr& metadata,
                                        WorkingSet* ws,
                                        PlanStage* child)
-        : _ws(ws), _child(child), _commonStats(kStageType), _metadata(metadata) { }
+        : _ns(ns), _ws(ws), _child(child), _commonStats(kStageType), _metadata(metadata) { }
 
     ShardFilterStage::~ShardFilterStage() { }
 
@@ -108,6 +110,15 @@ namespace mongo {
                     ++_specificStats.chunkSkips;
                     return PlanStage::NEED_TIME;
                 }
+
+                if (int numOps = chunkLoadTracker.sample()) {
+                    chunkLoadTracker.record(_ns,
+                                            *_metadata,
+                                            shardKey,
+                                            ChunkLoadTracker::kRead,
+                                            numOps,
+                                            Date_t::now());
+                }
             }
 
             // If we're here either we have shard state and our doc passed, or we have no shard
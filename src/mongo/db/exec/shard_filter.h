@@ -29,6 +29,7 @@
 #pragma once
 
 #include <boost/scoped_ptr.hpp>
+#include <string>
 
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/jsobj.h"
@@ -74,7 +75,10 @@ namespace mongo {
      */
     class ShardFilterStage : public PlanStage {
     public:
-        ShardFilterStage(const CollectionMetadataPtr& metadata, WorkingSet* ws, PlanStage* child);
+        ShardFilterStage(const std::string& ns,
+                         const CollectionMetadataPtr& metadata,
+                         WorkingSet* ws,
+                         PlanStage* child);
         virtual ~ShardFilterStage();
 
         virtual bool isEOF();
@@ -97,6 +101,9 @@ namespace mongo {
         static const char* kStageType;
 
     private:
+        // The collection being filtered, used to report the load on its chunks.
+        const std::string _ns;
+
         WorkingSet* _ws;
         boost::scoped_ptr<PlanStage> _child;
 
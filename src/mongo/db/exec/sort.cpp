@@ -41,6 +41,7 @@
 #include "mongo/db/query/lite_parsed_query.h"
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
+#include "mongo/db/storage_options.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -52,6 +53,30 @@ namespace mongo {
     // static
     const char* SortStage::kStageType = "SORT";
 
+namespace {
+
+    /**
+     * Returns true if 'member' carries computed data which the external sorter can't keep.
+     */
+    bool hasComputedData(const WorkingSetMember& member) {
+        for (int i = 0; i < WSM_COMPUTED_NUM_TYPES; ++i) {
+            if (member.hasComputed(static_cast<WorkingSetComputedDataType>(i))) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Status cannotSpillStatus(size_t maxBytes) {
+        mongoutils::str::stream ss;
+        ss << "Sort operation used more than the maximum " << maxBytes
+           << " bytes of RAM and cannot spill documents with computed metadata, such as text"
+           << " scores, to disk. Add an index, or specify a smaller limit.";
+        return Status(ErrorCodes::OperationFailed, ss);
+    }
+
+}  // namespace
+
     SortStageKeyGenerator::SortStageKeyGenerator(const Collection* collection,
                                                  const BSONObj& sortSpec,
                                                  const BSONObj& queryObj) {
@@ -285,6 +310,30 @@ namespace mongo {
         return lhs.loc < rhs.loc;
     }
 
+    int SortStage::SpillComparator::operator()(const SpillSorter::Data& lhs,
+                                               const SpillSorter::Data& rhs) const {
+        // False means ignore field names.
+        int result = lhs.first.woCompare(rhs.first, pattern, false);
+        if (0 != result) {
+            return result;
+        }
+        return lhs.second.loc.compare(rhs.second.loc);
+    }
+
+    void SortStage::SpilledItem::serializeForSorter(BufBuilder& buf) const {
+        loc.serializeForSorter(buf);
+        obj.serializeForSorter(buf);
+    }
+
+    // static
+    SortStage::SpilledItem SortStage::SpilledItem::deserializeForSorter(
+            BufReader& buf,
+            const SorterDeserializeSettings&) {
+        RecordId loc = RecordId::deserializeForSorter(buf, RecordId::SorterDeserializeSettings());
+        BSONObj obj = BSONObj::deserializeForSorter(buf, BSONObj::SorterDeserializeSettings());
+        return SpilledItem(loc, obj);
+    }
+
     SortStage::SortStage(const SortStageParams& params,
                          WorkingSet* ws,
                          PlanStage* child)
@@ -294,6 +343,7 @@ namespace mongo {
           _pattern(params.pattern),
           _query(params.query),
           _limit(params.limit),
+          _allowDiskUse(params.allowDiskUse),
           _sorted(false),
           _resultIterator(_data.end()),
           _commonStats(kStageType),
@@ -305,7 +355,15 @@ namespace mongo {
     bool SortStage::isEOF() {
         // We're done when our child has no more results, we've sorted the child's results, and
         // we've returned all sorted results.
-        return _child->isEOF() && _sorted && (_data.end() == _resultIterator);
+        if (!_child->isEOF() || !_sorted) {
+            return false;
+        }
+
+        if (NULL != _sorterIterator) {
+            return !_sorterIterator->more();
+        }
+
+        return _data.end() == _resultIterator;
     }
 
     PlanStage::StageState SortStage::work(WorkingSetID* out) {
@@ -353,6 +411,30 @@ namespace mongo {
                 // Planner must put a fetch before we get here.
                 verify(member->hasObj());
 
+                // Once we've spilled, documents go straight to the external sorter.
+                if (NULL != _sorter) {
+                    BSONObj sortKey;
+                    Status sortKeyStatus = _sortKeyGen->getSortKey(*member, &sortKey);
+                    if (!sortKeyStatus.isOK()) {
+                        *out = WorkingSetCommon::allocateStatusMember(_ws, sortKeyStatus);
+                        return PlanStage::FAILURE;
+                    }
+
+                    if (hasComputedData(*member)) {
+                        *out = WorkingSetCommon::allocateStatusMember(_ws,
+                                                                      cannotSpillStatus(maxBytes));
+                        return PlanStage::FAILURE;
+                    }
+
+                    _sorter->add(sortKey.getOwned(),
+                                 SpilledItem(member->hasLoc() ? member->loc : RecordId(),
+                                             member->obj.value().getOwned()));
+                    _ws->free(id);
+
+                    ++_commonStats.needTime;
+                    return PlanStage::NEED_TIME;
+                }
+
                 // We might be sorting something that was invalidated at some point.
                 if (member->hasLoc()) {
                     _wsidByDiskLoc[member->loc] = id;
@@ -361,7 +443,7 @@ namespace mongo {
                 // The data remains in the WorkingSet and we wrap the WSID with the sort key.
                 SortableDataItem item;
                 Status sortKeyStatus = _sortKeyGen->getSortKey(*member, &item.sortKey);
-                if (!_sortKeyGen->getSortKey(*member, &item.sortKey).isOK()) {
+                if (!sortKeyStatus.isOK()) {
                     *out = WorkingSetCommon::allocateStatusMember(_ws, sortKeyStatus);
                     return PlanStage::FAILURE;
                 }
@@ -373,14 +455,27 @@ namespace mongo {
 
                 addToBuffer(item);
 
+                if (_allowDiskUse && _memUsage > maxBytes) {
+                    Status spillStatus = spill();
+                    if (!spillStatus.isOK()) {
+                        *out = WorkingSetCommon::allocateStatusMember(_ws, spillStatus);
+                        return PlanStage::FAILURE;
+                    }
+                }
+
                 ++_commonStats.needTime;
                 return PlanStage::NEED_TIME;
             }
             else if (PlanStage::IS_EOF == code) {
                 // TODO: We don't need the lock for this.  We could ask for a yield and do this work
                 // unlocked.  Also, this is performing a lot of work for one call to work(...)
-                sortBuffer();
-                _resultIterator = _data.begin();
+                if (NULL != _sorter) {
+                    _sorterIterator.reset(_sorter->done());
+                }
+                else {
+                    sortBuffer();
+                    _resultIterator = _data.begin();
+                }
                 _sorted = true;
                 ++_commonStats.needTime;
                 return PlanStage::NEED_TIME;
@@ -410,8 +505,29 @@ namespace mongo {
         }
 
         // Returning results.
-        verify(_resultIterator != _data.end());
         verify(_sorted);
+
+        if (NULL != _sorterIterator) {
+            // Spilled documents were copied out of the WorkingSet, so they come back owned.
+            // Invalidations no longer reach them, which is fine as only reads may spill.
+            SpillSorter::Data data = _sorterIterator->next();
+            WorkingSetID id = _ws->allocate();
+            WorkingSetMember* member = _ws->get(id);
+            member->obj = Snapshotted<BSONObj>(SnapshotId(), data.second.obj.getOwned());
+            if (data.second.loc.isNull()) {
+                member->state = WorkingSetMember::OWNED_OBJ;
+            }
+            else {
+                member->loc = data.second.loc;
+                member->state = WorkingSetMember::LOC_AND_OWNED_OBJ;
+            }
+
+            *out = id;
+            ++_commonStats.advanced;
+            return PlanStage::ADVANCED;
+        }
+
+        verify(_resultIterator != _data.end());
         *out = _resultIterator->wsid;
         _resultIterator++;
 
@@ -473,7 +589,7 @@ namespace mongo {
         _commonStats.isEOF = isEOF();
         const size_t maxBytes = static_cast<size_t>(internalQueryExecMaxBlockingSortBytes);
         _specificStats.memLimit = maxBytes;
-        _specificStats.memUsage = _memUsage;
+        _specificStats.memUsage = (NULL != _sorter) ? _sorter->memUsed() : _memUsage;
         _specificStats.limit = _limit;
         _specificStats.sortPattern = _pattern.getOwned();
 
@@ -574,6 +690,45 @@ namespace mongo {
         }
     }
 
+    Status SortStage::spill() {
+        const size_t maxBytes = static_cast<size_t>(internalQueryExecMaxBlockingSortBytes);
+
+        if (_limit > 1) {
+            _data.assign(_dataSet->begin(), _dataSet->end());
+            _dataSet.reset();
+        }
+
+        for (vector<SortableDataItem>::const_iterator it = _data.begin(); it != _data.end();
+             ++it) {
+            if (hasComputedData(*_ws->get(it->wsid))) {
+                return cannotSpillStatus(maxBytes);
+            }
+        }
+
+        LOG(1) << "Sort stage exceeded " << maxBytes << " bytes, spilling to disk" << endl;
+
+        SortOptions opts;
+        opts.limit = _limit;
+        opts.maxMemoryUsageBytes = maxBytes;
+        opts.extSortAllowed = true;
+        opts.tempDir = storageGlobalParams.dbpath + "/_tmp";
+        _sorter.reset(SpillSorter::make(opts, SpillComparator(_sortKeyComparator->pattern)));
+
+        for (vector<SortableDataItem>::const_iterator it = _data.begin(); it != _data.end();
+             ++it) {
+            WorkingSetMember* member = _ws->get(it->wsid);
+            _sorter->add(it->sortKey.getOwned(),
+                         SpilledItem(it->loc, member->obj.value().getOwned()));
+            _ws->free(it->wsid);
+        }
+
+        _data.clear();
+        _wsidByDiskLoc.clear();
+        _memUsage = 0;
+        _specificStats.usedDisk = true;
+        return Status::OK();
+    }
+
     void SortStage::sortBuffer() {
         if (_limit == 0) {
             const WorkingSetComparator& cmp = *_sortKeyComparator;
@@ -594,3 +749,6 @@ namespace mongo {
     }
 
 }  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+// Explicit instantiation unneeded since we aren't exposing Sorter outside of this file.
@@ -37,6 +37,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/index_bounds.h"
 #include "mongo/db/record_id.h"
+#include "mongo/db/sorter/sorter.h"
 #include "mongo/platform/unordered_map.h"
 
 
@@ -47,7 +48,7 @@ namespace mongo {
     // Parameters that must be provided to a SortStage
     class SortStageParams {
     public:
-        SortStageParams() : collection(NULL), limit(0) { }
+        SortStageParams() : collection(NULL), limit(0), allowDiskUse(false) { }
 
         // Used for resolving RecordIds to BSON
         const Collection* collection;
@@ -60,6 +61,10 @@ namespace mongo {
 
         // Equal to 0 for no limit.
         size_t limit;
+
+        // If true, we hand our data to an external sorter rather than fail once it exceeds
+        // internalQueryExecMaxBlockingSortBytes.
+        bool allowDiskUse;
     };
 
     /**
@@ -191,6 +196,8 @@ namespace mongo {
         // Equal to 0 for no limit.
         size_t _limit;
 
+        bool _allowDiskUse;
+
         //
         // Sort key generation
         //
@@ -240,10 +247,53 @@ namespace mongo {
          */
         void sortBuffer();
 
+        /**
+         * Moves everything buffered so far out of the WorkingSet and into _sorter, which from
+         * then on receives all remaining input and spills to disk as needed.
+         *
+         * Fails if any buffered member carries computed data, such as a text score, since only
+         * the object and RecordId are kept by the external sorter.
+         */
+        Status spill();
+
         // Comparator for data buffer
         // Initialization follows sort key generator
         boost::scoped_ptr<WorkingSetComparator> _sortKeyComparator;
 
+        // What the external sorter keeps for each document once we've spilled.
+        struct SpilledItem {
+            SpilledItem() { }
+            SpilledItem(const RecordId& loc, const BSONObj& obj) : loc(loc), obj(obj) { }
+
+            // For Sorter
+            struct SorterDeserializeSettings {}; // unused
+            void serializeForSorter(BufBuilder& buf) const;
+            static SpilledItem deserializeForSorter(BufReader& buf,
+                                                    const SorterDeserializeSettings&);
+            int memUsageForSorter() const { return sizeof(SpilledItem) + obj.objsize(); }
+            SpilledItem getOwned() const { return SpilledItem(loc, obj.getOwned()); }
+
+            RecordId loc;
+            BSONObj obj;
+        };
+
+        typedef Sorter<BSONObj, SpilledItem> SpillSorter;
+
+        // Compares spilled items the same way WorkingSetComparator compares buffered ones.
+        struct SpillComparator {
+            explicit SpillComparator(BSONObj p) : pattern(p) { }
+
+            int operator()(const SpillSorter::Data& lhs, const SpillSorter::Data& rhs) const;
+
+            BSONObj pattern;
+        };
+
+        // Non-NULL once we have exceeded our memory limit with _allowDiskUse set.
+        boost::scoped_ptr<SpillSorter> _sorter;
+
+        // Returns the results of _sorter once the child is EOF.
+        boost::scoped_ptr<SpillSorter::Iterator> _sorterIterator;
+
         // The data we buffer and sort.
         // _data will contain sorted data when all data is gathered
         // and sorted.
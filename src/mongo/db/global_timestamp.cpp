@@ -61,22 +61,31 @@ namespace mongo {
     }
 
     Timestamp getNextGlobalTimestamp() {
+        return getNextGlobalTimestamps(1);
+    }
+
+    Timestamp getNextGlobalTimestamps(unsigned count) {
+        invariant(count > 0);
         boost::lock_guard<boost::mutex> lk(globalTimestampMutex);
 
         const unsigned now = (unsigned) time(0);
         const unsigned globalSecs = globalTimestamp.getSecs();
+        Timestamp first;
         if ( globalSecs == now ) {
-            globalTimestamp = Timestamp(globalSecs, globalTimestamp.getInc() + 1);
+            first = Timestamp(globalSecs, globalTimestamp.getInc() + 1);
+            globalTimestamp = Timestamp(globalSecs, globalTimestamp.getInc() + count);
         }
         else if ( now < globalSecs ) {
-            globalTimestamp = Timestamp(globalSecs, globalTimestamp.getInc() + 1);
+            first = Timestamp(globalSecs, globalTimestamp.getInc() + 1);
+            globalTimestamp = Timestamp(globalSecs, globalTimestamp.getInc() + count);
             // separate function to keep out of the hot code path
             fassert(17449, !skewed(globalTimestamp));
         }
         else {
-            globalTimestamp = Timestamp(now, 1);
+            first = Timestamp(now, 1);
+            globalTimestamp = Timestamp(now, count);
         }
 
-        return globalTimestamp;
+        return first;
     }
 }
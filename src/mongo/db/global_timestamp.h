@@ -42,4 +42,10 @@ namespace mongo {
      * Generates a new and unique Timestamp.
      */
     Timestamp getNextGlobalTimestamp();
+
+    /**
+     * Generates 'count' new and unique Timestamps, which share their seconds and have consecutive
+     * increments. Returns the first of them.
+     */
+    Timestamp getNextGlobalTimestamps(unsigned count);
 }
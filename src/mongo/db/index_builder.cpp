@@ -41,6 +41,9 @@
 #include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/operation_context_impl.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/batch_snapshot_manager.h"
+#include "mongo/db/storage/storage_engine.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -192,6 +195,19 @@ namespace {
                         WriteUnitOfWork wunit(txn);
                         indexer.commit();
                         wunit.commit();
+
+                        // A background build finishes outside of any replication batch, so the
+                        // batch snapshot predates the index. It is retired while we still hold
+                        // the database lock, which readers check it under. Taking the batch
+                        // snapshot lock instead could deadlock with the applier, which holds it
+                        // while a drop waits for this build to finish.
+                        if (allowBackgroundBuilding) {
+                            BatchSnapshotManager* batchSnapshots = getGlobalServiceContext()
+                                ->getGlobalStorageEngine()->getBatchSnapshotManager();
+                            if (batchSnapshots) {
+                                batchSnapshots->retireSnapshot();
+                            }
+                        }
                     }
                 }
                 catch (const DBException& e) {
@@ -0,0 +1,287 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/compiled_match_expression.h"
+
+#include <boost/scoped_array.hpp>
+
+#include "mongo/db/field_ref.h"
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/matcher/matchable.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+    namespace {
+        // Programs testing no more paths than this keep their per-document state in a fixed
+        // buffer rather than on the heap.
+        const size_t kInlinePaths = 16;
+    }  // namespace
+
+    CompiledMatchExpression::CompiledMatchExpression(const MatchExpression* root) {
+        invariant(root);
+        _compile(root);
+    }
+
+    size_t CompiledMatchExpression::_emit(OpCode op, const MatchExpression* expr) {
+        Instruction instr;
+        instr.op = op;
+        instr.expr = expr;
+        instr.path = 0;
+        instr.target = 0;
+        instr.value = false;
+        _program.push_back(instr);
+        return _program.size() - 1;
+    }
+
+    size_t CompiledMatchExpression::_pathSlot(StringData dotted) {
+        for (size_t i = 0; i < _paths.size(); ++i) {
+            if (dotted == _paths[i].dotted) {
+                return i;
+            }
+        }
+
+        Path path;
+        path.dotted = dotted.toString();
+        FieldRef ref(dotted);
+        for (size_t i = 0; i < ref.numParts(); ++i) {
+            path.parts.push_back(ref.getPart(i).toString());
+        }
+        _paths.push_back(path);
+        return _paths.size() - 1;
+    }
+
+    bool CompiledMatchExpression::_canTest(const MatchExpression* expr) {
+        switch (expr->matchType()) {
+        case MatchExpression::EQ:
+        case MatchExpression::LTE:
+        case MatchExpression::LT:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+        case MatchExpression::REGEX:
+        case MatchExpression::MOD:
+        case MatchExpression::EXISTS:
+        case MatchExpression::MATCH_IN:
+            // Leaves under an $elemMatch have an empty path and are never compiled on their
+            // own, but be defensive.
+            return !expr->path().empty();
+        default:
+            return false;
+        }
+    }
+
+    void CompiledMatchExpression::_compileList(const MatchExpression* expr,
+                                               OpCode jump,
+                                               bool emptyValue) {
+        if (expr->numChildren() == 0) {
+            _program[_emit(kConst)].value = emptyValue;
+            return;
+        }
+
+        // Each child but the last is followed by a jump to the end of the list, taken as soon
+        // as the outcome of the whole list is known.
+        std::vector<size_t> jumps;
+        for (size_t i = 0; i < expr->numChildren(); ++i) {
+            _compile(expr->getChild(i));
+            if (i + 1 < expr->numChildren()) {
+                jumps.push_back(_emit(jump));
+            }
+        }
+
+        for (size_t i = 0; i < jumps.size(); ++i) {
+            _program[jumps[i]].target = _program.size();
+        }
+    }
+
+    void CompiledMatchExpression::_compile(const MatchExpression* expr) {
+        switch (expr->matchType()) {
+        case MatchExpression::AND:
+            _compileList(expr, kJumpIfFalse, true);
+            return;
+        case MatchExpression::OR:
+            _compileList(expr, kJumpIfTrue, false);
+            return;
+        case MatchExpression::NOR:
+            _compileList(expr, kJumpIfTrue, false);
+            _emit(kNegate);
+            return;
+        case MatchExpression::NOT:
+            invariant(expr->numChildren() == 1);
+            _compile(expr->getChild(0));
+            _emit(kNegate);
+            return;
+        default:
+            break;
+        }
+
+        if (_canTest(expr)) {
+            _program[_emit(kTest, expr)].path = _pathSlot(expr->path());
+            return;
+        }
+
+        _emit(kOpaque, expr);
+    }
+
+    void CompiledMatchExpression::_resolve(const BSONObj& doc,
+                                           size_t path,
+                                           PathValue* value) const {
+        const std::vector<std::string>& parts = _paths[path].parts;
+
+        BSONElement elt;
+        BSONObj current = doc;
+        for (size_t i = 0; i < parts.size(); ++i) {
+            elt = current.getField(parts[i]);
+            if (elt.type() == Array) {
+                // Array traversal, both in the middle of the path and at its end, is left to
+                // the ElementIterator.
+                value->state = PathValue::kArray;
+                return;
+            }
+
+            if (i + 1 < parts.size()) {
+                if (!elt.isABSONObj()) {
+                    // Missing, or a scalar where the path continues.
+                    elt = BSONElement();
+                    break;
+                }
+                current = elt.embeddedObject();
+            }
+        }
+
+        value->state = PathValue::kElement;
+        value->element = elt;
+    }
+
+    bool CompiledMatchExpression::_run(const BSONObj& doc, PathValue* values) const {
+        bool result = true;
+        size_t pc = 0;
+        while (pc < _program.size()) {
+            const Instruction& instr = _program[pc];
+            switch (instr.op) {
+            case kTest: {
+                PathValue& value = values[instr.path];
+                if (value.state == PathValue::kUnresolved) {
+                    _resolve(doc, instr.path, &value);
+                }
+
+                const LeafMatchExpression* leaf =
+                    static_cast<const LeafMatchExpression*>(instr.expr);
+                if (value.state == PathValue::kElement) {
+                    result = leaf->matchesSingleElement(value.element);
+                }
+                else {
+                    BSONMatchableDocument matchable(doc);
+                    result = leaf->matches(&matchable, NULL);
+                }
+                break;
+            }
+            case kOpaque: {
+                BSONMatchableDocument matchable(doc);
+                result = instr.expr->matches(&matchable, NULL);
+                break;
+            }
+            case kConst:
+                result = instr.value;
+                break;
+            case kJumpIfFalse:
+                if (!result) {
+                    pc = instr.target;
+                    continue;
+                }
+                break;
+            case kJumpIfTrue:
+                if (result) {
+                    pc = instr.target;
+                    continue;
+                }
+                break;
+            case kNegate:
+                result = !result;
+                break;
+            }
+            ++pc;
+        }
+        return result;
+    }
+
+    bool CompiledMatchExpression::matchesBSON(const BSONObj& doc) const {
+        if (_paths.size() <= kInlinePaths) {
+            PathValue values[kInlinePaths];
+            for (size_t i = 0; i < _paths.size(); ++i) {
+                values[i].state = PathValue::kUnresolved;
+            }
+            return _run(doc, values);
+        }
+
+        boost::scoped_array<PathValue> values(new PathValue[_paths.size()]);
+        for (size_t i = 0; i < _paths.size(); ++i) {
+            values[i].state = PathValue::kUnresolved;
+        }
+        return _run(doc, values.get());
+    }
+
+    std::string CompiledMatchExpression::debugString() const {
+        mongoutils::str::stream ss;
+        for (size_t pc = 0; pc < _program.size(); ++pc) {
+            const Instruction& instr = _program[pc];
+            ss << pc << ": ";
+            switch (instr.op) {
+            case kTest: {
+                StringBuilder leaf;
+                instr.expr->debugString(leaf);
+                ss << "TEST $" << instr.path << " (" << _paths[instr.path].dotted << ") "
+                   << leaf.str();
+                break;
+            }
+            case kOpaque: {
+                StringBuilder expr;
+                instr.expr->debugString(expr);
+                ss << "TREE " << expr.str();
+                break;
+            }
+            case kConst:
+                ss << "CONST " << (instr.value ? "true" : "false") << "\n";
+                break;
+            case kJumpIfFalse:
+                ss << "JUMP_IF_FALSE " << instr.target << "\n";
+                break;
+            case kJumpIfTrue:
+                ss << "JUMP_IF_TRUE " << instr.target << "\n";
+                break;
+            case kNegate:
+                ss << "NEGATE\n";
+                break;
+            }
+        }
+        return ss;
+    }
+
+}  // namespace mongo
@@ -0,0 +1,130 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/matcher/expression.h"
+
+namespace mongo {
+
+    class LeafMatchExpression;
+
+    /**
+     * A MatchExpression tree flattened into a linear program, for callers which evaluate the
+     * same filter against many BSON documents.
+     *
+     * AND, OR, NOR and NOT become conditional jumps over the instructions of their children,
+     * so no virtual calls are made to walk the tree. The paths of the leaves which compare
+     * single values (EQ, LT, LTE, GT, GTE, REGEX, MOD, EXISTS and IN) are split into their parts
+     * once, at compile time, and leaves with the same path share one slot: the path is looked
+     * up at most once per document, however many predicates test it.
+     *
+     * A path which runs into an array needs the full ElementIterator semantics, so the leaves
+     * testing it fall back to LeafMatchExpression::matches(). Every other kind of expression
+     * ($elemMatch, $type, $where, geo, ...) is evaluated through the tree as well. Compiled and
+     * tree evaluation therefore always agree.
+     *
+     * The program only points into the tree, which must outlive it. matchesBSON() keeps all of
+     * its state on the stack, so one program may be used by several threads at once.
+     */
+    class CompiledMatchExpression {
+        MONGO_DISALLOW_COPYING(CompiledMatchExpression);
+    public:
+        explicit CompiledMatchExpression(const MatchExpression* root);
+
+        /**
+         * Returns the same answer as root->matchesBSON(doc).
+         */
+        bool matchesBSON(const BSONObj& doc) const;
+
+        size_t numInstructions() const { return _program.size(); }
+
+        size_t numPaths() const { return _paths.size(); }
+
+        std::string debugString() const;
+
+    private:
+        enum OpCode {
+            // result = the leaf's predicate on the value at the instruction's path.
+            kTest,
+            // result = expr->matches(doc), through the tree.
+            kOpaque,
+            // result = value.
+            kConst,
+            // Moves to target if result is false / true.
+            kJumpIfFalse,
+            kJumpIfTrue,
+            // result = !result.
+            kNegate,
+        };
+
+        struct Instruction {
+            OpCode op;
+            const MatchExpression* expr;
+            size_t path;
+            size_t target;
+            bool value;
+        };
+
+        // A dotted path, split into its parts.
+        struct Path {
+            std::string dotted;
+            std::vector<std::string> parts;
+        };
+
+        // What matchesBSON() has found at a path so far.
+        struct PathValue {
+            enum State { kUnresolved, kElement, kArray };
+            State state;
+            BSONElement element;
+        };
+
+        void _compile(const MatchExpression* expr);
+
+        void _compileList(const MatchExpression* expr, OpCode jump, bool emptyValue);
+
+        size_t _emit(OpCode op, const MatchExpression* expr = NULL);
+
+        size_t _pathSlot(StringData dotted);
+
+        static bool _canTest(const MatchExpression* expr);
+
+        void _resolve(const BSONObj& doc, size_t path, PathValue* value) const;
+
+        bool _run(const BSONObj& doc, PathValue* values) const;
+
+        std::vector<Instruction> _program;
+        std::vector<Path> _paths;
+    };
+
+}  // namespace mongo
@@ -0,0 +1,184 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/unittest/unittest.h"
+
+#include <memory>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/matcher/expression_parser.h"
+
+namespace mongo {
+
+    namespace {
+
+        std::unique_ptr<MatchExpression> parse(const BSONObj& query) {
+            StatusWithMatchExpression result = MatchExpressionParser::parse(query);
+            ASSERT_OK(result.getStatus());
+            return std::unique_ptr<MatchExpression>(result.getValue());
+        }
+
+        /**
+         * Checks that the compiled form of 'query' agrees with the tree on every document.
+         */
+        void assertSameAsTree(const BSONObj& query, const std::vector<BSONObj>& docs) {
+            std::unique_ptr<MatchExpression> expr = parse(query);
+            CompiledMatchExpression compiled(expr.get());
+            for (size_t i = 0; i < docs.size(); ++i) {
+                ASSERT_EQUALS(expr->matchesBSON(docs[i]), compiled.matchesBSON(docs[i]))
+                    << "query: " << query << " doc: " << docs[i]
+                    << " program:\n" << compiled.debugString();
+            }
+        }
+
+        std::vector<BSONObj> corpus() {
+            const char* docs[] = {
+                "{}",
+                "{a: 1}",
+                "{a: 5}",
+                "{a: null}",
+                "{a: 'abc'}",
+                "{a: 1, b: 2}",
+                "{a: 3, b: 'x'}",
+                "{a: [1, 5]}",
+                "{a: []}",
+                "{a: [[1]]}",
+                "{a: {b: 1}}",
+                "{a: {b: 5, c: 'abc'}}",
+                "{a: {b: null}}",
+                "{a: {b: {c: 1}}}",
+                "{a: {b: [1, 2]}}",
+                "{a: [{b: 1}, {b: 5}]}",
+                "{a: [{b: [2]}]}",
+                "{a: {'0': 1}}",
+                "{a: ['x', 'y']}",
+                "{a: 7, b: {c: 7}}",
+                "{b: 1}",
+            };
+
+            std::vector<BSONObj> out;
+            for (size_t i = 0; i < sizeof(docs) / sizeof(docs[0]); ++i) {
+                out.push_back(fromjson(docs[i]));
+            }
+            return out;
+        }
+
+    }  // namespace
+
+    TEST(CompiledMatchExpressionTest, Leaves) {
+        const char* queries[] = {
+            "{a: 1}",
+            "{a: null}",
+            "{a: {$lt: 5}}",
+            "{a: {$lte: 5}}",
+            "{a: {$gt: 1}}",
+            "{a: {$gte: 5}}",
+            "{a: /^ab/}",
+            "{a: {$mod: [2, 1]}}",
+            "{a: {$exists: true}}",
+            "{a: {$exists: false}}",
+            "{a: {$in: [1, null, /x/]}}",
+            "{a: {$nin: [1, 5]}}",
+            "{a: {$ne: 1}}",
+            "{'a.b': 1}",
+            "{'a.b': null}",
+            "{'a.b': {$gt: 1}}",
+            "{'a.b.c': 1}",
+            "{'a.0': 1}",
+            "{'a.b': {$exists: false}}",
+            "{a: [1, 5]}",
+            "{a: {b: 1}}",
+        };
+
+        std::vector<BSONObj> docs = corpus();
+        for (size_t i = 0; i < sizeof(queries) / sizeof(queries[0]); ++i) {
+            assertSameAsTree(fromjson(queries[i]), docs);
+        }
+    }
+
+    TEST(CompiledMatchExpressionTest, Trees) {
+        const char* queries[] = {
+            "{}",
+            "{a: {$gt: 1, $lt: 6}}",
+            "{a: 1, b: 2}",
+            "{$or: [{a: 1}, {b: 'x'}]}",
+            "{$or: [{a: {$lt: 2}}, {'a.b': {$gte: 5}}, {b: {$exists: false}}]}",
+            "{$nor: [{a: 1}, {b: 2}]}",
+            "{a: {$not: {$gt: 1}}}",
+            "{$and: [{$or: [{a: 1}, {a: 5}]}, {$nor: [{b: 2}]}]}",
+            "{$or: [{$and: [{a: 7}, {'b.c': 7}]}, {'a.b': null}]}",
+            "{a: {$elemMatch: {b: 1}}}",
+            "{a: {$size: 2}, b: {$exists: false}}",
+            "{a: {$type: 2}}",
+            "{$or: [{a: {$all: [1, 5]}}, {'a.c': 'abc'}]}",
+        };
+
+        std::vector<BSONObj> docs = corpus();
+        for (size_t i = 0; i < sizeof(queries) / sizeof(queries[0]); ++i) {
+            assertSameAsTree(fromjson(queries[i]), docs);
+        }
+    }
+
+    TEST(CompiledMatchExpressionTest, SharesPaths) {
+        std::unique_ptr<MatchExpression> expr =
+            parse(fromjson("{a: {$gt: 1, $lt: 6}, $or: [{a: 3}, {'b.c': 1}, {'b.c': 2}]}"));
+        CompiledMatchExpression compiled(expr.get());
+        ASSERT_EQUALS(2U, compiled.numPaths());
+    }
+
+    TEST(CompiledMatchExpressionTest, TreeOnlyExpressionsUseNoPaths) {
+        std::unique_ptr<MatchExpression> expr =
+            parse(fromjson("{a: {$elemMatch: {b: 1}}, c: {$type: 2}}"));
+        CompiledMatchExpression compiled(expr.get());
+        ASSERT_EQUALS(0U, compiled.numPaths());
+        ASSERT(compiled.matchesBSON(fromjson("{a: [{b: 1}], c: 'x'}")));
+        ASSERT(!compiled.matchesBSON(fromjson("{a: [{b: 1}], c: 1}")));
+    }
+
+    TEST(CompiledMatchExpressionTest, ManyPaths) {
+        // More paths than fit in the inline buffer.
+        BSONObjBuilder query;
+        BSONObjBuilder doc;
+        for (int i = 0; i < 40; ++i) {
+            const std::string field = str::stream() << "f" << i;
+            query.append(field, i);
+            doc.append(field, i);
+        }
+        std::unique_ptr<MatchExpression> expr = parse(query.obj());
+        CompiledMatchExpression compiled(expr.get());
+        ASSERT_EQUALS(40U, compiled.numPaths());
+
+        BSONObj matching = doc.obj();
+        ASSERT(compiled.matchesBSON(matching));
+        ASSERT(!compiled.matchesBSON(matching.removeField("f39")));
+    }
+
+}  // namespace mongo
@@ -36,6 +36,7 @@
 #include "mongo/db/matcher/matcher.h"
 #include "mongo/db/matcher/path.h"
 #include "mongo/db/exec/working_set.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/stacktrace.h"
 
@@ -51,12 +52,18 @@ namespace mongo {
                  result.isOK() );
 
         _expression.reset( result.getValue() );
+        if ( internalQueryCompileMatchExpressions ) {
+            _compiled.reset( new CompiledMatchExpression( _expression.get() ) );
+        }
     }
 
     bool Matcher::matches(const BSONObj& doc, MatchDetails* details ) const {
         if ( !_expression )
             return true;
 
+        if ( !details && _compiled )
+            return _compiled->matchesBSON( doc );
+
         return _expression->matchesBSON( doc, details );
     }
 
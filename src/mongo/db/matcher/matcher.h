@@ -35,6 +35,7 @@
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/matcher/match_details.h"
@@ -63,6 +64,10 @@ namespace mongo {
         BSONObj _pattern;
 
         boost::scoped_ptr<MatchExpression> _expression;
+
+        // Used when the caller does not ask for MatchDetails. NULL unless
+        // internalQueryCompileMatchExpressions was set when this was built.
+        boost::scoped_ptr<CompiledMatchExpression> _compiled;
     };
 
 }  // namespace mongo
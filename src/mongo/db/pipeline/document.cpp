@@ -62,7 +62,7 @@ namespace mongo {
             }
         }
         else { // linear scan
-            for (DocumentStorageIterator it = iteratorAll(); !it.atEnd(); it.advance()) {
+            for (DocumentStorageIterator it = loadedIteratorAll(); !it.atEnd(); it.advance()) {
                 if (it->nameLen == reqSize
                     && memcmp(requested.rawData(), it->_name, reqSize) == 0) {
                     return it.position();
@@ -70,11 +70,64 @@ namespace mongo {
             }
         }
 
+        // The field may not have been converted from the backing BSON yet
+        if (hasUnloadedFields())
+            return loadFields(requested, true);
+
         // if we got here, there's no such field
         return Position();
     }
 
-    Value& DocumentStorage::appendField(StringData name) {
+    void DocumentStorage::initFromBson(const BSONObj& bson, bool stripMetadata) {
+        fassert(28682, !_buffer && !hasUnloadedFields() && bson.isOwned());
+
+        _bson = bson;
+        _bsonPos = _bson.objdata() + sizeof(int);
+        _bsonEnd = _bson.objdata() + _bson.objsize() - 1; // before the trailing EOO
+        _stripMetadata = stripMetadata;
+        _bsonMatchesFields = true;
+
+        if (_stripMetadata) {
+            // Metadata must be available before any field is converted, so find it now. This
+            // only walks the element headers.
+            BSONForEach(elem, _bson) {
+                if (elem.fieldName()[0] == '$'
+                        && elem.fieldNameStringData() == Document::metaFieldTextScore) {
+                    setTextScore(elem.Double());
+                    _bsonMatchesFields = false;
+                }
+            }
+        }
+    }
+
+    Position DocumentStorage::loadFields(StringData name, bool stopAtName) const {
+        // Converting only fills in state which is already logically part of this document, and
+        // DocumentStorages are never const objects, so this is safe.
+        DocumentStorage* self = const_cast<DocumentStorage*>(this);
+
+        while (self->_bsonPos != self->_bsonEnd) {
+            BSONElement elem(self->_bsonPos);
+            self->_bsonPos += elem.size();
+
+            if (_stripMetadata
+                    && elem.fieldName()[0] == '$'
+                    && elem.fieldNameStringData() == Document::metaFieldTextScore) {
+                continue;
+            }
+
+            // Convert before appending so a failed conversion doesn't leave a stray field.
+            const Value val(elem);
+            const Position pos = getNextPosition();
+            self->appendLoadedField(elem.fieldNameStringData()) = val;
+
+            if (stopAtName && elem.fieldNameStringData() == name)
+                return pos;
+        }
+
+        return Position();
+    }
+
+    Value& DocumentStorage::appendLoadedField(StringData name) {
         Position pos = getNextPosition();
         const int nameSize = name.size();
 
@@ -186,6 +239,9 @@ namespace mongo {
     }
 
     intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
+        // The clone is about to be modified, so it can't be lazy.
+        loadAllFields();
+
         intrusive_ptr<DocumentStorage> out (new DocumentStorage());
 
         // Make a copy of the buffer.
@@ -213,21 +269,20 @@ namespace mongo {
     DocumentStorage::~DocumentStorage() {
         boost::scoped_array<char> deleteBufferAtScopeEnd (_buffer);
 
-        for (DocumentStorageIterator it = iteratorAll(); !it.atEnd(); it.advance()) {
+        for (DocumentStorageIterator it = loadedIteratorAll(); !it.atEnd(); it.advance()) {
             it->val.~Value(); // explicit destructor call
         }
     }
 
     Document::Document(const BSONObj& bson) {
-        MutableDocument md(bson.nFields());
-
-        BSONObjIterator it(bson);
-        while(it.more()) {
-            BSONElement bsonElement(it.next());
-            md.addField(bsonElement.fieldNameStringData(), Value(bsonElement));
-        }
-
-        *this = md.freeze();
+        if (bson.isEmpty())
+            return;
+
+        // Copying the BSON, if it isn't already owned, is much cheaper than converting every
+        // field up front.
+        intrusive_ptr<DocumentStorage> storage(new DocumentStorage());
+        storage->initFromBson(bson.getOwned(), false);
+        _storage = storage;
     }
 
     BSONObjBuilder& operator << (BSONObjBuilderValueStream& builder, const Document& doc) {
@@ -238,12 +293,20 @@ namespace mongo {
     }
 
     void Document::toBson(BSONObjBuilder* pBuilder) const {
+        if (const BSONObj* bson = storage().bsonIfUnmodified()) {
+            pBuilder->appendElements(*bson);
+            return;
+        }
+
         for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
             *pBuilder << it->nameSD() << it->val;
         }
     }
 
     BSONObj Document::toBson() const {
+        if (const BSONObj* bson = storage().bsonIfUnmodified())
+            return *bson;
+
         BSONObjBuilder bb;
         toBson(&bb);
         return bb.obj();
@@ -260,23 +323,13 @@ namespace mongo {
     }
 
     Document Document::fromBsonWithMetaData(const BSONObj& bson) {
-        MutableDocument md;
-
-        BSONObjIterator it(bson);
-        while(it.more()) {
-            BSONElement elem(it.next());
-            if (elem.fieldName()[0] == '$') {
-                if (elem.fieldNameStringData() == metaFieldTextScore) {
-                    md.setTextScore(elem.Double());
-                    continue;
-                }
-            }
+        if (bson.isEmpty())
+            return Document();
 
-            // Note: this will not parse out metadata in embedded documents.
-            md.addField(elem.fieldNameStringData(), Value(elem));
-        }
-
-        return md.freeze();
+        // Note: this will not parse out metadata in embedded documents.
+        intrusive_ptr<DocumentStorage> storage(new DocumentStorage());
+        storage->initFromBson(bson.getOwned(), true);
+        return Document(storage.get());
     }
 
     MutableDocument::MutableDocument(size_t expectedFields)
@@ -355,9 +408,10 @@ namespace mongo {
             return 0; // we've allocated no memory
 
         size_t size = sizeof(DocumentStorage);
-        size += storage().allocatedBytes();
+        size += storage().allocatedBytes(); // includes any backing BSON
 
-        for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
+        // Fields which haven't been converted are accounted for by the backing BSON.
+        for (DocumentStorageIterator it = storage().loadedIterator(); !it.atEnd(); it.advance()) {
             size += it->val.getApproximateSize();
             size -= sizeof(Value); // already accounted for above
         }
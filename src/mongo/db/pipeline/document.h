@@ -71,7 +71,10 @@ namespace mongo {
         /// Empty Document (does no allocation)
         Document() {}
 
-        /// Create a new Document deep-converted from the given BSONObj.
+        /** Create a new Document backed by (an owned copy of) the given BSONObj.
+         *  Fields are only converted to Values as they are looked up, and toBson() hands back
+         *  the original BSON for as long as the Document is not modified.
+         */
         explicit Document(const BSONObj& bson);
 
         void swap(Document& rhs) { _storage.swap(rhs._storage); }
@@ -427,7 +430,9 @@ namespace mongo {
                 return clonedStorage();
 
             // This function exists to ensure this is safe
-            return const_cast<DocumentStorage&>(*storagePtr());
+            DocumentStorage& storage = const_cast<DocumentStorage&>(*storagePtr());
+            storage.prepareForWrite();
+            return storage;
         }
         DocumentStorage& newStorage() {
             reset(new DocumentStorage);
@@ -160,7 +160,13 @@ namespace mongo {
         bool _includeMissing;
     };
 
-    /// Storage class used by both Document and MutableDocument
+    /** Storage class used by both Document and MutableDocument
+     *
+     *  A DocumentStorage may be backed by a BSONObj, in which case fields are only converted
+     *  into the buffer, in order, as lookups reach them. Anything that needs all fields, such as
+     *  iteration, converts the rest first. Converting mutates the storage behind const methods,
+     *  so a Document must not be read from several threads at once.
+     */
     class DocumentStorage :  public RefCountable {
     public:
         // Note: default constructor should zero-init to support emptyDoc()
@@ -171,6 +177,10 @@ namespace mongo {
                           , _hashTabMask(0)
                           , _hasTextScore(false)
                           , _textScore(0)
+                          , _bsonPos(NULL)
+                          , _bsonEnd(NULL)
+                          , _stripMetadata(false)
+                          , _bsonMatchesFields(false)
         {}
         ~DocumentStorage();
 
@@ -179,6 +189,38 @@ namespace mongo {
             return *reinterpret_cast<const DocumentStorage*>(emptyBytes);
         }
 
+        /** Makes this storage lazily backed by 'bson', which must be owned.
+         *  If 'stripMetadata' is true, top-level metadata fields such as $textScore are set as
+         *  metadata rather than fields. Only valid on a newly constructed storage.
+         */
+        void initFromBson(const BSONObj& bson, bool stripMetadata);
+
+        /// True if some fields of the backing BSON have not been converted yet.
+        bool hasUnloadedFields() const { return _bsonPos != _bsonEnd; }
+
+        /// Converts every field still waiting in the backing BSON. Positions remain valid.
+        void loadAllFields() const {
+            if (MONGO_unlikely(hasUnloadedFields()))
+                loadFields(StringData(), false);
+        }
+
+        /** Called by MutableDocument before it modifies the fields.
+         *  Converts everything, so that later lookups can't append fields from the backing BSON
+         *  after newly added ones, and drops the backing BSON since it no longer matches.
+         */
+        void prepareForWrite() {
+            loadAllFields();
+            if (MONGO_unlikely(_bsonMatchesFields)) {
+                _bsonMatchesFields = false;
+                _bson = BSONObj();
+            }
+        }
+
+        /// Returns the backing BSON if it holds exactly this document's fields, else NULL.
+        const BSONObj* bsonIfUnmodified() const {
+            return _bsonMatchesFields ? &_bson : NULL;
+        }
+
         size_t size() const {
             // can't use _numFields because it includes removed Fields
             size_t count = 0;
@@ -218,7 +260,10 @@ namespace mongo {
         }
 
         /// Adds a new field with missing Value at the end of the document
-        Value& appendField(StringData name);
+        Value& appendField(StringData name) {
+            loadAllFields();
+            return appendLoadedField(name);
+        }
 
         /** Preallocates space for fields. Use this to attempt to prevent buffer growth.
          *  This is only valid to call before anything is added to the document.
@@ -227,19 +272,27 @@ namespace mongo {
 
         /// This skips missing values
         DocumentStorageIterator iterator() const {
+            loadAllFields();
             return DocumentStorageIterator(_firstElement, end(), false);
         }
 
         /// This includes missing values
         DocumentStorageIterator iteratorAll() const {
-            return DocumentStorageIterator(_firstElement, end(), true);
+            loadAllFields();
+            return loadedIteratorAll();
+        }
+
+        /// Like iterator() but only visits the fields converted so far.
+        DocumentStorageIterator loadedIterator() const {
+            return DocumentStorageIterator(_firstElement, end(), false);
         }
 
         /// Shallow copy of this. Caller owns memory.
         boost::intrusive_ptr<DocumentStorage> clone() const;
 
         size_t allocatedBytes() const {
-            return !_buffer ? 0 : (_bufferEnd - _buffer + hashTabBytes());
+            return (!_buffer ? 0 : (_bufferEnd - _buffer + hashTabBytes()))
+                 + (_bson.isOwned() ? _bson.objsize() : 0);
         }
 
         /**
@@ -264,6 +317,20 @@ namespace mongo {
         /// Same as lastElement->next() or firstElement() if empty.
         const ValueElement* end() const { return _firstElement->plusBytes(_usedBytes); }
 
+        /// Doesn't convert anything from the backing BSON. Used while converting.
+        DocumentStorageIterator loadedIteratorAll() const {
+            return DocumentStorageIterator(_firstElement, end(), true);
+        }
+
+        /// appendField without converting the rest of the backing BSON first.
+        Value& appendLoadedField(StringData name);
+
+        /** Converts fields from the backing BSON in order. If 'stopAtName' is true, stops after
+         *  converting a field called 'name' and returns its position, else converts everything.
+         *  Returns Position() if no such field was converted.
+         */
+        Position loadFields(StringData name, bool stopAtName) const;
+
         /// Allocates space in _buffer. Copies existing data if there is any.
         void alloc(unsigned newSize);
 
@@ -294,7 +361,7 @@ namespace mongo {
         /// Adds all fields to the hash table
         void rehash() {
             hashTabInit();
-            for (DocumentStorageIterator it = iteratorAll(); !it.atEnd(); it.advance())
+            for (DocumentStorageIterator it = loadedIteratorAll(); !it.atEnd(); it.advance())
                 addFieldToHashTable(it.position());
         }
 
@@ -330,6 +397,15 @@ namespace mongo {
 
         bool _hasTextScore; // When adding more metadata fields, this should become a bitvector
         double _textScore;
+
+        // The BSON this storage is lazily converted from, if any. Fields before _bsonPos are in
+        // _buffer, in the same order; the ones from _bsonPos up to _bsonEnd are not converted yet.
+        BSONObj _bson;
+        const char* _bsonPos;
+        const char* _bsonEnd;
+        bool _stripMetadata; // skip metadata fields while converting
+        bool _bsonMatchesFields; // _bson holds exactly our fields, see bsonIfUnmodified()
+
         // When adding a field, make sure to update clone() method
     };
 }
@@ -96,6 +96,70 @@ namespace DocumentTests {
             }            
         };
 
+        /** Fields of a BSON-backed Document are converted as they are looked up. */
+        class LazyFieldLookup {
+        public:
+            void run() {
+                BSONObj obj = BSON( "a" << 1 << "b" << "q" << "c" << BSON( "x" << 2 )
+                                    << "d" << 4 << "e" << 5 );
+                Document document = fromBson( obj );
+
+                ASSERT_EQUALS( Value(4), document["d"] );
+                ASSERT_EQUALS( Value(2), document.getNestedField(FieldPath("c.x")) );
+                ASSERT( document["z"].missing() );
+                ASSERT_EQUALS( "a", getNthField(document, 0).first.toString() );
+                ASSERT_EQUALS( "e", getNthField(document, 4).first.toString() );
+                ASSERT_EQUALS( 5U, document.size() );
+
+                // An unmodified Document gives back the BSON it was created from.
+                ASSERT_EQUALS( obj.objdata(), document.toBson().objdata() );
+                assertRoundTrips( document );
+            }
+        };
+
+        /** Modifying a partially converted Document keeps the original field order. */
+        class LazyModify {
+        public:
+            void run() {
+                BSONObj obj = BSON( "a" << 1 << "b" << 2 << "c" << 3 );
+                const Document document = fromBson( obj );
+                ASSERT_EQUALS( Value(1), document["a"] );
+
+                // Copy-on-write from a shared Document.
+                MutableDocument md (document);
+                md["d"] = Value(4);
+                md["b"] = Value(20);
+                ASSERT_EQUALS( DOC( "a" << 1 << "b" << 20 << "c" << 3 << "d" << 4 ), md.freeze() );
+                ASSERT_EQUALS( obj, document.toBson() );
+
+                // In-place modification once the Document is no longer shared.
+                MutableDocument unshared (fromBson( obj ));
+                unshared.addField( "z", Value(26) );
+                ASSERT_EQUALS( Value(3), unshared.peek()["c"] );
+                ASSERT_EQUALS( DOC( "a" << 1 << "b" << 2 << "c" << 3 << "z" << 26 ),
+                               unshared.peek() );
+                ASSERT_EQUALS( BSON( "a" << 1 << "b" << 2 << "c" << 3 << "z" << 26 ),
+                               unshared.peek().toBson() );
+            }
+        };
+
+        /** Metadata fields are split out of a lazily converted Document. */
+        class LazyMetaData {
+        public:
+            void run() {
+                Document document = Document::fromBsonWithMetaData(
+                        BSON( "a" << 1 << "$textScore" << 2.5 << "b" << 2 ) );
+                ASSERT( document.hasTextScore() );
+                ASSERT_EQUALS( 2.5, document.getTextScore() );
+                ASSERT_EQUALS( Value(2), document["b"] );
+                ASSERT( document["$textScore"].missing() );
+                ASSERT_EQUALS( 2U, document.size() );
+                ASSERT_EQUALS( BSON( "a" << 1 << "b" << 2 ), document.toBson() );
+                ASSERT_EQUALS( BSON( "a" << 1 << "b" << 2 << "$textScore" << 2.5 ),
+                               document.toBsonWithMetaData() );
+            }
+        };
+
         /** Add Document fields. */
         class AddField {
         public:
@@ -1421,6 +1485,9 @@ namespace DocumentTests {
         void setupTests() {
             add<Document::Create>();
             add<Document::CreateFromBsonObj>();
+            add<Document::LazyFieldLookup>();
+            add<Document::LazyModify>();
+            add<Document::LazyMetaData>();
             add<Document::AddField>();
             add<Document::GetValue>();
             add<Document::SetField>();
@@ -181,6 +181,11 @@ namespace {
                                    | QueryPlannerParams::INCLUDE_SHARD_FILTER
                                    | QueryPlannerParams::NO_BLOCKING_SORT
                                    ;
+        // Collection scans are split across threads under the same conditions as for finds.
+        const auto parallelScanOptions = [txn, &pExpCtx](const CanonicalQuery& cq) -> size_t {
+            return canScanInParallel(txn, pExpCtx->ns, cq) ?
+                QueryPlannerParams::PARALLEL_COLLSCAN : 0;
+        };
         boost::shared_ptr<PlanExecutor> exec;
         bool sortInRunner = false;
 
@@ -202,7 +207,8 @@ namespace {
                                              cq,
                                              PlanExecutor::YIELD_AUTO,
                                              &rawExec,
-                                             runnerOptions).isOK()) {
+                                             parallelScanOptions(*cq) | runnerOptions)
+                                     .isOK()) {
                 // success: The PlanExecutor will handle sorting for us using an index.
                 exec.reset(rawExec);
                 sortInRunner = true;
@@ -232,7 +238,7 @@ namespace {
                                         cq,
                                         PlanExecutor::YIELD_AUTO,
                                         &rawExec,
-                                        runnerOptions));
+                                        parallelScanOptions(*cq) | runnerOptions));
             exec.reset(rawExec);
         }
 
@@ -42,8 +42,11 @@
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
 #include "mongo/db/stats/timer_stats.h"
 #include "mongo/db/storage/mmap_v1/mmap.h"
+#include "mongo/db/storage/snapshot.h"
+#include "mongo/db/storage/storage_engine.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -151,6 +154,66 @@ namespace {
             }
         }
     }
+
+    // Engines other than MMAP V1 have no pages to fault in directly, but reading through their
+    // cursors brings what is read into their cache. An update or delete looks its document up by
+    // _id and then removes the document's current keys from every index, so that is what is read
+    // here, with the keys taken from the stored document rather than from the op, which only
+    // carries the _id.
+    void prefetchDocumentAndIndexPages(OperationContext* txn,
+                                       Collection* collection,
+                                       const BackgroundSync::IndexPrefetchConfig& prefetchConfig,
+                                       const BSONObj& obj) {
+        if (prefetchConfig == BackgroundSync::PREFETCH_NONE) {
+            return;
+        }
+
+        BSONElement id = obj["_id"];
+        IndexCatalog* indexCatalog = collection->getIndexCatalog();
+        IndexDescriptor* idDesc = indexCatalog->findIdIndex(txn);
+        if (id.eoo() || !idDesc) {
+            return;
+        }
+
+        try {
+            RecordId loc;
+            {
+                TimerHolder timer(&prefetchIndexStats);
+                loc = indexCatalog->getIndex(idDesc)->findSingle(txn, id.wrap());
+            }
+            if (loc.isNull()) {
+                return;
+            }
+
+            Snapshotted<BSONObj> doc;
+            {
+                TimerHolder timer(&prefetchDocStats);
+                if (!collection->findDoc(txn, loc, &doc)) {
+                    return;
+                }
+            }
+
+            if (prefetchConfig != BackgroundSync::PREFETCH_ALL) {
+                return;
+            }
+
+            IndexCatalog::IndexIterator ii = indexCatalog->getIndexIterator(txn, true);
+            while (ii.more()) {
+                IndexDescriptor* desc = ii.next();
+                if (desc->isIdIndex()) {
+                    continue;
+                }
+                TimerHolder timer(&prefetchIndexStats);
+                IndexAccessMethod* iam = indexCatalog->getIndex(desc);
+                invariant(iam);
+                iam->touch(txn, doc.value());
+            }
+        }
+        catch (const DBException& e) {
+            LOG(2) << "ignoring exception in prefetchDocumentAndIndexPages(): " << e.what()
+                   << endl;
+        }
+    }
 } // namespace
 
     // prefetch for an oplog operation
@@ -178,9 +241,25 @@ namespace {
         BSONObj obj = op.getObjectField(opField);
         const char *ns = op.getStringField("ns");
 
-        // This will have to change for engines other than MMAP V1, because they might not have
-        // means for directly prefetching pages from the collection. For this purpose, acquire S
-        // lock on the database, instead of optimizing with IS.
+        if (!getGlobalServiceContext()->getGlobalStorageEngine()->isMmapV1()) {
+            // The caller's intent lock is enough here, as nothing is read outside of the engine's
+            // own cursors. Inserts only add keys, so there is nothing of theirs to read ahead.
+            if (*opType == 'i') {
+                return;
+            }
+
+            Collection* collection = db->getCollection(ns);
+            if (!collection || collection->isCapped()) {
+                return;
+            }
+
+            LOG(4) << "document and index prefetch for op " << *opType << endl;
+            prefetchDocumentAndIndexPages(txn, collection, prefetchConfig, obj);
+            return;
+        }
+
+        // MMAP V1 touches the collection's pages directly, so acquire S lock on the collection,
+        // instead of optimizing with IS.
         Lock::CollectionLock collLock(txn->lockState(), ns, MODE_S);
 
         Collection* collection = db->getCollection( ns );
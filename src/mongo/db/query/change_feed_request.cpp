@@ -0,0 +1,346 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/change_feed_request.h"
+
+#include <cctype>
+
+#include "mongo/db/namespace_string.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+namespace {
+
+    const char kSubscriptionsField[] = "subscriptions";
+    const char kResumeAfterField[] = "resumeAfter";
+
+    bool isCrudOp(const std::string& op) {
+        return op == "i" || op == "u" || op == "d";
+    }
+
+    bool isValidOp(const std::string& op) {
+        return isCrudOp(op) || op == "c" || op == "n";
+    }
+
+    std::string escapeRegex(const std::string& str) {
+        std::string escaped;
+        for (char c : str) {
+            if (!isalnum(static_cast<unsigned char>(c)) && c != '_') {
+                escaped += '\\';
+            }
+            escaped += c;
+        }
+        return escaped;
+    }
+
+    /**
+     * Parses 'el' into 'subscription' if it is one of the fields describing a subscription.
+     * Returns false if it is not.
+     */
+    StatusWith<bool> parseSubscriptionField(const BSONElement& el,
+                                            ChangeFeedRequest::Subscription* subscription) {
+        const char* fieldName = el.fieldName();
+        if (str::equals(fieldName, "ns")) {
+            std::vector<BSONElement> namespaces;
+            if (el.type() == String) {
+                namespaces.push_back(el);
+            }
+            else if (el.type() == Array) {
+                namespaces = el.Array();
+            }
+            else {
+                return {ErrorCodes::TypeMismatch,
+                        "Field 'ns' must be a string or an array of strings"};
+            }
+
+            for (const BSONElement& nsElt : namespaces) {
+                if (nsElt.type() != String) {
+                    return {ErrorCodes::TypeMismatch, "Field 'ns' must only contain strings"};
+                }
+                const std::string ns = nsElt.String();
+                const bool valid = ns.find('.') == std::string::npos ?
+                    NamespaceString::validDBName(ns) : NamespaceString(ns).isValid();
+                if (!valid) {
+                    return {ErrorCodes::InvalidNamespace,
+                            str::stream() << "Invalid namespace or database name: " << ns};
+                }
+                subscription->namespaces.push_back(ns);
+            }
+        }
+        else if (str::equals(fieldName, "ops")) {
+            if (el.type() != Array) {
+                return {ErrorCodes::TypeMismatch, "Field 'ops' must be an array of strings"};
+            }
+
+            for (const BSONElement& opElt : el.Obj()) {
+                if (opElt.type() != String || !isValidOp(opElt.String())) {
+                    return {ErrorCodes::BadValue,
+                            str::stream() << "Field 'ops' may only contain \"i\", \"u\", \"d\", "
+                                          << "\"c\" and \"n\", but found " << opElt};
+                }
+                subscription->ops.push_back(opElt.String());
+            }
+
+            if (subscription->ops.empty()) {
+                return {ErrorCodes::BadValue, "Field 'ops' must not be empty"};
+            }
+        }
+        else if (str::equals(fieldName, "filter")) {
+            if (el.type() != Object) {
+                return {ErrorCodes::TypeMismatch, "Field 'filter' must be an object"};
+            }
+            subscription->filter = el.Obj().getOwned();
+        }
+        else if (str::equals(fieldName, "fields")) {
+            if (el.type() != Object) {
+                return {ErrorCodes::TypeMismatch, "Field 'fields' must be an object"};
+            }
+            subscription->fields = el.Obj().getOwned();
+        }
+        else {
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * Fills in the operation types of 'subscription' if they were left out, and checks that
+     * they agree with its filter.
+     */
+    Status finishSubscription(ChangeFeedRequest::Subscription* subscription) {
+        if (subscription->ops.empty()) {
+            subscription->ops = {"i", "u", "d"};
+            if (subscription->filter.isEmpty()) {
+                subscription->ops.push_back("c");
+            }
+        }
+
+        if (!subscription->filter.isEmpty()) {
+            for (const std::string& op : subscription->ops) {
+                if (!isCrudOp(op)) {
+                    return Status(ErrorCodes::BadValue,
+                                  str::stream() << "Field 'filter' only applies to the \"i\", "
+                                                << "\"u\" and \"d\" ops, but 'ops' contains \""
+                                                << op << "\"");
+                }
+            }
+        }
+
+        return Status::OK();
+    }
+
+} // namespace
+
+    BSONObj ChangeFeedRequest::Subscription::toEntryFilter() const {
+        BSONObjBuilder filterBuilder;
+        if (!namespaces.empty()) {
+            std::vector<std::string> exactNamespaces;
+            BSONArrayBuilder nsBuilder(filterBuilder.subarrayStart("$or"));
+            for (const std::string& ns : namespaces) {
+                if (ns.find('.') == std::string::npos) {
+                    nsBuilder.append(BSON("ns" << BSONRegEx("^" + escapeRegex(ns) + "\\.")));
+                }
+                else {
+                    exactNamespaces.push_back(ns);
+                }
+            }
+            if (!exactNamespaces.empty()) {
+                nsBuilder.append(BSON("ns" << BSON("$in" << exactNamespaces)));
+            }
+            nsBuilder.doneFast();
+        }
+        filterBuilder.append("op", BSON("$in" << ops));
+        return filterBuilder.obj();
+    }
+
+    BSONObj ChangeFeedRequest::toOplogFilter(const Timestamp& after) const {
+        BSONObjBuilder filterBuilder;
+        filterBuilder.append("ts", BSON((resumeAfterSubscription ? "$gte" : "$gt") << after));
+        BSONArrayBuilder subscriptionsBuilder(filterBuilder.subarrayStart("$or"));
+        for (const Subscription& subscription : subscriptions) {
+            subscriptionsBuilder.append(subscription.toEntryFilter());
+        }
+        subscriptionsBuilder.doneFast();
+        return filterBuilder.obj();
+    }
+
+    // static
+    StatusWith<ChangeFeedRequest> ChangeFeedRequest::parseFromBSON(const BSONObj& cmdObj) {
+        ChangeFeedRequest request;
+        Subscription unnamedSubscription;
+        bool hasUnnamedSubscription = false;
+        bool hasSubscriptions = false;
+
+        for (BSONElement el : cmdObj) {
+            const char* fieldName = el.fieldName();
+            if (str::equals(fieldName, "changeFeed")) {
+                continue;
+            }
+            else if (str::equals(fieldName, kSubscriptionsField)) {
+                if (el.type() != Array) {
+                    return {ErrorCodes::TypeMismatch,
+                            str::stream() << "Field '" << kSubscriptionsField
+                                          << "' must be an array in: " << cmdObj};
+                }
+
+                hasSubscriptions = true;
+                for (const BSONElement& subscriptionElt : el.Obj()) {
+                    if (subscriptionElt.type() != Object) {
+                        return {ErrorCodes::TypeMismatch,
+                                str::stream() << "Each subscription must be an object in: "
+                                              << cmdObj};
+                    }
+
+                    Subscription subscription;
+                    for (const BSONElement& subscriptionField : subscriptionElt.Obj()) {
+                        if (str::equals(subscriptionField.fieldName(), "name")) {
+                            if (subscriptionField.type() != String ||
+                                subscriptionField.valuestrsize() <= 1) {
+                                return {ErrorCodes::BadValue,
+                                        str::stream() << "Subscription names must be non-empty "
+                                                      << "strings in: " << cmdObj};
+                            }
+                            subscription.name = subscriptionField.String();
+                            continue;
+                        }
+
+                        StatusWith<bool> parsed =
+                            parseSubscriptionField(subscriptionField, &subscription);
+                        if (!parsed.isOK()) {
+                            return parsed.getStatus();
+                        }
+                        if (!parsed.getValue()) {
+                            return {ErrorCodes::FailedToParse,
+                                    str::stream() << "Failed to parse: " << cmdObj << ". "
+                                                  << "Unrecognized subscription field '"
+                                                  << subscriptionField.fieldName() << "'."};
+                        }
+                    }
+
+                    if (subscription.name.empty()) {
+                        return {ErrorCodes::FailedToParse,
+                                str::stream() << "Each subscription must have a name in: "
+                                              << cmdObj};
+                    }
+                    for (const Subscription& other : request.subscriptions) {
+                        if (other.name == subscription.name) {
+                            return {ErrorCodes::BadValue,
+                                    str::stream() << "Duplicate subscription name '"
+                                                  << subscription.name << "' in: " << cmdObj};
+                        }
+                    }
+
+                    Status status = finishSubscription(&subscription);
+                    if (!status.isOK()) {
+                        return status;
+                    }
+                    request.subscriptions.push_back(subscription);
+                }
+
+                if (request.subscriptions.empty()) {
+                    return {ErrorCodes::BadValue,
+                            str::stream() << "Field '" << kSubscriptionsField
+                                          << "' must not be empty in: " << cmdObj};
+                }
+            }
+            else if (str::equals(fieldName, kResumeAfterField)) {
+                if (el.type() != Object || el.Obj()["ts"].type() != bsonTimestamp) {
+                    return {ErrorCodes::TypeMismatch,
+                            str::stream() << "Field '" << kResumeAfterField << "' must be the "
+                                          << "_id of an entry returned by changeFeed in: "
+                                          << cmdObj};
+                }
+                request.resumeAfter = el.Obj()["ts"].timestamp();
+
+                const BSONElement subscriptionElt = el.Obj()["s"];
+                if (!subscriptionElt.eoo()) {
+                    if (!subscriptionElt.isNumber() || subscriptionElt.numberInt() < 0) {
+                        return {ErrorCodes::TypeMismatch,
+                                str::stream() << "Field '" << kResumeAfterField << "' must be "
+                                              << "the _id of an entry returned by changeFeed "
+                                              << "in: " << cmdObj};
+                    }
+                    request.resumeAfterSubscription = subscriptionElt.numberInt();
+                }
+            }
+            else if (str::equals(fieldName, "batchSize")) {
+                if (!el.isNumber()) {
+                    return {ErrorCodes::TypeMismatch,
+                            str::stream() << "Field 'batchSize' must be a number in: " << cmdObj};
+                }
+                if (el.numberInt() < 0) {
+                    return {ErrorCodes::BadValue,
+                            str::stream() << "Field 'batchSize' must not be negative in: "
+                                          << cmdObj};
+                }
+                request.batchSize = el.numberInt();
+            }
+            else if (str::equals(fieldName, "maxTimeMS")) {
+                // maxTimeMS is parsed by the command handling code, so we don't repeat the parsing
+                // here.
+                continue;
+            }
+            else if (str::startsWith(fieldName, "$")) {
+                continue;
+            }
+            else {
+                StatusWith<bool> parsed = parseSubscriptionField(el, &unnamedSubscription);
+                if (!parsed.isOK()) {
+                    return parsed.getStatus();
+                }
+                if (!parsed.getValue()) {
+                    return {ErrorCodes::FailedToParse,
+                            str::stream() << "Failed to parse: " << cmdObj << ". "
+                                          << "Unrecognized field '" << fieldName << "'."};
+                }
+                hasUnnamedSubscription = true;
+            }
+        }
+
+        if (hasSubscriptions && hasUnnamedSubscription) {
+            return {ErrorCodes::FailedToParse,
+                    str::stream() << "Subscription fields must be given inside '"
+                                  << kSubscriptionsField << "' when it is present in: " << cmdObj};
+        }
+
+        if (!hasSubscriptions) {
+            Status status = finishSubscription(&unnamedSubscription);
+            if (!status.isOK()) {
+                return status;
+            }
+            request.subscriptions.push_back(unnamedSubscription);
+        }
+
+        return request;
+    }
+
+} // namespace mongo
@@ -0,0 +1,110 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <string>
+#include <vector>
+
+#include "mongo/base/status_with.h"
+#include "mongo/bson/timestamp.h"
+#include "mongo/db/jsobj.h"
+
+namespace mongo {
+
+    /**
+     * A parsed changeFeed command, which tails the oplog on behalf of one or more subscriptions
+     * and returns the entries each of them selects, filtered and projected on the server.
+     *
+     * The command either lists its subscriptions,
+     *     {changeFeed: 1, subscriptions: [{name: <string>, <subscription>}, ...], <options>}
+     * or is itself a single, unnamed, subscription,
+     *     {changeFeed: 1, <subscription>, <options>}
+     * where <subscription> is any of
+     *     ns: <string or array of strings>  full namespaces, or database names for all of their
+     *                                       collections; all namespaces if left out
+     *     ops: <array of strings>           oplog entry types out of "i", "u", "d", "c" and "n";
+     *                                       ["i", "u", "d", "c"] if left out
+     *     filter: <query>                   matched against the document of inserts, updates and
+     *                                       deletes, which are the only entries it lets through
+     *     fields: <projection>              applied to the document of inserts, updates and deletes
+     * and <options> are any of
+     *     resumeAfter: {ts: <Timestamp>, t: <long>, s: <int>}  the _id of the last event seen;
+     *                                                          the feed starts at the end of the
+     *                                                          oplog if left out
+     *     batchSize: <int>
+     *     maxTimeMS: <int>
+     */
+    struct ChangeFeedRequest {
+        struct Subscription {
+            /**
+             * Returns a predicate over oplog entries selecting the namespaces and operation types
+             * of this subscription.
+             */
+            BSONObj toEntryFilter() const;
+
+            // Empty for the unnamed subscription.
+            std::string name;
+
+            // Full namespaces, or database names.
+            std::vector<std::string> namespaces;
+
+            std::vector<std::string> ops;
+
+            BSONObj filter;
+
+            BSONObj fields;
+        };
+
+        /**
+         * Construct a ChangeFeedRequest from the command specification.
+         */
+        static StatusWith<ChangeFeedRequest> parseFromBSON(const BSONObj& cmdObj);
+
+        /**
+         * Returns a predicate over oplog entries selecting those after 'after' which may be
+         * returned to any of the subscriptions. The entry at 'after' is selected as well when
+         * the resume token leaves some of its events to be returned.
+         */
+        BSONObj toOplogFilter(const Timestamp& after) const;
+
+        std::vector<Subscription> subscriptions;
+
+        // The timestamp of the resume token, if any.
+        boost::optional<Timestamp> resumeAfter;
+
+        // The position of the subscription the resume token was returned to. The events of the
+        // same entry for the subscriptions after it are returned again. Tokens without one skip
+        // their whole entry.
+        boost::optional<int> resumeAfterSubscription;
+
+        boost::optional<int> batchSize;
+    };
+
+} // namespace mongo
@@ -0,0 +1,176 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/query/change_feed_request.h"
+#include "mongo/unittest/unittest.h"
+
+namespace {
+
+    using namespace mongo;
+
+    TEST(ChangeFeedRequestTest, parseFromBSONUnnamedSubscriptionDefaults) {
+        StatusWith<ChangeFeedRequest> result =
+            ChangeFeedRequest::parseFromBSON(BSON("changeFeed" << 1));
+        ASSERT_OK(result.getStatus());
+        const ChangeFeedRequest& request = result.getValue();
+        ASSERT_FALSE(request.resumeAfter);
+        ASSERT_FALSE(request.batchSize);
+        ASSERT_EQUALS(1U, request.subscriptions.size());
+        ASSERT_EQUALS("", request.subscriptions[0].name);
+        ASSERT_TRUE(request.subscriptions[0].namespaces.empty());
+        ASSERT_EQUALS(BSON("op" << BSON("$in" << BSON_ARRAY("i" << "u" << "d" << "c"))),
+                      request.subscriptions[0].toEntryFilter());
+    }
+
+    TEST(ChangeFeedRequestTest, parseFromBSONUnnamedSubscription) {
+        StatusWith<ChangeFeedRequest> result = ChangeFeedRequest::parseFromBSON(
+            BSON("changeFeed" << 1 <<
+                 "ns" << BSON_ARRAY("test.a" << "other") <<
+                 "ops" << BSON_ARRAY("i" << "d") <<
+                 "filter" << BSON("x" << 1) <<
+                 "fields" << BSON("y" << 1) <<
+                 "resumeAfter" << BSON("ts" << Timestamp(5, 1) << "t" << 1LL << "s" << 0) <<
+                 "batchSize" << 10 <<
+                 "maxTimeMS" << 1000));
+        ASSERT_OK(result.getStatus());
+        const ChangeFeedRequest& request = result.getValue();
+        ASSERT_EQUALS(Timestamp(5, 1), *request.resumeAfter);
+        ASSERT_EQUALS(0, *request.resumeAfterSubscription);
+        ASSERT_EQUALS(10, *request.batchSize);
+        ASSERT_EQUALS(1U, request.subscriptions.size());
+        const ChangeFeedRequest::Subscription& subscription = request.subscriptions[0];
+        ASSERT_EQUALS(BSON("x" << 1), subscription.filter);
+        ASSERT_EQUALS(BSON("y" << 1), subscription.fields);
+        ASSERT_EQUALS(BSON("$or" << BSON_ARRAY(BSON("ns" << BSONRegEx("^other\\.")) <<
+                                               BSON("ns" << BSON("$in" << BSON_ARRAY("test.a")))) <<
+                           "op" << BSON("$in" << BSON_ARRAY("i" << "d"))),
+                      subscription.toEntryFilter());
+    }
+
+    TEST(ChangeFeedRequestTest, parseFromBSONFilterDefaultsToCrudOps) {
+        StatusWith<ChangeFeedRequest> result = ChangeFeedRequest::parseFromBSON(
+            BSON("changeFeed" << 1 << "filter" << BSON("x" << 1)));
+        ASSERT_OK(result.getStatus());
+        ASSERT_EQUALS(BSON("op" << BSON("$in" << BSON_ARRAY("i" << "u" << "d"))),
+                      result.getValue().subscriptions[0].toEntryFilter());
+    }
+
+    TEST(ChangeFeedRequestTest, parseFromBSONFilterWithCommandOps) {
+        StatusWith<ChangeFeedRequest> result = ChangeFeedRequest::parseFromBSON(
+            BSON("changeFeed" << 1 <<
+                 "filter" << BSON("x" << 1) <<
+                 "ops" << BSON_ARRAY("i" << "c")));
+        ASSERT_EQUALS(ErrorCodes::BadValue, result.getStatus().code());
+    }
+
+    TEST(ChangeFeedRequestTest, parseFromBSONNamedSubscriptions) {
+        StatusWith<ChangeFeedRequest> result = ChangeFeedRequest::parseFromBSON(
+            BSON("changeFeed" << 1 <<
+                 "subscriptions" << BSON_ARRAY(BSON("name" << "a" << "ns" << "test.a") <<
+                                               BSON("name" << "b" << "ops" << BSON_ARRAY("c")))));
+        ASSERT_OK(result.getStatus());
+        const ChangeFeedRequest& request = result.getValue();
+        ASSERT_EQUALS(2U, request.subscriptions.size());
+        ASSERT_EQUALS("a", request.subscriptions[0].name);
+        ASSERT_EQUALS("b", request.subscriptions[1].name);
+        ASSERT_EQUALS(BSON("ts" << BSON("$gt" << Timestamp(1, 0)) <<
+                           "$or" << BSON_ARRAY(request.subscriptions[0].toEntryFilter() <<
+                                               request.subscriptions[1].toEntryFilter())),
+                      request.toOplogFilter(Timestamp(1, 0)));
+    }
+
+    TEST(ChangeFeedRequestTest, parseFromBSONSubscriptionWithoutName) {
+        StatusWith<ChangeFeedRequest> result = ChangeFeedRequest::parseFromBSON(
+            BSON("changeFeed" << 1 <<
+                 "subscriptions" << BSON_ARRAY(BSON("ns" << "test.a"))));
+        ASSERT_EQUALS(ErrorCodes::FailedToParse, result.getStatus().code());
+    }
+
+    TEST(ChangeFeedRequestTest, parseFromBSONDuplicateSubscriptionNames) {
+        StatusWith<ChangeFeedRequest> result = ChangeFeedRequest::parseFromBSON(
+            BSON("changeFeed" << 1 <<
+                 "subscriptions" << BSON_ARRAY(BSON("name" << "a") << BSON("name" << "a"))));
+        ASSERT_EQUALS(ErrorCodes::BadValue, result.getStatus().code());
+    }
+
+    TEST(ChangeFeedRequestTest, parseFromBSONMixedSubscriptionForms) {
+        StatusWith<ChangeFeedRequest> result = ChangeFeedRequest::parseFromBSON(
+            BSON("changeFeed" << 1 <<
+                 "ns" << "test.a" <<
+                 "subscriptions" << BSON_ARRAY(BSON("name" << "a"))));
+        ASSERT_EQUALS(ErrorCodes::FailedToParse, result.getStatus().code());
+    }
+
+    TEST(ChangeFeedRequestTest, parseFromBSONInvalidOp) {
+        StatusWith<ChangeFeedRequest> result = ChangeFeedRequest::parseFromBSON(
+            BSON("changeFeed" << 1 << "ops" << BSON_ARRAY("x")));
+        ASSERT_EQUALS(ErrorCodes::BadValue, result.getStatus().code());
+    }
+
+    TEST(ChangeFeedRequestTest, parseFromBSONInvalidNamespace) {
+        StatusWith<ChangeFeedRequest> result = ChangeFeedRequest::parseFromBSON(
+            BSON("changeFeed" << 1 << "ns" << "test."));
+        ASSERT_EQUALS(ErrorCodes::InvalidNamespace, result.getStatus().code());
+    }
+
+    TEST(ChangeFeedRequestTest, parseFromBSONResumeAfterNotAToken) {
+        StatusWith<ChangeFeedRequest> result = ChangeFeedRequest::parseFromBSON(
+            BSON("changeFeed" << 1 << "resumeAfter" << BSON("ts" << 5)));
+        ASSERT_EQUALS(ErrorCodes::TypeMismatch, result.getStatus().code());
+    }
+
+    TEST(ChangeFeedRequestTest, parseFromBSONResumeAfterBadSubscription) {
+        StatusWith<ChangeFeedRequest> result = ChangeFeedRequest::parseFromBSON(
+            BSON("changeFeed" << 1 <<
+                 "resumeAfter" << BSON("ts" << Timestamp(5, 1) << "s" << -1)));
+        ASSERT_EQUALS(ErrorCodes::TypeMismatch, result.getStatus().code());
+    }
+
+    TEST(ChangeFeedRequestTest, toOplogFilterIncludesPartlySeenEntry) {
+        StatusWith<ChangeFeedRequest> result = ChangeFeedRequest::parseFromBSON(
+            BSON("changeFeed" << 1 << "resumeAfter" << BSON("ts" << Timestamp(5, 1))));
+        ASSERT_OK(result.getStatus());
+        ChangeFeedRequest request = result.getValue();
+        ASSERT_EQUALS(BSON("$gt" << Timestamp(5, 1)),
+                      request.toOplogFilter(Timestamp(5, 1))["ts"].Obj());
+
+        request.resumeAfterSubscription = 0;
+        ASSERT_EQUALS(BSON("$gte" << Timestamp(5, 1)),
+                      request.toOplogFilter(Timestamp(5, 1))["ts"].Obj());
+    }
+
+    TEST(ChangeFeedRequestTest, parseFromBSONUnrecognizedField) {
+        StatusWith<ChangeFeedRequest> result = ChangeFeedRequest::parseFromBSON(
+            BSON("changeFeed" << 1 << "foo" << 1));
+        ASSERT_EQUALS(ErrorCodes::FailedToParse, result.getStatus().code());
+    }
+
+} // namespace
@@ -155,6 +155,11 @@ namespace {
             const CollectionScanStats* spec = static_cast<const CollectionScanStats*>(specific);
             return spec->docsTested;
         }
+        else if (STAGE_PARALLEL_COLLSCAN == type) {
+            const ParallelCollectionScanStats* spec =
+                static_cast<const ParallelCollectionScanStats*>(specific);
+            return spec->docsTested;
+        }
 
         return 0;
     }
@@ -371,6 +376,29 @@ namespace mongo {
                 bob->appendNumber("locsForgotten", spec->locsForgotten);
             }
         }
+        else if (STAGE_PARALLEL_COLLSCAN == stats.stageType) {
+            ParallelCollectionScanStats* spec =
+                static_cast<ParallelCollectionScanStats*>(stats.specific.get());
+
+            if (verbosity >= ExplainCommon::EXEC_STATS) {
+                bob->appendNumber("docsExamined", spec->docsTested);
+
+                BSONArrayBuilder workersBob(bob->subarrayStart("workers"));
+                for (size_t i = 0; i < spec->workers.size(); ++i) {
+                    BSONObjBuilder workerBob(workersBob.subobjStart());
+                    workerBob.appendNumber("works", spec->workers[i].works);
+                    workerBob.appendNumber("advanced", spec->workers[i].advanced);
+                }
+            }
+        }
+        else if (STAGE_CHANGE_FEED == stats.stageType) {
+            ChangeFeedStats* spec = static_cast<ChangeFeedStats*>(stats.specific.get());
+
+            if (verbosity >= ExplainCommon::EXEC_STATS) {
+                bob->appendNumber("entriesExamined", spec->entriesExamined);
+                bob->appendNumber("eventsReturned", spec->eventsReturned);
+            }
+        }
         else if (STAGE_LIMIT == stats.stageType) {
             LimitStats* spec = static_cast<LimitStats*>(stats.specific.get());
             bob->appendNumber("limitAmount", spec->limit);
@@ -397,6 +425,7 @@ namespace mongo {
             if (verbosity >= ExplainCommon::EXEC_STATS) {
                 bob->appendNumber("memUsage", spec->memUsage);
                 bob->appendNumber("memLimit", spec->memLimit);
+                bob->appendBool("usedDisk", spec->usedDisk);
             }
 
             if (spec->limit > 0) {
@@ -39,6 +39,7 @@
 #include "mongo/base/parse_number.h"
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/db/exec/cached_plan.h"
+#include "mongo/db/exec/change_feed.h"
 #include "mongo/db/exec/count.h"
 #include "mongo/db/exec/delete.h"
 #include "mongo/db/exec/eof.h"
@@ -268,7 +269,8 @@ namespace mongo {
                 // Might have to filter out orphaned docs.
                 if (plannerParams.options & QueryPlannerParams::INCLUDE_SHARD_FILTER) {
                     *rootOut =
-                        new ShardFilterStage(shardingState.getCollectionMetadata(collection->ns()),
+                        new ShardFilterStage(collection->ns().ns(),
+                                             shardingState.getCollectionMetadata(collection->ns()),
                                              ws, *rootOut);
                 }
 
@@ -497,8 +499,9 @@ namespace mongo {
 
         // Might have to filter out orphaned docs.
         if (plannerOptions & QueryPlannerParams::INCLUDE_SHARD_FILTER) {
-            root = new ShardFilterStage(shardingState.getCollectionMetadata(collection->ns()), ws,
-                                        root);
+            root = new ShardFilterStage(collection->ns().ns(),
+                                        shardingState.getCollectionMetadata(collection->ns()),
+                                        ws, root);
         }
 
         return PlanExecutor::make(txn, ws, root, collection, yieldPolicy, out);
@@ -528,89 +531,112 @@ namespace {
         return static_cast<const mongo::ComparisonMatchExpression*>(me)->getData();
     }
 
-    Status getOplogStartHack(OperationContext* txn,
-                             Collection* collection,
-                             CanonicalQuery* cq,
-                             PlanExecutor** execOut) {
-        invariant(collection);
-        invariant(cq);
-        auto_ptr<CanonicalQuery> autoCq(cq);
-
-        // A query can only do oplog start finding if it has a top-level $gt or $gte predicate over
-        // the "ts" field (the operation's timestamp). Find that predicate and pass it to
-        // the OplogStart stage.
-        MatchExpression* tsExpr = NULL;
+    /**
+     * Finds the top-level $gt or $gte predicate over the "ts" field of an oplog query, the
+     * operation's timestamp, or returns NULL if there is none.
+     */
+    MatchExpression* findOplogTsPred(CanonicalQuery* cq) {
         if (MatchExpression::AND == cq->root()->matchType()) {
             // The query has an AND at the top-level. See if any of the children
             // of the AND are $gt or $gte predicates over 'ts'.
             for (size_t i = 0; i < cq->root()->numChildren(); ++i) {
                 MatchExpression* me = cq->root()->getChild(i);
                 if (isOplogTsPred(me)) {
-                    tsExpr = me;
-                    break;
+                    return me;
                 }
             }
         }
         else if (isOplogTsPred(cq->root())) {
             // The root of the tree is a $gt or $gte predicate over 'ts'.
-            tsExpr = cq->root();
+            return cq->root();
         }
+        return NULL;
+    }
 
-        if (NULL == tsExpr) {
-            return Status(ErrorCodes::OplogOperationUnsupported,
-                          "OplogReplay query does not contain top-level "
-                          "$gt or $gte over the 'ts' field.");
-        }
-
-        boost::optional<RecordId> startLoc = boost::none;
-
+    /**
+     * Returns where a scan of the oplog for the entries matching 'tsExpr' should start, or a null
+     * RecordId if that is the beginning of the oplog.
+     */
+    StatusWith<RecordId> findOplogStart(OperationContext* txn,
+                                        Collection* collection,
+                                        MatchExpression* tsExpr) {
         // See if the RecordStore supports the oplogStartHack
         const BSONElement tsElem = extractOplogTsOptime(tsExpr);
         if (tsElem.type() == bsonTimestamp) {
             StatusWith<RecordId> goal = oploghack::keyForOptime(tsElem.timestamp());
             if (goal.isOK()) {
-                startLoc = collection->getRecordStore()->oplogStartHack(txn, goal.getValue());
+                boost::optional<RecordId> startLoc =
+                    collection->getRecordStore()->oplogStartHack(txn, goal.getValue());
+                if (startLoc) {
+                    LOG(3) << "Using direct oplog seek";
+                    return *startLoc;
+                }
             }
         }
 
-        if (startLoc) {
-            LOG(3) << "Using direct oplog seek";
+        LOG(3) << "Using OplogStart stage";
+
+        // Fallback to trying the OplogStart stage.
+        WorkingSet* oplogws = new WorkingSet();
+        OplogStart* stage = new OplogStart(txn, collection, tsExpr, oplogws);
+        PlanExecutor* rawExec;
+
+        // Takes ownership of oplogws and stage.
+        Status execStatus = PlanExecutor::make(txn, oplogws, stage, collection,
+                                               PlanExecutor::YIELD_AUTO, &rawExec);
+        invariant(execStatus.isOK());
+        std::unique_ptr<PlanExecutor> exec(rawExec);
+
+        // The stage returns a RecordId of where to start.
+        RecordId startLoc;
+        PlanExecutor::ExecState state = exec->getNext(NULL, &startLoc);
+
+        // This is normal.  The start of the oplog is the beginning of the collection.
+        if (PlanExecutor::IS_EOF == state) {
+            return RecordId();
         }
-        else {
-            LOG(3) << "Using OplogStart stage";
-
-            // Fallback to trying the OplogStart stage.
-            WorkingSet* oplogws = new WorkingSet();
-            OplogStart* stage = new OplogStart(txn, collection, tsExpr, oplogws);
-            PlanExecutor* rawExec;
-
-            // Takes ownership of oplogws and stage.
-            Status execStatus = PlanExecutor::make(txn, oplogws, stage, collection,
-                                                   PlanExecutor::YIELD_AUTO, &rawExec);
-            invariant(execStatus.isOK());
-            std::unique_ptr<PlanExecutor> exec(rawExec);
-
-            // The stage returns a RecordId of where to start.
-            startLoc = RecordId();
-            PlanExecutor::ExecState state = exec->getNext(NULL, startLoc.get_ptr());
-
-            // This is normal.  The start of the oplog is the beginning of the collection.
-            if (PlanExecutor::IS_EOF == state) {
-                return getExecutor(txn, collection, autoCq.release(), PlanExecutor::YIELD_AUTO,
-                                   execOut);
-            }
 
-            // This is not normal.  An error was encountered.
-            if (PlanExecutor::ADVANCED != state) {
-                return Status(ErrorCodes::InternalError,
-                              "quick oplog start location had error...?");
-            }
+        // This is not normal.  An error was encountered.
+        if (PlanExecutor::ADVANCED != state) {
+            return Status(ErrorCodes::InternalError,
+                          "quick oplog start location had error...?");
+        }
+
+        return startLoc;
+    }
+
+    Status getOplogStartHack(OperationContext* txn,
+                             Collection* collection,
+                             CanonicalQuery* cq,
+                             PlanExecutor** execOut) {
+        invariant(collection);
+        invariant(cq);
+        auto_ptr<CanonicalQuery> autoCq(cq);
+
+        // A query can only do oplog start finding if it has a top-level $gt or $gte predicate over
+        // the "ts" field (the operation's timestamp). Find that predicate and pass it to
+        // the OplogStart stage.
+        MatchExpression* tsExpr = findOplogTsPred(cq);
+        if (NULL == tsExpr) {
+            return Status(ErrorCodes::OplogOperationUnsupported,
+                          "OplogReplay query does not contain top-level "
+                          "$gt or $gte over the 'ts' field.");
+        }
+
+        StatusWith<RecordId> startLoc = findOplogStart(txn, collection, tsExpr);
+        if (!startLoc.isOK()) {
+            return startLoc.getStatus();
+        }
+
+        if (startLoc.getValue().isNull()) {
+            return getExecutor(txn, collection, autoCq.release(), PlanExecutor::YIELD_AUTO,
+                               execOut);
         }
 
         // Build our collection scan...
         CollectionScanParams params;
         params.collection = collection;
-        params.start = *startLoc;
+        params.start = startLoc.getValue();
         params.direction = CollectionScanParams::FORWARD;
         params.tailable = cq->getParsed().isTailable();
 
@@ -621,8 +647,82 @@ namespace {
                                   PlanExecutor::YIELD_AUTO, execOut);
     }
 
+    /**
+     * Compiles the filter and projection of 'subscription' into the form used by ChangeFeedStage.
+     */
+    StatusWith<std::unique_ptr<ChangeFeedSubscription>> compileSubscription(
+            const ChangeFeedRequest::Subscription& subscription) {
+        auto compiled = stdx::make_unique<ChangeFeedSubscription>();
+        compiled->name = subscription.name;
+
+        StatusWithMatchExpression entryFilter =
+            MatchExpressionParser::parse(subscription.toEntryFilter());
+        if (!entryFilter.isOK()) {
+            return entryFilter.getStatus();
+        }
+        compiled->entryFilter.reset(entryFilter.getValue());
+
+        if (!subscription.filter.isEmpty()) {
+            StatusWithMatchExpression filter = MatchExpressionParser::parse(subscription.filter);
+            if (!filter.isOK()) {
+                return filter.getStatus();
+            }
+            compiled->filter.reset(filter.getValue());
+        }
+
+        if (!subscription.fields.isEmpty()) {
+            // The projection is validated against an empty query, as there is none to take
+            // positional matches from.
+            AndMatchExpression emptyQuery;
+            ParsedProjection* rawParsedProj;
+            Status ppStatus = ParsedProjection::make(subscription.fields, &emptyQuery,
+                                                     &rawParsedProj);
+            if (!ppStatus.isOK()) {
+                return ppStatus;
+            }
+            std::unique_ptr<ParsedProjection> pp(rawParsedProj);
+
+            if (pp->requiresMatchDetails()) {
+                return Status(ErrorCodes::BadValue,
+                              "cannot use a positional projection in a change feed");
+            }
+            BSONObjIterator it(subscription.fields);
+            while (it.more()) {
+                const BSONElement elt = it.next();
+                if (elt.type() == Object && elt.Obj().hasField("$meta")) {
+                    return Status(ErrorCodes::BadValue,
+                                  "cannot use $meta in the projection of a change feed");
+                }
+            }
+
+            compiled->projection.reset(new ProjectionExec(subscription.fields, NULL));
+        }
+
+        return std::move(compiled);
+    }
+
 } // namespace
 
+    bool canScanInParallel(OperationContext* txn,
+                           const NamespaceString& nss,
+                           const CanonicalQuery& cq) {
+        const Client* client = txn->getClient();
+        if (!client->isFromUserConnection() || client->isInDirectClient()) {
+            return false;
+        }
+
+        if (!txn->writesAreReplicated() || txn->lockState()->isBatchWriter()) {
+            return false;
+        }
+
+        if (nss.db() == "local") {
+            return false;
+        }
+
+        const LiteParsedQuery& pq = cq.getParsed();
+        return !pq.isTailable() && !pq.isExhaust() && !pq.isSnapshot();
+    }
+
     Status getExecutorFind(OperationContext* txn,
                            Collection* collection,
                            const NamespaceString& nss,
@@ -635,12 +735,66 @@ namespace {
         }
 
         size_t options = QueryPlannerParams::DEFAULT;
+        if (canScanInParallel(txn, nss, *cq)) {
+            options |= QueryPlannerParams::PARALLEL_COLLSCAN;
+        }
         if (shardingState.needCollectionMetadata(txn->getClient(), nss.ns())) {
             options |= QueryPlannerParams::INCLUDE_SHARD_FILTER;
         }
         return getExecutor(txn, collection, cq.release(), PlanExecutor::YIELD_AUTO, out, options);
     }
 
+    Status getExecutorChangeFeed(OperationContext* txn,
+                                 Collection* collection,
+                                 CanonicalQuery* rawCanonicalQuery,
+                                 const ChangeFeedRequest& request,
+                                 PlanExecutor** out) {
+        invariant(collection);
+        std::unique_ptr<CanonicalQuery> cq(rawCanonicalQuery);
+
+        std::vector<std::unique_ptr<ChangeFeedSubscription>> compiled;
+        for (const auto& subscription : request.subscriptions) {
+            auto swCompiled = compileSubscription(subscription);
+            if (!swCompiled.isOK()) {
+                return swCompiled.getStatus();
+            }
+            compiled.push_back(std::move(swCompiled.getValue()));
+        }
+
+        MatchExpression* tsExpr = findOplogTsPred(cq.get());
+        if (NULL == tsExpr) {
+            return Status(ErrorCodes::OplogOperationUnsupported,
+                          "change feed query does not contain top-level "
+                          "$gt or $gte over the 'ts' field.");
+        }
+
+        StatusWith<RecordId> startLoc = findOplogStart(txn, collection, tsExpr);
+        if (!startLoc.isOK()) {
+            return startLoc.getStatus();
+        }
+
+        // All the subscriptions share this one scan of the oplog.
+        CollectionScanParams params;
+        params.collection = collection;
+        params.start = startLoc.getValue();
+        params.direction = CollectionScanParams::FORWARD;
+        params.tailable = true;
+
+        WorkingSet* ws = new WorkingSet();
+        CollectionScan* cs = new CollectionScan(txn, params, ws, cq->root());
+        // The scan only includes the entry at the resume token if some of its events are left.
+        const Timestamp resumeAfter = request.resumeAfterSubscription ? *request.resumeAfter :
+                                                                        Timestamp();
+        ChangeFeedStage* feed = new ChangeFeedStage(std::move(compiled),
+                                                    resumeAfter,
+                                                    request.resumeAfterSubscription.value_or(-1),
+                                                    ws,
+                                                    cs);
+        // Takes ownership of 'ws', 'feed', and 'cq'.
+        return PlanExecutor::make(txn, ws, feed, cq.release(), collection,
+                                  PlanExecutor::YIELD_AUTO, out);
+    }
+
 namespace {
 
     /**
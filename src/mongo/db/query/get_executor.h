@@ -27,6 +27,7 @@
  */
 
 #include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/change_feed_request.h"
 #include "mongo/db/query/plan_executor.h"
 #include "mongo/db/query/query_planner_params.h"
 #include "mongo/db/query/query_settings.h"
@@ -97,6 +98,17 @@ namespace mongo {
                        PlanExecutor** out,
                        size_t plannerOptions = 0);
 
+    /**
+     * Returns true if a collection scan for 'cq' over 'nss' may be split across threads, in which
+     * case callers pass QueryPlannerParams::PARALLEL_COLLSCAN to getExecutor(). The scan then no
+     * longer reads from the caller's snapshot, which only user reads are known not to rely on:
+     * internal reads through DBDirectClient, reads on behalf of replication and reads of the
+     * local database are left alone, as are tailable, exhaust and $snapshot queries.
+     */
+    bool canScanInParallel(OperationContext* txn,
+                           const NamespaceString& nss,
+                           const CanonicalQuery& cq);
+
     /**
      * Get a plan executor for a .find() operation. Takes ownership of 'rawCanonicalQuery'.
      *
@@ -112,6 +124,23 @@ namespace mongo {
                            PlanExecutor::YieldPolicy yieldPolicy,
                            PlanExecutor** out);
 
+    /**
+     * Get a plan executor for the changeFeed command, which scans 'collection', the oplog, with
+     * the tailable, oplogReplay query 'rawCanonicalQuery' and turns the entries it returns into
+     * the events of the subscriptions of 'request', skipping those already seen before its
+     * resume token. Takes ownership of 'rawCanonicalQuery'.
+     *
+     * If the subscriptions are valid and an executor could be created, returns Status::OK()
+     * and populates *out with the PlanExecutor.
+     *
+     * If the query cannot be executed, returns a Status indicating why.
+     */
+    Status getExecutorChangeFeed(OperationContext* txn,
+                                 Collection* collection,
+                                 CanonicalQuery* rawCanonicalQuery,
+                                 const ChangeFeedRequest& request,
+                                 PlanExecutor** out);
+
     /**
      * If possible, turn the provided QuerySolution into a QuerySolution that uses a DistinctNode
      * to provide results for the distinct command.
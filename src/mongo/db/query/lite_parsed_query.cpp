@@ -256,6 +256,14 @@ namespace mongo {
 
                 pq->_snapshot = el.boolean();
             }
+            else if (mongoutils::str::equals(fieldName, "allowDiskUse")) {
+                Status status = checkFieldType(el, Bool);
+                if (!status.isOK()) {
+                    return status;
+                }
+
+                pq->_allowDiskUse = el.boolean();
+            }
             else if (mongoutils::str::equals(fieldName, "$readPreference")) {
                 pq->_hasReadPref = true;
             }
@@ -706,6 +714,10 @@ namespace mongo {
                     // Won't throw.
                     _snapshot = e.trueValue();
                 }
+                else if (str::equals("allowDiskUse", name)) {
+                    // Won't throw.
+                    _allowDiskUse = e.trueValue();
+                }
                 else if (str::equals("min", name)) {
                     if (!e.isABSONObj()) {
                         return Status(ErrorCodes::BadValue, "$min must be a BSONObj");
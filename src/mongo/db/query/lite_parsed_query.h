@@ -139,6 +139,7 @@ namespace mongo {
         bool returnKey() const { return _returnKey; }
         bool showRecordId() const { return _showRecordId; }
         bool isSnapshot() const { return _snapshot; }
+        bool allowDiskUse() const { return _allowDiskUse; }
         bool hasReadPref() const { return _hasReadPref; }
 
         bool isTailable() const { return _tailable; }
@@ -249,6 +250,10 @@ namespace mongo {
         bool _snapshot = false;
         bool _hasReadPref = false;
 
+        // Whether a blocking sort may spill to temporary files instead of failing once it
+        // exceeds internalQueryExecMaxBlockingSortBytes.
+        bool _allowDiskUse = false;
+
         // Options that can be specified in the OP_QUERY 'flags' header.
         bool _tailable = false;
         bool _slaveOk = false;
@@ -412,6 +412,20 @@ namespace {
         ASSERT(lpq->wantMore());
     }
 
+    TEST(LiteParsedQueryTest, ParseFromCommandAllowDiskUse) {
+        BSONObj cmdObj = fromjson("{find: 'testns',"
+                                   "filter: {a: 1},"
+                                   "sort: {b: 1},"
+                                   "allowDiskUse: true}");
+
+        LiteParsedQuery* rawLpq;
+        bool isExplain = false;
+        Status status = LiteParsedQuery::make("testns", cmdObj, isExplain, &rawLpq);
+        ASSERT_OK(status);
+        scoped_ptr<LiteParsedQuery> lpq(rawLpq);
+        ASSERT(lpq->allowDiskUse());
+    }
+
     //
     // Parsing errors where a field has the wrong type.
     //
@@ -574,6 +588,17 @@ namespace {
         ASSERT_NOT_OK(status);
     }
 
+    TEST(LiteParsedQueryTest, ParseFromCommandAllowDiskUseWrongType) {
+        BSONObj cmdObj = fromjson("{find: 'testns',"
+                                   "filter:  {a: 1},"
+                                   "allowDiskUse: 3}");
+
+        LiteParsedQuery* rawLpq;
+        bool isExplain = false;
+        Status status = LiteParsedQuery::make("testns", cmdObj, isExplain, &rawLpq);
+        ASSERT_NOT_OK(status);
+    }
+
     TEST(LiteParsedQueryTest, ParseFromCommandTailableWrongType) {
         BSONObj cmdObj = fromjson("{find: 'testns',"
                                    "filter:  {a: 1},"
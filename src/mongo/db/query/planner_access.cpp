@@ -73,11 +73,15 @@ namespace mongo {
         csn->tailable = tailable;
         csn->maxScan = query.getParsed().getMaxScan();
 
+        // Whether the caller asked for the results in natural order.
+        bool naturalOrder = false;
+
         // If the hint is {$natural: +-1} this changes the direction of the collection scan.
         if (!query.getParsed().getHint().isEmpty()) {
             BSONElement natural = query.getParsed().getHint().getFieldDotted("$natural");
             if (!natural.eoo()) {
                 csn->direction = natural.numberInt() >= 0 ? 1 : -1;
+                naturalOrder = true;
             }
         }
 
@@ -88,9 +92,20 @@ namespace mongo {
             BSONElement natural = sortObj.getFieldDotted("$natural");
             if (!natural.eoo()) {
                 csn->direction = natural.numberInt() >= 0 ? 1 : -1;
+                naturalOrder = true;
             }
         }
 
+        // A parallel scan interleaves the documents of several ranges of the collection, and
+        // evaluates the filter on other threads, which $where cannot support. Queries with a limit
+        // are expected to stop early, so they are not worth the threads.
+        csn->parallel = (params.options & QueryPlannerParams::PARALLEL_COLLSCAN)
+                        && !tailable
+                        && !naturalOrder
+                        && 0 == csn->maxScan
+                        && !query.getParsed().getLimit()
+                        && !QueryPlannerCommon::hasNode(query.root(), MatchExpression::WHERE);
+
         return csn;
     }
 
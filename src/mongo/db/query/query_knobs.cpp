@@ -68,4 +68,11 @@ namespace mongo {
     MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldIterations, int, 128);
     MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldPeriodMS, int, 10);
 
+    MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecParallelCollScanThreads, int, 0);
+    MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecParallelCollScanMinRecords,
+                                  long long,
+                                  100 * 1000);
+
+    MONGO_EXPORT_SERVER_PARAMETER(internalQueryCompileMatchExpressions, bool, false);
+
 }  // namespace mongo
@@ -104,4 +104,15 @@ namespace mongo {
     // Yield if it's been at least this many milliseconds since we last yielded.
     extern int internalQueryExecYieldPeriodMS;
 
+    // Number of threads over which a read-only collection scan may be split. Zero or one
+    // disables parallel collection scans.
+    extern int internalQueryExecParallelCollScanThreads;
+
+    // Collections with fewer records than this are always scanned by a single thread.
+    extern long long internalQueryExecParallelCollScanMinRecords;
+
+    // Do stages which filter fetched documents, and Matchers built while this is set, evaluate
+    // a compiled form of the filter? Off by default until the compiled matcher has proven itself.
+    extern bool internalQueryCompileMatchExpressions;
+
 }  // namespace mongo
@@ -86,6 +86,11 @@ namespace mongo {
             // Set this to prevent the planner from generating plans which answer a predicate
             // implicitly via exact index bounds for index intersection solutions.
             CANNOT_TRIM_IXISECT = 1 << 8,
+
+            // Set this to allow a collection scan to be split across several threads. Documents
+            // are then not read from the caller's snapshot, so this must only be set for
+            // read-only queries.
+            PARALLEL_COLLSCAN = 1 << 9,
         };
 
         // See Options enum above.
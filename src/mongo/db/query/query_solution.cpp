@@ -105,13 +105,18 @@ namespace mongo {
     // CollectionScanNode
     //
 
-    CollectionScanNode::CollectionScanNode() : tailable(false), direction(1), maxScan(0) { }
+    CollectionScanNode::CollectionScanNode()
+        : tailable(false), direction(1), maxScan(0), parallel(false) { }
 
     void CollectionScanNode::appendToString(mongoutils::str::stream* ss, int indent) const {
         addIndent(ss, indent);
         *ss << "COLLSCAN\n";
         addIndent(ss, indent + 1);
         *ss <<  "ns = " << name << '\n';
+        if (parallel) {
+            addIndent(ss, indent + 1);
+            *ss << "parallel\n";
+        }
         if (NULL != filter) {
             addIndent(ss, indent + 1);
             *ss << "filter = " << filter->toString();
@@ -128,6 +133,7 @@ namespace mongo {
         copy->tailable = this->tailable;
         copy->direction = this->direction;
         copy->maxScan = this->maxScan;
+        copy->parallel = this->parallel;
 
         return copy;
     }
@@ -631,6 +637,8 @@ namespace mongo {
         *ss << "query for bounds = " << query.toString() << '\n';
         addIndent(ss, indent + 1);
         *ss << "limit = " << limit << '\n';
+        addIndent(ss, indent + 1);
+        *ss << "allowDiskUse = " << allowDiskUse << '\n';
         addCommon(ss, indent);
         addIndent(ss, indent + 1);
         *ss << "Child:" << '\n';
@@ -645,6 +653,7 @@ namespace mongo {
         copy->pattern = this->pattern;
         copy->query = this->query;
         copy->limit = this->limit;
+        copy->allowDiskUse = this->allowDiskUse;
 
         return copy;
     }
@@ -274,6 +274,10 @@ namespace mongo {
 
         // maxScan option to .find() limits how many docs we look at.
         int maxScan;
+
+        // May the scan be split across several threads? Only set for forward scans which do not
+        // need to return documents in natural order.
+        bool parallel;
     };
 
     struct AndHashNode : public QuerySolutionNode {
@@ -499,7 +503,7 @@ namespace mongo {
     };
 
     struct SortNode : public QuerySolutionNode {
-        SortNode() : limit(0) { }
+        SortNode() : limit(0), allowDiskUse(false) { }
         virtual ~SortNode() { }
 
         virtual StageType getType() const { return STAGE_SORT; }
@@ -530,6 +534,9 @@ namespace mongo {
 
         // Sum of both limit and skip count in the parsed query.
         size_t limit;
+
+        // Whether the sort may spill to disk rather than fail when it runs out of memory.
+        bool allowDiskUse;
     };
 
     struct LimitNode : public QuerySolutionNode {
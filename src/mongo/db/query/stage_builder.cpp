@@ -43,6 +43,7 @@
 #include "mongo/db/exec/limit.h"
 #include "mongo/db/exec/merge_sort.h"
 #include "mongo/db/exec/or.h"
+#include "mongo/db/exec/parallel_collection_scan.h"
 #include "mongo/db/exec/projection.h"
 #include "mongo/db/exec/shard_filter.h"
 #include "mongo/db/exec/sort.h"
@@ -51,6 +52,8 @@
 #include "mongo/db/index/fts_access_method.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/storage/record_store.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -70,6 +73,20 @@ namespace mongo {
             params.direction = (csn->direction == 1) ? CollectionScanParams::FORWARD
                                                      : CollectionScanParams::BACKWARD;
             params.maxScan = csn->maxScan;
+
+            const int numThreads = internalQueryExecParallelCollScanThreads;
+            if (csn->parallel && NULL != collection && numThreads > 1
+                && CollectionScanParams::FORWARD == params.direction
+                && collection->numRecords(txn) >= internalQueryExecParallelCollScanMinRecords) {
+                // The record store may not support splitting, in which case we scan serially.
+                std::vector<RecordId> splitPoints =
+                    collection->getRecordStore()->getSplitPoints(txn, numThreads);
+                if (!splitPoints.empty()) {
+                    return new ParallelCollectionScan(txn, params, splitPoints, ws,
+                                                      csn->filter.get());
+                }
+            }
+
             return new CollectionScan(txn, params, ws, csn->filter.get());
         }
         else if (STAGE_IXSCAN == root->getType()) {
@@ -111,6 +128,7 @@ namespace mongo {
             params.pattern = sn->pattern;
             params.query = sn->query;
             params.limit = sn->limit;
+            params.allowDiskUse = sn->allowDiskUse;
             return new SortStage(params, ws, childStage);
         }
         else if (STAGE_PROJECTION == root->getType()) {
@@ -279,7 +297,8 @@ namespace mongo {
             const ShardingFilterNode* fn = static_cast<const ShardingFilterNode*>(root);
             PlanStage* childStage = buildStages(txn, collection, qsol, fn->children[0], ws);
             if (NULL == childStage) { return NULL; }
-            return new ShardFilterStage(shardingState.getCollectionMetadata(collection->ns()),
+            return new ShardFilterStage(collection->ns().ns(),
+                                        shardingState.getCollectionMetadata(collection->ns()),
                                         ws, childStage);
         }
         else if (STAGE_KEEP_MUTATIONS == root->getType()) {
@@ -37,6 +37,10 @@ namespace mongo {
         STAGE_AND_HASH,
         STAGE_AND_SORTED,
         STAGE_CACHED_PLAN,
+
+        // Turns oplog entries into the events of a change feed.
+        STAGE_CHANGE_FEED,
+
         STAGE_COLLSCAN,
 
         // This stage sits at the root of the query tree and counts up the number of results
@@ -81,6 +85,10 @@ namespace mongo {
         STAGE_MULTI_PLAN,
         STAGE_OPLOG_START,
         STAGE_OR,
+
+        // Collection scan split across several threads.
+        STAGE_PARALLEL_COLLSCAN,
+
         STAGE_PROJECTION,
 
         // Stage for running aggregation pipelines.
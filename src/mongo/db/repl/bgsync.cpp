@@ -48,10 +48,12 @@
 #include "mongo/db/repl/rollback_source_impl.h"
 #include "mongo/db/repl/rs_rollback.h"
 #include "mongo/db/repl/rs_sync.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/stats/timer_stats.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -63,8 +65,16 @@ namespace {
     const char hashFieldName[] = "h";
     int SleepToAllowBatchingMillis = 2;
     const int BatchIsSmallish = 40000; // bytes
+
+    // Room to leave in the buffer before taking another streamed batch off the connection. A
+    // batch is at most 4MB plus one document.
+    const size_t StreamingBatchRoom = 4 * 1024 * 1024 + BSONObjMaxInternalSize;
 } // namespace
 
+    // Fetch the oplog through an exhaust cursor, which the sync source keeps sending batches on
+    // without waiting for a getMore per batch.
+    MONGO_EXPORT_SERVER_PARAMETER(bgSyncOplogStreaming, bool, false);
+
     MONGO_FP_DECLARE(rsBgSyncProduce);
 
     BackgroundSync* BackgroundSync::s_instance = 0;
@@ -75,6 +85,11 @@ namespace {
     static ServerStatusMetricField<TimerStats> displayBatchesRecieved(
                                                     "repl.network.getmores",
                                                     &getmoreReplStats );
+    //The number of batches the sync source pushed to us through a streaming cursor
+    static Counter64 streamedBatchesStats;
+    static ServerStatusMetricField<Counter64> displayStreamedBatches(
+                                                    "repl.network.streamedBatches",
+                                                    &streamedBatchesStats );
     //The oplog entries read via the oplog reader
     static Counter64 opsReadStats;
     static ServerStatusMetricField<Counter64> displayOpsRead( "repl.network.ops",
@@ -253,7 +268,17 @@ namespace {
             _replCoord->signalUpstreamUpdater();
         }
 
-        _syncSourceReader.tailingQueryGTE(rsOplogName.c_str(), lastOpTimeFetched.getTimestamp());
+        _syncSourceReader.tailingQueryGTE(rsOplogName.c_str(),
+                                          lastOpTimeFetched.getTimestamp(),
+                                          bgSyncOplogStreaming);
+
+        // A streaming sync source keeps writing to the connection until it blocks, so don't
+        // leave the cursor open once we stop reading from it.
+        ON_BLOCK_EXIT([this] {
+            if (_syncSourceReader.isStreaming()) {
+                _syncSourceReader.resetConnection();
+            }
+        });
 
         // if target cut connections between connecting and querying (for
         // example, because it stepped down) we might not have a cursor
@@ -272,8 +297,10 @@ namespace {
                 // (whenever we run out of items in the
                 // current cursor batch)
 
+                // A streaming sync source does not wait for us to ask for the next batch, so
+                // waiting here would not let it accumulate larger ones.
                 int bs = _syncSourceReader.currentBatchMessageSize();
-                if( bs > 0 && bs < BatchIsSmallish ) {
+                if( bs > 0 && bs < BatchIsSmallish && !_syncSourceReader.isStreaming() ) {
                     // on a very low latency network, if we don't wait a little, we'll be 
                     // getting ops to write almost one at a time.  this will both be expensive
                     // for the upstream server as well as potentially defeating our parallel 
@@ -297,15 +324,34 @@ namespace {
                     return;
                 }
 
+                if (_syncSourceReader.isStreaming()) {
+                    // Leave the next batch on the connection until the buffer has room for it.
+                    // Once the connection's buffers fill up the sync source blocks, so the
+                    // buffer's size is what limits how far ahead of the applier it can get.
+                    while (!_buffer.waitForSpace(StreamingBatchRoom, 1)) {
+                        if (inShutdown() || shouldChangeSyncSource()) {
+                            return;
+                        }
+                        boost::unique_lock<boost::mutex> lock(_mutex);
+                        if (_pause) {
+                            return;
+                        }
+                    }
+                }
+
                 {
                     //record time for each getmore
                     TimerHolder batchTimer(&getmoreReplStats);
                     
-                    // This calls receiveMore() on the oplogreader cursor.
+                    // This calls receiveMore() on the oplogreader cursor, or waits for the
+                    // next pushed batch if it is streaming.
                     // It can wait up to five seconds for more data.
                     _syncSourceReader.more();
                 }
                 networkByteStats.increment(_syncSourceReader.currentBatchMessageSize());
+                if (_syncSourceReader.isStreaming()) {
+                    streamedBatchesStats.increment();
+                }
 
                 if (!_syncSourceReader.moreInCurrentBatch()) {
                     // If there is still no data from upstream, check a few more things
@@ -411,6 +457,12 @@ namespace {
 
         if (!r.more()) {
             try {
+                // The queries below need the connection to themselves.
+                if (!r.stopStreaming()) {
+                    error() << "could not reconnect to " << hn;
+                    sleepsecs(2);
+                    return true;
+                }
                 BSONObj theirLastOp = r.getLastOp(rsOplogName.c_str());
                 if (theirLastOp.isEmpty()) {
                     error() << "empty query result from " << hn << " oplog";
@@ -447,6 +499,11 @@ namespace {
         if ( opTime != _lastOpTimeFetched || hash != _lastFetchedHash ) {
             log() << "our last op time fetched: " << _lastOpTimeFetched;
             log() << "source's GTE: " << opTime;
+            if (!r.stopStreaming()) {
+                error() << "could not reconnect to " << hn << " to roll back";
+                sleepsecs(2);
+                return true;
+            }
             fassertRollbackStatusNoTrace(
                 28657,
                 syncRollback(txn,
@@ -504,6 +561,11 @@ namespace {
         }
     }
 
+    OpTime BackgroundSync::getLastOpTimeFetched() const {
+        boost::lock_guard<boost::mutex> lck(_mutex);
+        return _lastOpTimeFetched;
+    }
+
     long long BackgroundSync::getLastAppliedHash() const {
         boost::lock_guard<boost::mutex> lck(_mutex);
         return _lastAppliedHash;
@@ -109,6 +109,9 @@ namespace repl {
         BSONObj getCounters();
 
         long long getLastAppliedHash() const;
+
+        // The optime of the last op added to the buffer.
+        OpTime getLastOpTimeFetched() const;
         void setLastAppliedHash(long long oldH);
         void loadLastAppliedHash(OperationContext* txn);
 
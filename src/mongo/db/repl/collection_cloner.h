@@ -228,7 +228,8 @@ namespace repl {
                                        const std::vector<BSONObj>& indexSpecs) = 0;
 
         /**
-         * Inserts documents into a collection.
+         * Inserts documents into a collection. Implementations should write the whole batch
+         * with Collection::insertDocuments rather than one document at a time.
          *
          * Assume that no database locks have been acquired prior to calling this
          * function.
@@ -0,0 +1,461 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kReplication
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/initial_sync_cloner.h"
+
+#include "mongo/client/dbclientinterface.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog/database_holder.h"
+#include "mongo/db/catalog/document_validation.h"
+#include "mongo/db/client.h"
+#include "mongo/db/cloner.h"
+#include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/operation_context_impl.h"
+#include "mongo/db/repl/oplogreader.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/exit.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace repl {
+
+namespace {
+
+    const BSONObj kIdIndexPattern = BSON("_id" << 1);
+
+    InitialSyncProgress initialSyncProgress;
+
+    void initializeClonerThread() {
+        if (!ClientBasic::getCurrent()) {
+            Client::initThreadIfNotAlready();
+            AuthorizationSession::get(cc())->grantInternalAuthorization();
+        }
+    }
+
+    /**
+     * Opens a new connection to the sync source, authenticated as the internal user.
+     */
+    StatusWith<DBClientBase*> connectToSyncSource(const std::string& host) {
+        std::unique_ptr<DBClientConnection> conn(new DBClientConnection());
+        std::string errmsg;
+        if (!conn->connect(HostAndPort(host), errmsg)) {
+            return StatusWith<DBClientBase*>(ErrorCodes::HostUnreachable, errmsg);
+        }
+        if (!replAuthenticate(conn.get())) {
+            return StatusWith<DBClientBase*>(ErrorCodes::AuthenticationFailed,
+                                             "Unable to authenticate as internal user");
+        }
+        return StatusWith<DBClientBase*>(conn.release());
+    }
+
+    void reportDocumentsCopied(long long numDocs, long long numBytes) {
+        InitialSyncProgress::get()->onDocumentsCopied(numDocs, numBytes);
+    }
+
+} // namespace
+
+    InitialSyncProgress* InitialSyncProgress::get() {
+        return &initialSyncProgress;
+    }
+
+    void InitialSyncProgress::start() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _active = true;
+        _attempt++;
+        _phase = "starting";
+        _startDate = jsTime();
+        _timer.reset();
+        _collections = 0;
+        _collectionsCloned = 0;
+        _ranges = 0;
+        _rangesCloned = 0;
+        _collectionsToIndex = 0;
+        _collectionsIndexed = 0;
+        _documentsCopied = 0;
+        _bytesCopied = 0;
+    }
+
+    void InitialSyncProgress::finish() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _active = false;
+    }
+
+    void InitialSyncProgress::setPhase(const std::string& phase) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _phase = phase;
+    }
+
+    void InitialSyncProgress::addCollections(long long numCollections, long long numRanges) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _collections += numCollections;
+        _ranges += numRanges;
+    }
+
+    void InitialSyncProgress::addIndexedCollections(long long numCollections) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _collectionsToIndex += numCollections;
+    }
+
+    void InitialSyncProgress::onRangeCloned() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _rangesCloned++;
+    }
+
+    void InitialSyncProgress::onCollectionCloned() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _collectionsCloned++;
+    }
+
+    void InitialSyncProgress::onCollectionIndexed() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _collectionsIndexed++;
+    }
+
+    void InitialSyncProgress::onDocumentsCopied(long long numDocs, long long numBytes) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _documentsCopied += numDocs;
+        _bytesCopied += numBytes;
+    }
+
+    void InitialSyncProgress::append(BSONObjBuilder* builder) const {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (!_active) {
+            return;
+        }
+
+        const long long elapsedMillis = _timer.millis();
+        BSONObjBuilder status(builder->subobjStart("initialSyncStatus"));
+        status.append("attempt", _attempt);
+        status.append("phase", _phase);
+        status.appendDate("startDate", _startDate);
+        status.append("elapsedMillis", elapsedMillis);
+        status.append("collections", _collections);
+        status.append("collectionsCloned", _collectionsCloned);
+        status.append("ranges", _ranges);
+        status.append("rangesCloned", _rangesCloned);
+        status.append("collectionsToIndex", _collectionsToIndex);
+        status.append("collectionsIndexed", _collectionsIndexed);
+        status.append("documentsCopied", _documentsCopied);
+        status.append("bytesCopied", _bytesCopied);
+        if (elapsedMillis > 0) {
+            status.append("documentsCopiedPerSecond", _documentsCopied * 1000 / elapsedMillis);
+            status.append("bytesCopiedPerSecond", _bytesCopied * 1000 / elapsedMillis);
+        }
+        status.done();
+    }
+
+    struct InitialSyncCloner::CollectionState {
+        NamespaceString nss;
+
+        // Number of ranges which are still to be cloned. Protected by the cloner's mutex.
+        size_t rangesRemaining = 0;
+    };
+
+    InitialSyncCloner::InitialSyncCloner(const std::string& host,
+                                         int numThreads,
+                                         long long rangeBytes)
+        : _host(host),
+          _numThreads(std::max(1, numThreads)),
+          _rangeBytes(rangeBytes) { }
+
+    InitialSyncCloner::~InitialSyncCloner() { }
+
+    Status InitialSyncCloner::cloneData(OperationContext* txn,
+                                        const std::list<std::string>& dbs) {
+        invariant(!txn->lockState()->isLocked());
+        InitialSyncProgress* progress = InitialSyncProgress::get();
+
+        StatusWith<DBClientBase*> conn = connectToSyncSource(_host);
+        if (!conn.isOK()) {
+            return conn.getStatus();
+        }
+        Cloner cloner;
+        cloner.setConnection(conn.getValue());
+
+        for (std::list<std::string>::const_iterator i = dbs.begin(); i != dbs.end(); ++i) {
+            const std::string& db = *i;
+            if (db == "local") {
+                continue;
+            }
+
+            log() << "initial sync creating collections of db: " << db;
+
+            CloneOptions options;
+            options.fromDB = db;
+            options.slaveOk = true;
+            options.useReplAuth = true;
+            options.snapshot = false;
+            options.mayYield = true;
+            options.mayBeInterrupted = false;
+
+            std::list<BSONObj> collections;
+            {
+                ScopedTransaction transaction(txn, MODE_IX);
+                Lock::DBLock dbWrite(txn->lockState(), db, MODE_X);
+
+                Status status = cloner.createCollections(txn, db, options, &collections);
+                if (!status.isOK()) {
+                    return status;
+                }
+            }
+
+            for (std::list<BSONObj>::const_iterator it = collections.begin();
+                 it != collections.end();
+                 ++it) {
+                std::shared_ptr<CollectionState> collection = std::make_shared<CollectionState>();
+                collection->nss = NamespaceString(db, (*it)["name"].valuestr());
+
+                const std::vector<BSONObj> splitKeys =
+                    _getSplitKeys(conn.getValue(), collection->nss, it->getObjectField("options"));
+                collection->rangesRemaining = splitKeys.size() + 1;
+
+                stdx::lock_guard<stdx::mutex> lk(_mutex);
+                BSONObj min;
+                for (const BSONObj& splitKey : splitKeys) {
+                    _cloneTasks.push_back(CloneTask{collection, min, splitKey});
+                    min = splitKey;
+                }
+                _cloneTasks.push_back(CloneTask{collection, min, BSONObj()});
+
+                _collections.push_back(collection);
+                progress->addCollections(1, collection->rangesRemaining);
+            }
+        }
+
+        log() << "initial sync cloning " << _collections.size() << " collections in "
+              << _cloneTasks.size() << " ranges with " << _numThreads << " threads";
+
+        threadpool::ThreadPool pool(_numThreads, "initsync-clone");
+        for (int i = 0; i < _numThreads; i++) {
+            pool.schedule(stdx::bind(&InitialSyncCloner::_cloneWorker, this));
+        }
+        pool.join();
+
+        return _getError();
+    }
+
+    Status InitialSyncCloner::buildIndexes(OperationContext* txn) {
+        invariant(!txn->lockState()->isLocked());
+
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _indexTasks.assign(_collections.begin(), _collections.end());
+        }
+        InitialSyncProgress::get()->addIndexedCollections(_collections.size());
+
+        threadpool::ThreadPool pool(_numThreads, "initsync-index");
+        for (int i = 0; i < _numThreads; i++) {
+            pool.schedule(stdx::bind(&InitialSyncCloner::_indexWorker, this));
+        }
+        pool.join();
+
+        return _getError();
+    }
+
+    std::vector<BSONObj> InitialSyncCloner::_getSplitKeys(DBClientBase* conn,
+                                                          const NamespaceString& nss,
+                                                          const BSONObj& options) {
+        std::vector<BSONObj> splitKeys;
+
+        // Capped collections must keep their insertion order, so they are cloned as a whole.
+        if (_rangeBytes <= 0 || options["capped"].trueValue()) {
+            return splitKeys;
+        }
+
+        BSONObj result;
+        const BSONObj cmd = BSON("splitVector" << nss.ns() <<
+                                 "keyPattern" << kIdIndexPattern <<
+                                 "maxChunkSizeBytes" << _rangeBytes);
+        if (!conn->runCommand(nss.db().toString(), cmd, result, QueryOption_SlaveOk)) {
+            // For example, the collection has no _id index.
+            LOG(1) << "initial sync cloning " << nss << " as a whole, splitVector failed: "
+                   << result;
+            return splitKeys;
+        }
+
+        BSONForEach(splitKey, result.getObjectField("splitKeys")) {
+            splitKeys.push_back(splitKey.Obj().getOwned());
+        }
+        return splitKeys;
+    }
+
+    void InitialSyncCloner::_cloneWorker() {
+        initializeClonerThread();
+
+        OperationContextImpl txn;
+        txn.setReplicatedWrites(false);
+        DisableDocumentValidation validationDisabler(&txn);
+
+        StatusWith<DBClientBase*> conn = connectToSyncSource(_host);
+        if (!conn.isOK()) {
+            _setError(conn.getStatus());
+            return;
+        }
+        Cloner cloner;
+        cloner.setConnection(conn.getValue());
+
+        InitialSyncProgress* progress = InitialSyncProgress::get();
+
+        CloneTask task;
+        while (_nextCloneTask(&task)) {
+            const NamespaceString& nss = task.collection->nss;
+            try {
+                // Ranges are given in the order of the _id index, which may differ from the
+                // order in which the query language compares values of different types, so they
+                // are bounded with $min and $max rather than a predicate on _id.
+                Query query;
+                if (!task.min.isEmpty() || !task.max.isEmpty()) {
+                    query.hint(kIdIndexPattern);
+                    if (!task.min.isEmpty()) {
+                        query.minKey(task.min);
+                    }
+                    if (!task.max.isEmpty()) {
+                        query.maxKey(task.max);
+                    }
+                }
+
+                LOG(1) << "initial sync cloning " << nss << " from " << task.min
+                       << " to " << task.max;
+                cloner.copyCollectionRange(&txn, nss, query, true, reportDocumentsCopied);
+                progress->onRangeCloned();
+
+                bool lastRange;
+                {
+                    stdx::lock_guard<stdx::mutex> lk(_mutex);
+                    lastRange = --task.collection->rangesRemaining == 0;
+                }
+                if (!lastRange) {
+                    continue;
+                }
+
+                ScopedTransaction transaction(&txn, MODE_IX);
+                Lock::DBLock dbWrite(txn.lockState(), nss.db(), MODE_X);
+
+                Database* db = dbHolder().get(&txn, nss.db());
+                Collection* collection = db ? db->getCollection(nss) : NULL;
+                uassert(ErrorCodes::NamespaceNotFound,
+                        str::stream() << "collection " << nss.ns() << " dropped during clone",
+                        collection);
+
+                Cloner::buildIdIndex(&txn, collection, false);
+                progress->onCollectionCloned();
+            }
+            catch (const DBException& e) {
+                error() << "initial sync failed to clone " << nss << ": " << e.toString();
+                _setError(e.toStatus());
+                return;
+            }
+        }
+    }
+
+    void InitialSyncCloner::_indexWorker() {
+        initializeClonerThread();
+
+        OperationContextImpl txn;
+        txn.setReplicatedWrites(false);
+        DisableDocumentValidation validationDisabler(&txn);
+
+        StatusWith<DBClientBase*> conn = connectToSyncSource(_host);
+        if (!conn.isOK()) {
+            _setError(conn.getStatus());
+            return;
+        }
+        Cloner cloner;
+        cloner.setConnection(conn.getValue());
+
+        std::shared_ptr<CollectionState> collection;
+        while (_nextIndexTask(&collection)) {
+            const NamespaceString& nss = collection->nss;
+            try {
+                log() << "initial sync building indexes for " << nss;
+
+                ScopedTransaction transaction(&txn, MODE_IX);
+                Lock::DBLock dbWrite(txn.lockState(), nss.db(), MODE_X);
+
+                cloner.copyIndexes(&txn, nss.db().toString(), nss, nss, false, true, true, false);
+                InitialSyncProgress::get()->onCollectionIndexed();
+            }
+            catch (const DBException& e) {
+                error() << "initial sync failed to build the indexes of " << nss << ": "
+                        << e.toString();
+                _setError(e.toStatus());
+                return;
+            }
+        }
+    }
+
+    bool InitialSyncCloner::_nextCloneTask(CloneTask* task) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_error.isOK() && inShutdown()) {
+            _error = Status(ErrorCodes::ShutdownInProgress, "shutting down");
+        }
+        if (!_error.isOK() || _cloneTasks.empty()) {
+            return false;
+        }
+
+        *task = _cloneTasks.front();
+        _cloneTasks.pop_front();
+        return true;
+    }
+
+    bool InitialSyncCloner::_nextIndexTask(std::shared_ptr<CollectionState>* collection) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_error.isOK() && inShutdown()) {
+            _error = Status(ErrorCodes::ShutdownInProgress, "shutting down");
+        }
+        if (!_error.isOK() || _indexTasks.empty()) {
+            return false;
+        }
+
+        *collection = _indexTasks.front();
+        _indexTasks.pop_front();
+        return true;
+    }
+
+    void InitialSyncCloner::_setError(const Status& status) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_error.isOK()) {
+            _error = status;
+        }
+    }
+
+    Status InitialSyncCloner::_getError() const {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        return _error;
+    }
+
+} // namespace repl
+} // namespace mongo
@@ -0,0 +1,181 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+
+    class DBClientBase;
+    class OperationContext;
+
+namespace repl {
+
+    /**
+     * Progress of the initial sync of this node, reported in the "initialSyncStatus" field of
+     * replSetGetStatus while an attempt is running.
+     */
+    class InitialSyncProgress {
+        MONGO_DISALLOW_COPYING(InitialSyncProgress);
+    public:
+        InitialSyncProgress() = default;
+
+        static InitialSyncProgress* get();
+
+        /**
+         * Resets the progress at the start of an attempt.
+         */
+        void start();
+
+        /**
+         * Marks the current attempt as over, whether it succeeded or not.
+         */
+        void finish();
+
+        void setPhase(const std::string& phase);
+
+        void addCollections(long long numCollections, long long numRanges);
+        void addIndexedCollections(long long numCollections);
+        void onRangeCloned();
+        void onCollectionCloned();
+        void onCollectionIndexed();
+        void onDocumentsCopied(long long numDocs, long long numBytes);
+
+        /**
+         * Appends the "initialSyncStatus" field to 'builder' if an attempt is running.
+         */
+        void append(BSONObjBuilder* builder) const;
+
+    private:
+        mutable stdx::mutex _mutex;
+
+        bool _active = false;
+        int _attempt = 0;
+        std::string _phase;
+        Date_t _startDate;
+        Timer _timer;
+
+        long long _collections = 0;
+        long long _collectionsCloned = 0;
+        long long _ranges = 0;
+        long long _rangesCloned = 0;
+        long long _collectionsToIndex = 0;
+        long long _collectionsIndexed = 0;
+        long long _documentsCopied = 0;
+        long long _bytesCopied = 0;
+    };
+
+    /**
+     * Copies the databases of an initial sync from a sync source on several threads, each with
+     * its own connection to it.
+     *
+     * Collections are cloned concurrently. Those which are larger than the range size are split
+     * into ranges of _id, as chosen by splitVector on the sync source, which are cloned
+     * concurrently too. The _id index of a collection is built by the thread which clones its last
+     * range, while the other collections are still being copied. Its secondary indexes are built
+     * by buildIndexes(), once the oplog has been applied, again with several collections at once.
+     */
+    class InitialSyncCloner {
+        MONGO_DISALLOW_COPYING(InitialSyncCloner);
+    public:
+        /**
+         * 'rangeBytes' is the approximate size of the ranges large collections are split into,
+         * or 0 to clone every collection as a whole.
+         */
+        InitialSyncCloner(const std::string& host, int numThreads, long long rangeBytes);
+        ~InitialSyncCloner();
+
+        /**
+         * Creates the collections of 'dbs' and copies their documents. 'txn' must hold no locks.
+         */
+        Status cloneData(OperationContext* txn, const std::list<std::string>& dbs);
+
+        /**
+         * Builds the secondary indexes of the collections created by cloneData().
+         */
+        Status buildIndexes(OperationContext* txn);
+
+    private:
+        struct CollectionState;
+
+        // A range of _id of one collection. An empty bound is unbounded.
+        struct CloneTask {
+            std::shared_ptr<CollectionState> collection;
+            BSONObj min;
+            BSONObj max;
+        };
+
+        /**
+         * Returns the bounds of the ranges 'nss' should be cloned in, as given by splitVector on
+         * the sync source. Collections which cannot be split are cloned as a single range.
+         */
+        std::vector<BSONObj> _getSplitKeys(DBClientBase* conn,
+                                           const NamespaceString& nss,
+                                           const BSONObj& options);
+
+        /**
+         * Body of the threads of each phase. They take tasks until there are none left or one
+         * of them failed.
+         */
+        void _cloneWorker();
+        void _indexWorker();
+
+        bool _nextCloneTask(CloneTask* task);
+        bool _nextIndexTask(std::shared_ptr<CollectionState>* collection);
+        void _setError(const Status& status);
+        Status _getError() const;
+
+        const std::string _host;
+        const int _numThreads;
+        const long long _rangeBytes;
+
+        // Every collection created by cloneData().
+        std::vector<std::shared_ptr<CollectionState>> _collections;
+
+        // Protects the members below.
+        mutable stdx::mutex _mutex;
+        std::deque<CloneTask> _cloneTasks;
+        std::deque<std::shared_ptr<CollectionState>> _indexTasks;
+        Status _error = Status::OK();
+    };
+
+} // namespace repl
+} // namespace mongo
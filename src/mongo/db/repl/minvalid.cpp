@@ -32,6 +32,8 @@
 
 #include "mongo/db/repl/minvalid.h"
 
+#include <algorithm>
+
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/dbhelpers.h"
@@ -39,6 +41,8 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/operation_context_impl.h"
 #include "mongo/db/repl/oplog.h"
+#include "mongo/db/repl/optime.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 
@@ -49,6 +53,18 @@ namespace {
     const char* initialSyncFlagString = "doingInitialSync";
     const BSONObj initialSyncFlag(BSON(initialSyncFlagString << true));
     const char* minvalidNS = "local.replset.minvalid";
+
+    // The minValid optime last read or written by this process, so that advanceMinValid() can
+    // tell whether a batch is already covered without reading the collection.
+    stdx::mutex minValidCacheMutex;
+    OpTime minValidCache;
+    bool minValidCacheLoaded = false;
+
+    void setMinValidCache(const OpTime& opTime) {
+        stdx::lock_guard<stdx::mutex> lk(minValidCacheMutex);
+        minValidCache = opTime;
+        minValidCacheLoaded = true;
+    }
 } // namespace
 
     // Writes
@@ -80,6 +96,25 @@ namespace {
                                                       "t" << opTime.getTerm())));
 
         } MONGO_WRITE_CONFLICT_RETRY_LOOP_END(ctx, "setMinValid", minvalidNS);
+        setMinValidCache(opTime);
+    }
+
+    bool advanceMinValid(OperationContext* txn, const OpTime& opTime, const OpTime& ahead) {
+        bool loaded;
+        {
+            stdx::lock_guard<stdx::mutex> lk(minValidCacheMutex);
+            if (minValidCacheLoaded && minValidCache >= opTime) {
+                return false;
+            }
+            loaded = minValidCacheLoaded;
+        }
+
+        if (!loaded && getMinValid(txn) >= opTime) {
+            return false;
+        }
+
+        setMinValid(txn, std::max(opTime, ahead));
+        return true;
     }
 
     // Reads
@@ -108,10 +143,9 @@ namespace {
             Lock::CollectionLock lk(txn->lockState(), minvalidNS, MODE_IS);
             BSONObj mv;
             bool found = Helpers::getSingleton(txn, minvalidNS, mv);
-            if (found) {
-                return extractOpTime(mv);
-            }
-            return OpTime();
+            const OpTime minValid = found ? extractOpTime(mv) : OpTime();
+            setMinValidCache(minValid);
+            return minValid;
         } MONGO_WRITE_CONFLICT_RETRY_LOOP_END(txn, "getMinValid", minvalidNS);
     }
 
@@ -63,5 +63,22 @@ namespace repl {
      */
     void setMinValid(OperationContext* ctx, const OpTime& opTime);
     OpTime getMinValid(OperationContext* txn);
+
+    /**
+     * Makes sure minValid is at least 'opTime', the last op of a batch about to be applied.
+     *
+     * Instead of writing minValid before every batch, this moves it up to 'ahead' when it has to
+     * write, where 'ahead' is the newest op already fetched from the sync source, so that the
+     * batches which follow up to there need no write at all. The price is that a node which
+     * restarts in between stays in RECOVERING until it has applied up to 'ahead' rather than to
+     * the end of the batch it was applying.
+     *
+     * Only a SECONDARY may write ahead. A member in RECOVERING goes to SECONDARY once it has
+     * applied through minValid, so it must pass the end of the batch as 'ahead' or it would
+     * stay in RECOVERING until it caught up with everything fetched.
+     *
+     * Returns true if minValid had to be written.
+     */
+    bool advanceMinValid(OperationContext* txn, const OpTime& opTime, const OpTime& ahead);
 }
 }
@@ -54,8 +54,10 @@
 #include "mongo/db/catalog/drop_database.h"
 #include "mongo/db/catalog/drop_indexes.h"
 #include "mongo/db/catalog/rename_collection.h"
+#include "mongo/base/counter.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/commands/dbhash.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
@@ -84,6 +86,7 @@
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/stacktrace.h"
 #include "mongo/util/startup_test.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -106,64 +109,127 @@ namespace {
     mongo::mutex newOpMutex;
     boost::condition newTimestampNotifier;
 
+    // Number of times oplog slots were reserved under newOpMutex, and the number of slots which
+    // were reserved, which is larger when writes reserve slots for several entries at once.
+    Counter64 slotReservationsStats;
+    ServerStatusMetricField<Counter64> displaySlotReservations("repl.oplog.slotReservations",
+                                                               &slotReservationsStats);
+    Counter64 slotsReservedStats;
+    ServerStatusMetricField<Counter64> displaySlotsReserved("repl.oplog.slotsReserved",
+                                                            &slotsReservedStats);
+
+    // Number of reservations which had to wait for newOpMutex, and the total time they waited.
+    Counter64 slotReservationsContendedStats;
+    ServerStatusMetricField<Counter64> displaySlotReservationsContended(
+                                                    "repl.oplog.slotReservationsContended",
+                                                    &slotReservationsContendedStats);
+    Counter64 slotReservationWaitMicrosStats;
+    ServerStatusMetricField<Counter64> displaySlotReservationWaitMicros(
+                                                    "repl.oplog.slotReservationWaitMicros",
+                                                    &slotReservationWaitMicrosStats);
+
     static std::string _oplogCollectionName;
 
     // so we can fail the same way
-    void checkOplogInsert( StatusWith<RecordId> result ) {
+    void checkOplogInsert( const Status& status ) {
         massert( 17322,
-                 str::stream() << "write to oplog failed: " << result.getStatus().toString(),
-                 result.isOK() );
+                 str::stream() << "write to oplog failed: " << status.toString(),
+                 status.isOK() );
+    }
+
+    void checkOplogInsert( StatusWith<RecordId> result ) {
+        checkOplogInsert( result.getStatus() );
     }
 
+    typedef std::pair<OpTime, long long> OplogSlot;
+
     /**
-     * Allocates an optime for a new entry in the oplog, and updates the replication coordinator to
-     * reflect that new optime.  Returns the new optime and the correct value of the "h" field for
-     * the new oplog entry.
+     * Allocates optimes for 'count' new entries in the oplog, and updates the replication
+     * coordinator to reflect the last of them. Fills 'slotsOut', which must have room for 'count'
+     * elements, with the new optimes and the correct values of the "h" field for the entries.
      *
-     * NOTE: From the time this function returns to the time that the new oplog entry is written
-     * to the storage system, all errors must be considered fatal.  This is because the this
-     * function registers the new optime with the storage system and the replication coordinator,
-     * and provides no facility to revert those registrations on rollback.
+     * All the slots are reserved in one critical section, and only the first one is registered
+     * with the storage system: readers of the oplog never see past its oldest uncommitted entry,
+     * so this hides the whole block until the entries commit.
+     *
+     * NOTE: From the time this function returns to the time that the new oplog entries are
+     * written to the storage system, all errors must be considered fatal.  This is because the
+     * this function registers the new optimes with the storage system and the replication
+     * coordinator, and provides no facility to revert those registrations on rollback.
      */
-    std::pair<OpTime, long long> getNextOpTime(OperationContext* txn,
-                                               Collection* oplog,
-                                               const char* ns,
-                                               ReplicationCoordinator* replCoord,
-                                               const char* opstr) {
-        boost::lock_guard<boost::mutex> lk(newOpMutex);
-        Timestamp ts = getNextGlobalTimestamp();
-        newTimestampNotifier.notify_all();
+    void getNextOpTimes(OperationContext* txn,
+                        Collection* oplog,
+                        const char* ns,
+                        ReplicationCoordinator* replCoord,
+                        const char* opstr,
+                        size_t count,
+                        OplogSlot* slotsOut) {
+        invariant(count > 0);
 
-        fassert(28560, oplog->getRecordStore()->oplogDiskLocRegister(txn, ts));
-
-        long long hashNew = 0;
         long long term = 0;
+        int myId = 0;
+        const bool isReplSet =
+            replCoord->getReplicationMode() == ReplicationCoordinator::modeReplSet;
 
         // Set hash and term if we're in replset mode, otherwise they remain 0 in master/slave.
-        if (replCoord->getReplicationMode() == ReplicationCoordinator::modeReplSet) {
+        // Everything which does not depend on the order of the entries is looked up before taking
+        // newOpMutex.
+        if (isReplSet) {
             // Current term. If we're not a replset of pv=1, it could be the default value (0) or
             // the last valid term before downgrade.
             term = ReplClientInfo::forClient(txn->getClient()).getTerm();
 
-            hashNew = BackgroundSync::get()->getLastAppliedHash();
-
             // Check to make sure logOp() is legal at this point.
             if (*opstr == 'n') {
                 // 'n' operations are always logged
                 invariant(*ns == '\0');
-                // 'n' operations do not advance the hash, since they are not rolled back
             }
             else {
-                // Advance the hash
-                hashNew = (hashNew * 131 + ts.asLL()) * 17 + replCoord->getMyId();
+                myId = replCoord->getMyId();
+            }
+        }
+
+        boost::unique_lock<boost::mutex> lk(newOpMutex, boost::try_to_lock);
+        if (!lk.owns_lock()) {
+            Timer waitTimer;
+            lk.lock();
+            slotReservationsContendedStats.increment();
+            slotReservationWaitMicrosStats.increment(waitTimer.micros());
+        }
+        slotReservationsStats.increment();
+        slotsReservedStats.increment(count);
+
+        const Timestamp first = getNextGlobalTimestamps(count);
+
+        fassert(28560, oplog->getRecordStore()->oplogDiskLocRegister(txn, first));
+
+        long long hashNew = 0;
+        if (isReplSet) {
+            hashNew = BackgroundSync::get()->getLastAppliedHash();
+        }
 
-                BackgroundSync::get()->setLastAppliedHash(hashNew);
+        for (size_t i = 0; i < count; ++i) {
+            const Timestamp ts(first.getSecs(), first.getInc() + i);
+
+            // 'n' operations do not advance the hash, since they are not rolled back
+            if (isReplSet && *opstr != 'n') {
+                // Advance the hash
+                hashNew = (hashNew * 131 + ts.asLL()) * 17 + myId;
             }
+
+            slotsOut[i] = OplogSlot(OpTime(ts, term), hashNew);
         }
 
-        OpTime opTime(ts, term);
-        replCoord->setMyLastOptime(opTime);
-        return std::pair<OpTime,long long>(opTime, hashNew);
+        if (isReplSet && *opstr != 'n') {
+            BackgroundSync::get()->setLastAppliedHash(hashNew);
+        }
+
+        replCoord->setMyLastOptime(slotsOut[count - 1].first);
+        lk.unlock();
+
+        // Waiters check the timestamp under newOpMutex, so notifying after unlocking cannot lose
+        // the wakeup.
+        newTimestampNotifier.notify_all();
     }
 
     /**
@@ -238,41 +304,44 @@ namespace {
 
     */
 
-    void _logOp(OperationContext* txn,
-                const char *opstr,
-                const char *ns,
-                const BSONObj& obj,
-                BSONObj *o2,
-                bool fromMigrate) {
+namespace {
+
+    /**
+     * Returns true if operations on 'ns' by 'txn' need to be written to the oplog.
+     */
+    bool shouldLogOp(OperationContext* txn, const char* ns) {
         if ( strncmp(ns, "local.", 6) == 0 ) {
-            return;
+            return false;
         }
 
         if (NamespaceString(ns).isSystemDotProfile()) {
-            return;
+            return false;
         }
 
         if (!getGlobalReplicationCoordinator()->isReplEnabled()) {
-            return;
+            return false;
         }
 
         if (!txn->writesAreReplicated()) {
-            return;
+            return false;
         }
 
         fassert(28626, txn->recoveryUnit());
+        return true;
+    }
 
-        Lock::DBLock lk(txn->lockState(), "local", MODE_IX);
-
-        ReplicationCoordinator* replCoord = getGlobalReplicationCoordinator();
-
+    /**
+     * Checks that writes to 'ns' may be logged, and returns the oplog collection.
+     * The caller must hold the "local" database and oplog collection locks in MODE_IX.
+     */
+    Collection* getOplogCollectionForWrite(OperationContext* txn,
+                                           ReplicationCoordinator* replCoord,
+                                           const char* ns) {
         if (ns[0] && replCoord->getReplicationMode() == ReplicationCoordinator::modeReplSet &&
                     !replCoord->canAcceptWritesForDatabase(nsToDatabaseSubstring(ns))) {
                 severe() << "logOp() but can't accept write to collection " << ns;
                 fassertFailed(17405);
         }
-        Lock::CollectionLock lk2(txn->lockState(), _oplogCollectionName, MODE_IX);
-
 
         if (_localOplogCollection == nullptr) {
             OldClientContext ctx(txn, _oplogCollectionName);
@@ -284,13 +353,17 @@ namespace {
                             " missing. did you drop it? if so, restart the server",
                     _localOplogCollection);
         }
+        return _localOplogCollection;
+    }
 
-        std::pair<OpTime, long long> slot = getNextOpTime(txn,
-                                                          _localOplogCollection,
-                                                          ns,
-                                                          replCoord,
-                                                          opstr);
-
+    void writeOplogEntry(OperationContext* txn,
+                         Collection* oplog,
+                         const OplogSlot& slot,
+                         const char* opstr,
+                         const char* ns,
+                         const BSONObj& obj,
+                         BSONObj* o2,
+                         bool fromMigrate) {
         /* we jump through a bunch of hoops here to avoid copying the obj buffer twice --
            instead we do a single copy to the destination position in the memory mapped file.
         */
@@ -312,11 +385,60 @@ namespace {
         BSONObj partial = b.done();
 
         OplogDocWriter writer( partial, obj );
-        checkOplogInsert( _localOplogCollection->insertDocument( txn, &writer, false ) );
+        checkOplogInsert( oplog->insertDocument( txn, &writer, false ) );
+    }
+
+} // namespace
+
+    void _logOp(OperationContext* txn,
+                const char *opstr,
+                const char *ns,
+                const BSONObj& obj,
+                BSONObj *o2,
+                bool fromMigrate) {
+        if (!shouldLogOp(txn, ns)) {
+            return;
+        }
+
+        Lock::DBLock lk(txn->lockState(), "local", MODE_IX);
+        ReplicationCoordinator* replCoord = getGlobalReplicationCoordinator();
+        Lock::CollectionLock lk2(txn->lockState(), _oplogCollectionName, MODE_IX);
+        Collection* oplog = getOplogCollectionForWrite(txn, replCoord, ns);
+
+        OplogSlot slot;
+        getNextOpTimes(txn, oplog, ns, replCoord, opstr, 1, &slot);
+
+        writeOplogEntry(txn, oplog, slot, opstr, ns, obj, o2, fromMigrate);
 
         ReplClientInfo::forClient(txn->getClient()).setLastOp( slot.first );
     }
 
+    void _logOps(OperationContext* txn,
+                 const char* opstr,
+                 const char* ns,
+                 std::vector<BSONObj>::const_iterator begin,
+                 std::vector<BSONObj>::const_iterator end,
+                 bool fromMigrate) {
+        if (begin == end || !shouldLogOp(txn, ns)) {
+            return;
+        }
+
+        Lock::DBLock lk(txn->lockState(), "local", MODE_IX);
+        ReplicationCoordinator* replCoord = getGlobalReplicationCoordinator();
+        Lock::CollectionLock lk2(txn->lockState(), _oplogCollectionName, MODE_IX);
+        Collection* oplog = getOplogCollectionForWrite(txn, replCoord, ns);
+
+        const size_t count = end - begin;
+        std::vector<OplogSlot> slots(count);
+        getNextOpTimes(txn, oplog, ns, replCoord, opstr, count, &slots[0]);
+
+        for (size_t i = 0; i < count; ++i) {
+            writeOplogEntry(txn, oplog, slots[i], opstr, ns, begin[i], NULL, fromMigrate);
+        }
+
+        ReplClientInfo::forClient(txn->getClient()).setLastOp( slots.back().first );
+    }
+
     OpTime writeOpsToOplog(OperationContext* txn, const std::deque<BSONObj>& ops) {
         ReplicationCoordinator* replCoord = getGlobalReplicationCoordinator();
 
@@ -347,8 +469,6 @@ namespace {
                 const BSONObj& op = *it;
                 const OpTime optime = extractOpTime(op);
 
-                checkOplogInsert(_localOplogCollection->insertDocument(txn, op, false));
-
                 if (!(lastOptime < optime)) {
                     severe() << "replication oplog stream went back in time. "
                         "previous timestamp: " << lastOptime << " newest timestamp: " << optime
@@ -357,6 +477,12 @@ namespace {
                 }
                 lastOptime = optime;
             }
+
+            const std::vector<BSONObj> opsVector(ops.begin(), ops.end());
+            checkOplogInsert(_localOplogCollection->insertDocuments(txn,
+                                                                    opsVector.begin(),
+                                                                    opsVector.end(),
+                                                                    false));
             wunit.commit();
         } MONGO_WRITE_CONFLICT_RETRY_LOOP_END(txn, "writeOps", _localOplogCollection->ns().ns());
 
@@ -639,7 +765,10 @@ namespace {
         invariant(*opType != 'c'); // commands are processed in applyCommand_inlock()
 
         if ( *opType == 'i' ) {
-            opCounters->gotInsert();
+            // Grouped inserts are counted once they have been applied, see below.
+            if (fieldO.type() != Array) {
+                opCounters->gotInsert();
+            }
 
             const char *p = strchr(ns, '.');
             if ( p && nsToCollectionSubstring( p ) == "system.indexes" ) {
@@ -657,6 +786,35 @@ namespace {
                     uassertStatusOK(status);
                 }
             }
+            else if (fieldO.type() == Array) {
+                // A group of inserts into this collection, formed by the applier out of
+                // consecutive oplog entries. The documents are inserted rather than upserted, so
+                // this fails if any of them was already applied, and the caller must then apply
+                // the entries one at a time. That is only detected through the _id index, so
+                // without one the entries are always applied one at a time.
+                uassert(ErrorCodes::NamespaceNotFound, str::stream() <<
+                        "Failed to apply grouped insert due to missing collection: " << ns,
+                        collection);
+                uassert(ErrorCodes::IndexNotFound, str::stream() <<
+                        "Failed to apply grouped insert due to missing _id index: " << ns,
+                        indexCatalog->findIdIndex(txn));
+
+                std::vector<BSONObj> docs;
+                BSONForEach(elem, o) {
+                    uassert(ErrorCodes::NoSuchKey, str::stream() <<
+                            "Failed to apply grouped insert due to missing _id: " << elem.toString(),
+                            elem.type() == Object && elem.Obj().hasField("_id"));
+                    docs.push_back(elem.Obj());
+                }
+
+                WriteUnitOfWork wuow(txn);
+                uassertStatusOK(collection->insertDocuments(txn, docs.begin(), docs.end(), false));
+                wuow.commit();
+
+                for (size_t i = 0; i < docs.size(); i++) {
+                    opCounters->gotInsert();
+                }
+            }
             else {
                 // do upserts for inserts as we might get replayed more than once
                 OpDebug debug;
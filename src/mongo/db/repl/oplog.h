@@ -31,6 +31,7 @@
 #include <cstddef>
 #include <deque>
 #include <string>
+#include <vector>
 
 #include "mongo/base/status.h"
 #include "mongo/base/disallow_copying.h"
@@ -88,6 +89,18 @@ namespace repl {
                 BSONObj *o2,
                 bool fromMigrate);
 
+    /**
+     * Logs an operation of type 'opstr' on 'ns' for each of the objects in [begin, end), as if
+     * by calling _logOp() on each of them, but reserves the optimes for all of the entries at
+     * once.
+     */
+    void _logOps(OperationContext* txn,
+                 const char* opstr,
+                 const char* ns,
+                 std::vector<BSONObj>::const_iterator begin,
+                 std::vector<BSONObj>::const_iterator end,
+                 bool fromMigrate);
+
     // Flush out the cached pointers to the local database and oplog.
     // Used by the closeDatabase command to ensure we don't cache closed things.
     void oplogCheckCloseDatabase(OperationContext* txn, Database * db);
@@ -85,6 +85,8 @@ namespace repl {
         /* TODO: slaveOk maybe shouldn't use? */
         _tailingQueryOptions |= QueryOption_AwaitData;
 
+        _streaming = false;
+
         readersCreatedStats.increment();
     }
 
@@ -125,18 +127,34 @@ namespace repl {
         );
     }
 
-    void OplogReader::tailingQuery(const char *ns, const BSONObj& query) {
+    void OplogReader::tailingQuery(const char *ns, const BSONObj& query, bool stream) {
         verify( !haveCursor() );
         LOG(2) << ns << ".find(" << query.toString() << ')' << endl;
-        cursor.reset( _conn->query( ns, query, 0, 0, nullptr, _tailingQueryOptions ).release() );
+
+        int options = _tailingQueryOptions;
+        _streaming = stream && (_conn->availableOptions() & QueryOption_Exhaust);
+        if (_streaming) {
+            options |= QueryOption_Exhaust;
+        }
+        cursor.reset( _conn->query( ns, query, 0, 0, nullptr, options ).release() );
     }
 
-    void OplogReader::tailingQueryGTE(const char *ns, Timestamp optime) {
+    void OplogReader::tailingQueryGTE(const char *ns, Timestamp optime, bool stream) {
         BSONObjBuilder gte;
         gte.append("$gte", optime);
         BSONObjBuilder query;
         query.append("ts", gte.done());
-        tailingQuery(ns, query.done());
+        tailingQuery(ns, query.done(), stream);
+    }
+
+    bool OplogReader::stopStreaming() {
+        if (!_streaming) {
+            return true;
+        }
+
+        const HostAndPort host = _host;
+        resetConnection();
+        return connect(host);
     }
 
     HostAndPort OplogReader::getHost() const {
@@ -66,17 +66,29 @@ namespace repl {
         boost::shared_ptr<DBClientCursor> cursor;
         int _tailingQueryOptions;
 
+        // True if cursor is an exhaust cursor, whose batches the sync source pushes over _conn
+        // without waiting for getMores.
+        bool _streaming;
+
         // If _conn was actively connected, _host represents the current HostAndPort of the
         // connection.
         HostAndPort _host;
     public:
         OplogReader();
         ~OplogReader() { }
-        void resetCursor() { cursor.reset(); }
+        void resetCursor() {
+            cursor.reset();
+            if (_streaming) {
+                // The sync source may still be writing batches for the old cursor to the
+                // connection, so it can not be used for anything else.
+                resetConnection();
+            }
+        }
         void resetConnection() {
             cursor.reset();
             _conn.reset();
             _host = HostAndPort();
+            _streaming = false;
         }
         DBClientConnection* conn() { return _conn.get(); }
         BSONObj findOne(const char *ns, const Query& q) {
@@ -102,9 +114,24 @@ namespace repl {
                    int nToSkip,
                    const BSONObj* fields=0);
 
-        void tailingQuery(const char *ns, const BSONObj& query);
+        /**
+         * Opens a tailable, awaitData cursor on 'ns'. If 'stream' is true and the sync source
+         * supports it, the cursor is opened in exhaust mode: the sync source then sends each
+         * batch as soon as it is available, without waiting for a getMore, and relies on the
+         * connection's flow control to hold it back while we are not reading.
+         */
+        void tailingQuery(const char *ns, const BSONObj& query, bool stream = false);
 
-        void tailingQueryGTE(const char *ns, Timestamp t);
+        void tailingQueryGTE(const char *ns, Timestamp t, bool stream = false);
+
+        bool isStreaming() const { return _streaming; }
+
+        /**
+         * If the cursor is streaming, drops it and opens a new connection to the same host, so
+         * that conn() can be used for other requests. Returns false if reconnecting fails, in
+         * which case this OplogReader is left unconnected.
+         */
+        bool stopStreaming();
 
         bool more() {
             uassert( 15910, "Doesn't have cursor for reading oplog", cursor.get() );
@@ -114,10 +114,10 @@ namespace {
     struct ReplicationCoordinatorImpl::WaiterInfo {
 
         /**
-         * Constructor takes the list of waiters and enqueues itself on the list, removing itself
-         * in the destructor.
+         * Constructor takes the list of waiters and enqueues itself on the list at its opTime,
+         * removing itself in the destructor.
          */
-        WaiterInfo(std::vector<WaiterInfo*>* _list,
+        WaiterInfo(WaitersByOpTime* _list,
                    unsigned int _opID,
                    const OpTime* _opTime,
                    const WriteConcernOptions* _writeConcern,
@@ -127,14 +127,15 @@ namespace {
                                                           opTime(_opTime),
                                                           writeConcern(_writeConcern),
                                                           condVar(_condVar) {
-            list->push_back(this);
+            position = list->insert(std::make_pair(*opTime, this));
         }
 
         ~WaiterInfo() {
-            list->erase(std::remove(list->begin(), list->end(), this), list->end());
+            list->erase(position);
         }
 
-        std::vector<WaiterInfo*>* list;
+        WaitersByOpTime* list;
+        WaitersByOpTime::iterator position;
         bool master; // Set to false to indicate that stepDown was called while waiting
         const unsigned int opID;
         const OpTime* opTime;
@@ -143,6 +144,17 @@ namespace {
     };
 
 namespace {
+    /**
+     * Returns the key of the group of _replicationWaiters waiting for 'writeConcern'. Only the
+     * parts of the write concern which decide when it is satisfied matter.
+     */
+    std::string getWaiterGroupKey(const WriteConcernOptions& writeConcern) {
+        if (!writeConcern.wMode.empty()) {
+            return "mode:" + writeConcern.wMode;
+        }
+        return str::stream() << "w:" << writeConcern.wNumNodes;
+    }
+
     ReplicationCoordinator::Mode getReplicationModeFromSettings(const ReplSettings& settings) {
         if (settings.usingReplSets()) {
             return ReplicationCoordinator::modeReplSet;
@@ -409,10 +421,10 @@ namespace {
                 return;
             }
             fassert(18823, _rsConfigState != kConfigStartingUp);
-            for (std::vector<WaiterInfo*>::iterator it = _replicationWaiterList.begin();
-                    it != _replicationWaiterList.end(); ++it) {
-                WaiterInfo* waiter = *it;
-                waiter->condVar->notify_all();
+            for (auto& group : _replicationWaiters) {
+                for (auto& entry : group.second) {
+                    entry.second->condVar->notify_all();
+                }
             }
         }
 
@@ -752,10 +764,11 @@ namespace {
             return;
         }
 
-        for (auto& opTimeWaiter : _opTimeWaiterList) {
-            if (*(opTimeWaiter->opTime) <= opTime) {
-                opTimeWaiter->condVar->notify_all();
+        for (auto& entry : _opTimeWaiters) {
+            if (entry.first > opTime) {
+                break;
             }
+            entry.second->condVar->notify_all();
         }
 
         if (_getMemberState_inlock().primary()) {
@@ -821,7 +834,7 @@ namespace {
             }
 
             boost::condition_variable condVar;
-            WaiterInfo waitInfo(&_opTimeWaiterList,
+            WaiterInfo waitInfo(&_opTimeWaiters,
                                 txn->getOpID(),
                                 &ts,
                                 nullptr, // Don't care about write concern.
@@ -926,18 +939,19 @@ namespace {
 
     void ReplicationCoordinatorImpl::interrupt(unsigned opId) {
         boost::lock_guard<boost::mutex> lk(_mutex);
-        for (std::vector<WaiterInfo*>::iterator it = _replicationWaiterList.begin();
-                it != _replicationWaiterList.end(); ++it) {
-            WaiterInfo* info = *it;
-            if (info->opID == opId) {
-                info->condVar->notify_all();
-                return;
+        for (auto& group : _replicationWaiters) {
+            for (auto& entry : group.second) {
+                WaiterInfo* info = entry.second;
+                if (info->opID == opId) {
+                    info->condVar->notify_all();
+                    return;
+                }
             }
         }
 
-        for (auto& opTimeWaiter : _opTimeWaiterList) {
-            if (opTimeWaiter->opID == opId) {
-                opTimeWaiter->condVar->notify_all();
+        for (auto& entry : _opTimeWaiters) {
+            if (entry.second->opID == opId) {
+                entry.second->condVar->notify_all();
                 return;
             }
         }
@@ -950,14 +964,14 @@ namespace {
 
     void ReplicationCoordinatorImpl::interruptAll() {
         boost::lock_guard<boost::mutex> lk(_mutex);
-        for (std::vector<WaiterInfo*>::iterator it = _replicationWaiterList.begin();
-                it != _replicationWaiterList.end(); ++it) {
-            WaiterInfo* info = *it;
-            info->condVar->notify_all();
+        for (auto& group : _replicationWaiters) {
+            for (auto& entry : group.second) {
+                entry.second->condVar->notify_all();
+            }
         }
 
-        for (auto& opTimeWaiter : _opTimeWaiterList) {
-            opTimeWaiter->condVar->notify_all();
+        for (auto& entry : _opTimeWaiters) {
+            entry.second->condVar->notify_all();
         }
 
         _replExecutor.scheduleWork(
@@ -1101,10 +1115,22 @@ namespace {
             }
         }
 
-        // Must hold _mutex before constructing waitInfo as it will modify _replicationWaiterList
+        // Must hold _mutex before constructing waitInfo as it will modify _replicationWaiters
+        auto group = _replicationWaiters.insert(
+            std::make_pair(getWaiterGroupKey(writeConcern), WaitersByOpTime())).first;
+        // Declared before waitInfo so that it runs once waitInfo has left the group, which the
+        // last waiter then removes rather than leaving one group behind per write concern seen.
+        ON_BLOCK_EXIT([this, group] {
+            if (group->second.empty()) {
+                _replicationWaiters.erase(group);
+            }
+        });
         boost::condition_variable condVar;
-        WaiterInfo waitInfo(
-                &_replicationWaiterList, txn->getOpID(), &opTime, &writeConcern, &condVar);
+        WaiterInfo waitInfo(&group->second,
+                            txn->getOpID(),
+                            &opTime,
+                            &writeConcern,
+                            &condVar);
         while (!_doneWaitingForReplication_inlock(opTime, writeConcern)) {
             const Milliseconds elapsed{timer->millis()};
 
@@ -2058,11 +2084,12 @@ namespace {
         PostMemberStateUpdateAction result;
         if (_memberState.primary() || newState.removed() || newState.rollback()) {
             // Wake up any threads blocked in awaitReplication, close connections, etc.
-            for (std::vector<WaiterInfo*>::iterator it = _replicationWaiterList.begin();
-                 it != _replicationWaiterList.end(); ++it) {
-                WaiterInfo* info = *it;
-                info->master = false;
-                info->condVar->notify_all();
+            for (auto& group : _replicationWaiters) {
+                for (auto& entry : group.second) {
+                    WaiterInfo* info = entry.second;
+                    info->master = false;
+                    info->condVar->notify_all();
+                }
             }
             _isWaitingForDrainToComplete = false;
             _canAcceptNonLocalWrites = false;
@@ -2243,10 +2270,14 @@ namespace {
      }
 
     void ReplicationCoordinatorImpl::_wakeReadyWaiters_inlock(){
-        for (std::vector<WaiterInfo*>::iterator it = _replicationWaiterList.begin();
-                it != _replicationWaiterList.end(); ++it) {
-            WaiterInfo* info = *it;
-            if (_doneWaitingForReplication_inlock(*info->opTime, *info->writeConcern)) {
+        for (auto& group : _replicationWaiters) {
+            // The waiters of a group share their write concern, so once one of them is not done
+            // waiting, none of those waiting for later opTimes are either.
+            for (auto& entry : group.second) {
+                WaiterInfo* info = entry.second;
+                if (!_doneWaitingForReplication_inlock(*info->opTime, *info->writeConcern)) {
+                    break;
+                }
                 info->condVar->notify_all();
             }
         }
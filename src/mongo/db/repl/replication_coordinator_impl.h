@@ -32,8 +32,10 @@
 #include <boost/thread.hpp>
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/condition_variable.hpp>
-#include <vector>
+#include <map>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "mongo/base/status.h"
 #include "mongo/bson/timestamp.h"
@@ -345,6 +347,9 @@ namespace repl {
         // Struct that holds information about clients waiting for replication.
         struct WaiterInfo;
 
+        // Waiters ordered by the optime they are waiting for.
+        typedef std::multimap<OpTime, WaiterInfo*> WaitersByOpTime;
+
         // Struct that holds information about nodes in this replication group, mainly used for
         // tracking replication progress for write concern satisfaction.
         struct SlaveInfo {
@@ -413,7 +418,7 @@ namespace repl {
                 int myIndex);
 
         /**
-         * Helper to wake waiters in _replicationWaiterList that are doneWaitingForReplication.
+         * Helper to wake waiters in _replicationWaiters that are doneWaitingForReplication.
          */
         void _wakeReadyWaiters_inlock();
 
@@ -939,13 +944,15 @@ namespace repl {
         // TODO: ideally this should only change on rollbacks NOT on mongod restarts also.
         int _rbid;                                                                        // (M)
 
-        // list of information about clients waiting on replication.  Does *not* own the
-        // WaiterInfos.
-        std::vector<WaiterInfo*> _replicationWaiterList;                                  // (M)
+        // information about clients waiting on replication, grouped by the number of nodes or
+        // the mode of their write concern, and ordered by opTime within each group.  Whether a
+        // write concern is satisfied is monotonic in the opTime, so waking the satisfied waiters
+        // of a group stops at the first one which is not.  Does *not* own the WaiterInfos.
+        std::map<std::string, WaitersByOpTime> _replicationWaiters;                       // (M)
 
-        // list of information about clients waiting for a particular opTime.
+        // information about clients waiting for a particular opTime, ordered by it.
         // Does *not* own the WaiterInfos.
-        std::vector<WaiterInfo*> _opTimeWaiterList;                                       // (M)
+        WaitersByOpTime _opTimeWaiters;                                                   // (M)
 
         // Set to true when we are in the process of shutting down replication.
         bool _inShutdown;                                                                 // (M)
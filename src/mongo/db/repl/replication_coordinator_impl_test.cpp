@@ -753,6 +753,60 @@ namespace {
         awaiter.reset();
     }
 
+    TEST_F(ReplCoordTest, AwaitReplicationWakesWaitersInOpTimeOrder) {
+        OperationContextNoop txn;
+        assertStartSuccess(
+                BSON("_id" << "mySet" <<
+                     "version" << 2 <<
+                     "members" << BSON_ARRAY(BSON("host" << "node1:12345" << "_id" << 0) <<
+                                             BSON("host" << "node2:12345" << "_id" << 1) <<
+                                             BSON("host" << "node3:12345" << "_id" << 2))),
+                HostAndPort("node1", 12345));
+        ASSERT(getReplCoord()->setFollowerMode(MemberState::RS_SECONDARY));
+        getReplCoord()->setMyLastOptime(OpTimeWithTermZero(100, 0));
+        simulateSuccessfulElection();
+
+        OpTimeWithTermZero time1(100, 1);
+        OpTimeWithTermZero time2(100, 2);
+        OpTimeWithTermZero time3(100, 3);
+
+        WriteConcernOptions w2;
+        w2.wTimeout = WriteConcernOptions::kNoTimeout;
+        w2.wNumNodes = 2;
+        WriteConcernOptions w3 = w2;
+        w3.wNumNodes = 3;
+
+        // Waiters are started out of opTime order, and in two write concern groups.
+        ReplicationAwaiter awaiter3(getReplCoord(), &txn);
+        awaiter3.setOpTime(time3);
+        awaiter3.setWriteConcern(w2);
+        awaiter3.start(&txn);
+        ReplicationAwaiter awaiter1(getReplCoord(), &txn);
+        awaiter1.setOpTime(time1);
+        awaiter1.setWriteConcern(w2);
+        awaiter1.start(&txn);
+        ReplicationAwaiter awaiter2(getReplCoord(), &txn);
+        awaiter2.setOpTime(time2);
+        awaiter2.setWriteConcern(w2);
+        awaiter2.start(&txn);
+        ReplicationAwaiter awaiterAll(getReplCoord(), &txn);
+        awaiterAll.setOpTime(time1);
+        awaiterAll.setWriteConcern(w3);
+        awaiterAll.start(&txn);
+
+        getReplCoord()->setMyLastOptime(time3);
+
+        ASSERT_OK(getReplCoord()->setLastOptime_forTest(2, 1, time1));
+        ASSERT_OK(awaiter1.getResult().status);
+
+        ASSERT_OK(getReplCoord()->setLastOptime_forTest(2, 1, time3));
+        ASSERT_OK(awaiter2.getResult().status);
+        ASSERT_OK(awaiter3.getResult().status);
+
+        ASSERT_OK(getReplCoord()->setLastOptime_forTest(2, 2, time1));
+        ASSERT_OK(awaiterAll.getResult().status);
+    }
+
     TEST_F(ReplCoordTest, AwaitReplicationTimeout) {
         OperationContextNoop txn;
         assertStartSuccess(
@@ -45,6 +45,7 @@
 #include "mongo/db/service_context.h"
 #include "mongo/db/op_observer.h"
 #include "mongo/db/repl/initial_sync.h"
+#include "mongo/db/repl/initial_sync_cloner.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/repl_set_heartbeat_args.h"
 #include "mongo/db/repl/repl_set_heartbeat_args_v1.h"
@@ -160,6 +161,9 @@ namespace repl {
                 return appendCommandStatus(result, status);
 
             status = getGlobalReplicationCoordinator()->processReplSetGetStatus(&result);
+            if (status.isOK()) {
+                InitialSyncProgress::get()->append(&result);
+            }
             return appendCommandStatus(result, status);
         }
     } cmdReplSetGetStatus;
@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status_with.h"
 #include "mongo/db/jsobj.h"
@@ -73,6 +75,14 @@ namespace repl {
          */
         virtual BSONObj findOne(const NamespaceString& nss, const BSONObj& filter) const = 0;
 
+        /**
+         * Fetches the documents of a collection on the sync source whose _id is one of 'ids'.
+         * Documents which do not exist there are left out of the result.
+         * May be called from several threads at once.
+         */
+        virtual std::vector<BSONObj> findByIds(const NamespaceString& nss,
+                                               const std::vector<BSONElement>& ids) const = 0;
+
         /**
          * Clones a single collection from the sync source.
          */
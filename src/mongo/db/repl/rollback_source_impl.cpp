@@ -66,6 +66,55 @@ namespace repl {
         return _conn->findOne(nss.toString(), filter, NULL, QueryOption_SlaveOk).getOwned();
     }
 
+    std::vector<BSONObj> RollbackSourceImpl::findByIds(const NamespaceString& nss,
+                                                       const std::vector<BSONElement>& ids) const {
+        BSONObjBuilder filter;
+        {
+            BSONObjBuilder idBuilder(filter.subobjStart("_id"));
+            BSONArrayBuilder inBuilder(idBuilder.subarrayStart("$in"));
+            for (const BSONElement& id : ids) {
+                inBuilder.append(id);
+            }
+        }
+
+        std::unique_ptr<DBClientConnection> conn = _acquireConnection();
+        std::vector<BSONObj> docs;
+        docs.reserve(ids.size());
+        conn->query([&docs](const BSONObj& doc) { docs.push_back(doc.getOwned()); },
+                    nss.ns(),
+                    filter.obj(),
+                    NULL,
+                    QueryOption_SlaveOk);
+        // A connection is only handed back if its query did not throw.
+        _releaseConnection(std::move(conn));
+        return docs;
+    }
+
+    std::unique_ptr<DBClientConnection> RollbackSourceImpl::_acquireConnection() const {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_connectionsMutex);
+            if (!_connections.empty()) {
+                std::unique_ptr<DBClientConnection> conn = std::move(_connections.back());
+                _connections.pop_back();
+                return conn;
+            }
+        }
+
+        std::string errmsg;
+        std::unique_ptr<DBClientConnection> conn(new DBClientConnection());
+        uassert(28685,
+                str::stream() << "rollback couldn't connect to "
+                              << _conn->getServerHostAndPort().toString() << ": " << errmsg,
+                conn->connect(_conn->getServerHostAndPort(), errmsg) &&
+                replAuthenticate(conn.get()));
+        return conn;
+    }
+
+    void RollbackSourceImpl::_releaseConnection(std::unique_ptr<DBClientConnection> conn) const {
+        stdx::lock_guard<stdx::mutex> lk(_connectionsMutex);
+        _connections.push_back(std::move(conn));
+    }
+
     void RollbackSourceImpl::copyCollectionFromRemote(OperationContext* txn,
                                                       const NamespaceString& nss) const {
         std::string errmsg;
@@ -28,10 +28,13 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "mongo/db/repl/oplog_interface_remote.h"
 #include "mongo/db/repl/rollback_source.h"
+#include "mongo/stdx/mutex.h"
 
 namespace mongo {
 
@@ -56,6 +59,9 @@ namespace repl {
 
         BSONObj findOne(const NamespaceString& nss, const BSONObj& filter) const override;
 
+        std::vector<BSONObj> findByIds(const NamespaceString& nss,
+                                       const std::vector<BSONElement>& ids) const override;
+
         void copyCollectionFromRemote(OperationContext* txn,
                                       const NamespaceString& nss) const override;
 
@@ -63,10 +69,23 @@ namespace repl {
 
     private:
 
+        /**
+         * Returns a connection to the sync source which is not in use by any other thread,
+         * opening a new one if needed. Hand it back with _releaseConnection() once done.
+         */
+        std::unique_ptr<DBClientConnection> _acquireConnection() const;
+
+        void _releaseConnection(std::unique_ptr<DBClientConnection> conn) const;
+
         DBClientConnection* _conn;
         std::string _collectionName;
         OplogInterfaceRemote _oplog;
 
+        // Connections used by findByIds(), which runs on several threads, unlike the other
+        // methods, which share _conn.
+        mutable stdx::mutex _connectionsMutex;
+        mutable std::vector<std::unique_ptr<DBClientConnection>> _connections;
+
     };
 
 
@@ -37,9 +37,9 @@
 #include "mongo/db/auth/authorization_manager.h"
 #include "mongo/db/auth/authorization_manager_global.h"
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/catalog/document_validation.h"
 #include "mongo/db/client.h"
-#include "mongo/db/cloner.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/dbhelpers.h"
@@ -49,15 +49,18 @@
 #include "mongo/db/operation_context_impl.h"
 #include "mongo/db/repl/bgsync.h"
 #include "mongo/db/repl/initial_sync.h"
+#include "mongo/db/repl/initial_sync_cloner.h"
 #include "mongo/db/repl/minvalid.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/oplogreader.h"
 #include "mongo/db/repl/repl_client_info.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace repl {
@@ -69,6 +72,14 @@ namespace {
     // Failpoint which fails initial sync and leaves on oplog entry in the buffer.
     MONGO_FP_DECLARE(failInitSyncWithBufferedEntriesLeft);
 
+    // Number of threads, each with its own connection to the sync source, which clone the data
+    // and build the indexes.
+    MONGO_EXPORT_SERVER_PARAMETER(initialSyncCloneThreads, int, 4);
+
+    // Collections larger than this are split into ranges of _id which are cloned concurrently.
+    // 0 clones every collection as a whole.
+    MONGO_EXPORT_SERVER_PARAMETER(initialSyncCloneRangeBytes, long long, 256 * 1024 * 1024);
+
     /**
      * Truncates the oplog (removes any documents) and resets internal variables that were
      * originally initialized or affected by using values from the oplog at startup time.  These
@@ -163,52 +174,6 @@ namespace {
         }
     }
 
-    bool _initialSyncClone(OperationContext* txn,
-                           Cloner& cloner,
-                           const std::string& host,
-                           const list<string>& dbs,
-                           bool dataPass) {
-
-        for( list<string>::const_iterator i = dbs.begin(); i != dbs.end(); i++ ) {
-            const string db = *i;
-            if ( db == "local" )
-                continue;
-
-            if ( dataPass )
-                log() << "initial sync cloning db: " << db;
-            else
-                log() << "initial sync cloning indexes for : " << db;
-
-            CloneOptions options;
-            options.fromDB = db;
-            options.slaveOk = true;
-            options.useReplAuth = true;
-            options.snapshot = false;
-            options.mayYield = true;
-            options.mayBeInterrupted = false;
-            options.syncData = dataPass;
-            options.syncIndexes = ! dataPass;
-
-            // Make database stable
-            ScopedTransaction transaction(txn, MODE_IX);
-            Lock::DBLock dbWrite(txn->lockState(), db, MODE_X);
-
-            Status status = cloner.copyDb(txn, db, host, options, NULL);
-            if (!status.isOK()) {
-                log() << "initial sync: error while "
-                      << (dataPass ? "cloning " : "indexing ") << db
-                      << ".  " << status.toString();
-                return false;
-            }
-
-            if (db == "admin") {
-                checkAdminDatabasePostClone(txn, dbHolder().get(txn, db));
-            }
-        }
-
-        return true;
-    }
-
     /**
      * Replays the sync target's oplog from lastOp to the latest op on the sync target.
      *
@@ -345,6 +310,10 @@ namespace {
 
         log() << "initial sync pending";
 
+        InitialSyncProgress* progress = InitialSyncProgress::get();
+        progress->start();
+        ON_BLOCK_EXIT(&InitialSyncProgress::finish, progress);
+
         BackgroundSync* bgsync(BackgroundSync::get());
         OperationContextImpl txn;
         txn.setReplicatedWrites(false);
@@ -402,11 +371,22 @@ namespace {
             }
         }
 
-        Cloner cloner;
-        if (!_initialSyncClone(&txn, cloner, r.conn()->getServerAddress(), dbs, true)) {
+        progress->setPhase("cloning data");
+        InitialSyncCloner cloner(r.conn()->getServerAddress(),
+                                 initialSyncCloneThreads,
+                                 initialSyncCloneRangeBytes);
+        Status cloneStatus = cloner.cloneData(&txn, dbs);
+        if (!cloneStatus.isOK()) {
+            log() << "initial sync: error while cloning: " << cloneStatus;
             return Status(ErrorCodes::InitialSyncFailure, "initial sync failed data cloning");
         }
 
+        if (std::find(dbs.begin(), dbs.end(), "admin") != dbs.end()) {
+            ScopedTransaction transaction(&txn, MODE_IX);
+            Lock::DBLock dbLock(txn.lockState(), "admin", MODE_X);
+            checkAdminDatabasePostClone(&txn, dbHolder().get(&txn, "admin"));
+        }
+
         log() << "initial sync data copy, starting syncup";
 
         // prime oplog
@@ -421,6 +401,7 @@ namespace {
 
         std::string msg = "oplog sync 1 of 3";
         log() << msg;
+        progress->setPhase(msg);
         if (!_initialSyncApplyOplog(&txn, init, &r)) {
             return Status(ErrorCodes::InitialSyncFailure,
                           str::stream() << "initial sync failed: " << msg);
@@ -431,6 +412,7 @@ namespace {
         // nothing should need to be recloned.
         msg = "oplog sync 2 of 3";
         log() << msg;
+        progress->setPhase(msg);
         if (!_initialSyncApplyOplog(&txn, init, &r)) {
             return Status(ErrorCodes::InitialSyncFailure,
                           str::stream() << "initial sync failed: " << msg);
@@ -439,7 +421,10 @@ namespace {
 
         msg = "initial sync building indexes";
         log() << msg;
-        if (!_initialSyncClone(&txn, cloner, r.conn()->getServerAddress(), dbs, false)) {
+        progress->setPhase("building indexes");
+        Status indexStatus = cloner.buildIndexes(&txn);
+        if (!indexStatus.isOK()) {
+            log() << "initial sync: error while building indexes: " << indexStatus;
             return Status(ErrorCodes::InitialSyncFailure,
                           str::stream() << "initial sync failed: " << msg);
         }
@@ -450,6 +435,7 @@ namespace {
         // could have fetched newer document than the oplog entry we were applying from).
         msg = "oplog sync 3 of 3";
         log() << msg;
+        progress->setPhase(msg);
 
         SyncTail tail(bgsync, multiSyncApply);
         if (!_initialSyncApplyOplog(&txn, tail, &r)) {
@@ -466,6 +452,7 @@ namespace {
         }
 
         log() << "initial sync finishing up";
+        progress->setPhase("finishing up");
 
         {
             ScopedTransaction scopedXact(&txn, MODE_IX);
@@ -36,6 +36,7 @@
 #include <boost/shared_ptr.hpp>
 #include <memory>
 
+#include "mongo/base/counter.h"
 #include "mongo/db/auth/authorization_manager_global.h"
 #include "mongo/db/auth/authorization_manager.h"
 #include "mongo/db/catalog/collection.h"
@@ -43,6 +44,7 @@
 #include "mongo/db/catalog/document_validation.h"
 #include "mongo/db/client.h"
 #include "mongo/db/commands.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/dbhelpers.h"
 #include "mongo/db/exec/working_set_common.h"
@@ -61,7 +63,12 @@
 #include "mongo/db/repl/roll_back_local_operations.h"
 #include "mongo/db/repl/rollback_source.h"
 #include "mongo/db/repl/rslog.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/stats/timer_stats.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/log.h"
+#include "mongo/util/timer.h"
 
 /* Scenarios
  *
@@ -115,6 +122,34 @@ namespace mongo {
 namespace repl {
 namespace {
 
+    // Number of threads refetching documents from the sync source during rollback.
+    MONGO_EXPORT_SERVER_PARAMETER(rollbackRefetchThreads, int, 4);
+
+    // Upper bounds on the number and total size of the _ids refetched by a single query.
+    const size_t kMaxRefetchBatchIds = 1000;
+    const int kMaxRefetchBatchBytes = 1024 * 1024;
+
+    // Time spent in each phase of rollback
+    TimerStats findCommonPointStats;
+    ServerStatusMetricField<TimerStats> displayFindCommonPoint("repl.rollback.findCommonPoint",
+                                                               &findCommonPointStats);
+    TimerStats refetchStats;
+    ServerStatusMetricField<TimerStats> displayRefetch("repl.rollback.refetch", &refetchStats);
+    TimerStats resyncCollectionsStats;
+    ServerStatusMetricField<TimerStats> displayResyncCollections(
+                                                "repl.rollback.resyncCollections",
+                                                &resyncCollectionsStats);
+    TimerStats fixUpDocumentsStats;
+    ServerStatusMetricField<TimerStats> displayFixUpDocuments("repl.rollback.fixUpDocuments",
+                                                              &fixUpDocumentsStats);
+    TimerStats truncateOplogStats;
+    ServerStatusMetricField<TimerStats> displayTruncateOplog("repl.rollback.truncateOplog",
+                                                             &truncateOplogStats);
+
+    Counter64 docsRefetched;
+    ServerStatusMetricField<Counter64> displayDocsRefetched("repl.rollback.docsRefetched",
+                                                            &docsRefetched);
+
     class RSFatalException : public std::exception {
     public:
         RSFatalException(std::string m = "replica set fatal exception")
@@ -159,6 +194,107 @@ namespace {
         int rbid; // remote server's current rollback sequence #
     };
 
+    /**
+     * Refetches the current version of every document in 'toRefetch' from the sync source.
+     * Documents are fetched in batches of _ids of the same namespace, which are spread over
+     * rollbackRefetchThreads threads. Documents which no longer exist at the sync source are
+     * paired with an empty object, meaning that they should be deleted.
+     */
+    void refetchDocuments(const set<DocID>& toRefetch,
+                          const RollbackSource& rollbackSource,
+                          list< pair<DocID, BSONObj> >* goodVersions) {
+        // Each batch is a range of 'toRefetch', which is ordered by namespace first.
+        typedef pair<set<DocID>::const_iterator, set<DocID>::const_iterator> Batch;
+        std::vector<Batch> batches;
+        for (set<DocID>::const_iterator it = toRefetch.begin(); it != toRefetch.end();) {
+            set<DocID>::const_iterator batchEnd = it;
+            size_t batchIds = 0;
+            int batchBytes = 0;
+            while (batchEnd != toRefetch.end() &&
+                   strcmp(batchEnd->ns, it->ns) == 0 &&
+                   batchIds < kMaxRefetchBatchIds &&
+                   batchBytes < kMaxRefetchBatchBytes) {
+                verify(!batchEnd->_id.eoo());
+                batchBytes += batchEnd->_id.size();
+                ++batchIds;
+                ++batchEnd;
+            }
+            batches.push_back(Batch(it, batchEnd));
+            it = batchEnd;
+        }
+
+        stdx::mutex mutex;
+        map<DocID, BSONObj> fetched;
+        unsigned long long totalSize = 0;
+        Status status = Status::OK();
+        const char* failedNs = NULL;
+
+        auto fetchBatch = [&](const Batch& batch) {
+            {
+                stdx::lock_guard<stdx::mutex> lk(mutex);
+                if (!status.isOK()) {
+                    return;
+                }
+            }
+
+            try {
+                std::vector<BSONElement> ids;
+                for (set<DocID>::const_iterator it = batch.first; it != batch.second; ++it) {
+                    ids.push_back(it->_id);
+                }
+                std::vector<BSONObj> docs =
+                    rollbackSource.findByIds(NamespaceString(batch.first->ns), ids);
+
+                stdx::lock_guard<stdx::mutex> lk(mutex);
+                for (const BSONObj& good : docs) {
+                    DocID doc;
+                    doc.ownedObj = good;
+                    doc.ns = batch.first->ns;
+                    doc._id = good["_id"];
+                    totalSize += good.objsize();
+                    fetched[doc] = good;
+                }
+                uassert(13410, "replSet too much data to roll back",
+                        totalSize < 300 * 1024 * 1024);
+            }
+            catch (const DBException& e) {
+                stdx::lock_guard<stdx::mutex> lk(mutex);
+                if (status.isOK()) {
+                    status = e.toStatus();
+                    failedNs = batch.first->ns;
+                }
+            }
+        };
+
+        if (batches.size() > 1 && rollbackRefetchThreads > 1) {
+            ThreadPool pool(std::min(static_cast<size_t>(rollbackRefetchThreads), batches.size()),
+                            "rollback refetch ");
+            for (const Batch& batch : batches) {
+                pool.schedule([&fetchBatch, &batch] { fetchBatch(batch); });
+            }
+            pool.join();
+        }
+        else {
+            for (const Batch& batch : batches) {
+                fetchBatch(batch);
+            }
+        }
+
+        if (!status.isOK()) {
+            error() << "rollback couldn't re-get documents of ns:" << failedNs << ' '
+                    << status.toString() << ' ' << fetched.size() << '/' << toRefetch.size();
+            uassertStatusOK(status);
+        }
+
+        for (const DocID& doc : toRefetch) {
+            map<DocID, BSONObj>::const_iterator it = fetched.find(doc);
+            // note a missing document means we should delete it
+            goodVersions->push_back(pair<DocID, BSONObj>(doc, it == fetched.end() ? BSONObj() :
+                                                                                   it->second));
+        }
+        docsRefetched.increment(toRefetch.size());
+    }
+
 
     Status refetch(FixUpInfo& fixUpInfo, const BSONObj& ourObj) {
         const char* op = ourObj.getStringField("op");
@@ -276,35 +412,14 @@ namespace {
                    ReplicationCoordinator* replCoord) {
         // fetch all first so we needn't handle interruption in a fancy way
 
-        unsigned long long totalSize = 0;
-
         list< pair<DocID, BSONObj> > goodVersions;
 
         BSONObj newMinValid;
 
         // fetch all the goodVersions of each document from current primary
-        DocID doc;
-        unsigned long long numFetched = 0;
+        Timer refetchTimer;
         try {
-            for (set<DocID>::iterator it = fixUpInfo.toRefetch.begin();
-                    it != fixUpInfo.toRefetch.end();
-                    it++) {
-                doc = *it;
-
-                verify(!doc._id.eoo());
-
-                {
-                    // TODO : slow.  lots of round trips.
-                    numFetched++;
-                    BSONObj good = rollbackSource.findOne(NamespaceString(doc.ns), doc._id.wrap());
-                    totalSize += good.objsize();
-                    uassert(13410, "replSet too much data to roll back",
-                            totalSize < 300 * 1024 * 1024);
-
-                    // note good might be eoo, indicating we should delete it
-                    goodVersions.push_back(pair<DocID, BSONObj>(doc,good));
-                }
-            }
+            refetchDocuments(fixUpInfo.toRefetch, rollbackSource, &goodVersions);
             newMinValid = rollbackSource.getLastOperation();
             if (newMinValid.isEmpty()) {
                 error() << "rollback error newMinValid empty?";
@@ -313,10 +428,11 @@ namespace {
         }
         catch (const DBException& e) {
             LOG(1) << "rollback re-get objects: " << e.toString();
-            error() << "rollback couldn't re-get ns:" << doc.ns << " _id:" << doc._id << ' '
-                    << numFetched << '/' << fixUpInfo.toRefetch.size();
-            throw e;
+            throw;
         }
+        refetchStats.recordMillis(refetchTimer.millis());
+        log() << "rollback refetched " << goodVersions.size() << " documents in "
+              << refetchTimer.millis() << "ms";
 
         log() << "rollback 3.5";
         if (fixUpInfo.rbid != rollbackSource.getRollbackId()) {
@@ -342,6 +458,7 @@ namespace {
         // any full collection resyncs required?
         if (!fixUpInfo.collectionsToResyncData.empty()
                 || !fixUpInfo.collectionsToResyncMetadata.empty()) {
+            TimerHolder resyncTimer(&resyncCollectionsStats);
 
             for (const string& ns : fixUpInfo.collectionsToResyncData) {
                 log() << "rollback 4.1.1 coll resync " << ns;
@@ -453,6 +570,7 @@ namespace {
             log() << "rollback 4.3";
         }
 
+        Timer fixUpDocumentsTimer;
         map<string,shared_ptr<Helpers::RemoveSaver> > removeSavers;
 
         log() << "rollback 4.6";
@@ -660,13 +778,16 @@ namespace {
         }
 
         removeSavers.clear(); // this effectively closes all of them
-        log() << "rollback 5 d:" << deletes << " u:" << updates;
+        fixUpDocumentsStats.recordMillis(fixUpDocumentsTimer.millis());
+        log() << "rollback 5 d:" << deletes << " u:" << updates << " in "
+              << fixUpDocumentsTimer.millis() << "ms";
         log() << "rollback 6";
 
         // clean up oplog
         LOG(2) << "rollback truncate oplog after " <<
                 fixUpInfo.commonPoint.toStringPretty();
         {
+            TimerHolder truncateTimer(&truncateOplogStats);
             const NamespaceString oplogNss(rsOplogName);
             ScopedTransaction transaction(txn, MODE_IX);
             Lock::DBLock oplogDbLock(txn->lockState(), oplogNss.db(), MODE_IX);
@@ -731,6 +852,7 @@ namespace {
         how.rbid = rollbackSource.getRollbackId();
         {
             log() << "rollback 2 FindCommonPoint";
+            TimerHolder findCommonPointTimer(&findCommonPointStats);
             try {
                 auto processOperationForFixUp = [&how](const BSONObj& operation) {
                     return refetch(how, operation);
@@ -29,7 +29,9 @@
 #include "mongo/platform/basic.h"
 
 #include <list>
+#include <map>
 #include <memory>
+#include <string>
 #include <utility>
 
 #include "mongo/db/catalog/collection.h"
@@ -49,6 +51,7 @@
 #include "mongo/db/repl/rollback_source.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage_options.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/unittest/temp_dir.h"
 
@@ -84,6 +87,8 @@ namespace {
         const OplogInterface& getOplog() const override;
         BSONObj getLastOperation() const override;
         BSONObj findOne(const NamespaceString& nss, const BSONObj& filter) const override;
+        std::vector<BSONObj> findByIds(const NamespaceString& nss,
+                                       const std::vector<BSONElement>& ids) const override;
         void copyCollectionFromRemote(OperationContext* txn,
                                       const NamespaceString& nss) const override;
         StatusWith<BSONObj> getCollectionInfo(const NamespaceString& nss) const override;
@@ -113,6 +118,18 @@ namespace {
         return BSONObj();
     }
 
+    std::vector<BSONObj> RollbackSourceMock::findByIds(const NamespaceString& nss,
+                                                       const std::vector<BSONElement>& ids) const {
+        std::vector<BSONObj> docs;
+        for (const BSONElement& id : ids) {
+            BSONObj doc = findOne(nss, id.wrap());
+            if (!doc.isEmpty()) {
+                docs.push_back(doc);
+            }
+        }
+        return docs;
+    }
+
     void RollbackSourceMock::copyCollectionFromRemote(OperationContext* txn,
                                                       const NamespaceString& nss) const { }
 
@@ -397,6 +414,72 @@ namespace {
         ASSERT_EQUALS(1, _testRollBackDelete(_txn.get(), _coordinator.get(), doc));
     }
 
+    TEST_F(RSRollbackTest, RollBackInsertsRefetchesDocumentsInBatchesByNamespace) {
+        createOplog(_txn.get());
+        _createCollection(_txn.get(), "test.t", CollectionOptions());
+        _createCollection(_txn.get(), "test.u", CollectionOptions());
+        auto commonOperation =
+            std::make_pair(BSON("ts" << Timestamp(Seconds(1), 0) << "h" << 1LL), RecordId(1));
+        OplogInterfaceMock::Operations localOperations;
+        int numInserts = 0;
+        for (auto ns : {"test.t", "test.u"}) {
+            for (int i = 0; i < 3; i++) {
+                numInserts++;
+                localOperations.push_front(
+                    std::make_pair(BSON("ts" << Timestamp(Seconds(1 + numInserts), 0) <<
+                                        "h" << 1LL <<
+                                        "op" << "i" <<
+                                        "ns" << ns <<
+                                        "o" << BSON("_id" << i)),
+                                   RecordId(1 + numInserts)));
+            }
+        }
+        localOperations.push_back(commonOperation);
+
+        class RollbackSourceLocal : public RollbackSourceMock {
+        public:
+            RollbackSourceLocal(std::unique_ptr<OplogInterface> oplog)
+                : RollbackSourceMock(std::move(oplog)) { }
+            std::vector<BSONObj> findByIds(const NamespaceString& nss,
+                                           const std::vector<BSONElement>& ids) const {
+                stdx::lock_guard<stdx::mutex> lk(_mutex);
+                idsByNs[nss.ns()] += ids.size();
+                ++calls;
+                // Only the document with _id 1 in test.t still exists on the sync source.
+                if (nss.ns() == "test.t") {
+                    return {BSON("_id" << 1 << "a" << 1)};
+                }
+                return {};
+            }
+            mutable std::map<std::string, size_t> idsByNs;
+            mutable int calls = 0;
+        private:
+            mutable stdx::mutex _mutex;
+        };
+        RollbackSourceLocal rollbackSource(std::unique_ptr<OplogInterface>(new OplogInterfaceMock({
+            commonOperation,
+        })));
+        OpTime opTime(localOperations.front().first["ts"].timestamp(),
+                      localOperations.front().first["h"].Long());
+        ASSERT_OK(
+            syncRollback(
+                _txn.get(),
+                opTime,
+                OplogInterfaceMock(localOperations),
+                rollbackSource,
+                _coordinator.get(),
+                noSleep));
+        ASSERT_EQUALS(2, rollbackSource.calls);
+        ASSERT_EQUALS(3U, rollbackSource.idsByNs["test.t"]);
+        ASSERT_EQUALS(3U, rollbackSource.idsByNs["test.u"]);
+
+        Lock::DBLock dbLock(_txn->lockState(), "test", MODE_S);
+        auto db = dbHolder().get(_txn.get(), "test");
+        ASSERT_TRUE(db);
+        ASSERT_EQUALS(1, db->getCollection("test.t")->getRecordStore()->numRecords(_txn.get()));
+        ASSERT_EQUALS(0, db->getCollection("test.u")->getRecordStore()->numRecords(_txn.get()));
+    }
+
     TEST_F(RSRollbackTest, RollbackUnknownCommand) {
         createOplog(_txn.get());
         auto commonOperation =
@@ -49,6 +49,7 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/namespace_string.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/operation_context_impl.h"
 #include "mongo/db/prefetch.h"
@@ -58,7 +59,11 @@
 #include "mongo/db/repl/repl_client_info.h"
 #include "mongo/db/repl/replica_set_config.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
+#include "mongo/db/repl/writer_count_tuner.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/stats/timer_stats.h"
+#include "mongo/db/storage/batch_snapshot_manager.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
@@ -70,15 +75,168 @@ namespace mongo {
 
 namespace repl {
 #if defined(MONGO_PLATFORM_64)
-    const int replWriterThreadCount = 16;
+    const int kDefaultWriterThreadCount = 16;
     const int replPrefetcherThreadCount = 16;
 #elif defined(MONGO_PLATFORM_32)
-    const int replWriterThreadCount = 2;
+    const int kDefaultWriterThreadCount = 2;
     const int replPrefetcherThreadCount = 2;
 #else
 #error need to include something that defines MONGO_PLATFORM_XX
 #endif
 
+namespace {
+
+    const int kMaxWriterThreadCount = 256;
+
+    /**
+     * An integer server parameter which must lie within [min, max].
+     */
+    class BoundedIntParameter : public ExportedServerParameter<int> {
+    public:
+        BoundedIntParameter(const std::string& name,
+                            int* value,
+                            int min,
+                            int max,
+                            bool allowedToChangeAtRuntime)
+            : ExportedServerParameter<int>(ServerParameterSet::getGlobal(),
+                                           name,
+                                           value,
+                                           true,
+                                           allowedToChangeAtRuntime),
+              _min(min),
+              _max(max) { }
+
+        virtual Status validate(const int& potentialNewValue) {
+            if (potentialNewValue < _min || potentialNewValue > _max) {
+                return Status(ErrorCodes::BadValue,
+                              str::stream() << name() << " must be between " << _min
+                                            << " and " << _max);
+            }
+            return Status::OK();
+        }
+
+    private:
+        const int _min;
+        const int _max;
+    };
+
+    // Number of threads in the writer pool.
+    int replWriterThreadCount = kDefaultWriterThreadCount;
+    BoundedIntParameter replWriterThreadCountParam("replWriterThreadCount",
+                                                   &replWriterThreadCount,
+                                                   1,
+                                                   kMaxWriterThreadCount,
+                                                   false);
+
+    // Number of writer threads each batch is spread over, or 0 for all of them. Ignored while
+    // replWriterAutoTune is set.
+    int replBatchWriterCount = 0;
+    BoundedIntParameter replBatchWriterCountParam("replBatchWriterCount",
+                                                  &replBatchWriterCount,
+                                                  0,
+                                                  kMaxWriterThreadCount,
+                                                  true);
+
+    // Whether the number of writer threads each batch is spread over is picked by the
+    // WriterCountTuner.
+    MONGO_EXPORT_SERVER_PARAMETER(replWriterAutoTune, bool, false);
+
+    // Cap the batches using the limit on journal commits.
+    // This works out to be 100 MB (64 bit) or 50 MB (32 bit)
+    int replBatchLimitBytes = dur::UncommittedBytesLimit;
+    BoundedIntParameter replBatchLimitBytesParam("replBatchLimitBytes",
+                                                 &replBatchLimitBytes,
+                                                 1024 * 1024,
+                                                 dur::UncommittedBytesLimit,
+                                                 true);
+
+    int replBatchLimitOperations = 5000;
+    BoundedIntParameter replBatchLimitOperationsParam("replBatchLimitOperations",
+                                                      &replBatchLimitOperations,
+                                                      1,
+                                                      1000 * 1000,
+                                                      true);
+
+    /**
+     * Reports how busy each writer thread has been, under repl.apply.writers.
+     */
+    class WriterStats : public ServerStatusMetric {
+    public:
+        WriterStats() : ServerStatusMetric("repl.apply.writers") { }
+
+        /**
+         * Records a batch spread over busyMicros.size() writers, which took 'elapsedMicros' in
+         * all. The i-th writer applied 'ops[i]' entries in 'busyMicros[i]'.
+         */
+        void recordBatch(const std::vector<size_t>& ops,
+                         const std::vector<long long>& busyMicros,
+                         long long elapsedMicros) {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            if (_writers.size() < busyMicros.size()) {
+                _writers.resize(busyMicros.size());
+            }
+            for (size_t i = 0; i < busyMicros.size(); ++i) {
+                _writers[i].ops += ops[i];
+                _writers[i].busyMicros += busyMicros[i];
+                _writers[i].idleMicros += std::max(0LL, elapsedMicros - busyMicros[i]);
+            }
+            _lastWriterCount = busyMicros.size();
+        }
+
+        virtual void appendAtLeaf(BSONObjBuilder& b) const {
+            BSONObjBuilder writersBuilder(b.subobjStart(_leafName));
+            writersBuilder.append("poolSize", replWriterThreadCount);
+            writersBuilder.append("autoTune", replWriterAutoTune);
+
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            writersBuilder.append("inUse", static_cast<int>(_lastWriterCount));
+
+            // Time a writer spent idle only counts batches it was part of.
+            BSONArrayBuilder perWriterBuilder(writersBuilder.subarrayStart("perWriter"));
+            for (size_t i = 0; i < _writers.size(); ++i) {
+                const PerWriter& writer = _writers[i];
+                const long long totalMicros = writer.busyMicros + writer.idleMicros;
+                BSONObjBuilder writerBuilder(perWriterBuilder.subobjStart());
+                writerBuilder.append("ops", writer.ops);
+                writerBuilder.append("busyMillis", writer.busyMicros / 1000);
+                writerBuilder.append("idleMillis", writer.idleMicros / 1000);
+                writerBuilder.append("utilization", totalMicros > 0 ?
+                    static_cast<double>(writer.busyMicros) / totalMicros : 0.0);
+            }
+        }
+
+    private:
+        struct PerWriter {
+            long long ops = 0;
+            long long busyMicros = 0;
+            long long idleMicros = 0;
+        };
+
+        mutable stdx::mutex _mutex;
+        std::vector<PerWriter> _writers;
+        size_t _lastWriterCount = 0;
+    } writerStats;
+
+    WriterCountTuner& getWriterCountTuner() {
+        static WriterCountTuner tuner(replWriterThreadCount);
+        return tuner;
+    }
+
+    /**
+     * Returns how many writers the next batch should be spread over.
+     */
+    size_t getBatchWriterCount() {
+        if (replWriterAutoTune) {
+            return getWriterCountTuner().getWriterCount();
+        }
+        if (replBatchWriterCount > 0) {
+            return std::min(replBatchWriterCount, replWriterThreadCount);
+        }
+        return replWriterThreadCount;
+    }
+
+} // namespace
+
     static Counter64 opsAppliedStats;
 
     //The oplog entries applied
@@ -87,11 +245,41 @@ namespace repl {
 
     MONGO_FP_DECLARE(rsSyncApplyStop);
 
+    // Pauses batch application while the parallel batch writer lock is held, for testing reads
+    // from the batch snapshot.
+    MONGO_FP_DECLARE(hangDuringBatchApplication);
+
     // Number and time of each ApplyOps worker pool round
     static TimerStats applyBatchStats;
     static ServerStatusMetricField<TimerStats> displayOpBatchesApplied(
                                                     "repl.apply.batches",
                                                     &applyBatchStats );
+
+    // Time spent in each phase of a batch: gathering its ops from the bgsync buffer, prefetching
+    // them before they are applied (mmapv1 only), applying them and writing them to the oplog,
+    // and making sure minValid covers the batch beforehand.
+    static TimerStats batchFetchStats;
+    static ServerStatusMetricField<TimerStats> displayBatchFetch("repl.apply.phases.fetch",
+                                                                 &batchFetchStats);
+    static TimerStats batchPrefetchStats;
+    static ServerStatusMetricField<TimerStats> displayBatchPrefetch("repl.apply.phases.prefetch",
+                                                                    &batchPrefetchStats);
+    static TimerStats batchApplyStats;
+    static ServerStatusMetricField<TimerStats> displayBatchApply("repl.apply.phases.apply",
+                                                                 &batchApplyStats);
+    static TimerStats batchMarkerStats;
+    static ServerStatusMetricField<TimerStats> displayBatchMarker("repl.apply.phases.marker",
+                                                                  &batchMarkerStats);
+
+    // Batches which were already covered by minValid, and so did not write it.
+    static Counter64 minValidWritesSkippedStats;
+    static ServerStatusMetricField<Counter64> displayMinValidWritesSkipped(
+                                                    "repl.apply.minValidWritesSkipped",
+                                                    &minValidWritesSkippedStats);
+
+    // Whether minValid is written ahead to the last op fetched, to cover the following batches
+    // too, rather than to the end of each batch.
+    MONGO_EXPORT_SERVER_PARAMETER(replMinValidWriteAhead, bool, true);
     void initializePrefetchThread() {
         if (!ClientBasic::getCurrent()) {
             Client::initThreadIfNotAlready();
@@ -176,7 +364,18 @@ namespace repl {
             DisableDocumentValidation validationDisabler(txn);
 
             Status status = applyOperationInLock(txn, db, op, convertUpdateToUpsert);
-            incrementOpsAppliedStats();
+
+            // A grouped insert counts as one operation for each of its documents.
+            int numOps = 1;
+            if (opType[0] == 'i') {
+                const BSONElement fieldO = op["o"];
+                if (fieldO.type() == Array) {
+                    numOps = fieldO.Obj().nFields();
+                }
+            }
+            for (int i = 0; i < numOps; i++) {
+                incrementOpsAppliedStats();
+            }
             return status;
         };
 
@@ -247,8 +446,14 @@ namespace repl {
 
 namespace {
 
-    // The pool threads call this to prefetch each op
-    void prefetchOp(const BSONObj& op) {
+    // The pool threads call this to prefetch each op. 'batchApplied' is only given when
+    // prefetching alongside the writers, and is set once they are done with the batch, after
+    // which there is nothing left to prefetch for.
+    void prefetchOp(const BSONObj& op, const AtomicWord<bool>* batchApplied) {
+        if (batchApplied && batchApplied->load()) {
+            return;
+        }
+
         initializePrefetchThread();
 
         const char *ns = op.getStringField("ns");
@@ -257,6 +462,11 @@ namespace {
                 // one possible tweak here would be to stay in the read lock for this database 
                 // for multiple prefetches if they are for the same database.
                 OperationContextImpl txn;
+                if (batchApplied) {
+                    // The writers hold the parallel batch writer lock, which would otherwise
+                    // keep this reader out until they are done.
+                    txn.lockState()->setIsBatchWriter(true);
+                }
                 AutoGetCollectionForRead ctx(&txn, ns);
                 Database* db = ctx.getDb();
                 if (db) {
@@ -280,25 +490,52 @@ namespace {
         for (std::deque<BSONObj>::const_iterator it = ops.begin();
              it != ops.end();
              ++it) {
-            prefetcherPool->schedule(&prefetchOp, *it);
+            prefetcherPool->schedule(&prefetchOp, *it, static_cast<AtomicWord<bool>*>(NULL));
         }
         prefetcherPool->join();
     }
 
-    // Doles out all the work to the writer pool threads and waits for them to complete
-    void applyOps(const std::vector< std::vector<BSONObj> >& writerVectors,
-                            threadpool::ThreadPool* writerPool,
-                            SyncTail::MultiSyncApplyFunc func,
-                            SyncTail* sync) {
-        TimerHolder timer(&applyBatchStats);
-        for (std::vector< std::vector<BSONObj> >::const_iterator it = writerVectors.begin();
-             it != writerVectors.end();
+    // Doles out the updates and deletes to the reader pool threads without waiting for them, so
+    // that they run ahead of the writers, which walk their share of the batch in the same order.
+    // The caller must set 'batchApplied' and join the pool once the writers are done.
+    void prefetchOpsAhead(const std::deque<BSONObj>& ops,
+                          threadpool::ThreadPool* prefetcherPool,
+                          const AtomicWord<bool>* batchApplied) {
+        invariant(prefetcherPool);
+        for (std::deque<BSONObj>::const_iterator it = ops.begin();
+             it != ops.end();
              ++it) {
-            if (!it->empty()) {
-                writerPool->schedule(func, boost::cref(*it), sync);
+            const char* opType = it->getField("op").valuestrsafe();
+            if (str::equals(opType, "u") || str::equals(opType, "d")) {
+                prefetcherPool->schedule(&prefetchOp, *it, batchApplied);
+            }
+        }
+    }
+
+    // Doles out all the work to the writer pool threads and waits for them to complete.
+    // Returns how long it took, in microseconds, and sets busyMicros[i] to the time taken by the
+    // writer applying writerVectors[i].
+    long long applyOps(const std::vector< std::vector<BSONObj> >& writerVectors,
+                       threadpool::ThreadPool* writerPool,
+                       SyncTail::MultiSyncApplyFunc func,
+                       SyncTail* sync,
+                       std::vector<long long>* busyMicros) {
+        TimerHolder timer(&applyBatchStats);
+        Timer elapsed;
+        busyMicros->assign(writerVectors.size(), 0);
+        for (size_t i = 0; i < writerVectors.size(); ++i) {
+            if (!writerVectors[i].empty()) {
+                long long* writerBusyMicros = &(*busyMicros)[i];
+                const std::vector<BSONObj>* ops = &writerVectors[i];
+                writerPool->schedule([func, ops, sync, writerBusyMicros]() {
+                    Timer busy;
+                    func(*ops, sync);
+                    *writerBusyMicros = busy.micros();
+                });
             }
         }
         writerPool->join();
+        return elapsed.micros();
     }
 
     void fillWriterVectors(const std::deque<BSONObj>& ops,
@@ -337,6 +574,27 @@ namespace {
         }
     }
 
+    /**
+     * Returns true if applying 'ops' may change the catalog, such as commands and index builds.
+     * Batch snapshot readers would see such changes before the data they go with, so these
+     * batches must block them.
+     */
+    bool batchChangesCatalog(const std::deque<BSONObj>& ops) {
+        for (std::deque<BSONObj>::const_iterator it = ops.begin(); it != ops.end(); ++it) {
+            const char* opType = it->getField("op").valuestrsafe();
+            if (str::equals(opType, "n")) {
+                continue;
+            }
+            if (!isCrudOpType(opType)) {
+                return true;
+            }
+            if (NamespaceString(it->getField("ns").valuestrsafe()).isSystemDotIndexes()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
 } // namespace
 
     // Doles out all the work to the writer pool threads and waits for them to complete
@@ -353,12 +611,24 @@ namespace {
         invariant(func);
         invariant(sync);
 
-        if (getGlobalServiceContext()->getGlobalStorageEngine()->isMmapV1()) {
+        StorageEngine* storageEngine = getGlobalServiceContext()->getGlobalStorageEngine();
+        if (storageEngine->isMmapV1()) {
             // Use a ThreadPool to prefetch all the operations in a batch.
+            TimerHolder prefetchTimer(&batchPrefetchStats);
             prefetchOps(ops.getDeque(), prefetcherPool);
         }
-        
-        std::vector< std::vector<BSONObj> > writerVectors(replWriterThreadCount);
+
+        TimerHolder applyTimer(&batchApplyStats);
+
+        // Other engines gain nothing from paging in the batch before applying it, but their
+        // writers still stall on cold index and document pages, so there the prefetcher pool
+        // reads them in while the batch is being applied.
+        const bool prefetchAhead = !storageEngine->isMmapV1() &&
+            storageEngine->supportsDocLocking() &&
+            BackgroundSync::get()->getIndexPrefetchConfig() != BackgroundSync::PREFETCH_NONE;
+        AtomicWord<bool> batchApplied(false);
+
+        std::vector< std::vector<BSONObj> > writerVectors(getBatchWriterCount());
 
         fillWriterVectors(ops.getDeque(), &writerVectors);
         LOG(2) << "replication batch size is " << ops.getDeque().size() << endl;
@@ -367,8 +637,11 @@ namespace {
         // because all readers are blocked anyway.
         SimpleMutex::scoped_lock fsynclk(filesLockedFsync);
 
-        // stop all readers until we're done
-        Lock::ParallelBatchWriterMode pbwm(txn->lockState());
+        // Stop all readers until we're done, except for those reading from the snapshot of the
+        // previous batch, unless the catalog changes under them.
+        BatchSnapshotManager* batchSnapshots = storageEngine->getBatchSnapshotManager();
+        Lock::ParallelBatchWriterMode pbwm(txn->lockState(),
+                                           !batchSnapshots || batchChangesCatalog(ops.getDeque()));
 
         ReplicationCoordinator* replCoord = getGlobalReplicationCoordinator();
         if (replCoord->getMemberState().primary() &&
@@ -378,7 +651,35 @@ namespace {
             fassertFailed(28527);
         }
 
-        applyOps(writerVectors, writerPool, func, sync);
+        if (prefetchAhead) {
+            prefetchOpsAhead(ops.getDeque(), prefetcherPool, &batchApplied);
+        }
+
+        std::vector<long long> busyMicros;
+        const long long elapsedMicros = applyOps(writerVectors, writerPool, func, sync,
+                                                 &busyMicros);
+
+        std::vector<size_t> writerOps(writerVectors.size());
+        long long totalBusyMicros = 0;
+        for (size_t i = 0; i < writerVectors.size(); ++i) {
+            writerOps[i] = writerVectors[i].size();
+            totalBusyMicros += busyMicros[i];
+        }
+        writerStats.recordBatch(writerOps, busyMicros, elapsedMicros);
+        if (replWriterAutoTune) {
+            getWriterCountTuner().recordBatch(ops.getDeque().size(), elapsedMicros,
+                                              totalBusyMicros);
+        }
+
+        if (prefetchAhead) {
+            // Whatever has not been prefetched by now is too late to matter.
+            batchApplied.store(true);
+            prefetcherPool->join();
+        }
+
+        while (MONGO_FAIL_POINT(hangDuringBatchApplication) && !inShutdown()) {
+            sleepmillis(10);
+        }
 
         if (inShutdown()) {
             return OpTime();
@@ -395,6 +696,14 @@ namespace {
         if (mustWaitUntilDurable) {
             txn->recoveryUnit()->waitUntilDurable();
         }
+        applyTimer.recordMillis();
+
+        // Every write of the batch has committed, so its snapshot can be read while the next
+        // batch is applied.
+        if (batchSnapshots) {
+            batchSnapshots->publishSnapshot(lastOpTime.getTimestamp());
+        }
+
         ReplClientInfo::forClient(txn->getClient()).setLastOp(lastOpTime);
         replCoord->setMyLastOptime(lastOpTime);
         setNewTimestamp(lastOpTime.getTimestamp());
@@ -434,9 +743,9 @@ namespace {
                 }
 
                 // apply replication batch limits
-                if (ops.getSize() > replBatchLimitBytes)
+                if (ops.getSize() > static_cast<size_t>(replBatchLimitBytes))
                     break;
-                if (ops.getDeque().size() > replBatchLimitOperations)
+                if (ops.getDeque().size() > static_cast<size_t>(replBatchLimitOperations))
                     break;
             };
 
@@ -516,14 +825,20 @@ namespace {
             Timer batchTimer;
             int lastTimeChecked = 0;
 
+            // Times the batch from its first op on, leaving out the wait for one to show up.
+            Timer fetchTimer;
+
             do {
                 int now = batchTimer.seconds();
+                if (ops.empty()) {
+                    fetchTimer.reset();
+                }
 
                 // apply replication batch limits
                 if (!ops.empty()) {
                     if (now > replBatchLimitSeconds)
                         break;
-                    if (ops.getDeque().size() > replBatchLimitOperations)
+                    if (ops.getDeque().size() > static_cast<size_t>(replBatchLimitOperations))
                         break;
                 }
                 // occasionally check some things
@@ -559,7 +874,7 @@ namespace {
             } while (!tryPopAndWaitForMore(&txn, &ops, replCoord) && // tryPopAndWaitForMore returns
                                                                      // true when we need to end a
                                                                      // batch early
-                   (ops.getSize() < replBatchLimitBytes) &&
+                   (ops.getSize() < static_cast<size_t>(replBatchLimitBytes)) &&
                    !inShutdown());
 
             // For pausing replication in tests
@@ -571,13 +886,32 @@ namespace {
                 continue;
             }
 
+            batchFetchStats.record(fetchTimer);
+
             const BSONObj lastOp = ops.back();
             handleSlaveDelay(lastOp);
 
-            // Set minValid to the last op to be applied in this next batch.
+            // Make sure minValid is at least the last op to be applied in this next batch.
             // This will cause this node to go into RECOVERING state
-            // if we should crash and restart before updating the oplog
-            setMinValid(&txn, extractOpTime(lastOp));
+            // if we should crash and restart before updating the oplog.
+            //
+            // A delayed secondary does not write ahead: the ops it has fetched may only be
+            // applied much later, and it would be stuck in RECOVERING until then after a restart.
+            // Nor does a member in RECOVERING, after a rollback, an initial sync or maintenance
+            // mode: it only becomes SECONDARY once it has applied through minValid, which would
+            // then keep moving up to whatever was fetched last.
+            {
+                TimerHolder markerTimer(&batchMarkerStats);
+                const OpTime batchEnd = extractOpTime(lastOp);
+                const OpTime ahead = (replMinValidWriteAhead &&
+                                      replCoord->getSlaveDelaySecs().count() == 0 &&
+                                      replCoord->getMemberState().secondary()) ?
+                    BackgroundSync::get()->getLastOpTimeFetched() : batchEnd;
+                if (!advanceMinValid(&txn, batchEnd, ahead)) {
+                    minValidWritesSkippedStats.increment();
+                }
+            }
+
             multiApply(&txn,
                        ops,
                        &_prefetcherPool,
@@ -808,6 +1142,21 @@ namespace {
 
     static AtomicUInt32 replWriterWorkerId;
 
+    // Number of grouped inserts applied by the writer threads, and the number of oplog entries
+    // they replaced.
+    static Counter64 groupedInsertsStats;
+    static ServerStatusMetricField<Counter64> displayGroupedInserts(
+                                                    "repl.apply.groupedInserts",
+                                                    &groupedInsertsStats );
+    static Counter64 groupedInsertOpsStats;
+    static ServerStatusMetricField<Counter64> displayGroupedInsertOps(
+                                                    "repl.apply.groupedInsertOps",
+                                                    &groupedInsertOpsStats );
+
+    // Limits on the number and total size of the oplog entries in a grouped insert.
+    const size_t replWriterMaxGroupedInserts = 64;
+    const int replWriterMaxGroupedInsertBytes = 256 * 1024;
+
     static void initializeWriterThread() {
         // Only do this once per thread
         if (!ClientBasic::getCurrent()) {
@@ -816,6 +1165,95 @@ namespace {
         }
     }
 
+namespace {
+
+    /**
+     * Returns true if 'op' is an insert which may be applied as part of a grouped insert.
+     */
+    bool isGroupableInsert(const BSONObj& op) {
+        const char* opType = op.getStringField("op");
+        if (opType[0] != 'i' || opType[1] != '\0') {
+            return false;
+        }
+
+        const char* ns = op.getStringField("ns");
+        if (!nsIsFull(ns) || nsToCollectionSubstring(ns) == "system.indexes") {
+            return false;
+        }
+
+        return op["o"].type() == Object;
+    }
+
+    /**
+     * Returns the end of the run of inserts into the same collection which starts at 'begin',
+     * within the limits on the size of a grouped insert. Returns 'begin' + 1 if the operation at
+     * 'begin' cannot be grouped.
+     */
+    std::vector<BSONObj>::const_iterator findInsertGroupEnd(
+                                            std::vector<BSONObj>::const_iterator begin,
+                                            std::vector<BSONObj>::const_iterator end) {
+        if (!isGroupableInsert(*begin)) {
+            return begin + 1;
+        }
+
+        const StringData ns = begin->getStringField("ns");
+        int groupBytes = begin->objsize();
+
+        auto it = begin + 1;
+        for (; it != end; ++it) {
+            if (size_t(it - begin) >= replWriterMaxGroupedInserts) {
+                break;
+            }
+
+            if (!isGroupableInsert(*it) || ns != it->getStringField("ns")) {
+                break;
+            }
+
+            groupBytes += it->objsize();
+            if (groupBytes > replWriterMaxGroupedInsertBytes) {
+                break;
+            }
+        }
+        return it;
+    }
+
+    /**
+     * Applies the inserts in [begin, end) with one multi-document insert, under a single lock
+     * acquisition and WriteUnitOfWork. Returns false if that failed, in which case none of them
+     * have been applied.
+     */
+    bool applyGroupedInserts(OperationContext* txn,
+                             std::vector<BSONObj>::const_iterator begin,
+                             std::vector<BSONObj>::const_iterator end) {
+        BSONObjBuilder groupedOp;
+        groupedOp.append("op", "i");
+        groupedOp.append(begin->getField("ns"));
+        {
+            BSONArrayBuilder docs(groupedOp.subarrayStart("o"));
+            for (auto it = begin; it != end; ++it) {
+                docs.append(it->getObjectField("o"));
+            }
+        }
+
+        try {
+            if (SyncTail::syncApply(txn, groupedOp.done(), true).isOK()) {
+                groupedInsertsStats.increment();
+                groupedInsertOpsStats.increment(end - begin);
+                return true;
+            }
+        }
+        catch (const DBException& e) {
+            // Most likely some of the documents were inserted by an earlier, interrupted
+            // attempt to apply this batch, or the collection has no _id index to detect that.
+            LOG(2) << "failed to apply " << (end - begin) << " inserts into "
+                   << begin->getStringField("ns") << " as a group, applying them one at a time: "
+                   << causedBy(e);
+        }
+        return false;
+    }
+
+} // namespace
+
     // This free function is used by the writer threads to apply each op
     void multiSyncApply(const std::vector<BSONObj>& ops, SyncTail* st) {
         initializeWriterThread();
@@ -829,23 +1267,31 @@ namespace {
 
         bool convertUpdatesToUpserts = true;
 
-        for (std::vector<BSONObj>::const_iterator it = ops.begin();
-             it != ops.end();
-             ++it) {
-            try {
-                if (!SyncTail::syncApply(&txn, *it, convertUpdatesToUpserts).isOK()) {
-                    fassertFailedNoTrace(16359);
-                }
+        std::vector<BSONObj>::const_iterator it = ops.begin();
+        while (it != ops.end()) {
+            // Consecutive inserts into the same collection are applied together where possible.
+            const std::vector<BSONObj>::const_iterator groupEnd = findInsertGroupEnd(it, ops.end());
+            if (groupEnd - it > 1 && applyGroupedInserts(&txn, it, groupEnd)) {
+                it = groupEnd;
+                continue;
             }
-            catch (const DBException& e) {
-                error() << "writer worker caught exception: " << causedBy(e)
-                        << " on: " << it->toString();
 
-                if (inShutdown()) {
-                    return;
+            for (; it != groupEnd; ++it) {
+                try {
+                    if (!SyncTail::syncApply(&txn, *it, convertUpdatesToUpserts).isOK()) {
+                        fassertFailedNoTrace(16359);
+                    }
                 }
+                catch (const DBException& e) {
+                    error() << "writer worker caught exception: " << causedBy(e)
+                            << " on: " << it->toString();
 
-                fassertFailedNoTrace(16360);
+                    if (inShutdown()) {
+                        return;
+                    }
+
+                    fassertFailedNoTrace(16360);
+                }
             }
         }
     }
@@ -144,11 +144,9 @@ namespace repl {
         void setHostname(const std::string& hostname);
 
     protected:
-        // Cap the batches using the limit on journal commits.
-        // This works out to be 100 MB (64 bit) or 50 MB (32 bit)
-        static const unsigned int replBatchLimitBytes = dur::UncommittedBytesLimit;
+        // The limits on the size and number of operations of a batch are the
+        // replBatchLimitBytes and replBatchLimitOperations server parameters.
         static const int replBatchLimitSeconds = 1;
-        static const unsigned int replBatchLimitOperations = 5000;
 
         // SyncTail base class always supports awaiting commit if any op has j:true flag
         // that indicates awaiting commit before updating last OpTime.
@@ -265,6 +265,38 @@ namespace {
         _testSyncApplyInsertDocument(MODE_IX);
     }
 
+    TEST_F(SyncTailTest, SyncApplyGroupedInsertCountsEachDocument) {
+        {
+            Lock::GlobalWrite globalLock(_txn->lockState());
+            bool justCreated = false;
+            Database* db = dbHolder().openDb(_txn.get(), "test", &justCreated);
+            ASSERT_TRUE(db);
+            ASSERT_TRUE(db->createCollection(_txn.get(), "test.t"));
+        }
+        const BSONObj op = BSON("op" << "i" << "ns" << "test.t" <<
+                                "o" << BSON_ARRAY(BSON("_id" << 1) <<
+                                                  BSON("_id" << 2) <<
+                                                  BSON("_id" << 3)));
+        int applyOpCalled = 0;
+        SyncTail::ApplyOperationInLockFn applyOp = [&](OperationContext* txn,
+                                                       Database* db,
+                                                       const BSONObj& theOperation,
+                                                       bool convertUpdateToUpsert) {
+            applyOpCalled++;
+            ASSERT_TRUE(txn->lockState()->isCollectionLockedForMode("test.t", MODE_IX));
+            ASSERT_EQUALS(op, theOperation);
+            return Status::OK();
+        };
+        SyncTail::ApplyCommandInLockFn applyCmd = [&](OperationContext* txn,
+                                                      const BSONObj& theOperation) {
+            FAIL("applyCommand unexpectedly invoked.");
+            return Status::OK();
+        };
+        ASSERT_OK(SyncTail::syncApply(_txn.get(), op, true, applyOp, applyCmd, _incOps));
+        ASSERT_EQUALS(1, applyOpCalled);
+        ASSERT_EQUALS(3U, _opsApplied);
+    }
+
     TEST_F(SyncTailTest, SyncApplyIndexBuild) {
         const BSONObj op = BSON("op" << "i" << "ns" << "test.system.indexes");
         bool applyOpCalled = false;
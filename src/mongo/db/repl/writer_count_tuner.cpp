@@ -0,0 +1,87 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/writer_count_tuner.h"
+
+#include <algorithm>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace repl {
+
+    const size_t WriterCountTuner::kBatchesPerWindow;
+    const double WriterCountTuner::kLowUtilization = 0.5;
+
+    WriterCountTuner::WriterCountTuner(size_t maxWriters)
+        : _maxWriters(maxWriters),
+          _writers(maxWriters) {
+        invariant(maxWriters > 0);
+    }
+
+    void WriterCountTuner::recordBatch(size_t ops, long long elapsedMicros, long long busyMicros) {
+        _windowOps += ops;
+        _windowMicros += elapsedMicros;
+        _windowBusyMicros += busyMicros;
+        _windowCapacityMicros += elapsedMicros * static_cast<long long>(_writers);
+        if (++_windowBatches < kBatchesPerWindow || _windowMicros <= 0) {
+            return;
+        }
+
+        const double throughput = _windowOps * 1000000.0 / _windowMicros;
+        const double utilization = _windowCapacityMicros > 0 ?
+            static_cast<double>(_windowBusyMicros) / _windowCapacityMicros : 1.0;
+
+        if (utilization < kLowUtilization) {
+            _direction = -1;
+        }
+        else if (_lastThroughput > 0 && throughput < _lastThroughput) {
+            _direction = -_direction;
+        }
+
+        // Steps of a quarter of the current count, so that a large pool converges quickly.
+        const size_t step = std::max<size_t>(1, _writers / 4);
+        if (_direction > 0) {
+            _writers = std::min(_maxWriters, _writers + step);
+        }
+        else {
+            _writers = _writers > step ? _writers - step : 1;
+        }
+
+        _lastThroughput = throughput;
+        _windowBatches = 0;
+        _windowOps = 0;
+        _windowMicros = 0;
+        _windowBusyMicros = 0;
+        _windowCapacityMicros = 0;
+    }
+
+} // namespace repl
+} // namespace mongo
@@ -0,0 +1,94 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "mongo/base/disallow_copying.h"
+
+namespace mongo {
+namespace repl {
+
+    /**
+     * Picks how many writer threads each batch of oplog entries is spread over on a secondary,
+     * by hill climbing on the throughput of the writers.
+     *
+     * Batches are grouped into windows of kBatchesPerWindow. At the end of each window the
+     * writer count takes a step in the current direction, which is reversed whenever the step
+     * before it made the throughput worse. While the writers spend most of a window idle, as
+     * when a batch only touches a few documents or collections, the count steps down instead,
+     * since more writers cannot help then.
+     *
+     * Not thread safe: it is only used by the thread applying batches.
+     */
+    class WriterCountTuner {
+        MONGO_DISALLOW_COPYING(WriterCountTuner);
+    public:
+        static const size_t kBatchesPerWindow = 8;
+
+        // Below this share of their time spent busy, the writers are considered mostly idle.
+        static const double kLowUtilization;
+
+        /**
+         * Starts out using all of the 'maxWriters' writers.
+         */
+        explicit WriterCountTuner(size_t maxWriters);
+
+        /**
+         * Returns the number of writers to spread the next batch over.
+         */
+        size_t getWriterCount() const { return _writers; }
+
+        /**
+         * Records that a batch of 'ops' entries took 'elapsedMicros' to apply with
+         * getWriterCount() writers, which were busy for 'busyMicros' in total.
+         */
+        void recordBatch(size_t ops, long long elapsedMicros, long long busyMicros);
+
+    private:
+        const size_t _maxWriters;
+
+        size_t _writers;
+
+        // +1 or -1.
+        int _direction = -1;
+
+        // Ops applied per second over the previous window, or 0 before the first one.
+        double _lastThroughput = 0;
+
+        // The current window.
+        size_t _windowBatches = 0;
+        size_t _windowOps = 0;
+        long long _windowMicros = 0;
+        long long _windowBusyMicros = 0;
+        long long _windowCapacityMicros = 0;
+    };
+
+} // namespace repl
+} // namespace mongo
@@ -0,0 +1,118 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/writer_count_tuner.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace repl {
+namespace {
+
+    /**
+     * Records a full window of identical batches, each applying 'ops' entries in 'elapsedMicros'
+     * with the writers busy for 'utilization' of that time.
+     */
+    void recordWindow(WriterCountTuner* tuner,
+                      size_t ops,
+                      long long elapsedMicros,
+                      double utilization) {
+        for (size_t i = 0; i < WriterCountTuner::kBatchesPerWindow; ++i) {
+            const long long busyMicros = static_cast<long long>(
+                elapsedMicros * tuner->getWriterCount() * utilization);
+            tuner->recordBatch(ops, elapsedMicros, busyMicros);
+        }
+    }
+
+    TEST(WriterCountTunerTest, StartsWithAllWriters) {
+        WriterCountTuner tuner(16);
+        ASSERT_EQUALS(16U, tuner.getWriterCount());
+    }
+
+    TEST(WriterCountTunerTest, OnlyAdjustsAtTheEndOfAWindow) {
+        WriterCountTuner tuner(16);
+        for (size_t i = 0; i + 1 < WriterCountTuner::kBatchesPerWindow; ++i) {
+            tuner.recordBatch(1000, 1000, 16 * 1000);
+            ASSERT_EQUALS(16U, tuner.getWriterCount());
+        }
+        tuner.recordBatch(1000, 1000, 16 * 1000);
+        ASSERT_NOT_EQUALS(16U, tuner.getWriterCount());
+    }
+
+    TEST(WriterCountTunerTest, KeepsGoingWhileThroughputImproves) {
+        WriterCountTuner tuner(16);
+        recordWindow(&tuner, 1000, 1000, 1.0);
+        ASSERT_EQUALS(12U, tuner.getWriterCount());
+        recordWindow(&tuner, 1000, 900, 1.0);
+        ASSERT_EQUALS(9U, tuner.getWriterCount());
+    }
+
+    TEST(WriterCountTunerTest, TurnsBackWhenThroughputDrops) {
+        WriterCountTuner tuner(16);
+        recordWindow(&tuner, 1000, 1000, 1.0);
+        ASSERT_EQUALS(12U, tuner.getWriterCount());
+
+        // Fewer writers made things slower, so go back up...
+        recordWindow(&tuner, 1000, 2000, 1.0);
+        ASSERT_EQUALS(15U, tuner.getWriterCount());
+
+        // ...but no further than the size of the pool.
+        recordWindow(&tuner, 1000, 1500, 1.0);
+        ASSERT_EQUALS(16U, tuner.getWriterCount());
+        recordWindow(&tuner, 1000, 1000, 1.0);
+        ASSERT_EQUALS(16U, tuner.getWriterCount());
+    }
+
+    TEST(WriterCountTunerTest, StepsDownWhileWritersAreMostlyIdle) {
+        WriterCountTuner tuner(16);
+        recordWindow(&tuner, 1000, 1000, 1.0);
+        recordWindow(&tuner, 1000, 2000, 1.0);
+        ASSERT_EQUALS(15U, tuner.getWriterCount());
+
+        // Even though throughput improves, idle writers are not worth adding.
+        recordWindow(&tuner, 1000, 500, 0.1);
+        ASSERT_EQUALS(12U, tuner.getWriterCount());
+
+        for (int i = 0; i < 20; ++i) {
+            recordWindow(&tuner, 1000, 500, 0.1);
+        }
+        ASSERT_EQUALS(1U, tuner.getWriterCount());
+    }
+
+    TEST(WriterCountTunerTest, SingleWriter) {
+        WriterCountTuner tuner(1);
+        recordWindow(&tuner, 1000, 1000, 1.0);
+        ASSERT_EQUALS(1U, tuner.getWriterCount());
+        recordWindow(&tuner, 1000, 2000, 1.0);
+        ASSERT_EQUALS(1U, tuner.getWriterCount());
+    }
+
+} // namespace
+} // namespace repl
+} // namespace mongo
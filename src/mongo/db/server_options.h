@@ -42,6 +42,7 @@ namespace mongo {
             configsvr(false), cpu(false), objcheck(true), defaultProfile(0),
             slowMS(100), defaultLocalThresholdMillis(15), moveParanoia(true),
             noUnixSocket(false), doFork(0), socket("/tmp"), maxConns(DEFAULT_MAX_CONN), 
+            transportMode(kTransportSynchronous), asyncIOThreads(2), asyncWorkerThreads(0),
             unixSocketPermissions(DEFAULT_UNIX_PERMS), logAppend(false), logRenameOnRotate(true),
             logWithSyslog(false), isHttpInterfaceEnabled(false)
         {
@@ -84,6 +85,21 @@ namespace mongo {
 
         int maxConns;          // Maximum number of simultaneous open connections.
 
+        // How incoming connections are serviced. Synchronous dedicates a thread to every
+        // connection; asynchronous multiplexes connections over a small set of I/O threads and
+        // runs their requests on a bounded pool of worker threads.
+        enum TransportMode {
+            kTransportSynchronous,
+            kTransportAsynchronous
+        };
+        TransportMode transportMode;    // --transportMode
+        int asyncIOThreads;             // --asyncIOThreads
+        int asyncWorkerThreads;         // --asyncWorkerThreads, 0 means size from the core count
+
+        // Names of the wire protocol compressors this process negotiates, in order of
+        // preference. Empty if compression is disabled.
+        std::vector<std::string> networkMessageCompressors; // --networkMessageCompressors
+
         int unixSocketPermissions; // permissions for the UNIX domain socket
 
         std::string keyFile;   // Path to keyfile, or empty if none.
@@ -55,6 +55,7 @@
 #include "mongo/util/net/listen.h" // For DEFAULT_MAX_CONN
 #include "mongo/util/net/ssl_options.h"
 #include "mongo/util/options_parser/startup_options.h"
+#include "mongo/util/stringutils.h"
 
 using std::endl;
 using std::string;
@@ -201,6 +202,27 @@ namespace {
         options->addOptionChaining("net.maxIncomingConnections", "maxConns", moe::Int,
                 maxConnInfoBuilder.str().c_str());
 
+        options->addOptionChaining("net.transportMode", "transportMode", moe::String,
+                "how connections are serviced: a thread per connection (synchronous) or "
+                "event-driven I/O with a worker thread pool (asynchronous)")
+                                  .format("(:?synchronous)|(:?asynchronous)",
+                                          "(synchronous/asynchronous)");
+
+        options->addOptionChaining("net.compression.compressors", "networkMessageCompressors",
+                moe::String,
+                "comma separated list of compressors to negotiate for wire protocol messages, "
+                "in order of preference, or \"disabled\" (the default)")
+                                  .format("(:?disabled)|(:?(snappy|zlib)(,(snappy|zlib))*)",
+                                          "(disabled/snappy/zlib/snappy,zlib/zlib,snappy)");
+
+        options->addOptionChaining("net.asyncIOThreads", "asyncIOThreads", moe::Int,
+                "number of threads polling sockets when transportMode is asynchronous");
+
+        options->addOptionChaining("net.asyncWorkerThreads", "asyncWorkerThreads", moe::Int,
+                "number of pooled threads running requests when transportMode is asynchronous, "
+                "beyond which requests get threads of their own "
+                "(defaults to a multiple of the number of cores)");
+
         options->addOptionChaining("logpath", "logpath", moe::String,
                 "log file to send write to instead of stdout - has to be a file, not directory")
                                   .setSources(moe::SourceAllLegacy)
@@ -780,6 +802,37 @@ namespace {
             }
         }
 
+        if (params.count("net.transportMode")) {
+            const std::string mode = params["net.transportMode"].as<std::string>();
+            serverGlobalParams.transportMode = (mode == "asynchronous") ?
+                ServerGlobalParams::kTransportAsynchronous :
+                ServerGlobalParams::kTransportSynchronous;
+        }
+
+        if (params.count("net.compression.compressors")) {
+            const std::string compressors = params["net.compression.compressors"].as<std::string>();
+            serverGlobalParams.networkMessageCompressors.clear();
+            if (compressors != "disabled") {
+                splitStringDelim(compressors, &serverGlobalParams.networkMessageCompressors, ',');
+            }
+        }
+
+        if (params.count("net.asyncIOThreads")) {
+            serverGlobalParams.asyncIOThreads = params["net.asyncIOThreads"].as<int>();
+
+            if (serverGlobalParams.asyncIOThreads < 1) {
+                return Status(ErrorCodes::BadValue, "asyncIOThreads has to be at least 1");
+            }
+        }
+
+        if (params.count("net.asyncWorkerThreads")) {
+            serverGlobalParams.asyncWorkerThreads = params["net.asyncWorkerThreads"].as<int>();
+
+            if (serverGlobalParams.asyncWorkerThreads < 1) {
+                return Status(ErrorCodes::BadValue, "asyncWorkerThreads has to be at least 1");
+            }
+        }
+
         if (params.count("net.wireObjectCheck")) {
             serverGlobalParams.objcheck = params["net.wireObjectCheck"].as<bool>();
         }
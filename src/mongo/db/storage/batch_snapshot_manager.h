@@ -0,0 +1,79 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/timestamp.h"
+
+namespace mongo {
+
+    /**
+     * Manages the snapshot which replication secondaries serve reads from while they apply an
+     * oplog batch. The applier publishes a new snapshot at the end of each batch, once all of its
+     * writes have committed, so readers only ever see the state at a batch boundary.
+     *
+     * Readers ask for it through their Locker (see Locker::setIsBatchSnapshotReader), after
+     * checking with RecoveryUnit::canReadFromBatchSnapshot() that this is possible.
+     */
+    class BatchSnapshotManager {
+        MONGO_DISALLOW_COPYING(BatchSnapshotManager);
+    public:
+        virtual ~BatchSnapshotManager() { }
+
+        /**
+         * Takes a snapshot of everything committed so far and makes it the one readers use from
+         * now on. 'appliedThrough' is the timestamp of the last operation in the batch.
+         *
+         * Must only be called by the applier, while it holds the parallel batch writer lock and
+         * after all the writes of the batch have been committed.
+         */
+        virtual void publishSnapshot(const Timestamp& appliedThrough) = 0;
+
+        /**
+         * Stops new readers from using the current snapshot until the next one is published,
+         * because the catalog changed outside of a batch. Readers which already started on it may
+         * carry on.
+         *
+         * Must be called after the change has committed, while still holding the exclusive lock
+         * on its database. Readers check that the snapshot is current once they hold their
+         * database lock.
+         */
+        virtual void retireSnapshot() = 0;
+
+        /**
+         * Returns the 'appliedThrough' timestamp of the current snapshot, or a null Timestamp if
+         * none has been published yet.
+         */
+        virtual Timestamp getSnapshotTimestamp() const = 0;
+
+    protected:
+        BatchSnapshotManager() { }
+    };
+
+}  // namespace mongo
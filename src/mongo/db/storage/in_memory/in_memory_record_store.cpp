@@ -440,6 +440,39 @@ namespace mongo {
         return StatusWith<RecordId>(loc);
     }
 
+    Status InMemoryRecordStore::insertRecords(OperationContext* txn,
+                                              std::vector<Record>* records,
+                                              bool enforceQuota) {
+        for (auto& record : *records) {
+            const int len = record.data.size();
+            if (_isCapped && len > _cappedMaxSize) {
+                return Status(ErrorCodes::BadValue, "object to insert exceeds cappedMaxSize");
+            }
+
+            InMemoryRecord rec(len);
+            memcpy(rec.data.get(), record.data.data(), len);
+
+            if (_data->isOplog) {
+                StatusWith<RecordId> status = extractAndCheckLocForOplog(record.data.data(), len);
+                if (!status.isOK())
+                    return status.getStatus();
+                record.id = status.getValue();
+            }
+            else {
+                record.id = allocateLoc();
+            }
+
+            txn->recoveryUnit()->registerChange(new InsertChange(_data, record.id));
+            _data->dataSize += len;
+            _data->records[record.id] = rec;
+        }
+
+        // Trim once for the whole batch rather than after every record.
+        cappedDeleteAsNeeded(txn);
+
+        return Status::OK();
+    }
+
     StatusWith<RecordId> InMemoryRecordStore::updateRecord(OperationContext* txn,
                                                           const RecordId& loc,
                                                           const char* data,
@@ -39,6 +39,7 @@
 
 namespace mongo {
 
+    class BatchSnapshotManager;
     class IndexDescriptor;
     class OperationContext;
     class RecordStore;
@@ -109,6 +110,11 @@ namespace mongo {
          */
         virtual bool supportsDirectoryPerDB() const = 0;
 
+        /**
+         * See StorageEngine::getBatchSnapshotManager.
+         */
+        virtual BatchSnapshotManager* getBatchSnapshotManager() const { return NULL; }
+
         virtual Status okToRename( OperationContext* opCtx,
                                    StringData fromNS,
                                    StringData toNS,
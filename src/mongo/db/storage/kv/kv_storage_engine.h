@@ -85,6 +85,8 @@ namespace mongo {
 
         virtual bool isDurable() const;
 
+        virtual BatchSnapshotManager* getBatchSnapshotManager() const;
+
         virtual Status repairRecordStore(OperationContext* txn, const std::string& ns);
 
         virtual void cleanShutdown();
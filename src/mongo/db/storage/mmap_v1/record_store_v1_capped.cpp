@@ -607,7 +607,7 @@ namespace mongo {
     }
 
     vector<std::unique_ptr<RecordCursor>> CappedRecordStoreV1::getManyCursors(
-            OperationContext* txn) const {
+            OperationContext* txn, size_t numCursors) const {
         vector<std::unique_ptr<RecordCursor>> cursors;
 
         if (!_details->capLooped()) {
@@ -65,7 +65,7 @@ namespace mongo {
         std::unique_ptr<RecordCursor> getCursor(OperationContext* txn, bool forward) const final;
 
         std::vector<std::unique_ptr<RecordCursor>> getManyCursors(
-            OperationContext* txn) const final;
+            OperationContext* txn, size_t numCursors) const final;
 
         // Start from firstExtent by default.
         DiskLoc firstRecord( OperationContext* txn,
@@ -245,7 +245,7 @@ namespace mongo {
     }
 
     vector<std::unique_ptr<RecordCursor>> SimpleRecordStoreV1::getManyCursors(
-            OperationContext* txn) const {
+            OperationContext* txn, size_t numCursors) const {
         vector<std::unique_ptr<RecordCursor>> cursors;
         const Extent* ext;
         for (DiskLoc extLoc = details()->firstExtent(txn); !extLoc.isNull(); extLoc = ext->xnext) {
@@ -54,7 +54,7 @@ namespace mongo {
         std::unique_ptr<RecordCursor> getCursor(OperationContext* txn, bool forward) const final;
 
         std::vector<std::unique_ptr<RecordCursor>> getManyCursors(
-            OperationContext* txn) const final;
+            OperationContext* txn, size_t numCursors) const final;
 
         virtual Status truncate(OperationContext* txn);
 
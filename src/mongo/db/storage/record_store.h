@@ -316,6 +316,30 @@ namespace mongo {
                                                   const DocWriter* doc,
                                                   bool enforceQuota ) = 0;
 
+        /**
+         * Inserts the data of each of 'records', in order, and sets its id to the RecordId at
+         * which it was stored. Stops at the first failure, in which case the caller is expected
+         * to roll back its WriteUnitOfWork.
+         *
+         * The default implementation simply calls insertRecord() for each record. Engines which
+         * pay a fixed cost per insert (cursor setup, size accounting, capped trimming) should
+         * override this to pay it once per batch.
+         */
+        virtual Status insertRecords( OperationContext* txn,
+                                      std::vector<Record>* records,
+                                      bool enforceQuota ) {
+            for ( auto& record : *records ) {
+                StatusWith<RecordId> res = insertRecord( txn,
+                                                         record.data.data(),
+                                                         record.data.size(),
+                                                         enforceQuota );
+                if ( !res.isOK() )
+                    return res.getStatus();
+                record.id = res.getValue();
+            }
+            return Status::OK();
+        }
+
         /**
          * @param notifier - Only used by record stores which do not support doc-locking.
          *                   In the case of a document move, this is called after the document
@@ -374,6 +398,10 @@ namespace mongo {
          * Returns many RecordCursors that partition the RecordStore into many disjoint sets.
          * Iterating all returned RecordCursors is equivalent to iterating the full store.
          *
+         * 'numCursors' is the number of partitions the caller would like, for example one per
+         * reader thread. It is only a hint: stores which partition along their physical layout
+         * (such as extents) may return more or fewer cursors.
+         *
          * Partition cursors are only required to support forward scanning, so it is illegal to call
          * seekExact() on any of the returned cursors.
          *
@@ -382,12 +410,38 @@ namespace mongo {
          * SERVER-17364.
          */
         virtual std::vector<std::unique_ptr<RecordCursor>> getManyCursors(
-                OperationContext* txn) const {
+                OperationContext* txn, size_t numCursors) const {
             std::vector<std::unique_ptr<RecordCursor>> out(1);
             out[0] = getCursor(txn);
             return out;
         }
 
+        /**
+         * Returns up to 'numRanges' - 1 increasing RecordIds which split this store into
+         * contiguous ranges of roughly equal size, each of which can then be scanned with
+         * getCursorForRange(), possibly by a different thread using its own OperationContext.
+         *
+         * Returns no split points if the store is too small to split or does not support range
+         * cursors, which is the default.
+         */
+        virtual std::vector<RecordId> getSplitPoints(OperationContext* txn,
+                                                     size_t numRanges) const {
+            return std::vector<RecordId>();
+        }
+
+        /**
+         * Returns a forward cursor over the records with ids in ['start', 'end'). A null 'start'
+         * or 'end' leaves that side of the range unbounded.
+         *
+         * May only be called on stores which returned split points from getSplitPoints().
+         */
+        virtual std::unique_ptr<RecordCursor> getCursorForRange(OperationContext* txn,
+                                                                const RecordId& start,
+                                                                const RecordId& end) const {
+            invariant(false);
+            return {};
+        }
+
         // higher level
 
 
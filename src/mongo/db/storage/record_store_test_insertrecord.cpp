@@ -183,4 +183,48 @@ namespace mongo {
         }
     }
 
+    // Insert a batch of records at once and verify that each was assigned a distinct id under
+    // which its data can be found.
+    TEST( RecordStoreTestHarness, InsertRecords ) {
+        scoped_ptr<HarnessHelper> harnessHelper( newHarnessHelper() );
+        scoped_ptr<RecordStore> rs( harnessHelper->newNonCappedRecordStore() );
+
+        const int nToInsert = 10;
+        std::vector<string> datas;
+        for ( int i = 0; i < nToInsert; i++ ) {
+            stringstream ss;
+            ss << "record " << i;
+            datas.push_back( ss.str() );
+        }
+
+        std::vector<Record> records( nToInsert );
+        for ( int i = 0; i < nToInsert; i++ ) {
+            records[i].data = RecordData( datas[i].c_str(), datas[i].size() + 1 );
+        }
+
+        {
+            scoped_ptr<OperationContext> opCtx( harnessHelper->newOperationContext() );
+            {
+                WriteUnitOfWork uow( opCtx.get() );
+                ASSERT_OK( rs->insertRecords( opCtx.get(), &records, false ) );
+                uow.commit();
+            }
+        }
+
+        {
+            scoped_ptr<OperationContext> opCtx( harnessHelper->newOperationContext() );
+            ASSERT_EQUALS( nToInsert, rs->numRecords( opCtx.get() ) );
+
+            for ( int i = 0; i < nToInsert; i++ ) {
+                for ( int j = 0; j < i; j++ ) {
+                    ASSERT_NOT_EQUALS( records[j].id, records[i].id );
+                }
+
+                RecordData record = rs->dataFor( opCtx.get(), records[i].id );
+                ASSERT_EQUALS( datas[i].size() + 1, static_cast<size_t>( record.size() ) );
+                ASSERT_EQUALS( datas[i], record.data() );
+            }
+        }
+    }
+
 } // namespace mongo
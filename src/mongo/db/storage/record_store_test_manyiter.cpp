@@ -58,7 +58,7 @@ namespace mongo {
 
         {
             scoped_ptr<OperationContext> opCtx( harnessHelper->newOperationContext() );
-            for (auto&& cursor : rs->getManyCursors(opCtx.get())) {
+            for (auto&& cursor : rs->getManyCursors(opCtx.get(), 4)) {
                 ASSERT(!cursor->next());
                 ASSERT(!cursor->next());
             }
@@ -103,7 +103,7 @@ namespace mongo {
         set<RecordId> remain( locs, locs + nToInsert );
         {
             scoped_ptr<OperationContext> opCtx( harnessHelper->newOperationContext() );
-            for (auto&& cursor : rs->getManyCursors(opCtx.get())) {
+            for (auto&& cursor : rs->getManyCursors(opCtx.get(), 4)) {
                 while (auto record = cursor->next()) {
                     ASSERT_EQ(remain.erase(record->id), size_t(1));
                 }
@@ -112,6 +112,18 @@ namespace mongo {
             }
             ASSERT( remain.empty() );
         }
+
+        // Asking for more cursors than there are records must still partition the store.
+        remain.insert( locs, locs + nToInsert );
+        {
+            scoped_ptr<OperationContext> opCtx( harnessHelper->newOperationContext() );
+            for (auto&& cursor : rs->getManyCursors(opCtx.get(), nToInsert * 2)) {
+                while (auto record = cursor->next()) {
+                    ASSERT_EQ(remain.erase(record->id), size_t(1));
+                }
+            }
+            ASSERT( remain.empty() );
+        }
     }
 
 } // namespace mongo
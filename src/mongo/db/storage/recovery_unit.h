@@ -89,6 +89,14 @@ namespace mongo {
 
         virtual SnapshotId getSnapshotId() const = 0;
 
+        /**
+         * Returns true if the next reads through this RecoveryUnit can come from the snapshot of
+         * the StorageEngine's BatchSnapshotManager, once the Locker of the operation is marked as
+         * a batch snapshot reader. This is not the case if a transaction which reads the latest
+         * data is already open.
+         */
+        virtual bool canReadFromBatchSnapshot() const { return false; }
+
         /**
          * A Change is an action that is registerChange()'d while a WriteUnitOfWork exists. The
          * change is either rollback()'d or commit()'d when the WriteUnitOfWork goes out of scope.
@@ -39,6 +39,7 @@
 
 namespace mongo {
 
+    class BatchSnapshotManager;
     class DatabaseCatalogEntry;
     class OperationContext;
     class RecoveryUnit;
@@ -172,6 +173,13 @@ namespace mongo {
          */
         virtual bool isMmapV1() const { return false; }
 
+        /**
+         * Returns the manager of the snapshot secondaries read from while applying a replication
+         * batch, or NULL if the engine cannot read from snapshots. StorageEngine owns the returned
+         * pointer.
+         */
+        virtual BatchSnapshotManager* getBatchSnapshotManager() const { return NULL; }
+
         /**
          * Closes all file handles associated with a database.
          */
@@ -0,0 +1,106 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include <boost/thread/locks.hpp>
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_batch_snapshot_manager.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+    WiredTigerBatchSnapshotManager::WiredTigerBatchSnapshotManager(WT_CONNECTION* conn)
+        : _conn(conn) {
+    }
+
+    void WiredTigerBatchSnapshotManager::publishSnapshot(const Timestamp& appliedThrough) {
+        boost::lock_guard<boost::mutex> lk(_mutex);
+        if (_shutdown) {
+            return;
+        }
+
+        if (!_session) {
+            invariantWTOK(_conn->open_session(_conn, NULL, "isolation=snapshot", &_session));
+        }
+
+        const std::string name = str::stream() << "batch" << _nextSnapshotId++;
+        const std::string createConfig = "name=" + name;
+        invariantWTOK(_session->snapshot(_session, createConfig.c_str()));
+
+        // Nothing can be beginning a transaction on the older snapshots, since that happens
+        // under _mutex.
+        const std::string dropConfig = "drop=(before=" + name + ")";
+        invariantWTOK(_session->snapshot(_session, dropConfig.c_str()));
+
+        _snapshotName = name;
+        _snapshotTimestamp = appliedThrough;
+        LOG(2) << "WT published batch snapshot " << name << " at " << appliedThrough.toString();
+    }
+
+    void WiredTigerBatchSnapshotManager::retireSnapshot() {
+        boost::lock_guard<boost::mutex> lk(_mutex);
+        _snapshotTimestamp = Timestamp();
+        LOG(2) << "WT retired batch snapshot " << _snapshotName;
+    }
+
+    Timestamp WiredTigerBatchSnapshotManager::getSnapshotTimestamp() const {
+        boost::lock_guard<boost::mutex> lk(_mutex);
+        return _snapshotTimestamp;
+    }
+
+    bool WiredTigerBatchSnapshotManager::beginTransactionOnSnapshot(WT_SESSION* session) const {
+        boost::lock_guard<boost::mutex> lk(_mutex);
+        if (_snapshotName.empty()) {
+            return false;
+        }
+
+        const std::string config = "snapshot=" + _snapshotName;
+        invariantWTOK(session->begin_transaction(session, config.c_str()));
+        return true;
+    }
+
+    void WiredTigerBatchSnapshotManager::shutdown() {
+        boost::lock_guard<boost::mutex> lk(_mutex);
+        _shutdown = true;
+        _snapshotName.clear();
+        _snapshotTimestamp = Timestamp();
+
+        if (_session) {
+            invariantWTOK(_session->snapshot(_session, "drop=(all)"));
+            invariantWTOK(_session->close(_session, NULL));
+            _session = NULL;
+        }
+    }
+
+}  // namespace mongo
@@ -0,0 +1,87 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+
+#include <boost/thread/mutex.hpp>
+#include <wiredtiger.h>
+
+#include "mongo/db/storage/batch_snapshot_manager.h"
+#include "mongo/platform/cstdint.h"
+
+namespace mongo {
+
+    /**
+     * Keeps the batch snapshot as a WiredTiger named snapshot. Publishing a snapshot drops the
+     * older ones, which does not affect the transactions already reading from them.
+     */
+    class WiredTigerBatchSnapshotManager final : public BatchSnapshotManager {
+    public:
+        explicit WiredTigerBatchSnapshotManager(WT_CONNECTION* conn);
+
+        virtual void publishSnapshot(const Timestamp& appliedThrough);
+
+        virtual void retireSnapshot();
+
+        virtual Timestamp getSnapshotTimestamp() const;
+
+        /**
+         * Begins a transaction on 'session' which reads from the current snapshot. Returns false,
+         * without beginning a transaction, if no snapshot has been published.
+         */
+        bool beginTransactionOnSnapshot(WT_SESSION* session) const;
+
+        /**
+         * Drops the snapshots and closes the session used to take them. Must be called before the
+         * connection is closed.
+         */
+        void shutdown();
+
+    private:
+        WT_CONNECTION* const _conn;
+
+        // Protects everything below. Transactions on the snapshot are begun under it so that the
+        // snapshot cannot be dropped in the meantime.
+        mutable boost::mutex _mutex;
+
+        // Session used to take and drop snapshots, opened on first use.
+        WT_SESSION* _session = NULL;
+        bool _shutdown = false;
+
+        uint64_t _nextSnapshotId = 1;
+
+        // Name and 'appliedThrough' timestamp of the current snapshot. Empty and null if there is
+        // none. A retired snapshot keeps its name, for the readers which already use it, but has a
+        // null timestamp.
+        std::string _snapshotName;
+        Timestamp _snapshotTimestamp;
+    };
+
+}  // namespace mongo
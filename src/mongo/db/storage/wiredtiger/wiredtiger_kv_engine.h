@@ -66,6 +66,10 @@ namespace mongo {
 
         virtual bool isDurable() const { return _durable; }
 
+        virtual BatchSnapshotManager* getBatchSnapshotManager() const {
+            return &_sessionCache->getBatchSnapshotManager();
+        }
+
         virtual RecoveryUnit* newRecoveryUnit();
 
         virtual Status createRecordStore( OperationContext* opCtx,
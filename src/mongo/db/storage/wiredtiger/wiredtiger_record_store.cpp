@@ -46,6 +46,7 @@
 #include "mongo/db/storage/oplog_hack.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_record_store_oplog_stones.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
@@ -92,17 +93,27 @@ namespace {
 
     class WiredTigerRecordStore::Cursor final : public RecordCursor {
     public:
+        /**
+         * A forward cursor may be limited to the RecordIds in [rangeStart, rangeEnd), where a
+         * null bound means the range is unbounded on that side.
+         */
         Cursor(OperationContext* txn,
                const WiredTigerRecordStore& rs,
                bool forward = true,
-               bool forParallelCollectionScan = false)
+               bool forParallelCollectionScan = false,
+               RecordId rangeStart = RecordId(),
+               RecordId rangeEnd = RecordId())
             : _rs(rs)
             , _txn(txn)
             , _forward(forward)
             , _forParallelCollectionScan(forParallelCollectionScan)
             , _cursor(new WiredTigerCursor(rs.getURI(), rs.instanceId(), true, txn))
+            , _rangeStart(rangeStart)
+            , _rangeEnd(rangeEnd)
             , _readUntilForOplog(WiredTigerRecoveryUnit::get(txn)->getOplogReadTill())
-        {}
+        {
+            invariant(_forward || (_rangeStart.isNull() && _rangeEnd.isNull()));
+        }
 
         boost::optional<Record> next() final {
             if (_eof) return {};
@@ -112,7 +123,9 @@ namespace {
                 // Nothing after the next line can throw WCEs.
                 // Note that an unpositioned (or eof) WT_CURSOR returns the first/last entry in the
                 // table when you call next/prev.
-                int advanceRet = WT_OP_CHECK(_forward ? c->next(c) : c->prev(c));
+                int advanceRet = (_lastReturnedId.isNull() && !_rangeStart.isNull())
+                                     ? _seekToRangeStart(c)
+                                     : WT_OP_CHECK(_forward ? c->next(c) : c->prev(c));
                 if (advanceRet == WT_NOTFOUND) {
                     _eof = true;
                     return {};
@@ -124,6 +137,11 @@ namespace {
             invariantWTOK(c->get_key(c, &key));
             const RecordId id = _fromKey(key);
 
+            if (!_rangeEnd.isNull() && id >= _rangeEnd) {
+                _eof = true;
+                return {};
+            }
+
             if (!isVisible(id)) {
                 _eof = true;
                 return {};
@@ -251,6 +269,19 @@ namespace {
         }
 
     private:
+        /**
+         * Positions the cursor on the first record at or after _rangeStart.
+         */
+        int _seekToRangeStart(WT_CURSOR* c) {
+            c->set_key(c, _makeKey(_rangeStart));
+            int cmp;
+            int ret = WT_OP_CHECK(c->search_near(c, &cmp));
+            if (ret == 0 && cmp < 0) {
+                ret = WT_OP_CHECK(c->next(c));
+            }
+            return ret;
+        }
+
         bool isVisible(const RecordId& id) {
             if (!_rs._isCapped) return true;
 
@@ -276,9 +307,305 @@ namespace {
         std::unique_ptr<WiredTigerCursor> _cursor;
         bool _eof = false;
         RecordId _lastReturnedId;
+        const RecordId _rangeStart;
+        const RecordId _rangeEnd;
         const RecordId _readUntilForOplog;
     };
 
+namespace {
+
+    // Stones found at startup by sampling are placed by this many random samples each.
+    const int64_t kRandomSamplesPerStone = 10;
+
+    // Oplogs holding fewer than this many stones' worth of data are scanned at startup rather
+    // than sampled.
+    const int64_t kMinSampleRatioForRandCursor = 20;
+
+    const uint64_t kMinStonesToKeep = 10;
+    const uint64_t kMaxStonesToKeep = 100;
+
+} // namespace
+
+    class WiredTigerRecordStore::OplogStones::InsertChange final : public RecoveryUnit::Change {
+    public:
+        InsertChange(OplogStones* oplogStones,
+                     int64_t bytesInserted,
+                     const RecordId& highestInserted,
+                     int64_t countInserted)
+            : _oplogStones(oplogStones),
+              _bytesInserted(bytesInserted),
+              _highestInserted(highestInserted),
+              _countInserted(countInserted) { }
+
+        void commit() final {
+            _oplogStones->_currentRecords.addAndFetch(_countInserted);
+            _oplogStones->_currentBytes.addAndFetch(_bytesInserted);
+            _oplogStones->createNewStoneIfNeeded(_highestInserted);
+        }
+
+        void rollback() final { }
+
+    private:
+        OplogStones* _oplogStones;
+        int64_t _bytesInserted;
+        RecordId _highestInserted;
+        int64_t _countInserted;
+    };
+
+    class WiredTigerRecordStore::OplogStones::TruncateChange final : public RecoveryUnit::Change {
+    public:
+        TruncateChange(OplogStones* oplogStones) : _oplogStones(oplogStones) { }
+
+        void commit() final {
+            boost::lock_guard<boost::mutex> lk(_oplogStones->_mutex);
+            _oplogStones->_currentRecords.store(0);
+            _oplogStones->_currentBytes.store(0);
+            _oplogStones->_stones.clear();
+        }
+
+        void rollback() final { }
+
+    private:
+        OplogStones* _oplogStones;
+    };
+
+    WiredTigerRecordStore::OplogStones::OplogStones(OperationContext* txn,
+                                                    WiredTigerRecordStore* rs)
+        : _rs(rs),
+          _isDead(false) {
+        invariant(rs->isCapped());
+        invariant(rs->cappedMaxSize() > 0);
+
+        // Keep enough stones that reclaiming one removes a small fraction of the oplog, but
+        // don't make them so small that a single document could span several.
+        const uint64_t maxSize = rs->cappedMaxSize();
+        const uint64_t numStones = maxSize / BSONObjMaxInternalSize;
+        _numStonesToKeep = std::min(kMaxStonesToKeep, std::max(kMinStonesToKeep, numStones));
+        _minBytesPerStone = maxSize / _numStonesToKeep;
+        invariant(_minBytesPerStone > 0);
+
+        _calculateStones(txn);
+
+        boost::lock_guard<boost::mutex> lk(_mutex);
+        _pokeReclaimThreadIfNeeded_inlock();
+    }
+
+    void WiredTigerRecordStore::OplogStones::kill() {
+        boost::lock_guard<boost::mutex> lk(_mutex);
+        _isDead = true;
+        _reclaimCond.notify_all();
+    }
+
+    bool WiredTigerRecordStore::OplogStones::isDead() const {
+        boost::lock_guard<boost::mutex> lk(_mutex);
+        return _isDead;
+    }
+
+    bool WiredTigerRecordStore::OplogStones::hasExcessStones() const {
+        boost::lock_guard<boost::mutex> lk(_mutex);
+        return _hasExcessStones_inlock();
+    }
+
+    bool WiredTigerRecordStore::OplogStones::_hasExcessStones_inlock() const {
+        return _stones.size() > _numStonesToKeep;
+    }
+
+    bool WiredTigerRecordStore::OplogStones::awaitHasExcessStonesOrDead(int maxSecondsToWait) {
+        boost::unique_lock<boost::mutex> lk(_mutex);
+        if (!_isDead && !_hasExcessStones_inlock()) {
+            _reclaimCond.timed_wait(lk, boost::posix_time::seconds(maxSecondsToWait));
+        }
+        return !_isDead && _hasExcessStones_inlock();
+    }
+
+    boost::optional<WiredTigerRecordStore::OplogStones::Stone>
+    WiredTigerRecordStore::OplogStones::peekOldestStoneIfNeeded() const {
+        boost::lock_guard<boost::mutex> lk(_mutex);
+        if (!_hasExcessStones_inlock()) {
+            return boost::none;
+        }
+        return _stones.front();
+    }
+
+    void WiredTigerRecordStore::OplogStones::popOldestStone() {
+        boost::lock_guard<boost::mutex> lk(_mutex);
+        invariant(!_stones.empty());
+        _stones.pop_front();
+    }
+
+    void WiredTigerRecordStore::OplogStones::createNewStoneIfNeeded(const RecordId& lastRecord) {
+        boost::unique_lock<boost::mutex> lk(_mutex, boost::try_to_lock);
+        if (!lk.owns_lock()) {
+            // Someone else is already creating a stone.
+            return;
+        }
+
+        if (_currentBytes.load() < _minBytesPerStone) {
+            return;
+        }
+
+        if (!_stones.empty() && lastRecord <= _stones.back().lastRecord) {
+            // Inserts committed out of order. Let a later insert end the stone.
+            return;
+        }
+
+        Stone stone = { _currentRecords.swap(0), _currentBytes.swap(0), lastRecord };
+        _stones.push_back(stone);
+        _pokeReclaimThreadIfNeeded_inlock();
+    }
+
+    void WiredTigerRecordStore::OplogStones::updateCurrentStoneAfterInsertOnCommit(
+            OperationContext* txn,
+            int64_t bytesInserted,
+            const RecordId& highestInserted,
+            int64_t countInserted) {
+        txn->recoveryUnit()->registerChange(
+            new InsertChange(this, bytesInserted, highestInserted, countInserted));
+    }
+
+    void WiredTigerRecordStore::OplogStones::clearStonesOnCommit(OperationContext* txn) {
+        txn->recoveryUnit()->registerChange(new TruncateChange(this));
+    }
+
+    void WiredTigerRecordStore::OplogStones::updateStonesAfterCappedTruncateAfter(
+            int64_t recordsRemoved,
+            int64_t bytesRemoved,
+            const RecordId& firstRemovedId) {
+        boost::lock_guard<boost::mutex> lk(_mutex);
+
+        int64_t recordsInRemovedStones = 0;
+        int64_t bytesInRemovedStones = 0;
+        while (!_stones.empty() && _stones.back().lastRecord >= firstRemovedId) {
+            recordsInRemovedStones += _stones.back().records;
+            bytesInRemovedStones += _stones.back().bytes;
+            _stones.pop_back();
+        }
+
+        // Whatever was left of the oldest of the removed stones now ends the oplog.
+        _currentRecords.addAndFetch(recordsInRemovedStones - recordsRemoved);
+        _currentBytes.addAndFetch(bytesInRemovedStones - bytesRemoved);
+    }
+
+    size_t WiredTigerRecordStore::OplogStones::numStones() const {
+        boost::lock_guard<boost::mutex> lk(_mutex);
+        return _stones.size();
+    }
+
+    void WiredTigerRecordStore::OplogStones::setMinBytesPerStone(int64_t size) {
+        invariant(size > 0);
+        boost::lock_guard<boost::mutex> lk(_mutex);
+
+        // Only allow changing the size before any stones exist.
+        invariant(_stones.empty());
+        _minBytesPerStone = size;
+    }
+
+    void WiredTigerRecordStore::OplogStones::setNumStonesToKeep(size_t numStones) {
+        invariant(numStones > 0);
+        boost::lock_guard<boost::mutex> lk(_mutex);
+        _numStonesToKeep = numStones;
+    }
+
+    void WiredTigerRecordStore::OplogStones::_pokeReclaimThreadIfNeeded_inlock() {
+        if (_hasExcessStones_inlock()) {
+            _reclaimCond.notify_one();
+        }
+    }
+
+    void WiredTigerRecordStore::OplogStones::_calculateStones(OperationContext* txn) {
+        const int64_t numRecords = _rs->numRecords(txn);
+        const int64_t dataSize = _rs->dataSize(txn);
+
+        log() << "The oplog contains about " << numRecords << " records totaling "
+              << dataSize << " bytes";
+
+        if (numRecords <= 0 || dataSize <= 0 ||
+                dataSize / _minBytesPerStone < kMinSampleRatioForRandCursor) {
+            _calculateStonesByScanning(txn);
+            return;
+        }
+
+        // Assume all records are the same size, and place the stones by sampling.
+        const int64_t avgRecordSize = std::max(dataSize / numRecords, int64_t(1));
+        const int64_t estRecordsPerStone =
+            (_minBytesPerStone + avgRecordSize - 1) / avgRecordSize;
+        _calculateStonesBySampling(txn, estRecordsPerStone, estRecordsPerStone * avgRecordSize);
+    }
+
+    void WiredTigerRecordStore::OplogStones::_calculateStonesByScanning(OperationContext* txn) {
+        log() << "Scanning the oplog to determine where to place markers for truncation";
+
+        int64_t currentRecords = 0;
+        int64_t currentBytes = 0;
+
+        Cursor cursor(txn, *_rs);
+        while (auto record = cursor.next()) {
+            currentRecords++;
+            currentBytes += record->data.size();
+            if (currentBytes >= _minBytesPerStone) {
+                Stone stone = { currentRecords, currentBytes, record->id };
+                _stones.push_back(stone);
+                currentRecords = 0;
+                currentBytes = 0;
+            }
+        }
+
+        _currentRecords.store(currentRecords);
+        _currentBytes.store(currentBytes);
+    }
+
+    void WiredTigerRecordStore::OplogStones::_calculateStonesBySampling(
+            OperationContext* txn,
+            int64_t estRecordsPerStone,
+            int64_t estBytesPerStone) {
+        const int64_t numRecords = _rs->numRecords(txn);
+        const int64_t dataSize = _rs->dataSize(txn);
+        const int64_t wholeStones = numRecords / estRecordsPerStone;
+        const int64_t numSamples = kRandomSamplesPerStone * wholeStones;
+
+        log() << "Sampling " << numSamples << " records from the oplog to determine where to"
+              << " place markers for truncation, assuming " << estRecordsPerStone
+              << " records per marker";
+
+        std::vector<RecordId> samples;
+        {
+            WT_SESSION* session = WiredTigerRecoveryUnit::get(txn)->getSession(txn)->getSession();
+            WT_CURSOR* c = NULL;
+            invariantWTOK(session->open_cursor(session, _rs->getURI().c_str(), NULL,
+                                               "next_random=true", &c));
+            ON_BLOCK_EXIT([c] { c->close(c); });
+
+            for (int64_t i = 0; i < numSamples; ++i) {
+                int ret = c->next(c);
+                if (ret == WT_NOTFOUND) {
+                    // The oplog was emptied since its size was read.
+                    break;
+                }
+                invariantWTOK(ret);
+
+                int64_t key;
+                invariantWTOK(c->get_key(c, &key));
+                samples.push_back(_fromKey(key));
+            }
+        }
+
+        if (static_cast<int64_t>(samples.size()) < numSamples) {
+            _calculateStonesByScanning(txn);
+            return;
+        }
+
+        std::sort(samples.begin(), samples.end());
+        for (int64_t i = 1; i <= wholeStones; ++i) {
+            Stone stone = { estRecordsPerStone,
+                            estBytesPerStone,
+                            samples[kRandomSamplesPerStone * i - 1] };
+            _stones.push_back(stone);
+        }
+
+        _currentRecords.store(numRecords - estRecordsPerStone * wholeStones);
+        _currentBytes.store(dataSize - estBytesPerStone * wholeStones);
+    }
+
     StatusWith<std::string> WiredTigerRecordStore::parseOptionsField(const BSONObj options) {
         StringBuilder ss;
         BSONForEach(elem, options) {
@@ -439,6 +766,9 @@ namespace {
         }
 
         _hasBackgroundThread = WiredTigerKVEngine::initRsOplogBackgroundThread(ns);
+        if (_isOplog && _isCapped && _hasBackgroundThread) {
+            _oplogStones = std::make_shared<OplogStones>(ctx, this);
+        }
     }
 
     WiredTigerRecordStore::~WiredTigerRecordStore() {
@@ -447,6 +777,10 @@ namespace {
             _shuttingDown = true;
         }
 
+        if (_oplogStones) {
+            _oplogStones->kill();
+        }
+
         LOG(1) << "~WiredTigerRecordStore for: " << ns();
         if ( _sizeStorer ) {
             _sizeStorer->onDestroy( this );
@@ -581,6 +915,10 @@ namespace {
         // This variable isn't thread safe, but has loose semantics anyway.
         dassert( !_isOplog || _cappedMaxDocs == -1 );
 
+        // The oplog is reclaimed a stone at a time by its background thread.
+        if (_oplogStones)
+            return 0;
+
         if (!cappedAndNeedDelete())
             return 0;
 
@@ -734,6 +1072,54 @@ namespace {
         return docsRemoved;
     }
 
+    int64_t WiredTigerRecordStore::reclaimOplog(OperationContext* txn) {
+        invariant(_oplogStones);
+
+        int64_t recordsRemoved = 0;
+        while (auto stone = _oplogStones->peekOldestStoneIfNeeded()) {
+            invariant(stone->lastRecord.isNormal());
+
+            LOG(1) << "Truncating the oplog between " << _oplogStones->firstRecord << " and "
+                   << stone->lastRecord << " to remove approximately " << stone->records
+                   << " records totaling " << stone->bytes << " bytes";
+
+            WT_SESSION* session = WiredTigerRecoveryUnit::get(txn)->getSession(txn)->getSession();
+
+            try {
+                WriteUnitOfWork wuow(txn);
+
+                WiredTigerCursor startWrap(_uri, _instanceId, true, txn);
+                WT_CURSOR* start = startWrap.get();
+                start->set_key(start, _makeKey(_oplogStones->firstRecord));
+
+                WiredTigerCursor stopWrap(_uri, _instanceId, true, txn);
+                WT_CURSOR* stop = stopWrap.get();
+                stop->set_key(stop, _makeKey(stone->lastRecord));
+
+                // Nothing in the oplog keeps an index, and cursors over it notice on restore
+                // that they were truncated away, so the capped delete callback is not needed.
+                invariantWTOK(WT_OP_CHECK(session->truncate(session, NULL, start, stop, NULL)));
+
+                _changeNumRecords(txn, -stone->records);
+                _increaseDataSize(txn, -stone->bytes);
+
+                wuow.commit();
+            }
+            catch (const WriteConflictException& wce) {
+                LOG(1) << "Caught WriteConflictException while truncating oplog entries, "
+                       << "retrying";
+                return recordsRemoved;
+            }
+
+            // Remove the stone after a successful truncation.
+            _oplogStones->popOldestStone();
+            _oplogStones->firstRecord = stone->lastRecord;
+            recordsRemoved += stone->records;
+        }
+
+        return recordsRemoved;
+    }
+
     StatusWith<RecordId> WiredTigerRecordStore::extractAndCheckLocForOplog(const char* data,
                                                                            int len) {
         return oploghack::extractKey(data, len);
@@ -743,31 +1129,61 @@ namespace {
                                                               const char* data,
                                                               int len,
                                                               bool enforceQuota ) {
-        if ( _isCapped && len > _cappedMaxSize ) {
-            return StatusWith<RecordId>( ErrorCodes::BadValue,
-                                         "object to insert exceeds cappedMaxSize" );
+        std::vector<Record> records(1);
+        records[0].data = RecordData(data, len);
+        Status status = insertRecords( txn, &records, enforceQuota );
+        if ( !status.isOK() )
+            return StatusWith<RecordId>( status );
+        return StatusWith<RecordId>( records[0].id );
+    }
+
+    Status WiredTigerRecordStore::insertRecords( OperationContext* txn,
+                                                 std::vector<Record>* records,
+                                                 bool enforceQuota ) {
+        if ( records->empty() )
+            return Status::OK();
+
+        if ( _isCapped ) {
+            for ( const auto& record : *records ) {
+                if ( record.data.size() > _cappedMaxSize ) {
+                    return Status( ErrorCodes::BadValue,
+                                   "object to insert exceeds cappedMaxSize" );
+                }
+            }
         }
 
-        RecordId loc;
         if ( _useOplogHack ) {
-            StatusWith<RecordId> status = extractAndCheckLocForOplog(data, len);
-            if (!status.isOK())
-                return status;
-            loc = status.getValue();
-            if ( loc > _oplog_highestSeen ) {
+            RecordId highestSeen;
+            for ( auto& record : *records ) {
+                StatusWith<RecordId> status = extractAndCheckLocForOplog(record.data.data(),
+                                                                         record.data.size());
+                if (!status.isOK())
+                    return status.getStatus();
+                record.id = status.getValue();
+                if ( record.id > highestSeen )
+                    highestSeen = record.id;
+            }
+            if ( highestSeen > _oplog_highestSeen ) {
                 boost::lock_guard<boost::mutex> lk( _uncommittedDiskLocsMutex );
-                if ( loc > _oplog_highestSeen ) {
-                    _oplog_highestSeen = loc;
+                if ( highestSeen > _oplog_highestSeen ) {
+                    _oplog_highestSeen = highestSeen;
                 }
             }
         }
         else if ( _isCapped ) {
             boost::lock_guard<boost::mutex> lk( _uncommittedDiskLocsMutex );
-            loc = _nextId();
-            _addUncommitedDiskLoc_inlock( txn, loc );
+            for ( auto& record : *records ) {
+                record.id = _nextId();
+                _addUncommitedDiskLoc_inlock( txn, record.id );
+            }
         }
         else {
-            loc = _nextId();
+            // Reserve the whole block of ids at once.
+            const int64_t first = _nextIdNum.fetchAndAdd( records->size() );
+            for ( size_t i = 0; i < records->size(); ++i ) {
+                (*records)[i].id = RecordId( first + i );
+                invariant( (*records)[i].id.isNormal() );
+            }
         }
 
         WiredTigerCursor curwrap( _uri, _instanceId, true, txn);
@@ -775,20 +1191,35 @@ namespace {
         WT_CURSOR *c = curwrap.get();
         invariant( c );
 
-        c->set_key(c, _makeKey(loc));
-        WiredTigerItem value(data, len);
-        c->set_value(c, value.Get());
-        int ret = WT_OP_CHECK(c->insert(c));
-        if (ret) {
-            return StatusWith<RecordId>(wtRCToStatus(ret, "WiredTigerRecordStore::insertRecord"));
+        int64_t totalLength = 0;
+        RecordId highestId;
+        for ( const auto& record : *records ) {
+            c->set_key(c, _makeKey(record.id));
+            WiredTigerItem value(record.data.data(), record.data.size());
+            c->set_value(c, value.Get());
+            int ret = WT_OP_CHECK(c->insert(c));
+            if (ret) {
+                return wtRCToStatus(ret, "WiredTigerRecordStore::insertRecord");
+            }
+            totalLength += record.data.size();
+            if ( record.id > highestId )
+                highestId = record.id;
         }
 
-        _changeNumRecords( txn, 1 );
-        _increaseDataSize( txn, len );
+        _changeNumRecords( txn, records->size() );
+        _increaseDataSize( txn, totalLength );
 
-        cappedDeleteAsNeeded(txn, loc);
+        if ( _oplogStones ) {
+            _oplogStones->updateCurrentStoneAfterInsertOnCommit( txn,
+                                                                 totalLength,
+                                                                 highestId,
+                                                                 records->size() );
+        }
+        else {
+            cappedDeleteAsNeeded(txn, highestId);
+        }
 
-        return StatusWith<RecordId>( loc );
+        return Status::OK();
     }
 
     void WiredTigerRecordStore::dealtWithCappedLoc( const RecordId& loc ) {
@@ -889,13 +1320,69 @@ namespace {
     }
 
     std::vector<std::unique_ptr<RecordCursor>> WiredTigerRecordStore::getManyCursors(
-            OperationContext* txn) const {
-        std::vector<std::unique_ptr<RecordCursor>> cursors(1);
-        cursors[0] = stdx::make_unique<Cursor>(txn, *this, /*forward=*/true,
-                                               /*forParallelCollectionScan=*/true);
+            OperationContext* txn, size_t numCursors) const {
+        std::vector<std::unique_ptr<RecordCursor>> cursors;
+
+        const std::vector<RecordId> splitPoints = getSplitPoints(txn, numCursors);
+
+        RecordId rangeStart;
+        for (const auto& splitPoint : splitPoints) {
+            cursors.push_back(stdx::make_unique<Cursor>(txn, *this, /*forward=*/true,
+                                                        /*forParallelCollectionScan=*/true,
+                                                        rangeStart, splitPoint));
+            rangeStart = splitPoint;
+        }
+        cursors.push_back(stdx::make_unique<Cursor>(txn, *this, /*forward=*/true,
+                                                    /*forParallelCollectionScan=*/true,
+                                                    rangeStart, RecordId()));
         return cursors;
     }
 
+    std::unique_ptr<RecordCursor> WiredTigerRecordStore::getCursorForRange(
+            OperationContext* txn, const RecordId& start, const RecordId& end) const {
+        invariant(!_isCapped);
+        return stdx::make_unique<Cursor>(txn, *this, /*forward=*/true,
+                                         /*forParallelCollectionScan=*/false,
+                                         start, end);
+    }
+
+    std::vector<RecordId> WiredTigerRecordStore::getSplitPoints(OperationContext* txn,
+                                                                size_t numRanges) const {
+        std::vector<RecordId> splitPoints;
+        if (_isCapped || numRanges < 2) {
+            return splitPoints;
+        }
+
+        // RecordIds are assigned in increasing order, so evenly spaced keys between the
+        // smallest and largest ones split the table into ranges of roughly equal size unless
+        // documents were deleted very unevenly.
+        int64_t first;
+        int64_t last;
+        {
+            WiredTigerCursor curwrap(_uri, _instanceId, true, txn);
+            WT_CURSOR* c = curwrap.get();
+
+            int ret = WT_OP_CHECK(c->next(c));
+            if (ret == WT_NOTFOUND) {
+                return splitPoints;
+            }
+            invariantWTOK(ret);
+            invariantWTOK(c->get_key(c, &first));
+
+            invariantWTOK(WT_OP_CHECK(c->reset(c)));
+            invariantWTOK(WT_OP_CHECK(c->prev(c)));
+            invariantWTOK(c->get_key(c, &last));
+        }
+
+        const int64_t span = last - first + 1;
+        numRanges = std::min(numRanges, static_cast<size_t>(span));
+        for (size_t i = 1; i < numRanges; i++) {
+            splitPoints.push_back(_fromKey(first + (span / numRanges) * i
+                                                 + (span % numRanges) * i / numRanges));
+        }
+        return splitPoints;
+    }
+
     Status WiredTigerRecordStore::truncate( OperationContext* txn ) {
         WiredTigerCursor startWrap( _uri, _instanceId, true, txn);
         WT_CURSOR* start = startWrap.get();
@@ -911,6 +1398,10 @@ namespace {
         _changeNumRecords(txn, -numRecords(txn));
         _increaseDataSize(txn, -dataSize(txn));
 
+        if (_oplogStones) {
+            _oplogStones->clearStonesOnCommit(txn);
+        }
+
         return Status::OK();
     }
 
@@ -1159,7 +1650,7 @@ namespace {
 
     class WiredTigerRecordStore::DataSizeChange : public RecoveryUnit::Change {
     public:
-        DataSizeChange(WiredTigerRecordStore* rs, int amount) :_rs(rs), _amount(amount) {}
+        DataSizeChange(WiredTigerRecordStore* rs, int64_t amount) :_rs(rs), _amount(amount) {}
         virtual void commit() {}
         virtual void rollback() {
             _rs->_increaseDataSize( NULL, -_amount );
@@ -1167,10 +1658,10 @@ namespace {
 
     private:
         WiredTigerRecordStore* _rs;
-        bool _amount;
+        int64_t _amount;
     };
 
-    void WiredTigerRecordStore::_increaseDataSize( OperationContext* txn, int amount ) {
+    void WiredTigerRecordStore::_increaseDataSize( OperationContext* txn, int64_t amount ) {
         if ( txn )
             txn->recoveryUnit()->registerChange(new DataSizeChange(this, amount));
 
@@ -1200,12 +1691,25 @@ namespace {
                                                           bool inclusive ) {
         WriteUnitOfWork wuow(txn);
         Cursor cursor(txn, *this);
+        RecordId firstRemovedId;
+        int64_t recordsRemoved = 0;
+        int64_t bytesRemoved = 0;
         while (auto record = cursor.next()) {
             RecordId loc = record->id;
             if ( end < loc || ( inclusive && end == loc ) ) {
+                if ( firstRemovedId.isNull() )
+                    firstRemovedId = loc;
+                recordsRemoved++;
+                bytesRemoved += record->data.size();
                 deleteRecord( txn, loc );
             }
         }
         wuow.commit();
+
+        if ( _oplogStones && recordsRemoved > 0 ) {
+            _oplogStones->updateStonesAfterCappedTruncateAfter( recordsRemoved,
+                                                                bytesRemoved,
+                                                                firstRemovedId );
+        }
     }
 }
@@ -31,6 +31,7 @@
 
 #pragma once
 
+#include <memory>
 #include <set>
 #include <string>
 
@@ -60,6 +61,7 @@ namespace mongo {
 
     class WiredTigerRecordStore : public RecordStore {
     public:
+        class OplogStones;
 
         /**
          * During record store creation, if size storer reports a record count under
@@ -131,6 +133,10 @@ namespace mongo {
                                                   const DocWriter* doc,
                                                   bool enforceQuota );
 
+        virtual Status insertRecords( OperationContext* txn,
+                                      std::vector<Record>* records,
+                                      bool enforceQuota );
+
         virtual StatusWith<RecordId> updateRecord( OperationContext* txn,
                                                   const RecordId& oldLocation,
                                                   const char* data,
@@ -147,8 +153,22 @@ namespace mongo {
                                           const mutablebson::DamageVector& damages );
 
         std::unique_ptr<RecordCursor> getCursor(OperationContext* txn, bool forward) const final;
+        /**
+         * Splits non-capped tables into 'numCursors' disjoint, roughly equal RecordId ranges,
+         * and returns a cursor over each.
+         */
         std::vector<std::unique_ptr<RecordCursor>> getManyCursors(
-            OperationContext* txn) const final;
+            OperationContext* txn, size_t numCursors) const final;
+
+        /**
+         * Capped tables are never split, so that readers can rely on never seeing holes.
+         */
+        std::vector<RecordId> getSplitPoints(OperationContext* txn,
+                                             size_t numRanges) const final;
+
+        std::unique_ptr<RecordCursor> getCursorForRange(OperationContext* txn,
+                                                        const RecordId& start,
+                                                        const RecordId& end) const final;
 
         virtual Status truncate( OperationContext* txn );
 
@@ -211,6 +231,18 @@ namespace mongo {
 
         boost::timed_mutex& cappedDeleterMutex() { return _cappedDeleterMutex; }
 
+        /**
+         * Set for the oplog when it has a background thread to reclaim it, in which case
+         * inserts never delete old entries themselves.
+         */
+        const std::shared_ptr<OplogStones>& oplogStones() const { return _oplogStones; }
+
+        /**
+         * Truncates the oldest stones of the oplog while there are more than needed. Returns the
+         * approximate number of records removed.
+         */
+        int64_t reclaimOplog(OperationContext* txn);
+
     private:
         class Cursor;
 
@@ -229,7 +261,7 @@ namespace mongo {
         void _setId(RecordId loc);
         bool cappedAndNeedDelete() const;
         void _changeNumRecords(OperationContext* txn, int64_t diff);
-        void _increaseDataSize(OperationContext* txn, int amount);
+        void _increaseDataSize(OperationContext* txn, int64_t amount);
         RecordData _getData( const WiredTigerCursor& cursor) const;
         StatusWith<RecordId> extractAndCheckLocForOplog(const char* data, int len);
         void _oplogSetStartHack( WiredTigerRecoveryUnit* wru ) const;
@@ -264,6 +296,8 @@ namespace mongo {
 
         bool _shuttingDown;
         bool _hasBackgroundThread;
+
+        std::shared_ptr<OplogStones> _oplogStones;
     };
 
     // WT failpoint to throw write conflict exceptions randomly
@@ -31,13 +31,16 @@
 
 #include "mongo/platform/basic.h"
 
+#include "mongo/db/namespace_string.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 
 namespace mongo {
 
     // static
     bool WiredTigerKVEngine::initRsOplogBackgroundThread(StringData ns) {
-        return false;
+        // No thread is started, but oplogs are still divided into stones so that tests can
+        // reclaim them explicitly.
+        return NamespaceString::oplog(ns);
     }
 
 }  // namespace mongo
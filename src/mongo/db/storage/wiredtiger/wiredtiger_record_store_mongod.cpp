@@ -45,6 +45,7 @@
 #include "mongo/db/operation_context_impl.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_record_store_oplog_stones.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/util/background.h"
 #include "mongo/util/exit.h"
@@ -100,6 +101,13 @@ namespace mongo {
                     OldClientContext ctx(&txn, _ns, false);
                     WiredTigerRecordStore* rs =
                         checked_cast<WiredTigerRecordStore*>(collection->getRecordStore());
+
+                    // Remembered so that run() can wait for stones outside of the locks.
+                    _oplogStones = rs->oplogStones();
+                    if (_oplogStones) {
+                        return rs->reclaimOplog(&txn);
+                    }
+
                     WriteUnitOfWork wuow(&txn);
                     boost::lock_guard<boost::timed_mutex> lock(rs->cappedDeleterMutex());
                     int64_t removed = rs->cappedDeleteAsNeeded_inlock(&txn, RecordId::max());
@@ -121,7 +129,14 @@ namespace mongo {
                 while (!inShutdown()) {
                     int64_t removed = _deleteExcessDocuments();
                     LOG(2) << "WiredTigerRecordStoreThread deleted " << removed;
-                    if (removed == 0) {
+                    if (_oplogStones) {
+                        // Inserts wake us up once there is a stone to reclaim.
+                        if (removed == 0) {
+                            _oplogStones->awaitHasExcessStonesOrDead(1);
+                        }
+                        _oplogStones.reset();
+                    }
+                    else if (removed == 0) {
                         // If we removed 0 documents, sleep a bit in case we're on a laptop
                         // or something to be nice.
                         sleepmillis(1000);
@@ -139,6 +154,9 @@ namespace mongo {
         private:
             NamespaceString _ns;
             std::string _name;
+
+            // Set while the oplog is reclaimed through stones.
+            std::shared_ptr<WiredTigerRecordStore::OplogStones> _oplogStones;
         };
 
     }  // namespace
@@ -0,0 +1,166 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <deque>
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+    class OperationContext;
+
+    /**
+     * Divides the oplog into "stones": contiguous regions of roughly equal size, each ending at
+     * a known RecordId. Inserts only add to the size of the region currently being filled, and
+     * a new stone is recorded once it is large enough. When there are more stones than are
+     * needed to hold the oplog's configured size, the oplog's background thread truncates the
+     * oldest of them as a single range, so that no deletions happen on the insert path.
+     *
+     * Sizes are approximate. Stones found at startup may come from sampling random records, and
+     * records committed out of order can be counted against a later stone.
+     */
+    class WiredTigerRecordStore::OplogStones {
+    public:
+        struct Stone {
+            int64_t records;      // Approximate number of records in this stone.
+            int64_t bytes;        // Approximate size of the records in this stone.
+            RecordId lastRecord;  // RecordId of the last record in this stone.
+        };
+
+        OplogStones(OperationContext* txn, WiredTigerRecordStore* rs);
+
+        /**
+         * Wakes up anyone waiting in awaitHasExcessStonesOrDead(), for good.
+         */
+        void kill();
+
+        bool isDead() const;
+
+        bool hasExcessStones() const;
+
+        /**
+         * Waits up to 'maxSecondsToWait' for there to be stones to reclaim. Returns true if
+         * there are any and this object has not been killed.
+         */
+        bool awaitHasExcessStonesOrDead(int maxSecondsToWait);
+
+        /**
+         * Returns the oldest stone if it should be reclaimed.
+         */
+        boost::optional<Stone> peekOldestStoneIfNeeded() const;
+
+        /**
+         * Called once the oldest stone has been truncated from the oplog.
+         */
+        void popOldestStone();
+
+        void createNewStoneIfNeeded(const RecordId& lastRecord);
+
+        /**
+         * Counts an insert against the current stone once 'txn' commits.
+         */
+        void updateCurrentStoneAfterInsertOnCommit(OperationContext* txn,
+                                                   int64_t bytesInserted,
+                                                   const RecordId& highestInserted,
+                                                   int64_t countInserted);
+
+        /**
+         * Forgets all stones once 'txn' commits, for when the oplog is emptied.
+         */
+        void clearStonesOnCommit(OperationContext* txn);
+
+        /**
+         * Drops the stones holding records removed from the end of the oplog, and takes what
+         * remained of the last of them into the current stone.
+         */
+        void updateStonesAfterCappedTruncateAfter(int64_t recordsRemoved,
+                                                  int64_t bytesRemoved,
+                                                  const RecordId& firstRemovedId);
+
+        // The first record which has not been reclaimed. Only used by the reclaiming thread.
+        RecordId firstRecord;
+
+        //
+        // The following are used for testing and stats.
+        //
+
+        size_t numStones() const;
+
+        int64_t currentRecords() const { return _currentRecords.load(); }
+
+        int64_t currentBytes() const { return _currentBytes.load(); }
+
+        void setMinBytesPerStone(int64_t size);
+
+        void setNumStonesToKeep(size_t numStones);
+
+    private:
+        class InsertChange;
+        class TruncateChange;
+
+        void _calculateStones(OperationContext* txn);
+        void _calculateStonesByScanning(OperationContext* txn);
+        void _calculateStonesBySampling(OperationContext* txn,
+                                        int64_t estRecordsPerStone,
+                                        int64_t estBytesPerStone);
+
+        bool _hasExcessStones_inlock() const;
+
+        void _pokeReclaimThreadIfNeeded_inlock();
+
+        WiredTigerRecordStore* _rs;
+
+        // Protects _stones, _isDead and the settings below.
+        mutable boost::mutex _mutex;
+
+        // Signalled when there are stones to reclaim, or when killed.
+        boost::condition_variable _reclaimCond;
+
+        bool _isDead;
+
+        // Reclaim the oldest stone once there are more than this many.
+        size_t _numStonesToKeep;
+
+        // The current stone becomes a new stone once it holds at least this many bytes.
+        int64_t _minBytesPerStone;
+
+        // The records inserted since the newest stone was created.
+        AtomicInt64 _currentRecords;
+        AtomicInt64 _currentBytes;
+
+        // Oldest stone at the front.
+        std::deque<Stone> _stones;
+    };
+
+}  // namespace mongo
@@ -43,6 +43,7 @@
 #include "mongo/db/storage/record_store_test_harness.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_record_store_oplog_stones.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
@@ -240,6 +241,32 @@ namespace mongo {
         }
     }
 
+    TEST(WiredTigerRecordStoreTest, InsertRecordsRollback ) {
+        scoped_ptr<HarnessHelper> harnessHelper( newHarnessHelper() );
+        scoped_ptr<RecordStore> rs( harnessHelper->newNonCappedRecordStore() );
+
+        std::vector<Record> records( 3 );
+        for ( size_t i = 0; i < records.size(); i++ ) {
+            records[i].data = RecordData( "abcd", 5 );
+        }
+
+        {
+            scoped_ptr<OperationContext> opCtx( harnessHelper->newOperationContext() );
+            WriteUnitOfWork uow( opCtx.get() );
+            ASSERT_OK( rs->insertRecords( opCtx.get(), &records, false ) );
+            ASSERT_EQUALS( 3, rs->numRecords( opCtx.get() ) );
+            ASSERT_EQUALS( 15, rs->dataSize( opCtx.get() ) );
+            // not committed
+        }
+
+        {
+            scoped_ptr<OperationContext> opCtx( harnessHelper->newOperationContext() );
+            ASSERT_EQUALS( 0, rs->numRecords( opCtx.get() ) );
+            ASSERT_EQUALS( 0, rs->dataSize( opCtx.get() ) );
+            ASSERT( !rs->getCursor( opCtx.get() )->next() );
+        }
+    }
+
     TEST(WiredTigerRecordStoreTest, Isolation2 ) {
         scoped_ptr<HarnessHelper> harnessHelper( newHarnessHelper() );
         scoped_ptr<RecordStore> rs( harnessHelper->newNonCappedRecordStore() );
@@ -880,4 +907,205 @@ namespace {
         ASSERT(!cursor->next());
     }
 
+    // Inserts an oplog entry at Timestamp(1, inc) whose BSON is 'size' bytes long.
+    RecordId _oplogStonesInsert(OperationContext* txn, RecordStore* rs, int inc, int size) {
+        const int padding = size - BSON("ts" << Timestamp(1, inc) << "pad" << "").objsize();
+        ASSERT_GTE(padding, 0);
+        BSONObj obj = BSON("ts" << Timestamp(1, inc) << "pad" << std::string(padding, 'x'));
+        ASSERT_EQUALS(size, obj.objsize());
+
+        WiredTigerRecordStore* wrs = checked_cast<WiredTigerRecordStore*>(rs);
+        ASSERT_OK(wrs->oplogDiskLocRegister(txn, Timestamp(1, inc)));
+        StatusWith<RecordId> res = rs->insertRecord(txn, obj.objdata(), obj.objsize(), false);
+        ASSERT_OK(res.getStatus());
+        return res.getValue();
+    }
+
+    TEST(WiredTigerRecordStoreTest, OplogStones_CreateNewStone) {
+        WiredTigerHarnessHelper harnessHelper;
+        scoped_ptr<RecordStore> rs(harnessHelper.newCappedRecordStore("local.oplog.stones",
+                                                                      1024 * 1024,
+                                                                      -1));
+        WiredTigerRecordStore* wrs = checked_cast<WiredTigerRecordStore*>(rs.get());
+        WiredTigerRecordStore::OplogStones* oplogStones = wrs->oplogStones().get();
+        ASSERT(oplogStones);
+        oplogStones->setMinBytesPerStone(100);
+
+        // Inserts which are rolled back are not counted.
+        {
+            scoped_ptr<OperationContext> opCtx(harnessHelper.newOperationContext());
+            WriteUnitOfWork wuow(opCtx.get());
+            _oplogStonesInsert(opCtx.get(), rs.get(), 1, 150);
+        }
+        ASSERT_EQUALS(0U, oplogStones->numStones());
+        ASSERT_EQUALS(0, oplogStones->currentRecords());
+        ASSERT_EQUALS(0, oplogStones->currentBytes());
+
+        {
+            scoped_ptr<OperationContext> opCtx(harnessHelper.newOperationContext());
+            WriteUnitOfWork wuow(opCtx.get());
+            _oplogStonesInsert(opCtx.get(), rs.get(), 2, 50);
+            wuow.commit();
+        }
+        ASSERT_EQUALS(0U, oplogStones->numStones());
+        ASSERT_EQUALS(1, oplogStones->currentRecords());
+        ASSERT_EQUALS(50, oplogStones->currentBytes());
+
+        // Reaching the minimum size ends the stone.
+        {
+            scoped_ptr<OperationContext> opCtx(harnessHelper.newOperationContext());
+            WriteUnitOfWork wuow(opCtx.get());
+            _oplogStonesInsert(opCtx.get(), rs.get(), 3, 50);
+            wuow.commit();
+        }
+        ASSERT_EQUALS(1U, oplogStones->numStones());
+        ASSERT_EQUALS(0, oplogStones->currentRecords());
+        ASSERT_EQUALS(0, oplogStones->currentBytes());
+
+        // Several inserts in one unit of work are counted together.
+        {
+            scoped_ptr<OperationContext> opCtx(harnessHelper.newOperationContext());
+            WriteUnitOfWork wuow(opCtx.get());
+            _oplogStonesInsert(opCtx.get(), rs.get(), 4, 60);
+            _oplogStonesInsert(opCtx.get(), rs.get(), 5, 60);
+            _oplogStonesInsert(opCtx.get(), rs.get(), 6, 60);
+            wuow.commit();
+        }
+        ASSERT_EQUALS(2U, oplogStones->numStones());
+        ASSERT_EQUALS(0, oplogStones->currentRecords());
+        ASSERT_EQUALS(0, oplogStones->currentBytes());
+        ASSERT_FALSE(oplogStones->hasExcessStones());
+    }
+
+    TEST(WiredTigerRecordStoreTest, OplogStones_ReclaimStones) {
+        WiredTigerHarnessHelper harnessHelper;
+        scoped_ptr<RecordStore> rs(harnessHelper.newCappedRecordStore("local.oplog.stones",
+                                                                      1024 * 1024,
+                                                                      -1));
+        WiredTigerRecordStore* wrs = checked_cast<WiredTigerRecordStore*>(rs.get());
+        WiredTigerRecordStore::OplogStones* oplogStones = wrs->oplogStones().get();
+        oplogStones->setMinBytesPerStone(100);
+        oplogStones->setNumStonesToKeep(1);
+
+        RecordId lastLoc;
+        for (int i = 1; i <= 3; ++i) {
+            scoped_ptr<OperationContext> opCtx(harnessHelper.newOperationContext());
+            WriteUnitOfWork wuow(opCtx.get());
+            lastLoc = _oplogStonesInsert(opCtx.get(), rs.get(), i, 100);
+            wuow.commit();
+        }
+        ASSERT_EQUALS(3U, oplogStones->numStones());
+        ASSERT_TRUE(oplogStones->hasExcessStones());
+
+        {
+            scoped_ptr<OperationContext> opCtx(harnessHelper.newOperationContext());
+            ASSERT_EQUALS(2, wrs->reclaimOplog(opCtx.get()));
+
+            ASSERT_EQUALS(1, rs->numRecords(opCtx.get()));
+            ASSERT_EQUALS(100, rs->dataSize(opCtx.get()));
+
+            auto cursor = rs->getCursor(opCtx.get());
+            auto record = cursor->next();
+            ASSERT(record);
+            ASSERT_EQUALS(lastLoc, record->id);
+            ASSERT(!cursor->next());
+        }
+        ASSERT_EQUALS(1U, oplogStones->numStones());
+        ASSERT_FALSE(oplogStones->hasExcessStones());
+
+        // Nothing more to reclaim.
+        {
+            scoped_ptr<OperationContext> opCtx(harnessHelper.newOperationContext());
+            ASSERT_EQUALS(0, wrs->reclaimOplog(opCtx.get()));
+            ASSERT_EQUALS(1, rs->numRecords(opCtx.get()));
+        }
+    }
+
+    TEST(WiredTigerRecordStoreTest, OplogStones_Truncate) {
+        WiredTigerHarnessHelper harnessHelper;
+        scoped_ptr<RecordStore> rs(harnessHelper.newCappedRecordStore("local.oplog.stones",
+                                                                      1024 * 1024,
+                                                                      -1));
+        WiredTigerRecordStore* wrs = checked_cast<WiredTigerRecordStore*>(rs.get());
+        WiredTigerRecordStore::OplogStones* oplogStones = wrs->oplogStones().get();
+        oplogStones->setMinBytesPerStone(100);
+
+        for (int i = 1; i <= 3; ++i) {
+            scoped_ptr<OperationContext> opCtx(harnessHelper.newOperationContext());
+            WriteUnitOfWork wuow(opCtx.get());
+            _oplogStonesInsert(opCtx.get(), rs.get(), i, 60);
+            wuow.commit();
+        }
+        ASSERT_EQUALS(1U, oplogStones->numStones());
+        ASSERT_EQUALS(1, oplogStones->currentRecords());
+
+        {
+            scoped_ptr<OperationContext> opCtx(harnessHelper.newOperationContext());
+            WriteUnitOfWork wuow(opCtx.get());
+            ASSERT_OK(rs->truncate(opCtx.get()));
+            wuow.commit();
+        }
+        ASSERT_EQUALS(0U, oplogStones->numStones());
+        ASSERT_EQUALS(0, oplogStones->currentRecords());
+        ASSERT_EQUALS(0, oplogStones->currentBytes());
+    }
+
+    TEST(WiredTigerRecordStoreTest, OplogStones_CappedTruncateAfter) {
+        WiredTigerHarnessHelper harnessHelper;
+        scoped_ptr<RecordStore> rs(harnessHelper.newCappedRecordStore("local.oplog.stones",
+                                                                      1024 * 1024,
+                                                                      -1));
+        WiredTigerRecordStore* wrs = checked_cast<WiredTigerRecordStore*>(rs.get());
+        WiredTigerRecordStore::OplogStones* oplogStones = wrs->oplogStones().get();
+        oplogStones->setMinBytesPerStone(100);
+
+        // Stones end at the second and fourth records, and the fifth is in the current one.
+        std::vector<RecordId> locs;
+        for (int i = 1; i <= 5; ++i) {
+            scoped_ptr<OperationContext> opCtx(harnessHelper.newOperationContext());
+            WriteUnitOfWork wuow(opCtx.get());
+            locs.push_back(_oplogStonesInsert(opCtx.get(), rs.get(), i, 50));
+            wuow.commit();
+        }
+        ASSERT_EQUALS(2U, oplogStones->numStones());
+        ASSERT_EQUALS(1, oplogStones->currentRecords());
+
+        // Removing the last two records drops the second stone and leaves its first record in
+        // the current stone.
+        {
+            scoped_ptr<OperationContext> opCtx(harnessHelper.newOperationContext());
+            rs->temp_cappedTruncateAfter(opCtx.get(), locs[2], false);
+            ASSERT_EQUALS(3, rs->numRecords(opCtx.get()));
+        }
+        ASSERT_EQUALS(1U, oplogStones->numStones());
+        ASSERT_EQUALS(1, oplogStones->currentRecords());
+        ASSERT_EQUALS(50, oplogStones->currentBytes());
+    }
+
+    TEST(WiredTigerRecordStoreTest, OplogStones_CalculatedOnStartup) {
+        WiredTigerHarnessHelper harnessHelper;
+
+        // With a 1000 byte oplog, each stone holds at least 100 bytes.
+        {
+            scoped_ptr<RecordStore> rs(harnessHelper.newCappedRecordStore("local.oplog.stones",
+                                                                          1000,
+                                                                          -1));
+            for (int i = 1; i <= 5; ++i) {
+                scoped_ptr<OperationContext> opCtx(harnessHelper.newOperationContext());
+                WriteUnitOfWork wuow(opCtx.get());
+                _oplogStonesInsert(opCtx.get(), rs.get(), i, 50);
+                wuow.commit();
+            }
+        }
+
+        scoped_ptr<RecordStore> rs(harnessHelper.newCappedRecordStore("local.oplog.stones",
+                                                                      1000,
+                                                                      -1));
+        WiredTigerRecordStore* wrs = checked_cast<WiredTigerRecordStore*>(rs.get());
+        WiredTigerRecordStore::OplogStones* oplogStones = wrs->oplogStones().get();
+        ASSERT_EQUALS(2U, oplogStones->numStones());
+        ASSERT_EQUALS(1, oplogStones->currentRecords());
+        ASSERT_EQUALS(50, oplogStones->currentBytes());
+    }
+
 }  // namespace mongo
@@ -84,6 +84,7 @@ namespace mongo {
         _session( NULL ),
         _inUnitOfWork(false),
         _active( false ),
+        _activeOnBatchSnapshot( false ),
         _myTransactionCount( 1 ),
         _everStartedWrite( false ),
         _currentlySquirreled( false ),
@@ -103,6 +104,7 @@ namespace mongo {
     void WiredTigerRecoveryUnit::reportState( BSONObjBuilder* b ) const {
         b->append("wt_inUnitOfWork", _inUnitOfWork);
         b->append("wt_active", _active);
+        b->append("wt_onBatchSnapshot", _activeOnBatchSnapshot);
         b->append("wt_everStartedWrite", _everStartedWrite);
         b->append("wt_hasTicket", _ticket.hasTicket());
         b->appendNumber("wt_myTransactionCount", static_cast<long long>(_myTransactionCount));
@@ -153,6 +155,11 @@ namespace mongo {
     void WiredTigerRecoveryUnit::beginUnitOfWork(OperationContext* opCtx) {
         invariant(!_inUnitOfWork);
         invariant(!_currentlySquirreled);
+        if (_activeOnBatchSnapshot) {
+            // Nothing was written through the snapshot transaction, and writes must start from
+            // the latest data.
+            _txnClose(false);
+        }
         _inUnitOfWork = true;
         _everStartedWrite = true;
         _getTicket(opCtx);
@@ -314,6 +321,7 @@ namespace mongo {
             LOG(2) << "WT rollback_transaction";
         }
         _active = false;
+        _activeOnBatchSnapshot = false;
         _myTransactionCount++;
         _ticket.reset(NULL);
     }
@@ -361,8 +369,21 @@ namespace mongo {
 
         WT_SESSION *s = _session->getSession();
         _syncing = _syncing || waitUntilDurableData.numWaitingForSync.load() > 0;
-        invariantWTOK( s->begin_transaction(s, _syncing ? "sync=true" : NULL) );
-        LOG(2) << "WT begin_transaction";
+
+        // Batch snapshot readers do not hold the parallel batch writer lock, so they must not
+        // see the writes of the batch being applied. Writes always start from the latest data.
+        if (!_inUnitOfWork &&
+            opCtx != NULL &&
+            opCtx->lockState() != NULL &&
+            opCtx->lockState()->isBatchSnapshotReader() &&
+            _sessionCache->getBatchSnapshotManager().beginTransactionOnSnapshot(s)) {
+            _activeOnBatchSnapshot = true;
+            LOG(2) << "WT begin_transaction on batch snapshot";
+        }
+        else {
+            invariantWTOK( s->begin_transaction(s, _syncing ? "sync=true" : NULL) );
+            LOG(2) << "WT begin_transaction";
+        }
         _timer.reset();
         _active = true;
     }
@@ -78,6 +78,8 @@ namespace mongo {
 
         virtual SnapshotId getSnapshotId() const;
 
+        virtual bool canReadFromBatchSnapshot() const { return !_active || _activeOnBatchSnapshot; }
+
         // ---- WT STUFF
 
         WiredTigerSession* getSession(OperationContext* opCtx);
@@ -108,6 +110,7 @@ namespace mongo {
         bool _defaultCommit;
         bool _inUnitOfWork;
         bool _active;
+        bool _activeOnBatchSnapshot; // the open transaction reads from the batch snapshot
         uint64_t _myTransactionCount;
         bool _everStartedWrite;
         Timer _timer;
@@ -124,12 +124,15 @@ namespace mongo {
     // -----------------------
 
     WiredTigerSessionCache::WiredTigerSessionCache( WiredTigerKVEngine* engine )
-        : _engine( engine ), _conn( engine->getConnection() ), _shuttingDown(0) {
+        : _engine( engine ),
+          _conn( engine->getConnection() ),
+          _batchSnapshotManager( _conn ),
+          _shuttingDown(0) {
 
     }
 
     WiredTigerSessionCache::WiredTigerSessionCache( WT_CONNECTION* conn )
-        : _engine( NULL ), _conn( conn ), _shuttingDown(0) {
+        : _engine( NULL ), _conn( conn ), _batchSnapshotManager( conn ), _shuttingDown(0) {
 
     }
 
@@ -148,6 +151,7 @@ namespace mongo {
             boost::lock_guard<boost::shared_mutex> lk(_shutdownLock);
         }
 
+        _batchSnapshotManager.shutdown();
         closeAll();
     }
 
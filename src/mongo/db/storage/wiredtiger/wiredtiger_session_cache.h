@@ -40,6 +40,7 @@
 
 #include <wiredtiger.h>
 
+#include "mongo/db/storage/wiredtiger/wiredtiger_batch_snapshot_manager.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/util/concurrency/spin_lock.h"
 
@@ -122,6 +123,8 @@ namespace mongo {
 
         WT_CONNECTION* conn() const { return _conn; }
 
+        WiredTigerBatchSnapshotManager& getBatchSnapshotManager() { return _batchSnapshotManager; }
+
     private:
         typedef std::vector<WiredTigerSession*> SessionPool;
 
@@ -142,6 +145,8 @@ namespace mongo {
         WiredTigerKVEngine* _engine; // not owned, might be NULL
         WT_CONNECTION* _conn; // not owned
 
+        WiredTigerBatchSnapshotManager _batchSnapshotManager;
+
         // Partitioned cache of WT sessions. The partition key is not important, but it is
         // important that sessions be returned to the same partition they were taken from in order
         // to have some form of balance between the partitions.
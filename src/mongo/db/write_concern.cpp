@@ -30,6 +30,9 @@
 
 #include "mongo/db/write_concern.h"
 
+#include <algorithm>
+#include <map>
+
 #include "mongo/base/counter.h"
 #include "mongo/bson/util/bson_extract.h"
 #include "mongo/db/commands/server_status_metric.h"
@@ -41,6 +44,7 @@
 #include "mongo/db/stats/timer_stats.h"
 #include "mongo/db/storage/storage_engine.h"
 #include "mongo/db/write_concern_options.h"
+#include "mongo/stdx/mutex.h"
 
 namespace mongo {
 
@@ -55,6 +59,90 @@ namespace mongo {
     static ServerStatusMetricField<Counter64> gleWtimeoutsDisplay("getLastError.wtimeouts",
                                                                   &gleWtimeouts );
 
+    namespace {
+        /**
+         * Histograms of the time spent waiting for replication, one per "w" value, so that slow
+         * majority or tagged waits are not hidden in the average of all of them.
+         */
+        class WtimeHistograms : public ServerStatusMetric {
+        public:
+            WtimeHistograms() : ServerStatusMetric("getLastError.wtimeHistograms") {}
+
+            void record(const WriteConcernOptions& writeConcern, long long millis) {
+                const std::string key = writeConcern.wMode.empty() ?
+                    std::string(str::stream() << writeConcern.wNumNodes) : writeConcern.wMode;
+
+                stdx::lock_guard<stdx::mutex> lk(_mutex);
+                std::map<std::string, Histogram>::iterator it = _histograms.find(key);
+                if (it == _histograms.end()) {
+                    // Tags are user defined, so bound how many distinct "w" values are kept.
+                    it = _histograms.insert(std::make_pair(
+                            _histograms.size() < kMaxHistograms ? key : "other",
+                            Histogram())).first;
+                }
+                it->second.record(millis);
+            }
+
+            virtual void appendAtLeaf(BSONObjBuilder& b) const {
+                BSONObjBuilder histogramsBuilder(b.subobjStart(_leafName));
+                stdx::lock_guard<stdx::mutex> lk(_mutex);
+                for (std::map<std::string, Histogram>::const_iterator it = _histograms.begin();
+                        it != _histograms.end(); ++it) {
+                    BSONObjBuilder histogramBuilder(histogramsBuilder.subobjStart(it->first));
+                    it->second.append(&histogramBuilder);
+                }
+            }
+
+        private:
+            static const size_t kMaxHistograms = 32;
+            static const int kNumBuckets = 13;
+            static const long long kBucketUpperBoundsMillis[kNumBuckets];
+
+            struct Histogram {
+                Histogram() : count(0), totalMillis(0) {
+                    std::fill(buckets, buckets + kNumBuckets + 1, 0);
+                }
+
+                void record(long long millis) {
+                    int bucket = 0;
+                    while (bucket < kNumBuckets && millis >= kBucketUpperBoundsMillis[bucket]) {
+                        ++bucket;
+                    }
+                    ++buckets[bucket];
+                    ++count;
+                    totalMillis += millis;
+                }
+
+                void append(BSONObjBuilder* b) const {
+                    b->append("count", count);
+                    b->append("totalMillis", totalMillis);
+                    BSONObjBuilder bucketsBuilder(b->subobjStart("buckets"));
+                    for (int i = 0; i < kNumBuckets; ++i) {
+                        bucketsBuilder.append(std::string(str::stream() << "lt"
+                                                                  << kBucketUpperBoundsMillis[i]),
+                                              buckets[i]);
+                    }
+                    bucketsBuilder.append(
+                            std::string(str::stream() << "gte"
+                                                      << kBucketUpperBoundsMillis[kNumBuckets - 1]),
+                            buckets[kNumBuckets]);
+                }
+
+                long long buckets[kNumBuckets + 1];
+                long long count;
+                long long totalMillis;
+            };
+
+            mutable stdx::mutex _mutex;
+            std::map<std::string, Histogram> _histograms;
+        };
+
+        const long long WtimeHistograms::kBucketUpperBoundsMillis[] =
+            {1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000};
+
+        WtimeHistograms gleWtimeHistograms;
+    } // namespace
+
     void setupSynchronousCommit(OperationContext* txn) {
         const WriteConcernOptions& writeConcern = txn->getWriteConcern();
 
@@ -270,6 +358,7 @@ namespace mongo {
         // Add stats
         result->writtenTo = repl::getGlobalReplicationCoordinator()->getHostsWrittenTo(replOpTime);
         gleWtimeStats.recordMillis(replStatus.duration.count());
+        gleWtimeHistograms.record(writeConcern, replStatus.duration.count());
         result->wTime = replStatus.duration.count();
 
         return replStatus.status;
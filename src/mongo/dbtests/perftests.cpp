@@ -39,6 +39,7 @@
 #include "mongo/platform/basic.h"
 
 #include <boost/filesystem/operations.hpp>
+#include <boost/scoped_ptr.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/thread/thread.hpp>
 #include <boost/thread/condition.hpp>
@@ -54,6 +55,8 @@
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/json.h"
 #include "mongo/db/lasterror.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
+#include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/operation_context_impl.h"
 #include "mongo/db/storage/mmap_v1/btree/key.h"
 #include "mongo/db/storage/mmap_v1/compress.h"
@@ -479,6 +482,41 @@ namespace PerfTests {
         }
     };
 
+    /** evaluates a filter with several predicates on a few shared paths by walking the tree */
+    class MatchTree : public NonDurTest {
+    public:
+        int n;
+        bo query, doc;
+        boost::scoped_ptr<MatchExpression> expr;
+        boost::scoped_ptr<CompiledMatchExpression> compiled;
+        string name() { return "MatchTree"; }
+        MatchTree() {
+            n = 0;
+            query = fromjson("{x: {$gte: 1, $lt: 100}, 'obj.t': {$exists: true},"
+                             " $or: [{'obj.s': 'abc'}, {'obj.s': /^a/}, {q: {$in: [false, null]}}],"
+                             " zz: {$ne: 2}}");
+            doc = BSON( "_id" << OID() << "x" << 3 << "yaaaaaa" << 3.00009 << "zz" << 1 << "q" << false << "obj" << BSON( "t" << 1 << "s" << "abd" ) << "zzzzzzz" << "a string a string" );
+            StatusWithMatchExpression parsed = MatchExpressionParser::parse(query);
+            verify( parsed.isOK() );
+            expr.reset( parsed.getValue() );
+            compiled.reset( new CompiledMatchExpression( expr.get() ) );
+        }
+        void timed() {
+            if( expr->matchesBSON(doc) )
+                n++;
+        }
+    };
+
+    /** the same filter, evaluated by its compiled program */
+    class MatchCompiled : public MatchTree {
+    public:
+        string name() { return "MatchCompiled"; }
+        void timed() {
+            if( compiled->matchesBSON(doc) )
+                n++;
+        }
+    };
+
     class KeyTest : public B {
     public:
         KeyV1Owned a,b,c;
@@ -1463,6 +1501,8 @@ namespace PerfTests {
                 add< BSONIter >();
                 add< BSONGetFields1 >();
                 add< BSONGetFields2 >();
+                add< MatchTree >();
+                add< MatchCompiled >();
                 //add< TaskQueueTest >();
                 add< InsertDup >();
                 add< Insert1 >();
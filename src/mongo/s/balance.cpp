@@ -319,7 +319,60 @@ namespace mongo {
         }        
     }
 
-    void Balancer::_doBalanceRound(vector<shared_ptr<MigrateInfo>>* candidateChunks) {
+    /**
+     * Asks each shard which owns chunks of 'ns' for the sampled load of those chunks. Chunks of
+     * shards which can't be asked are taken to be idle.
+     */
+    static void getChunkLoad(const NamespaceString& ns,
+                             const ShardToChunksMap& shardToChunksMap,
+                             ChunkLoadMap* chunkLoad) {
+
+        for (ShardToChunksMap::const_iterator i = shardToChunksMap.begin();
+             i != shardToChunksMap.end();
+             ++i) {
+
+            if (i->second.empty()) {
+                continue;
+            }
+
+            const auto shard = grid.shardRegistry()->findIfExists(i->first);
+            if (!shard) {
+                continue;
+            }
+
+            BSONObj result;
+            try {
+                if (!shard->runCommand("admin", BSON("_getChunkLoad" << ns.ns()), result)) {
+                    warning() << "could not get the load of the chunks of " << ns
+                              << " from " << i->first << causedBy(result.toString());
+                    continue;
+                }
+            }
+            catch (const DBException& ex) {
+                warning() << "could not get the load of the chunks of " << ns
+                          << " from " << i->first << causedBy(ex);
+                continue;
+            }
+
+            BSONObjIterator it(result["chunks"].Obj());
+            while (it.more()) {
+                BSONObj chunkObj = it.next().Obj();
+
+                ChunkLoad load;
+                load.max = chunkObj["max"].Obj().getOwned();
+                load.readsPerSec = chunkObj["readsPerSec"].numberDouble();
+                load.writesPerSec = chunkObj["writesPerSec"].numberDouble();
+                if (chunkObj.hasField("splitPoint")) {
+                    load.splitPoint = chunkObj["splitPoint"].Obj().getOwned();
+                }
+
+                (*chunkLoad)[chunkObj["min"].Obj().getOwned()] = load;
+            }
+        }
+    }
+
+    void Balancer::_doBalanceRound(bool balanceByLoad,
+                                   vector<shared_ptr<MigrateInfo>>* candidateChunks) {
         invariant(candidateChunks);
 
         vector<CollectionType> collections;
@@ -465,9 +518,42 @@ namespace mongo {
                 continue;
             }
 
+            if (balanceByLoad) {
+                ChunkLoadMap chunkLoad;
+                getChunkLoad(ns, shardToChunksMap, &chunkLoad);
+                status.setChunkLoad(chunkLoad);
+            }
+
             shared_ptr<MigrateInfo> migrateInfo(_policy->balance(ns, status, _balancedLastTime));
             if (migrateInfo) {
                 candidateChunks->push_back(migrateInfo);
+                continue;
+            }
+
+            // A chunk which is too hot to be moved as a whole is split at the median of its load,
+            // so that the halves can be moved in later rounds.
+            scoped_ptr<SplitInfo> splitInfo(_policy->findHotChunkToSplit(ns, status));
+            if (!splitInfo) {
+                continue;
+            }
+
+            ChunkPtr c = cm->findIntersectingChunk(splitInfo->chunk.min);
+            if (c->getMin().woCompare(splitInfo->chunk.min) ||
+                    c->getMax().woCompare(splitInfo->chunk.max)) {
+
+                log() << "chunk mismatch, not splitting " << splitInfo->chunk.toString();
+                continue;
+            }
+
+            vector<BSONObj> splitPoints;
+            splitPoints.push_back(splitInfo->splitPoint);
+
+            Status splitStatus = c->multiSplit(splitPoints, NULL);
+            if (!splitStatus.isOK()) {
+                error() << "split failed: " << splitStatus;
+            }
+            else {
+                LOG(1) << "split worked";
             }
         }
     }
@@ -587,14 +673,18 @@ namespace mongo {
                         writeConcern = std::move(balancerConfig.getWriteConcern());
                     }
 
+                    const bool balanceByLoad = balancerConfig.isBalancerModeSet() &&
+                        balancerConfig.getBalancerMode() == SettingsType::BalancerModeLoad;
+
                     LOG(1) << "*** start balancing round. "
                            << "waitForDelete: " << waitForDelete
+                           << ", balanceByLoad: " << balanceByLoad
                            << ", secondaryThrottle: "
                            << (writeConcern.get() ? writeConcern->toBSON().toString() : "default")
                           ;
 
                     vector<shared_ptr<MigrateInfo>> candidateChunks;
-                    _doBalanceRound(&candidateChunks);
+                    _doBalanceRound(balanceByLoad, &candidateChunks);
 
                     if ( candidateChunks.size() == 0 ) {
                         LOG(1) << "no need to move any chunk";
@@ -88,10 +88,11 @@ namespace mongo {
          * Gathers all the necessary information about shards and chunks, and decides whether there are candidate chunks to
          * be moved.
          *
-         * @param conn is the connection with the config server(s)
+         * @param balanceByLoad even out the sampled operation load of chunks instead of their number
          * @param candidateChunks (IN/OUT) filled with candidate chunks, one per collection, that could possibly be moved
          */
-        void _doBalanceRound(std::vector<boost::shared_ptr<MigrateInfo>>* candidateChunks);
+        void _doBalanceRound(bool balanceByLoad,
+                             std::vector<boost::shared_ptr<MigrateInfo>>* candidateChunks);
 
         /**
          * Issues chunk migration request, one at a time.
@@ -34,6 +34,7 @@
 #include "mongo/s/balancer_policy.h"
 
 #include <algorithm>
+#include <cmath>
 
 #include "mongo/s/catalog/catalog_manager.h"
 #include "mongo/s/catalog/type_shard.h"
@@ -52,6 +53,59 @@ namespace mongo {
     using std::string;
     using std::vector;
 
+namespace {
+
+    // Load is only moved between shards when the gap between the most and least loaded ones is
+    // at least this many operations per second and this fraction of the load of the most loaded
+    // one, so that sampling noise and small differences don't cause migrations.
+    const double kMinLoadImbalance = 10.0;
+    const double kLoadImbalanceFraction = 0.2;
+
+    /**
+     * Returns the tags of the distribution, including the "" tag, in random order. This is so that
+     * one bad tag doesn't prevent others from getting balanced.
+     */
+    vector<string> getTagsInRandomOrder(const DistributionStatus& distribution) {
+        vector<string> tags(distribution.tags().begin(), distribution.tags().end());
+        tags.push_back("");
+
+        std::random_shuffle(tags.begin(), tags.end());
+        return tags;
+    }
+
+    /**
+     * Finds the most loaded shard with chunks with the given tag and the least loaded shard which
+     * could receive them. Returns false if there are no such shards or if their load is too close
+     * for moving chunks between them to be worth it.
+     */
+    bool findLoadImbalance(const DistributionStatus& distribution,
+                           const string& tag,
+                           ShardId* from,
+                           ShardId* to,
+                           double* imbalance) {
+        *from = distribution.getMostLoadedShard(tag);
+        if (from->empty()) {
+            return false;
+        }
+
+        *to = distribution.getLeastLoadedReceiverShard(tag);
+        if (to->empty() || *to == *from) {
+            return false;
+        }
+
+        const double fromLoad = distribution.loadOfShard(*from);
+        const double toLoad = distribution.loadOfShard(*to);
+        *imbalance = fromLoad - toLoad;
+
+        LOG(1) << "donor      : " << *from << " load " << fromLoad;
+        LOG(1) << "receiver   : " << *to << " load " << toLoad;
+
+        return *imbalance >= kMinLoadImbalance &&
+               *imbalance >= fromLoad * kLoadImbalanceFraction;
+    }
+
+}  // namespace
+
     string TagRange::toString() const {
         return str::stream() << min << " -->> " << max << "  on  " << tag;
     }
@@ -59,7 +113,8 @@ namespace mongo {
     DistributionStatus::DistributionStatus(const ShardInfoMap& shardInfo,
                                            const ShardToChunksMap& shardToChunksMap)
             : _shardInfo(shardInfo),
-              _shardChunks(shardToChunksMap) {
+              _shardChunks(shardToChunksMap),
+              _balanceByLoad(false) {
 
         for (ShardInfoMap::const_iterator i = _shardInfo.begin(); i != _shardInfo.end(); ++i) {
             _shardIds.insert(i->first);
@@ -162,6 +217,87 @@ namespace mongo {
         return worst;
     }
 
+    string DistributionStatus::getMostLoadedShard(const string& tag) const {
+        string worst;
+        double maxLoad = 0;
+
+        for (ShardInfoMap::const_iterator i = _shardInfo.begin(); i != _shardInfo.end(); ++i) {
+            if (numberOfChunksInShardWithTag(i->first, tag) == 0)
+                continue;
+
+            const double myLoad = loadOfShard(i->first);
+            if (myLoad <= maxLoad)
+                continue;
+
+            worst = i->first;
+            maxLoad = myLoad;
+        }
+
+        return worst;
+    }
+
+    string DistributionStatus::getLeastLoadedReceiverShard(const string& tag) const {
+        string best;
+        double minLoad = numeric_limits<double>::max();
+
+        for (ShardInfoMap::const_iterator i = _shardInfo.begin(); i != _shardInfo.end(); ++i) {
+            if (i->second.isSizeMaxed()) {
+                LOG(1) << i->first << " has already reached the maximum total chunk size.";
+                continue;
+            }
+
+            if (i->second.isDraining()) {
+                LOG(1) << i->first << " is currently draining.";
+                continue;
+            }
+
+            if (!i->second.hasTag(tag)) {
+                LOG(1) << i->first << " doesn't have right tag";
+                continue;
+            }
+
+            const double myLoad = loadOfShard(i->first);
+            if (myLoad >= minLoad) {
+                LOG(1) << i->first << " has more load me:" << myLoad
+                       << " best: " << best << ":" << minLoad;
+                continue;
+            }
+
+            best = i->first;
+            minLoad = myLoad;
+        }
+
+        return best;
+    }
+
+    void DistributionStatus::setChunkLoad(const ChunkLoadMap& chunkLoad) {
+        _balanceByLoad = true;
+        _chunkLoad = chunkLoad;
+    }
+
+    ChunkLoad DistributionStatus::getChunkLoad(const ChunkType& chunk) const {
+        ChunkLoadMap::const_iterator i = _chunkLoad.find(chunk.getMin());
+        if (i == _chunkLoad.end() || i->second.max.woCompare(chunk.getMax()) != 0) {
+            return ChunkLoad();
+        }
+
+        return i->second;
+    }
+
+    double DistributionStatus::loadOfShard(const ShardId& shardId) const {
+        ShardToChunksMap::const_iterator i = _shardChunks.find(shardId);
+        if (i == _shardChunks.end()) {
+            return 0;
+        }
+
+        double total = 0;
+        for (const ChunkType& chunk : i->second) {
+            total += getChunkLoad(chunk).total();
+        }
+
+        return total;
+    }
+
     const vector<ChunkType>& DistributionStatus::getChunks(const ShardId& shardId) const {
         ShardToChunksMap::const_iterator i = _shardChunks.find(shardId);
         invariant(i != _shardChunks.end());
@@ -413,7 +549,54 @@ namespace mongo {
             }
         }
 
-        // 3) for each tag balance
+        vector<string> tags = getTagsInRandomOrder(distribution);
+
+        // 3) when balancing by load, even out the load for each tag
+
+        if (distribution.balanceByLoad()) {
+            for (const string& tag : tags) {
+                ShardId from;
+                ShardId to;
+                double imbalance;
+                if (!findLoadImbalance(distribution, tag, &from, &to, &imbalance))
+                    continue;
+
+                // Moving a chunk with load L changes the gap to |imbalance - 2L|, so only chunks
+                // with less load than the gap narrow it, and those closest to half of it the most.
+                const vector<ChunkType>& chunks = distribution.getChunks(from);
+                const ChunkType* best = NULL;
+                double bestDistance = numeric_limits<double>::max();
+
+                for (const ChunkType& chunk : chunks) {
+                    if (chunk.getJumbo() || distribution.getTagForChunk(chunk) != tag)
+                        continue;
+
+                    const double load = distribution.getChunkLoad(chunk).total();
+                    if (load <= 0 || load >= imbalance)
+                        continue;
+
+                    const double distance = std::abs(load - imbalance / 2);
+                    if (distance < bestDistance) {
+                        best = &chunk;
+                        bestDistance = distance;
+                    }
+                }
+
+                if (!best) {
+                    LOG(1) << "no chunk on " << from << " can narrow a load gap of " << imbalance
+                           << " for tag [" << tag << "]";
+                    continue;
+                }
+
+                log() << " ns: " << ns << " going to move " << *best
+                      << " with load " << distribution.getChunkLoad(*best).total()
+                      << " from: " << from << " to: " << to << " tag [" << tag << "]";
+                return new MigrateInfo(ns, to, from, best->toBSON());
+            }
+        }
+
+        // 4) for each tag balance the number of chunks. When balancing by load, only idle chunks
+        //    are moved for this, so as not to undo the above.
 
         int threshold = 8;
         if ( balancedLastTime || distribution.totalChunks() < 20 )
@@ -421,18 +604,6 @@ namespace mongo {
         else if ( distribution.totalChunks() < 80 )
             threshold = 4;
 
-        // randomize the order in which we balance the tags
-        // this is so that one bad tag doesn't prevent others from getting balanced
-        vector<string> tags;
-        {
-            set<string> t = distribution.tags();
-            for ( set<string>::const_iterator i = t.begin(); i != t.end(); ++i )
-                tags.push_back( *i );
-            tags.push_back( "" );
-
-            std::random_shuffle( tags.begin(), tags.end() );
-        }
-
         for ( unsigned i=0; i<tags.size(); i++ ) {
             string tag = tags[i];
 
@@ -464,6 +635,7 @@ namespace mongo {
 
             const vector<ChunkType>& chunks = distribution.getChunks(from);
             unsigned numJumboChunks = 0;
+            unsigned numLoadedChunks = 0;
             for ( unsigned j = 0; j < chunks.size(); j++ ) {
                 const ChunkType& chunk = chunks[j];
                 if (distribution.getTagForChunk(chunk) != tag)
@@ -474,6 +646,12 @@ namespace mongo {
                     continue;
                 }
 
+                if (distribution.balanceByLoad() &&
+                        distribution.getChunkLoad(chunk).total() > 0) {
+                    numLoadedChunks++;
+                    continue;
+                }
+
                 log() << " ns: " << ns << " going to move " << chunk
                       << " from: " << from << " to: " << to << " tag [" << tag << "]"
                      ;
@@ -488,6 +666,13 @@ namespace mongo {
                 continue;
             }
 
+            if ( numLoadedChunks ) {
+                LOG(1) << "shard: " << from << " ns: " << ns
+                       << " has too many chunks, but they all have load"
+                       << " numLoadedChunks: " << numLoadedChunks;
+                continue;
+            }
+
             verify( false ); // should be impossible
         }
 
@@ -495,6 +680,52 @@ namespace mongo {
         return NULL;
     }
 
+    SplitInfo* BalancerPolicy::findHotChunkToSplit(const string& ns,
+                                                   const DistributionStatus& distribution) {
+        if (!distribution.balanceByLoad()) {
+            return NULL;
+        }
+
+        for (const string& tag : getTagsInRandomOrder(distribution)) {
+            ShardId from;
+            ShardId to;
+            double imbalance;
+            if (!findLoadImbalance(distribution, tag, &from, &to, &imbalance))
+                continue;
+
+            const vector<ChunkType>& chunks = distribution.getChunks(from);
+            const ChunkType* hottest = NULL;
+            ChunkLoad hottestLoad;
+
+            for (const ChunkType& chunk : chunks) {
+                if (chunk.getJumbo() || distribution.getTagForChunk(chunk) != tag)
+                    continue;
+
+                const ChunkLoad load = distribution.getChunkLoad(chunk);
+                if (load.total() > hottestLoad.total()) {
+                    hottest = &chunk;
+                    hottestLoad = load;
+                }
+            }
+
+            // If the hottest chunk is below the gap, moving chunks can narrow it.
+            if (!hottest || hottestLoad.total() < imbalance)
+                continue;
+
+            if (hottestLoad.splitPoint.isEmpty()) {
+                log() << "chunk " << *hottest << " has too much load to balance " << ns
+                      << " by moving it, but no key to split it at";
+                continue;
+            }
+
+            log() << " ns: " << ns << " going to split " << *hottest
+                  << " with load " << hottestLoad.total() << " at " << hottestLoad.splitPoint;
+            return new SplitInfo(ns, from, hottest->toBSON(), hottestLoad.splitPoint);
+        }
+
+        return NULL;
+    }
+
 
     ShardInfo::ShardInfo(long long maxSizeMB,
                          long long currSizeMB,
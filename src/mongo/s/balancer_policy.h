@@ -111,6 +111,28 @@ namespace mongo {
     };
     
 
+    /**
+     * Recent operation rates of a chunk, as sampled by the shard which owns it.
+     */
+    struct ChunkLoad {
+        ChunkLoad() : readsPerSec(0), writesPerSec(0) { }
+
+        double total() const { return readsPerSec + writesPerSec; }
+
+        // Upper bound of the chunk the rates were sampled for.
+        BSONObj max;
+
+        double readsPerSec;
+        double writesPerSec;
+
+        // Key which splits the load of the chunk in about half. Empty if there is none.
+        BSONObj splitPoint;
+    };
+
+    // Chunk min -> load
+    typedef std::map<BSONObj, ChunkLoad> ChunkLoadMap;
+
+
     struct MigrateInfo {
         MigrateInfo(const std::string& a_ns,
                     const ShardId& a_to,
@@ -129,6 +151,28 @@ namespace mongo {
         const ChunkInfo chunk;
     };
 
+    /**
+     * A chunk which should be split before it can be balanced, because it carries more of its
+     * shard's load than can be moved away in one piece.
+     */
+    struct SplitInfo {
+        SplitInfo(const std::string& a_ns,
+                  const ShardId& a_shard,
+                  const BSONObj& a_chunk,
+                  const BSONObj& a_splitPoint)
+            : ns(a_ns),
+              shard(a_shard),
+              chunk(a_chunk),
+              splitPoint(a_splitPoint.getOwned()) {
+
+        }
+
+        const std::string ns;
+        const ShardId shard;
+        const ChunkInfo chunk;
+        const BSONObj splitPoint;
+    };
+
     typedef std::map<ShardId, ShardInfo> ShardInfoMap;
     typedef std::map<ShardId, std::vector<ChunkType>> ShardToChunksMap;
 
@@ -146,6 +190,12 @@ namespace mongo {
          */
         bool addTagRange( const TagRange& range );
 
+        /**
+         * Switches to balancing by operation load, using the sampled rates in 'chunkLoad'.
+         * Chunks missing from it are taken to be idle.
+         */
+        void setChunkLoad(const ChunkLoadMap& chunkLoad);
+
         // ---- these methods might be better suiting in BalancerPolicy
         
         /**
@@ -160,6 +210,17 @@ namespace mongo {
          */
         std::string getMostOverloadedShard( const std::string& forTag ) const;
 
+        /**
+         * @return the shard with the highest load which has chunks with the given tag
+         */
+        std::string getMostLoadedShard(const std::string& forTag) const;
+
+        /**
+         * Like getBestReceieverShard, but picks the shard with the lowest load rather than the
+         * one with the fewest chunks.
+         */
+        std::string getLeastLoadedReceiverShard(const std::string& forTag) const;
+
 
         // ---- basic accessors, counters, etc...
 
@@ -178,6 +239,15 @@ namespace mongo {
         /** @return all tags we know about, not include "" */
         const std::set<std::string>& tags() const { return _allTags; }
 
+        /** @return true if chunks should be balanced by load, see setChunkLoad */
+        bool balanceByLoad() const { return _balanceByLoad; }
+
+        /** @return the sampled load of the chunk, all zero if none was reported */
+        ChunkLoad getChunkLoad(const ChunkType& chunk) const;
+
+        /** @return summed load of the chunks in this shard */
+        double loadOfShard(const ShardId& shardId) const;
+
         /** @return the right tag for chunk, possibly "" */
         std::string getTagForChunk(const ChunkType& chunk) const;
         
@@ -209,6 +279,8 @@ namespace mongo {
         std::map<BSONObj,TagRange> _tagRanges;
         std::set<std::string> _allTags;
         std::set<ShardId> _shardIds;
+        bool _balanceByLoad;
+        ChunkLoadMap _chunkLoad;
     };
 
 
@@ -220,6 +292,9 @@ namespace mongo {
          * space usage and number of chunks for that collection. If the policy doesn't recommend
          * moving, it returns NULL.
          *
+         * When the distribution balances by load, chunks are first moved to even out the load
+         * between shards, and only idle chunks are then moved to even out chunk counts.
+         *
          * @param ns is the collections namepace.
          * @param DistributionStatus holds all the info about the current state of the cluster/namespace
          * @param balancedLastTime is the number of chunks effectively moved in the last round.
@@ -229,6 +304,15 @@ namespace mongo {
         static MigrateInfo* balance( const std::string& ns,
                                      const DistributionStatus& distribution,
                                      int balancedLastTime );
+
+        /**
+         * When balancing by load, returns the chunk which keeps the load of a collection from
+         * being evened out because it is hotter than the gap between the most and least loaded
+         * shards, along with the key to split it at. Returns NULL if there is no such chunk or
+         * it can't be split. Caller owns the SplitInfo instance.
+         */
+        static SplitInfo* findHotChunkToSplit(const std::string& ns,
+                                              const DistributionStatus& distribution);
     };
 
 }  // namespace mongo
@@ -40,6 +40,7 @@ namespace {
     using namespace mongo;
 
     using std::map;
+    using std::numeric_limits;
     using std::string;
     using std::stringstream;
     using std::vector;
@@ -627,4 +628,252 @@ namespace {
         }
     }
 
+    void setLoad(ChunkLoadMap* chunkLoad, const ChunkType& chunk, double load) {
+        ChunkLoad& entry = (*chunkLoad)[chunk.getMin()];
+        entry.max = chunk.getMax();
+        entry.writesPerSec = load;
+    }
+
+    TEST(BalancerPolicyTests, LoadMovesChunkClosestToHalfTheGap) {
+        ShardToChunksMap chunks;
+        addShard(chunks, 4, false);
+        addShard(chunks, 4, true);
+
+        ChunkLoadMap chunkLoad;
+        setLoad(&chunkLoad, chunks["shard0"][0], 100);
+        setLoad(&chunkLoad, chunks["shard0"][1], 45);
+        setLoad(&chunkLoad, chunks["shard0"][2], 10);
+        setLoad(&chunkLoad, chunks["shard1"][0], 5);
+
+        ShardInfoMap shards;
+        shards["shard0"] = ShardInfo(0, 4, false);
+        shards["shard1"] = ShardInfo(0, 4, false);
+
+        DistributionStatus d(shards, chunks);
+        d.setChunkLoad(chunkLoad);
+        ASSERT_EQUALS(155.0, d.loadOfShard("shard0"));
+
+        // The gap is 150. Moving the 100 chunk narrows it to 50 and moving the 45 chunk to 60,
+        // so the chunk closest to half the gap wins.
+        std::unique_ptr<MigrateInfo> m(BalancerPolicy::balance("ns", d, 0));
+        ASSERT(m);
+        ASSERT_EQUALS("shard0", m->from);
+        ASSERT_EQUALS("shard1", m->to);
+        ASSERT_EQUALS(chunks["shard0"][0].getMin(), m->chunk.min);
+    }
+
+    TEST(BalancerPolicyTests, LoadBalancedNoMove) {
+        ShardToChunksMap chunks;
+        addShard(chunks, 4, false);
+        addShard(chunks, 4, true);
+
+        ChunkLoadMap chunkLoad;
+        setLoad(&chunkLoad, chunks["shard0"][0], 100);
+        setLoad(&chunkLoad, chunks["shard1"][2], 90);
+
+        ShardInfoMap shards;
+        shards["shard0"] = ShardInfo(0, 4, false);
+        shards["shard1"] = ShardInfo(0, 4, false);
+
+        DistributionStatus d(shards, chunks);
+        d.setChunkLoad(chunkLoad);
+
+        std::unique_ptr<MigrateInfo> m(BalancerPolicy::balance("ns", d, 0));
+        ASSERT(!m);
+
+        std::unique_ptr<SplitInfo> split(BalancerPolicy::findHotChunkToSplit("ns", d));
+        ASSERT(!split);
+    }
+
+    TEST(BalancerPolicyTests, LoadIgnoresNoise) {
+        ShardToChunksMap chunks;
+        addShard(chunks, 4, false);
+        addShard(chunks, 4, true);
+
+        // Far apart relative to each other, but too little load to be worth moving.
+        ChunkLoadMap chunkLoad;
+        setLoad(&chunkLoad, chunks["shard0"][0], 5);
+
+        ShardInfoMap shards;
+        shards["shard0"] = ShardInfo(0, 4, false);
+        shards["shard1"] = ShardInfo(0, 4, false);
+
+        DistributionStatus d(shards, chunks);
+        d.setChunkLoad(chunkLoad);
+
+        std::unique_ptr<MigrateInfo> m(BalancerPolicy::balance("ns", d, 0));
+        ASSERT(!m);
+    }
+
+    TEST(BalancerPolicyTests, LoadSplitsChunkTooHotToMove) {
+        ShardToChunksMap chunks;
+        addShard(chunks, 2, false);
+        addShard(chunks, 2, true);
+
+        // All of the load is on one chunk, so moving it would just move the hot spot.
+        ChunkLoadMap chunkLoad;
+        setLoad(&chunkLoad, chunks["shard0"][1], 100);
+        chunkLoad[chunks["shard0"][1].getMin()].splitPoint = BSON("x" << 1.5);
+
+        ShardInfoMap shards;
+        shards["shard0"] = ShardInfo(0, 2, false);
+        shards["shard1"] = ShardInfo(0, 2, false);
+
+        DistributionStatus d(shards, chunks);
+        d.setChunkLoad(chunkLoad);
+
+        std::unique_ptr<MigrateInfo> m(BalancerPolicy::balance("ns", d, 0));
+        ASSERT(!m);
+
+        std::unique_ptr<SplitInfo> split(BalancerPolicy::findHotChunkToSplit("ns", d));
+        ASSERT(split);
+        ASSERT_EQUALS("shard0", split->shard);
+        ASSERT_EQUALS(chunks["shard0"][1].getMin(), split->chunk.min);
+        ASSERT_EQUALS(BSON("x" << 1.5), split->splitPoint);
+
+        // Without a split point nothing can be done.
+        chunkLoad[chunks["shard0"][1].getMin()].splitPoint = BSONObj();
+        DistributionStatus noSplitPoint(shards, chunks);
+        noSplitPoint.setChunkLoad(chunkLoad);
+
+        split.reset(BalancerPolicy::findHotChunkToSplit("ns", noSplitPoint));
+        ASSERT(!split);
+    }
+
+    TEST(BalancerPolicyTests, LoadNoSplitsWhenBalancingByCount) {
+        ShardToChunksMap chunks;
+        addShard(chunks, 2, false);
+        addShard(chunks, 2, true);
+
+        ShardInfoMap shards;
+        shards["shard0"] = ShardInfo(0, 2, false);
+        shards["shard1"] = ShardInfo(0, 2, false);
+
+        DistributionStatus d(shards, chunks);
+        ASSERT_FALSE(d.balanceByLoad());
+
+        std::unique_ptr<SplitInfo> split(BalancerPolicy::findHotChunkToSplit("ns", d));
+        ASSERT(!split);
+    }
+
+    TEST(BalancerPolicyTests, LoadOnlyMovesIdleChunksForCounts) {
+        ShardToChunksMap chunks;
+        addShard(chunks, 10, false);
+        addShard(chunks, 1, true);
+
+        // The load is even, but the chunk counts are not.
+        ChunkLoadMap chunkLoad;
+        for (size_t i = 0; i < 9; i++) {
+            setLoad(&chunkLoad, chunks["shard0"][i], 10);
+        }
+        setLoad(&chunkLoad, chunks["shard1"][0], 90);
+
+        ShardInfoMap shards;
+        shards["shard0"] = ShardInfo(0, 10, false);
+        shards["shard1"] = ShardInfo(0, 1, false);
+
+        DistributionStatus d(shards, chunks);
+        d.setChunkLoad(chunkLoad);
+
+        std::unique_ptr<MigrateInfo> m(BalancerPolicy::balance("ns", d, 0));
+        ASSERT(m);
+        ASSERT_EQUALS("shard0", m->from);
+        ASSERT_EQUALS("shard1", m->to);
+        ASSERT_EQUALS(chunks["shard0"][9].getMin(), m->chunk.min);
+
+        // Once there are no idle chunks left, nothing is moved.
+        setLoad(&chunkLoad, chunks["shard0"][9], 1);
+        setLoad(&chunkLoad, chunks["shard1"][0], 91);
+        DistributionStatus allLoaded(shards, chunks);
+        allLoaded.setChunkLoad(chunkLoad);
+
+        m.reset(BalancerPolicy::balance("ns", allLoaded, 0));
+        ASSERT(!m);
+    }
+
+    TEST(BalancerPolicyTests, LoadRespectsDraining) {
+        ShardToChunksMap chunks;
+        addShard(chunks, 2, false);
+        addShard(chunks, 0, false);
+        addShard(chunks, 2, true);
+
+        // shard1 has the least load, but is draining.
+        ChunkLoadMap chunkLoad;
+        setLoad(&chunkLoad, chunks["shard0"][0], 100);
+        setLoad(&chunkLoad, chunks["shard0"][1], 50);
+        setLoad(&chunkLoad, chunks["shard2"][0], 40);
+
+        ShardInfoMap shards;
+        shards["shard0"] = ShardInfo(0, 2, false);
+        shards["shard1"] = ShardInfo(0, 0, true);
+        shards["shard2"] = ShardInfo(0, 2, false);
+
+        DistributionStatus d(shards, chunks);
+        d.setChunkLoad(chunkLoad);
+
+        std::unique_ptr<MigrateInfo> m(BalancerPolicy::balance("ns", d, 0));
+        ASSERT(m);
+        ASSERT_EQUALS("shard0", m->from);
+        ASSERT_EQUALS("shard2", m->to);
+        ASSERT_EQUALS(chunks["shard0"][1].getMin(), m->chunk.min);
+    }
+
+    /**
+     * Starts with all the chunks of a collection, each with some load, on one shard, and checks
+     * that moving chunks as suggested spreads the load over all shards.
+     */
+    TEST(BalancerPolicyTests, LoadSimulation) {
+        PseudoRandom rng(1337);
+
+        const int numShards = 4;
+        const int numChunks = 40;
+
+        ShardToChunksMap chunks;
+        addShard(chunks, numChunks, false);
+        for (int i = 1; i < numShards; i++) {
+            addShard(chunks, 0, i == numShards - 1);
+        }
+
+        ChunkLoadMap chunkLoad;
+        for (const ChunkType& chunk : chunks["shard0"]) {
+            setLoad(&chunkLoad, chunk, 1 + rng.nextInt32(20));
+        }
+
+        ShardInfoMap shards;
+        for (int i = 0; i < numShards; i++) {
+            shards[str::stream() << "shard" << i] = ShardInfo(0, 0, false);
+        }
+
+        int moves = 0;
+        for (; moves < numChunks * numShards; moves++) {
+            DistributionStatus d(shards, chunks);
+            d.setChunkLoad(chunkLoad);
+
+            std::unique_ptr<MigrateInfo> m(BalancerPolicy::balance("ns", d, moves != 0));
+            if (!m) {
+                break;
+            }
+
+            moveChunk(chunks, m.get());
+        }
+
+        ASSERT_LESS_THAN(moves, numChunks * numShards);
+
+        DistributionStatus d(shards, chunks);
+        d.setChunkLoad(chunkLoad);
+
+        double minLoad = numeric_limits<double>::max();
+        double maxLoad = 0;
+        for (int i = 0; i < numShards; i++) {
+            const double load = d.loadOfShard(str::stream() << "shard" << i);
+            log() << "shard" << i << " load: " << load;
+            minLoad = std::min(minLoad, load);
+            maxLoad = std::max(maxLoad, load);
+        }
+
+        // No chunk has more than 20 load, so the gap can only be left open if it is below that or
+        // the balancing thresholds.
+        ASSERT_LESS_THAN_OR_EQUALS(maxLoad - minLoad, std::max(20.0, 0.2 * maxLoad));
+    }
+
 } // namespace
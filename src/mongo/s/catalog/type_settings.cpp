@@ -50,6 +50,9 @@ namespace mongo {
     const std::string SettingsType::BalancerDocKey("balancer");
     const std::string SettingsType::ChunkSizeDocKey("chunksize");
 
+    const std::string SettingsType::BalancerModeChunks("chunks");
+    const std::string SettingsType::BalancerModeLoad("load");
+
     const BSONField<std::string> SettingsType::key("_id");
     const BSONField<long long> SettingsType::chunkSize("value");
     const BSONField<bool> SettingsType::balancerStopped("stopped");
@@ -57,6 +60,7 @@ namespace mongo {
     const BSONField<bool> SettingsType::deprecated_secondaryThrottle("_secondaryThrottle");
     const BSONField<BSONObj> SettingsType::migrationWriteConcern("_secondaryThrottle");
     const BSONField<bool> SettingsType::waitForDelete("_waitForDelete");
+    const BSONField<std::string> SettingsType::balancerMode("mode");
 
     StatusWith<SettingsType> SettingsType::fromBSON(const BSONObj& source) {
         SettingsType settings;
@@ -138,6 +142,17 @@ namespace mongo {
                     settings._waitForDelete = settingsWaitForDelete;
                 }
             }
+
+            {
+                std::string settingsBalancerMode;
+                Status status = bsonExtractStringField(source,
+                                                       balancerMode.name(),
+                                                       &settingsBalancerMode);
+                if (status != ErrorCodes::NoSuchKey) {
+                    if (!status.isOK()) return status;
+                    settings._balancerMode = settingsBalancerMode;
+                }
+            }
         }
 
         return settings;
@@ -163,6 +178,15 @@ namespace mongo {
                               str::stream() << "cannot have both secondary throttle and "
                                             << "migration write concern set at the same time");
             }
+
+            if (_balancerMode.is_initialized() &&
+                _balancerMode != BalancerModeChunks &&
+                _balancerMode != BalancerModeLoad) {
+                return Status(ErrorCodes::BadValue,
+                              str::stream() << balancerMode.name() << " must be either \""
+                                            << BalancerModeChunks << "\" or \""
+                                            << BalancerModeLoad << "\"");
+            }
         }
         else {
             return Status(ErrorCodes::UnsupportedFormat,
@@ -185,6 +209,7 @@ namespace mongo {
             builder.append(migrationWriteConcern(), getMigrationWriteConcern().toBSON());
         }
         if (_waitForDelete) builder.append(waitForDelete(), getWaitForDelete());
+        if (_balancerMode) builder.append(balancerMode(), getBalancerMode());
 
         return builder.obj();
     }
@@ -303,4 +328,10 @@ namespace mongo {
         _waitForDelete = waitForDelete;
     }
 
+    void SettingsType::setBalancerMode(const std::string& balancerMode) {
+        invariant(_key == BalancerDocKey);
+        invariant(balancerMode == BalancerModeChunks || balancerMode == BalancerModeLoad);
+        _balancerMode = balancerMode;
+    }
+
 } // namespace mongo
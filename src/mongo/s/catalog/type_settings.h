@@ -75,6 +75,10 @@ namespace mongo {
         static const std::string BalancerDocKey;
         static const std::string ChunkSizeDocKey;
 
+        // Values of the balancer mode field.
+        static const std::string BalancerModeChunks;
+        static const std::string BalancerModeLoad;
+
         // Field names and types in the settings collection type.
         static const BSONField<std::string> key;
         static const BSONField<long long> chunkSize;
@@ -83,6 +87,7 @@ namespace mongo {
         static const BSONField<bool> deprecated_secondaryThrottle;
         static const BSONField<BSONObj> migrationWriteConcern;
         static const BSONField<bool> waitForDelete;
+        static const BSONField<std::string> balancerMode;
 
         /**
          * Returns OK if all mandatory fields have been set and their corresponding
@@ -148,6 +153,10 @@ namespace mongo {
         bool getWaitForDelete() const { return _waitForDelete.get(); }
         void setWaitForDelete(const bool waitForDelete);
 
+        bool isBalancerModeSet() const { return _balancerMode.is_initialized(); }
+        const std::string& getBalancerMode() const { return _balancerMode.get(); }
+        void setBalancerMode(const std::string& balancerMode);
+
     private:
 
         /**
@@ -185,6 +194,10 @@ namespace mongo {
 
         // (O)  synchronous migration cleanup.
         boost::optional<bool> _waitForDelete;
+
+        // (O)  what the balancer evens out between shards: the number of chunks (default), or
+        //      the operation load on them as sampled by the shards.
+        boost::optional<std::string> _balancerMode;
     };
 
 } // namespace mongo
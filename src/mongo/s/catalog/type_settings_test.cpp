@@ -132,6 +132,35 @@ namespace {
         ASSERT(settings.getSecondaryThrottle());
     }
 
+    TEST(SettingsType, BalancerMode) {
+        BSONObj objBalancer = BSON(SettingsType::key(SettingsType::BalancerDocKey) <<
+                                   SettingsType::balancerMode(SettingsType::BalancerModeLoad));
+        StatusWith<SettingsType> result = SettingsType::fromBSON(objBalancer);
+        ASSERT_OK(result.getStatus());
+        SettingsType settings = result.getValue();
+        ASSERT_OK(settings.validate());
+        ASSERT(settings.isBalancerModeSet());
+        ASSERT_EQUALS(settings.getBalancerMode(), SettingsType::BalancerModeLoad);
+        ASSERT_EQUALS(settings.toBSON()[SettingsType::balancerMode.name()].str(),
+                      SettingsType::BalancerModeLoad);
+
+        objBalancer = BSON(SettingsType::key(SettingsType::BalancerDocKey));
+        result = SettingsType::fromBSON(objBalancer);
+        ASSERT_OK(result.getStatus());
+        ASSERT_FALSE(result.getValue().isBalancerModeSet());
+
+        objBalancer = BSON(SettingsType::key(SettingsType::BalancerDocKey) <<
+                           SettingsType::balancerMode("size"));
+        result = SettingsType::fromBSON(objBalancer);
+        ASSERT_OK(result.getStatus());
+        ASSERT_EQUALS(result.getValue().validate(), ErrorCodes::BadValue);
+
+        objBalancer = BSON(SettingsType::key(SettingsType::BalancerDocKey) <<
+                           SettingsType::balancerMode() << 1);
+        result = SettingsType::fromBSON(objBalancer);
+        ASSERT_FALSE(result.isOK());
+    }
+
     TEST(SettingsType, BadType) {
         BSONObj badTypeObj = BSON(SettingsType::key() << 0);
         StatusWith<SettingsType> result = SettingsType::fromBSON(badTypeObj);
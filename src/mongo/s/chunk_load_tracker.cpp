@@ -0,0 +1,257 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/chunk_load_tracker.h"
+
+#include <algorithm>
+
+#include "mongo/db/server_parameters.h"
+#include "mongo/s/catalog/type_chunk.h"
+#include "mongo/s/collection_metadata.h"
+
+namespace mongo {
+
+    using std::string;
+    using std::vector;
+
+    // One in this many operations on a chunk is recorded. 0 turns tracking off.
+    MONGO_EXPORT_SERVER_PARAMETER(internalChunkLoadSampleRate, int, 100);
+
+    const size_t ChunkLoadTracker::kMaxSampledKeys = 32;
+
+    ChunkLoadTracker chunkLoadTracker(Seconds(60));
+
+    ChunkLoadTracker::ChunkLoadTracker(Milliseconds window)
+        : _window(window),
+          _random(static_cast<int64_t>(curTimeMicros64())) {
+
+    }
+
+    int ChunkLoadTracker::sample() {
+        const int sampleRate = internalChunkLoadSampleRate;
+        if (sampleRate <= 0) {
+            return 0;
+        }
+
+        if (_opCounter.fetchAndAdd(1) % static_cast<unsigned>(sampleRate) != 0) {
+            return 0;
+        }
+
+        return sampleRate;
+    }
+
+    void ChunkLoadTracker::record(const string& ns,
+                                  const CollectionMetadata& metadata,
+                                  const BSONObj& shardKey,
+                                  OpType opType,
+                                  int numOps,
+                                  Date_t now) {
+        ChunkType chunk;
+        if (!metadata.getNextChunk(shardKey, &chunk) || chunk.getMin().woCompare(shardKey) > 0) {
+            return;
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+        CollectionLoad& coll = _getCollection_inlock(ns, metadata.getCollVersion().epoch(), now);
+        ChunkCounts& counts = coll.current[chunk.getMin()];
+        counts.max = chunk.getMax();
+
+        if (opType == kRead) {
+            counts.reads += numOps;
+        }
+        else {
+            counts.writes += numOps;
+        }
+
+        // Reservoir sampling keeps every key seen in the window with the same probability.
+        counts.keysSeen++;
+        if (counts.keys.size() < kMaxSampledKeys) {
+            counts.keys.push_back(shardKey.getOwned());
+        }
+        else {
+            const uint64_t slot = static_cast<uint64_t>(_random.nextInt64()) % counts.keysSeen;
+            if (slot < kMaxSampledKeys) {
+                counts.keys[slot] = shardKey.getOwned();
+            }
+        }
+    }
+
+    void ChunkLoadTracker::report(const string& ns,
+                                  const CollectionMetadata& metadata,
+                                  Date_t now,
+                                  BSONArrayBuilder* chunks) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+        if (_collections.find(ns) == _collections.end()) {
+            return;
+        }
+
+        const CollectionLoad& coll = _getCollection_inlock(ns,
+                                                           metadata.getCollVersion().epoch(),
+                                                           now);
+
+        ChunkCountsMap totals = coll.previous;
+        for (ChunkCountsMap::const_iterator it = coll.current.begin();
+             it != coll.current.end();
+             ++it) {
+
+            ChunkCounts& total = totals[it->first];
+            if (total.max.isEmpty()) {
+                total.max = it->second.max;
+            }
+            else if (total.max.woCompare(it->second.max) != 0) {
+                // The chunk was split or merged between the windows, only keep the newer counts.
+                total = ChunkCounts();
+                total.max = it->second.max;
+            }
+
+            total.reads += it->second.reads;
+            total.writes += it->second.writes;
+            total.keys.insert(total.keys.end(), it->second.keys.begin(), it->second.keys.end());
+        }
+
+        const Date_t countsStart = coll.hasPrevious ? coll.windowStart - _window :
+                                                      coll.windowStart;
+
+        for (ChunkCountsMap::iterator it = totals.begin(); it != totals.end(); ++it) {
+            const BSONObj& min = it->first;
+            ChunkCounts& counts = it->second;
+
+            ChunkType chunk;
+            if (!metadata.getNextChunk(min, &chunk) ||
+                    chunk.getMin().woCompare(min) != 0 ||
+                    chunk.getMax().woCompare(counts.max) != 0) {
+                continue;
+            }
+
+            // A chunk which migrated in has only been taking operations here since it arrived,
+            // and measuring it over longer would make its shard look less loaded than it is.
+            Date_t since = countsStart;
+            ChunkArrivalMap::const_iterator arrival = coll.arrivals.find(min);
+            if (arrival != coll.arrivals.end() &&
+                    arrival->second.max.woCompare(counts.max) == 0 &&
+                    arrival->second.time > since) {
+                since = arrival->second.time;
+            }
+            const long long elapsedMillis = durationCount<Milliseconds>(now - since);
+            const double seconds = std::max(elapsedMillis, 1000LL) / 1000.0;
+
+            BSONObjBuilder chunkBuilder(chunks->subobjStart());
+            chunkBuilder.append("min", min);
+            chunkBuilder.append("max", counts.max);
+            chunkBuilder.append("readsPerSec", counts.reads / seconds);
+            chunkBuilder.append("writesPerSec", counts.writes / seconds);
+
+            if (!counts.keys.empty()) {
+                vector<BSONObj>::iterator median = counts.keys.begin() + counts.keys.size() / 2;
+                std::nth_element(counts.keys.begin(), median, counts.keys.end());
+
+                if (median->woCompare(min) > 0 && median->woCompare(counts.max) < 0) {
+                    chunkBuilder.append("splitPoint", *median);
+                }
+            }
+
+            chunkBuilder.done();
+        }
+    }
+
+    void ChunkLoadTracker::noteChunkArrived(const string& ns,
+                                            const OID& epoch,
+                                            const BSONObj& min,
+                                            const BSONObj& max,
+                                            Date_t now) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+        CollectionLoad& coll = _getCollection_inlock(ns, epoch, now);
+
+        // Whatever was counted while the chunk was last here would skew its new rates.
+        coll.current.erase(min);
+        coll.previous.erase(min);
+
+        ChunkArrival& arrival = coll.arrivals[min.getOwned()];
+        arrival.max = max.getOwned();
+        arrival.time = now;
+    }
+
+    void ChunkLoadTracker::reset(const string& ns) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _collections.erase(ns);
+    }
+
+    ChunkLoadTracker::CollectionLoad& ChunkLoadTracker::_getCollection_inlock(
+                                                        const string& ns,
+                                                        const OID& epoch,
+                                                        Date_t now) {
+
+        CollectionLoadMap::iterator it = _collections.find(ns);
+        if (it == _collections.end() || it->second.epoch != epoch) {
+            CollectionLoad& coll = _collections[ns];
+            coll = CollectionLoad();
+            coll.epoch = epoch;
+            coll.windowStart = now;
+            return coll;
+        }
+
+        CollectionLoad& coll = it->second;
+
+        const Milliseconds elapsed = now - coll.windowStart;
+        if (elapsed >= _window * 2) {
+            coll.current.clear();
+            coll.previous.clear();
+            coll.hasPrevious = false;
+            coll.windowStart = now;
+        }
+        else if (elapsed >= _window) {
+            coll.previous.swap(coll.current);
+            coll.current.clear();
+            coll.hasPrevious = true;
+            coll.windowStart += _window;
+        }
+        else {
+            return coll;
+        }
+
+        // Arrivals before the oldest counts no longer shorten the time they cover.
+        const Date_t countsStart = coll.hasPrevious ? coll.windowStart - _window :
+                                                      coll.windowStart;
+        for (ChunkArrivalMap::iterator it = coll.arrivals.begin(); it != coll.arrivals.end();) {
+            if (it->second.time <= countsStart) {
+                coll.arrivals.erase(it++);
+            }
+            else {
+                ++it;
+            }
+        }
+
+        return coll;
+    }
+
+}  // namespace mongo
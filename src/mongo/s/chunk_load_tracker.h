@@ -0,0 +1,186 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/oid.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/random.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+    class CollectionMetadata;
+
+    /**
+     * Keeps sampled counts of the reads and writes which hit each chunk of the sharded
+     * collections on this shard, so that the balancer can even out operation load and not just
+     * chunk counts.
+     *
+     * Only one operation in every internalChunkLoadSampleRate is recorded, and it counts for that
+     * many operations. Counts are kept for the current window and the one before it, so reported
+     * rates cover between one and two windows of history. They are keyed on the bounds of the
+     * chunk the operation fell into; counts for chunks which have since been split, merged or
+     * migrated away are no longer reported and age out with their window. The rates of a chunk
+     * which migrated in only cover the time since it arrived.
+     *
+     * A few of the sampled shard keys of each chunk are kept as well, so that a chunk which is
+     * too hot to move as a whole can be split at the median of its load rather than of its data.
+     */
+    class ChunkLoadTracker {
+        MONGO_DISALLOW_COPYING(ChunkLoadTracker);
+    public:
+        enum OpType {
+            kRead,
+            kWrite,
+        };
+
+        // Number of sampled shard keys kept per chunk and window.
+        static const size_t kMaxSampledKeys;
+
+        explicit ChunkLoadTracker(Milliseconds window);
+
+        /**
+         * Decides whether the current operation should be recorded. Returns the number of
+         * operations it should be recorded as, or 0 if it should not be recorded. Cheap enough to
+         * be called once per document.
+         */
+        int sample();
+
+        /**
+         * Records 'numOps' operations of type 'opType' on the document with shard key 'shardKey'
+         * of collection 'ns'. Keys which don't fall into a chunk of 'metadata' are ignored.
+         */
+        void record(const std::string& ns,
+                    const CollectionMetadata& metadata,
+                    const BSONObj& shardKey,
+                    OpType opType,
+                    int numOps,
+                    Date_t now);
+
+        /**
+         * Appends an object for each chunk of 'ns' which has seen operations recently, of the form
+         *
+         *   { min: <key>, max: <key>, readsPerSec: <double>, writesPerSec: <double>,
+         *     splitPoint: <key> }
+         *
+         * 'splitPoint' is the median of the sampled keys of the chunk and is only present if it
+         * lies strictly inside the chunk. Only chunks which are still part of 'metadata' are
+         * reported.
+         */
+        void report(const std::string& ns,
+                    const CollectionMetadata& metadata,
+                    Date_t now,
+                    BSONArrayBuilder* chunks);
+
+        /**
+         * Notes that the chunk [min, max) of the collection 'ns' with epoch 'epoch' migrated to
+         * this shard at 'now'. Anything recorded for it before is forgotten.
+         */
+        void noteChunkArrived(const std::string& ns,
+                              const OID& epoch,
+                              const BSONObj& min,
+                              const BSONObj& max,
+                              Date_t now);
+
+        /**
+         * Forgets everything recorded for 'ns'.
+         */
+        void reset(const std::string& ns);
+
+    private:
+        struct ChunkCounts {
+            BSONObj max;
+            long long reads = 0;
+            long long writes = 0;
+
+            // Reservoir of sampled shard keys, and the number of keys offered to it.
+            std::vector<BSONObj> keys;
+            long long keysSeen = 0;
+        };
+
+        // Chunk min -> counts.
+        typedef std::map<BSONObj, ChunkCounts> ChunkCountsMap;
+
+        struct ChunkArrival {
+            BSONObj max;
+            Date_t time;
+        };
+
+        // Chunk min -> when it migrated in.
+        typedef std::map<BSONObj, ChunkArrival> ChunkArrivalMap;
+
+        struct CollectionLoad {
+            // Epoch of the metadata the counts were recorded against.
+            OID epoch;
+
+            Date_t windowStart;
+            ChunkCountsMap current;
+
+            // Counts of the full window just before 'windowStart', if there was one.
+            bool hasPrevious = false;
+            ChunkCountsMap previous;
+
+            // Chunks which migrated in since the start of the previous window.
+            ChunkArrivalMap arrivals;
+        };
+
+        typedef std::map<std::string, CollectionLoad> CollectionLoadMap;
+
+        /**
+         * Returns the entry for 'ns', starting a new one if there is none or if the collection
+         * was dropped and recreated since, as told by 'epoch', and rolls its windows forward to
+         * 'now'.
+         */
+        CollectionLoad& _getCollection_inlock(const std::string& ns,
+                                              const OID& epoch,
+                                              Date_t now);
+
+        const Milliseconds _window;
+
+        AtomicUInt32 _opCounter;
+
+        // Protects everything below.
+        stdx::mutex _mutex;
+
+        PseudoRandom _random;
+
+        CollectionLoadMap _collections;
+    };
+
+    // Tracks the chunk load of this shard.
+    extern ChunkLoadTracker chunkLoadTracker;
+
+}  // namespace mongo
@@ -0,0 +1,277 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <boost/scoped_ptr.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/s/catalog/type_chunk.h"
+#include "mongo/s/chunk_load_tracker.h"
+#include "mongo/s/chunk_version.h"
+#include "mongo/s/collection_metadata.h"
+#include "mongo/unittest/unittest.h"
+
+namespace {
+
+    using namespace mongo;
+
+    using boost::scoped_ptr;
+    using std::string;
+    using std::vector;
+
+    const string kNs = "test.foo";
+
+    /**
+     * Builds metadata owning the chunks [0, 10), [10, 20) and [20, 30) of a collection sharded
+     * on 'a'.
+     */
+    CollectionMetadata* makeMetadata(const OID& epoch) {
+        CollectionMetadata empty;
+        std::unique_ptr<CollectionMetadata> metadata;
+
+        for (int i = 0; i < 3; i++) {
+            ChunkType chunk;
+            chunk.setMin(BSON("a" << i * 10));
+            chunk.setMax(BSON("a" << (i + 1) * 10));
+
+            string errMsg;
+            const CollectionMetadata& base = metadata ? *metadata : empty;
+            metadata.reset(base.clonePlusChunk(chunk, ChunkVersion(i + 1, 0, epoch), &errMsg));
+            ASSERT(metadata);
+        }
+
+        return metadata.release();
+    }
+
+    Date_t atSecond(int seconds) {
+        return Date_t::fromMillisSinceEpoch(seconds * 1000LL);
+    }
+
+    BSONArray report(ChunkLoadTracker* tracker,
+                     const CollectionMetadata& metadata,
+                     Date_t now) {
+        BSONArrayBuilder chunks;
+        tracker->report(kNs, metadata, now, &chunks);
+        return chunks.arr();
+    }
+
+    TEST(ChunkLoadTracker, NothingRecorded) {
+        ChunkLoadTracker tracker(Seconds(60));
+        scoped_ptr<CollectionMetadata> metadata(makeMetadata(OID::gen()));
+
+        ASSERT_EQUALS(0, report(&tracker, *metadata, atSecond(100)).nFields());
+    }
+
+    TEST(ChunkLoadTracker, RatesPerChunk) {
+        ChunkLoadTracker tracker(Seconds(60));
+        scoped_ptr<CollectionMetadata> metadata(makeMetadata(OID::gen()));
+
+        for (int i = 0; i < 10; i++) {
+            tracker.record(kNs, *metadata, BSON("a" << 5), ChunkLoadTracker::kRead, 10,
+                           atSecond(100));
+        }
+        tracker.record(kNs, *metadata, BSON("a" << 25), ChunkLoadTracker::kWrite, 20,
+                       atSecond(100));
+
+        // Keys outside of the chunks are ignored.
+        tracker.record(kNs, *metadata, BSON("a" << 35), ChunkLoadTracker::kWrite, 20,
+                       atSecond(100));
+
+        BSONArray chunks = report(&tracker, *metadata, atSecond(110));
+        ASSERT_EQUALS(2, chunks.nFields());
+
+        BSONObj first = chunks[0].Obj();
+        ASSERT_EQUALS(BSON("a" << 0), first["min"].Obj());
+        ASSERT_EQUALS(BSON("a" << 10), first["max"].Obj());
+        ASSERT_EQUALS(10.0, first["readsPerSec"].Double());
+        ASSERT_EQUALS(0.0, first["writesPerSec"].Double());
+
+        BSONObj second = chunks[1].Obj();
+        ASSERT_EQUALS(BSON("a" << 20), second["min"].Obj());
+        ASSERT_EQUALS(0.0, second["readsPerSec"].Double());
+        ASSERT_EQUALS(2.0, second["writesPerSec"].Double());
+    }
+
+    TEST(ChunkLoadTracker, WindowsAgeOut) {
+        ChunkLoadTracker tracker(Seconds(60));
+        scoped_ptr<CollectionMetadata> metadata(makeMetadata(OID::gen()));
+
+        tracker.record(kNs, *metadata, BSON("a" << 5), ChunkLoadTracker::kRead, 60,
+                       atSecond(0));
+
+        // Still within the first window.
+        BSONArray chunks = report(&tracker, *metadata, atSecond(30));
+        ASSERT_EQUALS(1, chunks.nFields());
+        ASSERT_EQUALS(2.0, chunks[0].Obj()["readsPerSec"].Double());
+
+        // The first window is now the previous one, so the rate covers both.
+        tracker.record(kNs, *metadata, BSON("a" << 15), ChunkLoadTracker::kRead, 60,
+                       atSecond(90));
+        chunks = report(&tracker, *metadata, atSecond(90));
+        ASSERT_EQUALS(2, chunks.nFields());
+        ASSERT_EQUALS(60.0 / 90, chunks[0].Obj()["readsPerSec"].Double());
+        ASSERT_EQUALS(60.0 / 90, chunks[1].Obj()["readsPerSec"].Double());
+
+        // Two windows later only the second chunk is left.
+        chunks = report(&tracker, *metadata, atSecond(150));
+        ASSERT_EQUALS(1, chunks.nFields());
+        ASSERT_EQUALS(BSON("a" << 10), chunks[0].Obj()["min"].Obj());
+
+        // And after two idle windows nothing is.
+        ASSERT_EQUALS(0, report(&tracker, *metadata, atSecond(300)).nFields());
+    }
+
+    TEST(ChunkLoadTracker, MigratedChunkRateSinceArrival) {
+        ChunkLoadTracker tracker(Seconds(60));
+        const OID epoch = OID::gen();
+        scoped_ptr<CollectionMetadata> metadata(makeMetadata(epoch));
+
+        tracker.record(kNs, *metadata, BSON("a" << 5), ChunkLoadTracker::kRead, 90,
+                       atSecond(0));
+        tracker.record(kNs, *metadata, BSON("a" << 15), ChunkLoadTracker::kRead, 1000,
+                       atSecond(10));
+
+        // Counts from before the chunk last arrived are dropped, and its rate only covers the
+        // time since.
+        tracker.noteChunkArrived(kNs, epoch, BSON("a" << 10), BSON("a" << 20), atSecond(80));
+        tracker.record(kNs, *metadata, BSON("a" << 15), ChunkLoadTracker::kRead, 100,
+                       atSecond(85));
+
+        BSONArray chunks = report(&tracker, *metadata, atSecond(90));
+        ASSERT_EQUALS(2, chunks.nFields());
+        ASSERT_EQUALS(1.0, chunks[0].Obj()["readsPerSec"].Double());
+        ASSERT_EQUALS(BSON("a" << 10), chunks[1].Obj()["min"].Obj());
+        ASSERT_EQUALS(10.0, chunks[1].Obj()["readsPerSec"].Double());
+
+        // Once the counts no longer go back further than the arrival, it makes no difference.
+        tracker.record(kNs, *metadata, BSON("a" << 15), ChunkLoadTracker::kRead, 500,
+                       atSecond(150));
+        chunks = report(&tracker, *metadata, atSecond(200));
+        ASSERT_EQUALS(1, chunks.nFields());
+        ASSERT_EQUALS(500.0 / 80, chunks[0].Obj()["readsPerSec"].Double());
+    }
+
+    TEST(ChunkLoadTracker, SplitChunksNotReported) {
+        const OID epoch = OID::gen();
+        ChunkLoadTracker tracker(Seconds(60));
+        scoped_ptr<CollectionMetadata> metadata(makeMetadata(epoch));
+
+        tracker.record(kNs, *metadata, BSON("a" << 5), ChunkLoadTracker::kWrite, 1,
+                       atSecond(0));
+        tracker.record(kNs, *metadata, BSON("a" << 15), ChunkLoadTracker::kWrite, 1,
+                       atSecond(0));
+
+        ChunkType chunk;
+        chunk.setMin(BSON("a" << 0));
+        chunk.setMax(BSON("a" << 10));
+
+        vector<BSONObj> splitKeys;
+        splitKeys.push_back(BSON("a" << 5));
+
+        string errMsg;
+        scoped_ptr<CollectionMetadata> split(metadata->cloneSplit(chunk,
+                                                                  splitKeys,
+                                                                  ChunkVersion(4, 0, epoch),
+                                                                  &errMsg));
+        ASSERT(split);
+
+        BSONArray chunks = report(&tracker, *split, atSecond(10));
+        ASSERT_EQUALS(1, chunks.nFields());
+        ASSERT_EQUALS(BSON("a" << 10), chunks[0].Obj()["min"].Obj());
+    }
+
+    TEST(ChunkLoadTracker, NewEpochResets) {
+        ChunkLoadTracker tracker(Seconds(60));
+        scoped_ptr<CollectionMetadata> metadata(makeMetadata(OID::gen()));
+
+        tracker.record(kNs, *metadata, BSON("a" << 5), ChunkLoadTracker::kWrite, 1,
+                       atSecond(0));
+        ASSERT_EQUALS(1, report(&tracker, *metadata, atSecond(10)).nFields());
+
+        scoped_ptr<CollectionMetadata> recreated(makeMetadata(OID::gen()));
+        ASSERT_EQUALS(0, report(&tracker, *recreated, atSecond(10)).nFields());
+    }
+
+    TEST(ChunkLoadTracker, SplitPointAtLoadMedian) {
+        ChunkLoadTracker tracker(Seconds(60));
+        scoped_ptr<CollectionMetadata> metadata(makeMetadata(OID::gen()));
+
+        // Most of the load is at the top of the chunk.
+        tracker.record(kNs, *metadata, BSON("a" << 1), ChunkLoadTracker::kWrite, 1,
+                       atSecond(0));
+        for (int i = 0; i < 10; i++) {
+            tracker.record(kNs, *metadata, BSON("a" << 8), ChunkLoadTracker::kWrite, 1,
+                           atSecond(0));
+        }
+        tracker.record(kNs, *metadata, BSON("a" << 9), ChunkLoadTracker::kWrite, 1,
+                       atSecond(0));
+
+        BSONArray chunks = report(&tracker, *metadata, atSecond(10));
+        ASSERT_EQUALS(1, chunks.nFields());
+        ASSERT_EQUALS(BSON("a" << 8), chunks[0].Obj()["splitPoint"].Obj());
+    }
+
+    TEST(ChunkLoadTracker, NoSplitPointAtChunkMin) {
+        ChunkLoadTracker tracker(Seconds(60));
+        scoped_ptr<CollectionMetadata> metadata(makeMetadata(OID::gen()));
+
+        // All of the load is on the lowest key, which splitting can't separate.
+        for (int i = 0; i < 10; i++) {
+            tracker.record(kNs, *metadata, BSON("a" << 10), ChunkLoadTracker::kRead, 1,
+                           atSecond(0));
+        }
+
+        BSONArray chunks = report(&tracker, *metadata, atSecond(10));
+        ASSERT_EQUALS(1, chunks.nFields());
+        ASSERT_FALSE(chunks[0].Obj().hasField("splitPoint"));
+    }
+
+    TEST(ChunkLoadTracker, SampledKeysBounded) {
+        ChunkLoadTracker tracker(Seconds(60));
+        scoped_ptr<CollectionMetadata> metadata(makeMetadata(OID::gen()));
+
+        // Offer many more keys than are kept; the median must still be one of them.
+        for (int i = 0; i < 1000; i++) {
+            tracker.record(kNs, *metadata, BSON("a" << 20 + (i % 10)), ChunkLoadTracker::kRead,
+                           1, atSecond(0));
+        }
+
+        BSONArray chunks = report(&tracker, *metadata, atSecond(10));
+        ASSERT_EQUALS(1, chunks.nFields());
+        ASSERT_EQUALS(100.0, chunks[0].Obj()["readsPerSec"].Double());
+
+        BSONObj splitPoint = chunks[0].Obj()["splitPoint"].Obj();
+        ASSERT_GREATER_THAN(splitPoint["a"].numberInt(), 20);
+        ASSERT_LESS_THAN(splitPoint["a"].numberInt(), 30);
+    }
+
+} // namespace
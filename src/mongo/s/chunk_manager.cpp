@@ -32,6 +32,7 @@
 
 #include "mongo/s/chunk_manager.h"
 
+#include <boost/make_shared.hpp>
 #include <boost/next_prior.hpp>
 #include <map>
 #include <set>
@@ -148,7 +149,8 @@ namespace {
           _keyPattern( pattern.getKeyPattern() ),
           _unique( unique ),
           _sequenceNumber(NextSequenceNumber.addAndFetch(1)),
-          _chunkRanges() {
+          _chunkRanges(),
+          _chunkMaxes(boost::make_shared<ShardKeyBoundaries>(vector<BSONObj>())) {
 
     }
 
@@ -157,7 +159,8 @@ namespace {
           _keyPattern(coll.getKeyPattern()),
           _unique(coll.getUnique()),
           _sequenceNumber(NextSequenceNumber.addAndFetch(1)),
-          _chunkRanges() {
+          _chunkRanges(),
+          _chunkMaxes(boost::make_shared<ShardKeyBoundaries>(vector<BSONObj>())) {
 
         _version = ChunkVersion::fromBSON(coll.toBSON());
     }
@@ -187,6 +190,7 @@ namespace {
                     _shardIds.swap(shardIds);
                     _shardVersions.swap(shardVersions);
                     _chunkRanges.reloadAll(_chunkMap);
+                    _buildRoutingTable(oldManager);
 
                     return;
                 }
@@ -206,6 +210,35 @@ namespace {
                                          << " after 3 attempts. Please try again.");
     }
 
+    void ChunkManager::_buildRoutingTable(const ChunkManager* oldManager) {
+        _chunksByMax.clear();
+        _chunksByMax.reserve(_chunkMap.size());
+        for (ChunkMap::const_iterator it = _chunkMap.begin(); it != _chunkMap.end(); ++it) {
+            _chunksByMax.push_back(it->second);
+        }
+
+        // Chunk migrations, the most common reason to reload, only change the shard of chunks,
+        // so their boundaries can often be kept rather than encoded again.
+        if (oldManager && oldManager->_chunksByMax.size() == _chunksByMax.size()) {
+            bool sameBoundaries = true;
+            for (size_t i = 0; i < _chunksByMax.size() && sameBoundaries; ++i) {
+                sameBoundaries = _chunksByMax[i]->getMax().binaryEqual(
+                                        oldManager->_chunksByMax[i]->getMax());
+            }
+            if (sameBoundaries) {
+                _chunkMaxes = oldManager->_chunkMaxes;
+                return;
+            }
+        }
+
+        vector<BSONObj> maxes;
+        maxes.reserve(_chunksByMax.size());
+        for (size_t i = 0; i < _chunksByMax.size(); ++i) {
+            maxes.push_back(_chunksByMax[i]->getMax());
+        }
+        _chunkMaxes = boost::make_shared<ShardKeyBoundaries>(maxes);
+    }
+
     bool ChunkManager::_load(ChunkMap& chunkMap,
                              set<ShardId>& shardIds,
                              ShardVersionMap* shardVersions,
@@ -431,13 +464,11 @@ namespace {
 
     ChunkPtr ChunkManager::findIntersectingChunk( const BSONObj& shardKey ) const {
         {
-            BSONObj chunkMin;
             ChunkPtr chunk;
             {
-                ChunkMap::const_iterator it = _chunkMap.upper_bound( shardKey );
-                if (it != _chunkMap.end()) {
-                    chunkMin = it->first;
-                    chunk = it->second;
+                const size_t i = _chunkMaxes->upperBound(shardKey);
+                if (i < _chunksByMax.size()) {
+                    chunk = _chunksByMax[i];
                 }
             }
 
@@ -446,7 +477,6 @@ namespace {
                     return chunk;
                 }
 
-                log() << chunkMin;
                 log() << *chunk;
                 log() << shardKey;
 
@@ -508,7 +538,7 @@ namespace {
         // than return an empty set of shards.
         if (shardIds.empty()) {
             massert( 16068, "no chunk ranges available", !_chunkRanges.ranges().empty() );
-            shardIds.insert(_chunkRanges.ranges().begin()->second->getShardId());
+            shardIds.insert(_chunkRanges.ranges().front()->getShardId());
         }
     }
 
@@ -516,17 +546,18 @@ namespace {
                                            const BSONObj& min,
                                            const BSONObj& max) const {
 
-        ChunkRangeMap::const_iterator it = _chunkRanges.upper_bound(min);
-        ChunkRangeMap::const_iterator end = _chunkRanges.upper_bound(max);
+        const ChunkRangeManager::ChunkRangeVector& ranges = _chunkRanges.ranges();
+        size_t it = _chunkRanges.upperBound(min);
+        size_t end = _chunkRanges.upperBound(max);
 
         massert(13507,
                 str::stream() << "no chunks found between bounds " << min << " and " << max,
-                it != _chunkRanges.ranges().end());
+                it != ranges.size());
 
-        if( end != _chunkRanges.ranges().end() ) ++end;
+        if( end != ranges.size() ) ++end;
 
         for( ; it != end; ++it ){
-            shardIds.insert(it->second->getShardId());
+            shardIds.insert(ranges[it]->getShardId());
 
             // once we know we need to visit all shards no need to keep looping
             if (shardIds.size() == _shardIds.size()) break;
@@ -707,53 +738,64 @@ namespace {
     }
 
 
+    ChunkRangeManager::ChunkRangeManager()
+        : _maxes(boost::make_shared<ShardKeyBoundaries>(vector<BSONObj>())) {
+
+    }
+
+    void ChunkRangeManager::clear() {
+        _ranges.clear();
+        _maxes = boost::make_shared<ShardKeyBoundaries>(vector<BSONObj>());
+    }
+
     void ChunkRangeManager::assertValid() const {
         if (_ranges.empty())
             return;
 
         try {
             // No Nulls
-            for (ChunkRangeMap::const_iterator it=_ranges.begin(), end=_ranges.end(); it != end; ++it) {
-                verify(it->second);
+            for (size_t i = 0; i < _ranges.size(); ++i) {
+                verify(_ranges[i]);
             }
 
             // Check endpoints
-            verify(allOfType(MinKey, _ranges.begin()->second->getMin()));
-            verify(allOfType(MaxKey, boost::prior(_ranges.end())->second->getMax()));
+            verify(allOfType(MinKey, _ranges.front()->getMin()));
+            verify(allOfType(MaxKey, _ranges.back()->getMax()));
 
             // Make sure there are no gaps or overlaps
-            for (ChunkRangeMap::const_iterator it=boost::next(_ranges.begin()), end=_ranges.end(); it != end; ++it) {
-                ChunkRangeMap::const_iterator last = boost::prior(it);
-                verify(it->second->getMin() == last->second->getMax());
+            for (size_t i = 1; i < _ranges.size(); ++i) {
+                verify(_ranges[i]->getMin() == _ranges[i - 1]->getMax());
             }
 
-            // Check Map keys
-            for (ChunkRangeMap::const_iterator it=_ranges.begin(), end=_ranges.end(); it != end; ++it) {
-                verify(it->first == it->second->getMax());
+            // Check the boundaries
+            verify(_maxes->size() == _ranges.size());
+            for (size_t i = 0; i < _ranges.size(); ++i) {
+                verify(_maxes->lowerBound(_ranges[i]->getMax()) == i);
+                verify(_maxes->upperBound(_ranges[i]->getMax()) == i + 1);
             }
 
             // Make sure we match the original chunks
-            const ChunkMap chunks = _ranges.begin()->second->getManager()->_chunkMap;
+            const ChunkMap chunks = _ranges.front()->getManager()->_chunkMap;
             for ( ChunkMap::const_iterator i=chunks.begin(); i!=chunks.end(); ++i ) {
                 const ChunkPtr chunk = i->second;
 
-                ChunkRangeMap::const_iterator min = _ranges.upper_bound(chunk->getMin());
-                ChunkRangeMap::const_iterator max = _ranges.lower_bound(chunk->getMax());
+                const size_t min = upperBound(chunk->getMin());
+                const size_t max = lowerBound(chunk->getMax());
 
-                verify(min != _ranges.end());
-                verify(max != _ranges.end());
+                verify(min != _ranges.size());
+                verify(max != _ranges.size());
                 verify(min == max);
-                verify(min->second->getShardId() == chunk->getShardId());
-                verify(min->second->containsKey( chunk->getMin() ));
-                verify(min->second->containsKey( chunk->getMax() ) || (min->second->getMax() == chunk->getMax()));
+                verify(_ranges[min]->getShardId() == chunk->getShardId());
+                verify(_ranges[min]->containsKey( chunk->getMin() ));
+                verify(_ranges[min]->containsKey( chunk->getMax() ) || (_ranges[min]->getMax() == chunk->getMax()));
             }
 
         }
         catch (...) {
-            error() << "\t invalid ChunkRangeMap! printing ranges:";
+            error() << "\t invalid ChunkRangeManager! printing ranges:";
 
-            for (ChunkRangeMap::const_iterator it = _ranges.begin(), end = _ranges.end(); it != end; ++it) {
-                log() << it->first << ": " << it->second->toString();
+            for (size_t i = 0; i < _ranges.size(); ++i) {
+                log() << _ranges[i]->getMax() << ": " << _ranges[i]->toString();
             }
 
             throw;
@@ -764,6 +806,13 @@ namespace {
         _ranges.clear();
         _insertRange(chunks.begin(), chunks.end());
 
+        vector<BSONObj> maxes;
+        maxes.reserve(_ranges.size());
+        for (size_t i = 0; i < _ranges.size(); ++i) {
+            maxes.push_back(_ranges[i]->getMax());
+        }
+        _maxes = boost::make_shared<ShardKeyBoundaries>(maxes);
+
         DEV assertValid();
     }
 
@@ -774,8 +823,7 @@ namespace {
             while (begin != end && (begin->second->getShardId() == shardId))
                 ++begin;
 
-            shared_ptr<ChunkRange> cr (new ChunkRange(first, begin));
-            _ranges[cr->getMax()] = cr;
+            _ranges.push_back(boost::make_shared<ChunkRange>(first, begin));
         }
     }
 
@@ -34,6 +34,7 @@
 #include <vector>
 
 #include "mongo/s/chunk.h"
+#include "mongo/s/shard_key_boundaries.h"
 
 namespace mongo {
 
@@ -78,28 +79,39 @@ namespace mongo {
         const BSONObj _max;
     };
 
-    typedef std::map<BSONObj, boost::shared_ptr<ChunkRange>, BSONObjCmp> ChunkRangeMap;
-
-
+    /**
+     * The chunks of a collection merged into ranges of consecutive chunks on the same shard, in
+     * a flat array sorted by their max.
+     */
     class ChunkRangeManager {
     public:
-        const ChunkRangeMap& ranges() const { return _ranges; }
+        typedef std::vector<boost::shared_ptr<ChunkRange>> ChunkRangeVector;
+
+        ChunkRangeManager();
 
-        void clear() { _ranges.clear(); }
+        const ChunkRangeVector& ranges() const { return _ranges; }
+
+        void clear();
 
         void reloadAll(const ChunkMap& chunks);
 
         // Slow operation -- wrap with DEV
         void assertValid() const;
 
-        ChunkRangeMap::const_iterator upper_bound(const BSONObj& o) const { return _ranges.upper_bound(o); }
-        ChunkRangeMap::const_iterator lower_bound(const BSONObj& o) const { return _ranges.lower_bound(o); }
+        // Index of the first range whose max is greater than 'o', or ranges().size().
+        size_t upperBound(const BSONObj& o) const { return _maxes->upperBound(o); }
+
+        // Index of the first range whose max is not less than 'o', or ranges().size().
+        size_t lowerBound(const BSONObj& o) const { return _maxes->lowerBound(o); }
 
     private:
         // assumes nothing in this range exists in _ranges
         void _insertRange(ChunkMap::const_iterator begin, const ChunkMap::const_iterator end);
 
-        ChunkRangeMap _ranges;
+        ChunkRangeVector _ranges;
+
+        // The max of each range in _ranges.
+        boost::shared_ptr<const ShardKeyBoundaries> _maxes;
     };
 
 
@@ -209,6 +221,12 @@ namespace mongo {
         boost::shared_ptr<ChunkManager> reload(bool force = true) const; // doesn't modify self!
 
     private:
+        /**
+         * Builds _chunksByMax and _chunkMaxes from _chunkMap, reusing the boundaries of
+         * 'oldManager' if they are the same.
+         */
+        void _buildRoutingTable(const ChunkManager* oldManager);
+
         // returns true if load was consistent
         bool _load(ChunkMap& chunks,
                    std::set<ShardId>& shardIds,
@@ -229,6 +247,12 @@ namespace mongo {
         ChunkMap _chunkMap;
         ChunkRangeManager _chunkRanges;
 
+        // The chunks of _chunkMap in order, along with their max, for findIntersectingChunk().
+        // The boundaries are shared with the ChunkManager this one was loaded from if none of
+        // them moved.
+        std::vector<ChunkPtr> _chunksByMax;
+        boost::shared_ptr<const ShardKeyBoundaries> _chunkMaxes;
+
         std::set<ShardId> _shardIds;
 
         // Max known version per shard
@@ -30,13 +30,19 @@
 
 #include "mongo/platform/basic.h"
 
+#include <map>
+#include <vector>
+
 #include "mongo/db/json.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/canonical_query.h"
+#include "mongo/platform/random.h"
 #include "mongo/s/chunk_manager.h"
+#include "mongo/s/shard_key_boundaries.h"
 #include "mongo/s/shard_key_pattern.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/log.h"
+#include "mongo/util/timer.h"
 
 namespace {
 
@@ -44,6 +50,8 @@ namespace {
 
     using std::auto_ptr;
     using std::make_pair;
+    using std::map;
+    using std::vector;
 
     /**
      * ChunkManager targeting test
@@ -532,4 +540,149 @@ namespace {
         CheckBoundList(list, expectedList);
     }
 
+    //
+    // Tests for the flat table of chunk boundaries used by ChunkManager lookups
+    //
+
+    typedef map<BSONObj, size_t, BSONObjCmp> BoundaryMap;
+
+    // Checks that ShardKeyBoundaries finds the same position for 'key' as a map of the same keys.
+    void checkBoundaries(const vector<BSONObj>& keys, const BSONObj& key) {
+        ShardKeyBoundaries boundaries(keys);
+        BoundaryMap map;
+        for (size_t i = 0; i < keys.size(); i++) {
+            map.insert(make_pair(keys[i], i));
+        }
+
+        BoundaryMap::const_iterator upper = map.upper_bound(key);
+        BoundaryMap::const_iterator lower = map.lower_bound(key);
+        ASSERT_EQUALS(upper == map.end() ? keys.size() : upper->second,
+                      boundaries.upperBound(key));
+        ASSERT_EQUALS(lower == map.end() ? keys.size() : lower->second,
+                      boundaries.lowerBound(key));
+    }
+
+    TEST(CMBoundariesTest, Empty) {
+        ShardKeyBoundaries boundaries((vector<BSONObj>()));
+        ASSERT_EQUALS(0U, boundaries.size());
+        ASSERT_EQUALS(0U, boundaries.upperBound(BSON("a" << 1)));
+        ASSERT_EQUALS(0U, boundaries.lowerBound(BSON("a" << 1)));
+    }
+
+    TEST(CMBoundariesTest, SingleField) {
+        vector<BSONObj> keys;
+        keys.push_back(BSON("a" << -10));
+        keys.push_back(BSON("a" << 0));
+        keys.push_back(BSON("a" << 10));
+        keys.push_back(BSON("a" << MAXKEY));
+
+        ASSERT_EQUALS(keys.size(), ShardKeyBoundaries(keys).size());
+        checkBoundaries(keys, BSON("a" << MINKEY));
+        checkBoundaries(keys, BSON("a" << -11));
+        checkBoundaries(keys, BSON("a" << -10));
+        checkBoundaries(keys, BSON("a" << 5));
+        checkBoundaries(keys, BSON("a" << 10));
+        checkBoundaries(keys, BSON("a" << "str"));
+        checkBoundaries(keys, BSON("a" << MAXKEY));
+    }
+
+    TEST(CMBoundariesTest, NumericTypes) {
+        vector<BSONObj> keys;
+        keys.push_back(BSON("a" << 1));
+        keys.push_back(BSON("a" << 2.5));
+        keys.push_back(BSON("a" << 3LL));
+        keys.push_back(BSON("a" << MAXKEY));
+
+        // Numbers compare by value whatever their type.
+        checkBoundaries(keys, BSON("a" << 1.0));
+        checkBoundaries(keys, BSON("a" << 1LL));
+        checkBoundaries(keys, BSON("a" << 2));
+        checkBoundaries(keys, BSON("a" << 2.5));
+        checkBoundaries(keys, BSON("a" << 3));
+        checkBoundaries(keys, BSON("a" << 3.0));
+    }
+
+    TEST(CMBoundariesTest, Strings) {
+        vector<BSONObj> keys;
+        keys.push_back(BSON("a" << ""));
+        keys.push_back(BSON("a" << "ab"));
+        keys.push_back(BSON("a" << "abc"));
+        keys.push_back(BSON("a" << "b"));
+        keys.push_back(BSON("a" << MAXKEY));
+
+        checkBoundaries(keys, BSON("a" << 100));
+        checkBoundaries(keys, BSON("a" << ""));
+        checkBoundaries(keys, BSON("a" << "a"));
+        checkBoundaries(keys, BSON("a" << "ab"));
+        checkBoundaries(keys, BSON("a" << "abb"));
+        checkBoundaries(keys, BSON("a" << "abc"));
+        checkBoundaries(keys, BSON("a" << "abcd"));
+        checkBoundaries(keys, BSON("a" << "c"));
+    }
+
+    TEST(CMBoundariesTest, Compound) {
+        vector<BSONObj> keys;
+        keys.push_back(BSON("a" << 1 << "b" << MINKEY));
+        keys.push_back(BSON("a" << 1 << "b" << "x"));
+        keys.push_back(BSON("a" << 1 << "b" << MAXKEY));
+        keys.push_back(BSON("a" << 2 << "b" << 0));
+        keys.push_back(BSON("a" << MAXKEY << "b" << MAXKEY));
+
+        checkBoundaries(keys, BSON("a" << 0 << "b" << 0));
+        checkBoundaries(keys, BSON("a" << 1 << "b" << MINKEY));
+        checkBoundaries(keys, BSON("a" << 1 << "b" << 0));
+        checkBoundaries(keys, BSON("a" << 1 << "b" << "x"));
+        checkBoundaries(keys, BSON("a" << 1 << "b" << "y"));
+        checkBoundaries(keys, BSON("a" << 1.0 << "b" << MAXKEY));
+        checkBoundaries(keys, BSON("a" << 2 << "b" << -1));
+        checkBoundaries(keys, BSON("a" << 2 << "b" << 0));
+        checkBoundaries(keys, BSON("a" << 3 << "b" << 0));
+        checkBoundaries(keys, BSON("a" << MAXKEY << "b" << MAXKEY));
+    }
+
+    // Compares lookups in the flat table against the ordered map it replaces, for a collection
+    // with many chunks. The timings are only logged, the results must agree.
+    TEST(CMBoundariesTest, LookupBenchmark) {
+        const int kNumChunks = 200 * 1000;
+        const int kNumLookups = 1000 * 1000;
+
+        vector<BSONObj> keys;
+        BoundaryMap map;
+        for (int i = 1; i < kNumChunks; i++) {
+            keys.push_back(BSON("a" << i * 10LL));
+        }
+        keys.push_back(BSON("a" << MAXKEY));
+        for (size_t i = 0; i < keys.size(); i++) {
+            map.insert(make_pair(keys[i], i));
+        }
+        ShardKeyBoundaries boundaries(keys);
+
+        PseudoRandom random(12345);
+        vector<BSONObj> lookups;
+        lookups.reserve(kNumLookups);
+        for (int i = 0; i < kNumLookups; i++) {
+            const long long value = random.nextInt64(kNumChunks * 10LL);
+            lookups.push_back(BSON("a" << value));
+        }
+
+        size_t mapSum = 0;
+        Timer mapTimer;
+        for (int i = 0; i < kNumLookups; i++) {
+            mapSum += map.upper_bound(lookups[i])->second;
+        }
+        const long long mapMicros = mapTimer.micros();
+
+        size_t flatSum = 0;
+        Timer flatTimer;
+        for (int i = 0; i < kNumLookups; i++) {
+            flatSum += boundaries.upperBound(lookups[i]);
+        }
+        const long long flatMicros = flatTimer.micros();
+
+        ASSERT_EQUALS(mapSum, flatSum);
+
+        log() << kNumLookups << " lookups among " << kNumChunks << " chunks took "
+              << mapMicros << "us with a map and " << flatMicros << "us with boundaries";
+    }
+
 } // namespace
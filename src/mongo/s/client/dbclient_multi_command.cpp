@@ -38,12 +38,17 @@
 #include "mongo/s/client/shard_connection.h"
 #include "mongo/s/write_ops/batched_command_request.h"
 #include "mongo/util/net/message.h"
+#include "mongo/util/net/message_port.h"
+#include "mongo/util/net/sock.h"
+#include "mongo/util/net/socket_poll.h"
 
 namespace mongo {
 
     using boost::scoped_ptr;
     using std::deque;
+    using std::set;
     using std::string;
+    using std::vector;
 
     DBClientMultiCommand::PendingCommand::PendingCommand( const ConnectionString& endpoint,
                                                           StringData dbName,
@@ -52,6 +57,7 @@ namespace mongo {
         dbName( dbName.toString() ),
         cmdObj( cmdObj ),
         conn( NULL ),
+        sent( false ),
         status( Status::OK() ) {
     }
 
@@ -126,6 +132,8 @@ namespace mongo {
             it != _pendingCommands.end(); ++it ) {
 
             PendingCommand* command = *it;
+            if ( command->sent ) continue;
+            command->sent = true;
             dassert( NULL == command->conn );
 
             try {
@@ -172,8 +180,9 @@ namespace mongo {
 
     Status DBClientMultiCommand::recvAny( ConnectionString* endpoint, BSONSerializable* response ) {
 
-        scoped_ptr<PendingCommand> command( _pendingCommands.front() );
-        _pendingCommands.pop_front();
+        PendingQueue::iterator next = _waitForResponse();
+        scoped_ptr<PendingCommand> command( *next );
+        _pendingCommands.erase( next );
 
         *endpoint = command->endpoint;
         if ( !command->status.isOK() ) return command->status;
@@ -215,6 +224,53 @@ namespace mongo {
         return Status::OK();
     }
 
+    DBClientMultiCommand::PendingQueue::iterator DBClientMultiCommand::_waitForResponse() {
+
+        // Only the oldest command to each endpoint is a candidate, so that responses from one
+        // endpoint come back in order even when its commands went out on several connections.
+        set<string> endpoints;
+        vector<PendingQueue::iterator> candidates;
+        vector<pollfd> pollInfo;
+
+        for ( PendingQueue::iterator it = _pendingCommands.begin();
+            it != _pendingCommands.end(); ++it ) {
+
+            PendingCommand* command = *it;
+            if ( !endpoints.insert( command->endpoint.toString() ).second ) continue;
+
+            // Failed sends are reported right away
+            if ( !command->status.isOK() ) return it;
+
+            DBClientConnection* conn = dynamic_cast<DBClientConnection*>( command->conn );
+            if ( NULL == conn || !isPollSupported() ) return _pendingCommands.begin();
+
+            Socket* socket = conn->port().psock.get();
+            if ( socket->hasBufferedInput() ) return it;
+
+            pollfd info;
+            info.fd = socket->rawFD();
+            info.events = POLLIN;
+            info.revents = 0;
+            pollInfo.push_back( info );
+            candidates.push_back( it );
+        }
+
+        if ( candidates.size() == 1 ) return candidates.front();
+
+        // On a timeout or an error, let the receive of the oldest command report it
+        int timeoutMillis = _timeoutMillis > 0 ? _timeoutMillis : -1;
+        if ( socketPoll( &pollInfo.front(), pollInfo.size(), timeoutMillis ) <= 0 ) {
+            return candidates.front();
+        }
+
+        for ( size_t i = 0; i < pollInfo.size(); ++i ) {
+            // Errors and hangups are readable too, in that recv returns at once
+            if ( pollInfo[i].revents != 0 ) return candidates[i];
+        }
+
+        return candidates.front();
+    }
+
     DBClientMultiCommand::~DBClientMultiCommand() {
 
         // Cleanup anything outstanding, do *not* return stuff to the pool, that might error
@@ -77,11 +77,21 @@ namespace mongo {
             // Where to send it
             DBClientBase* conn;
 
+            // Whether sendAll has dealt with it
+            bool sent;
+
             // If anything goes wrong
             Status status;
         };
 
         typedef std::deque<PendingCommand*> PendingQueue;
+
+        /**
+         * Returns the oldest pending command to some endpoint whose response can be read without
+         * waiting on the others, blocking until there is one.
+         */
+        PendingQueue::iterator _waitForResponse();
+
         PendingQueue _pendingCommands;
         int _timeoutMillis;
     };
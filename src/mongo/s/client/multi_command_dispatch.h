@@ -61,9 +61,10 @@ namespace mongo {
                                  const BSONSerializable& request ) = 0;
 
         /**
-         * Sends all the commands in this dispatch to their endpoints, in undefined order and
-         * without waiting for responses.  May block on full send queue (though this should be
-         * rare).
+         * Sends all the commands in this dispatch which have not been sent yet to their endpoints,
+         * in undefined order and without waiting for responses.  May block on full send queue
+         * (though this should be rare).  Commands may be added and sent while earlier ones are
+         * still outstanding.
          *
          * Any error which occurs during sendAll will be reported on recvAny, *does not throw.*
          */
@@ -76,7 +77,8 @@ namespace mongo {
 
         /**
          * Blocks until a command response has come back.  Any outstanding command response may be
-         * returned with associated endpoint.
+         * returned with associated endpoint, but responses from the same endpoint are returned in
+         * the order their commands were added.
          *
          * Returns !OK on send/recv/parse failure, otherwise command-level errors are returned in
          * the response object itself.
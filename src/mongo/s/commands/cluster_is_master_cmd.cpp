@@ -31,6 +31,7 @@
 #include "mongo/db/commands.h"
 #include "mongo/db/wire_version.h"
 #include "mongo/s/write_ops/batched_command_request.h"
+#include "mongo/util/net/message_compressor.h"
 
 namespace mongo {
 namespace {
@@ -76,6 +77,7 @@ namespace {
             // it is compiled.
             result.append("maxWireVersion", maxWireVersion);
             result.append("minWireVersion", minWireVersion);
+            appendNegotiatedCompressors(cmdObj, &result);
 
             return true;
         }
@@ -42,6 +42,8 @@
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/pipeline.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/s/catalog/catalog_cache.h"
 #include "mongo/s/chunk_manager.h"
@@ -63,6 +65,33 @@ namespace mongo {
 
 namespace {
 
+    // When set, split pipelines which don't end in $out are merged on one of the shards which ran
+    // the first half, rather than always on the primary shard of the database.
+    MONGO_EXPORT_SERVER_PARAMETER(internalAggMergeOnParticipatingShard, bool, false);
+
+    // Used to take turns between the participating shards when choosing where to merge.
+    AtomicUInt32 mergingShardCounter;
+
+    /**
+     * Returns the id of the shard which should run the merging half of a split pipeline.
+     *
+     * $out must run on the primary shard of the database, as that is where unsharded output
+     * collections live. Other merges go to the primary shard as well, unless
+     * internalAggMergeOnParticipatingShard is set, in which case they are spread round-robin over
+     * the shards which returned cursors. That shard already has one of the inputs locally and any
+     * spilling (with allowDiskUse) happens on it.
+     */
+    ShardId chooseMergingShard(const DBConfigPtr& conf,
+                               const vector<Strategy::CommandResult>& shardResults,
+                               bool hasOut) {
+        if (hasOut || !internalAggMergeOnParticipatingShard || shardResults.empty()) {
+            return conf->getPrimaryId();
+        }
+
+        const unsigned pick = mergingShardCounter.fetchAndAdd(1);
+        return shardResults[pick % shardResults.size()].shardTargetId;
+    }
+
     /**
      * Implements the aggregation (pipeline command for sharding).
      */
@@ -229,9 +258,15 @@ namespace {
                 outputNsOrEmpty = out->getOutputNs().ns();
             }
 
-            // Run merging command on primary shard of database. Need to use ShardConnection so
-            // that the merging mongod is sent the config servers on connection init.
-            const auto& shard = grid.shardRegistry()->findIfExists(conf->getPrimaryId());
+            // Run merging command on the chosen shard. Need to use ShardConnection so that the
+            // merging mongod is sent the config servers on connection init.
+            const ShardId mergingShardId =
+                chooseMergingShard(conf, shardResults, !outputNsOrEmpty.empty());
+            const auto& shard = grid.shardRegistry()->findIfExists(mergingShardId);
+            uassert(ErrorCodes::ShardNotFound,
+                    str::stream() << "merging shard " << mergingShardId << " not found",
+                    shard);
+
             ShardConnection conn(shard->getConnString(), outputNsOrEmpty);
             BSONObj mergedResults = aggRunCommand(conn.get(),
                                                   dbname,
@@ -239,7 +274,7 @@ namespace {
                                                   options);
             conn.done();
 
-            // Copy output from merging (primary) shard to the output object from our command.
+            // Copy output from merging shard to the output object from our command.
             // Also, propagates errmsg and code if ok == false.
             result.appendElements(mergedResults);
 
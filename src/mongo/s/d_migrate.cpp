@@ -72,6 +72,7 @@
 #include "mongo/s/catalog/catalog_manager.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/chunk.h"
+#include "mongo/s/chunk_load_tracker.h"
 #include "mongo/s/chunk_version.h"
 #include "mongo/s/config.h"
 #include "mongo/s/d_state.h"
@@ -2365,6 +2366,9 @@ namespace {
 
             setState(DONE);
             conn.done();
+
+            // The donor commits the migration next, after which the chunk takes operations here.
+            chunkLoadTracker.noteChunkArrived(ns, epoch, min, max, Date_t::now());
         }
 
         void status(BSONObjBuilder& b) {
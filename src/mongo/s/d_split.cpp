@@ -240,6 +240,8 @@ namespace mongo {
     public:
         SplitVector() : Command( "splitVector" , false ) {}
         virtual bool slaveOk() const { return false; }
+        // Initial sync splits collections on its sync source, which may be a secondary.
+        virtual bool slaveOverrideOk() const { return true; }
         virtual bool isWriteCommandForConfigServer() const { return false; }
         virtual void help( stringstream &help ) const {
             help <<
@@ -53,6 +53,7 @@
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/wire_version.h"
 #include "mongo/s/catalog/legacy/catalog_manager_legacy.h"
+#include "mongo/s/chunk_load_tracker.h"
 #include "mongo/s/client/shard_connection.h"
 #include "mongo/s/client/sharding_connection_hook.h"
 #include "mongo/s/config.h"
@@ -1306,6 +1307,49 @@ namespace mongo {
 
     } getShardVersion;
 
+    class GetChunkLoadCmd : public MongodShardCommand {
+    public:
+        GetChunkLoadCmd() : MongodShardCommand("_getChunkLoad") {}
+
+        virtual void help( stringstream& help ) const {
+            help << "internal, returns the sampled operation rates of the chunks of a collection";
+        }
+
+        virtual bool isWriteCommandForConfigServer() const { return false; }
+
+        virtual void addRequiredPrivileges(const std::string& dbname,
+                                           const BSONObj& cmdObj,
+                                           std::vector<Privilege>* out) {
+            ActionSet actions;
+            actions.addAction(ActionType::internal);
+            out->push_back(Privilege(ResourcePattern::forClusterResource(), actions));
+        }
+
+        bool run(OperationContext* txn,
+                 const string&,
+                 BSONObj& cmdObj,
+                 int,
+                 string& errmsg,
+                 BSONObjBuilder& result) {
+            const string ns = cmdObj["_getChunkLoad"].valuestrsafe();
+            if (ns.size() == 0) {
+                errmsg = "need to specify full namespace";
+                return false;
+            }
+
+            BSONArrayBuilder chunks(result.subarrayStart("chunks"));
+
+            CollectionMetadataPtr metadata = shardingState.getCollectionMetadata(ns);
+            if (metadata) {
+                chunkLoadTracker.report(ns, *metadata, Date_t::now(), &chunks);
+            }
+
+            chunks.done();
+            return true;
+        }
+
+    } getChunkLoadCmd;
+
     class ShardingStateCmd : public MongodShardCommand {
     public:
         ShardingStateCmd() : MongodShardCommand( "shardingState" ) {}
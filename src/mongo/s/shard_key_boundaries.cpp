@@ -0,0 +1,125 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/shard_key_boundaries.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "mongo/bson/ordering.h"
+#include "mongo/db/storage/key_string.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+namespace {
+
+    // Shard keys are compared in ascending order on every field, whatever their key pattern.
+    const Ordering kAscending = Ordering::make(BSONObj());
+
+    /**
+     * Compares two encoded keys the way KeyString::compare() does.
+     */
+    int compareEncoded(StringData lhs, StringData rhs) {
+        const size_t common = std::min(lhs.size(), rhs.size());
+        const int cmp = memcmp(lhs.rawData(), rhs.rawData(), common);
+        if (cmp != 0) {
+            return cmp;
+        }
+        if (lhs.size() == rhs.size()) {
+            return 0;
+        }
+        return lhs.size() < rhs.size() ? -1 : 1;
+    }
+
+} // namespace
+
+    ShardKeyBoundaries::ShardKeyBoundaries(const std::vector<BSONObj>& keys) {
+        _offsets.reserve(keys.size() + 1);
+
+        KeyString encoded;
+        for (size_t i = 0; i < keys.size(); ++i) {
+            encoded.resetToKey(keys[i], kAscending);
+            const StringData key(encoded.getBuffer(), encoded.getSize());
+
+            // The previous key only gets its end offset along with this key, so _keyAt() cannot
+            // return it yet.
+            dassert(i == 0 ||
+                    compareEncoded(StringData(_buffer.data() + _offsets.back(),
+                                              _buffer.size() - _offsets.back()),
+                                   key) <= 0);
+
+            _offsets.push_back(_buffer.size());
+            _buffer.insert(_buffer.end(), key.rawData(), key.rawData() + key.size());
+        }
+        _offsets.push_back(_buffer.size());
+
+        // The offsets are 32 bits to keep them compact.
+        invariant(_buffer.size() <= std::numeric_limits<uint32_t>::max());
+    }
+
+    size_t ShardKeyBoundaries::upperBound(const BSONObj& key) const {
+        const KeyString encoded(key, kAscending);
+        const StringData target(encoded.getBuffer(), encoded.getSize());
+
+        size_t low = 0;
+        size_t high = size();
+        while (low < high) {
+            const size_t mid = low + (high - low) / 2;
+            if (compareEncoded(_keyAt(mid), target) <= 0) {
+                low = mid + 1;
+            }
+            else {
+                high = mid;
+            }
+        }
+        return low;
+    }
+
+    size_t ShardKeyBoundaries::lowerBound(const BSONObj& key) const {
+        const KeyString encoded(key, kAscending);
+        const StringData target(encoded.getBuffer(), encoded.getSize());
+
+        size_t low = 0;
+        size_t high = size();
+        while (low < high) {
+            const size_t mid = low + (high - low) / 2;
+            if (compareEncoded(_keyAt(mid), target) < 0) {
+                low = mid + 1;
+            }
+            else {
+                high = mid;
+            }
+        }
+        return low;
+    }
+
+} // namespace mongo
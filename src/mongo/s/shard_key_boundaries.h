@@ -0,0 +1,84 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/db/jsobj.h"
+
+namespace mongo {
+
+    /**
+     * An immutable, sorted array of shard key values, such as the max of each chunk of a
+     * collection, for finding where a shard key falls among them.
+     *
+     * The keys are stored as KeyStrings, back to back in a single buffer, so a lookup is a binary
+     * search comparing flat byte strings rather than a walk down a tree of BSONObjs. They compare
+     * in the same order as BSONObjCmp orders shard keys, that is ignoring field names, which are
+     * those of the shard key pattern for all of them.
+     *
+     * Once built it is never modified, so it can be shared between the ChunkManagers of
+     * successive refreshes of a collection whose chunk boundaries have not changed.
+     */
+    class ShardKeyBoundaries {
+        MONGO_DISALLOW_COPYING(ShardKeyBoundaries);
+    public:
+        /**
+         * 'keys' must be sorted in ascending order.
+         */
+        explicit ShardKeyBoundaries(const std::vector<BSONObj>& keys);
+
+        size_t size() const { return _offsets.size() - 1; }
+
+        /**
+         * Returns the index of the first key greater than 'key', or size() if there is none.
+         */
+        size_t upperBound(const BSONObj& key) const;
+
+        /**
+         * Returns the index of the first key not less than 'key', or size() if there is none.
+         */
+        size_t lowerBound(const BSONObj& key) const;
+
+    private:
+        StringData _keyAt(size_t i) const {
+            return StringData(_buffer.data() + _offsets[i], _offsets[i + 1] - _offsets[i]);
+        }
+
+        // The encoded keys, one after the other.
+        std::vector<char> _buffer;
+
+        // Where each key starts in _buffer, followed by the size of _buffer.
+        std::vector<uint32_t> _offsets;
+    };
+
+} // namespace mongo
@@ -32,8 +32,11 @@
 
 #include "mongo/s/write_ops/batch_write_exec.h"
 
+#include <deque>
+#include <map>
+
 #include "mongo/base/error_codes.h"
-#include "mongo/base/owned_pointer_map.h"
+#include "mongo/base/owned_pointer_vector.h"
 #include "mongo/base/status.h"
 #include "mongo/bson/util/builder.h"
 #include "mongo/client/dbclientinterface.h" // ConnectionString (header-only)
@@ -44,6 +47,7 @@
 
 namespace mongo {
 
+    using std::deque;
     using std::endl;
     using std::make_pair;
     using std::stringstream;
@@ -66,7 +70,7 @@ namespace mongo {
         //
 
         // TODO: Unordered map?
-        typedef OwnedPointerMap<ConnectionString, TargetedWriteBatch> OwnedHostBatchMap;
+        typedef std::map<ConnectionString, TargetedWriteBatch*> HostBatchMap;
     }
 
     static void buildErrorFrom( const Status& status, WriteErrorDetail* error ) {
@@ -91,6 +95,33 @@ namespace mongo {
         return false;
     }
 
+    // Helper to target the ready write ops of a batch op, which returns false if targeting failed
+    static bool targetChildBatches( BatchWriteOp* batchOp,
+                                    NSTargeter* targeter,
+                                    bool recordTargetErrors,
+                                    BatchWriteExecStats* stats,
+                                    OwnedPointerVector<TargetedWriteBatch>* childBatchesOwned,
+                                    deque<TargetedWriteBatch*>* childBatches ) {
+
+        vector<TargetedWriteBatch*> targetedBatches;
+        Status targetStatus = batchOp->targetBatch( *targeter,
+                                                    recordTargetErrors,
+                                                    &targetedBatches );
+        if ( !targetStatus.isOK() ) {
+            // Don't do anything until a targeter refresh
+            targeter->noteCouldNotTarget();
+            ++stats->numTargetErrors;
+            dassert( targetedBatches.size() == 0u );
+            return false;
+        }
+
+        childBatchesOwned->mutableVector().insert( childBatchesOwned->mutableVector().end(),
+                                                   targetedBatches.begin(),
+                                                   targetedBatches.end() );
+        childBatches->insert( childBatches->end(), targetedBatches.begin(), targetedBatches.end() );
+        return true;
+    }
+
     // The number of times we'll try to continue a batch op if no progress is being made
     // This only applies when no writes are occurring and metadata is not changing on reload
     static const int kMaxRoundsWithoutProgress( 5 );
@@ -138,50 +169,53 @@ namespace mongo {
             //
 
             OwnedPointerVector<TargetedWriteBatch> childBatchesOwned;
-            vector<TargetedWriteBatch*>& childBatches = childBatchesOwned.mutableVector();
+
+            // Child batches not yet sent, in the order they were targeted
+            deque<TargetedWriteBatch*> childBatches;
+
+            // The write ops of an unordered batch may be targeted again before the round is over,
+            // whenever some are ready, so that each host is sent its next child batch as soon as
+            // it responds rather than once the slowest host of the round has.  Ordered batches
+            // can't be, since their write ops must wait for all the ones before them.
+            bool retargetInRound = !clientRequest.getOrdered();
 
             // If we've already had a targeting error, we've refreshed the metadata once and can
             // record target errors definitively.
             bool recordTargetErrors = refreshedTargeter;
-            Status targetStatus = batchOp.targetBatch( *_targeter,
-                                                       recordTargetErrors,
-                                                       &childBatches );
-            if ( !targetStatus.isOK() ) {
-                // Don't do anything until a targeter refresh
-                _targeter->noteCouldNotTarget();
+            if ( !targetChildBatches( &batchOp,
+                                      _targeter,
+                                      recordTargetErrors,
+                                      _stats.get(),
+                                      &childBatchesOwned,
+                                      &childBatches ) ) {
                 refreshedTargeter = true;
-                ++_stats->numTargetErrors;
-                dassert( childBatches.size() == 0u );
+                retargetInRound = false;
             }
 
             //
             // Send all child batches
             //
 
-            size_t numSent = 0;
-            size_t numToSend = childBatches.size();
-            bool remoteMetadataChanging = false;
-            while ( numSent != numToSend ) {
+            // Child batches out on the network, at most one per host
+            HostBatchMap pendingBatches;
 
-                // Collect batches out on the network, mapped by endpoint
-                OwnedHostBatchMap ownedPendingBatches;
-                OwnedHostBatchMap::MapType& pendingBatches = ownedPendingBatches.mutableMap();
+            bool remoteMetadataChanging = false;
+            bool targeterChanged = false;
+            while ( !childBatches.empty() || !pendingBatches.empty() ) {
 
                 //
                 // Send side
                 //
 
-                // Get as many batches as we can at once
-                for ( vector<TargetedWriteBatch*>::iterator it = childBatches.begin();
-                    it != childBatches.end(); ++it ) {
+                // Send every batch whose host isn't busy with an earlier one
+                for ( deque<TargetedWriteBatch*>::iterator it = childBatches.begin();
+                    it != childBatches.end(); ) {
 
                     //
                     // Collect the info needed to dispatch our targeted batch
                     //
 
                     TargetedWriteBatch* nextBatch = *it;
-                    // If the batch is NULL, we sent it previously, so skip
-                    if ( nextBatch == NULL ) continue;
 
                     // Figure out what host we need to dispatch our targeted batch
                     ConnectionString shardHost;
@@ -204,16 +238,15 @@ namespace mongo {
                         batchOp.noteBatchError( *nextBatch, error );
 
                         // We're done with this batch
-                        // Clean up when we can't resolve a host
-                        delete *it;
-                        *it = NULL;
-                        --numToSend;
+                        it = childBatches.erase( it );
                         continue;
                     }
 
-                    // If we already have a batch for this host, wait until the next time
-                    OwnedHostBatchMap::MapType::iterator pendingIt = pendingBatches.find( shardHost );
-                    if ( pendingIt != pendingBatches.end() ) continue;
+                    // If we already have a batch for this host, wait until it has responded
+                    if ( pendingBatches.find( shardHost ) != pendingBatches.end() ) {
+                        ++it;
+                        continue;
+                    }
 
                     //
                     // We now have all the info needed to dispatch the batch
@@ -232,85 +265,112 @@ namespace mongo {
 
                     _dispatcher->addCommand( shardHost, nss.db(), request );
 
-                    // Indicate we're done by setting the batch to NULL
-                    // We'll only get duplicate hostEndpoints if we have broadcast and non-broadcast
-                    // endpoints for the same host, so this should be pretty efficient without
-                    // moving stuff around.
-                    *it = NULL;
-
-                    // Recv-side is responsible for cleaning up the nextBatch when used
                     pendingBatches.insert( make_pair( shardHost, nextBatch ) );
+                    it = childBatches.erase( it );
                 }
 
                 // Send them all out
                 _dispatcher->sendAll();
-                numSent += pendingBatches.size();
+
+                if ( pendingBatches.empty() ) {
+                    dassert( childBatches.empty() );
+                    break;
+                }
 
                 //
                 // Recv side
                 //
 
-                while ( _dispatcher->numPending() > 0 ) {
-
-                    // Get the response
-                    ConnectionString shardHost;
-                    BatchedCommandResponse response;
-                    Status dispatchStatus = _dispatcher->recvAny( &shardHost, &response );
-
-                    // Get the TargetedWriteBatch to find where to put the response
-                    dassert( pendingBatches.find( shardHost ) != pendingBatches.end() );
-                    TargetedWriteBatch* batch = pendingBatches.find( shardHost )->second;
-
-                    if ( dispatchStatus.isOK() ) {
-
-                        TrackedErrors trackedErrors;
-                        trackedErrors.startTracking( ErrorCodes::StaleShardVersion );
-
-                        LOG( 4 ) << "write results received from " << shardHost.toString() << ": "
-                                 << response.toString() << endl;
-
-                        // Dispatch was ok, note response
-                        batchOp.noteBatchResponse( *batch, response, &trackedErrors );
+                // Get the first response to come back
+                ConnectionString shardHost;
+                BatchedCommandResponse response;
+                Status dispatchStatus = _dispatcher->recvAny( &shardHost, &response );
+
+                // Get the TargetedWriteBatch to find where to put the response
+                HostBatchMap::iterator pendingIt = pendingBatches.find( shardHost );
+                dassert( pendingIt != pendingBatches.end() );
+                TargetedWriteBatch* batch = pendingIt->second;
+                pendingBatches.erase( pendingIt );
+
+                if ( dispatchStatus.isOK() ) {
+
+                    TrackedErrors trackedErrors;
+                    trackedErrors.startTracking( ErrorCodes::StaleShardVersion );
+
+                    LOG( 4 ) << "write results received from " << shardHost.toString() << ": "
+                             << response.toString() << endl;
+
+                    // Dispatch was ok, note response
+                    batchOp.noteBatchResponse( *batch, response, &trackedErrors );
+
+                    // Note if anything was stale
+                    const vector<ShardError*>& staleErrors =
+                        trackedErrors.getErrors( ErrorCodes::StaleShardVersion );
+
+                    if ( staleErrors.size() > 0 ) {
+                        noteStaleResponses( staleErrors, _targeter );
+                        ++_stats->numStaleBatches;
+
+                        // Stale write ops are only worth retargeting before the round is over if
+                        // the targeter learned something from them, otherwise they would just go
+                        // back to the same place.
+                        if ( retargetInRound ) {
+                            bool wasChanged = false;
+                            Status refreshStatus = _targeter->refreshIfNeeded( &wasChanged );
+                            if ( refreshStatus.isOK() && wasChanged ) {
+                                targeterChanged = true;
+                            }
+                            else {
+                                retargetInRound = false;
+                            }
+                        }
+                    }
 
-                        // Note if anything was stale
-                        const vector<ShardError*>& staleErrors =
-                            trackedErrors.getErrors( ErrorCodes::StaleShardVersion );
+                    // Remember if the shard is actively changing metadata right now
+                    if ( isShardMetadataChanging( staleErrors ) ) {
+                        remoteMetadataChanging = true;
+                    }
 
-                        if ( staleErrors.size() > 0 ) {
-                            noteStaleResponses( staleErrors, _targeter );
-                            ++_stats->numStaleBatches;
-                        }
+                    // Remember that we successfully wrote to this shard
+                    // NOTE: This will record lastOps for shards where we actually didn't update
+                    // or delete any documents, which preserves old behavior but is conservative
+                    _stats->noteWriteAt( shardHost,
+                                         response.isLastOpSet() ? 
+                                         response.getLastOp() : Timestamp(),
+                                         response.isElectionIdSet() ?
+                                         response.getElectionId() : OID());
+                }
+                else {
 
-                        // Remember if the shard is actively changing metadata right now
-                        if ( isShardMetadataChanging( staleErrors ) ) {
-                            remoteMetadataChanging = true;
-                        }
+                    // Error occurred dispatching, note it
 
-                        // Remember that we successfully wrote to this shard
-                        // NOTE: This will record lastOps for shards where we actually didn't update
-                        // or delete any documents, which preserves old behavior but is conservative
-                        _stats->noteWriteAt( shardHost,
-                                             response.isLastOpSet() ? 
-                                             response.getLastOp() : Timestamp(),
-                                             response.isElectionIdSet() ?
-                                             response.getElectionId() : OID());
-                    }
-                    else {
+                    stringstream msg;
+                    msg << "write results unavailable from " << shardHost.toString()
+                        << causedBy( dispatchStatus.toString() );
 
-                        // Error occurred dispatching, note it
+                    WriteErrorDetail error;
+                    buildErrorFrom( Status( ErrorCodes::RemoteResultsUnavailable, msg.str() ),
+                                    &error );
 
-                        stringstream msg;
-                        msg << "write results unavailable from " << shardHost.toString()
-                            << causedBy( dispatchStatus.toString() );
+                    LOG( 4 ) << "unable to receive write results from " << shardHost.toString()
+                             << causedBy( dispatchStatus.toString() ) << endl;
 
-                        WriteErrorDetail error;
-                        buildErrorFrom( Status( ErrorCodes::RemoteResultsUnavailable, msg.str() ),
-                                        &error );
+                    batchOp.noteBatchError( *batch, error );
+                }
 
-                        LOG( 4 ) << "unable to receive write results from " << shardHost.toString()
-                                 << causedBy( dispatchStatus.toString() ) << endl;
+                //
+                // Target whatever is ready again, if we can
+                //
 
-                        batchOp.noteBatchError( *batch, error );
+                if ( retargetInRound && batchOp.numWriteOpsIn( WriteOpState_Ready ) > 0 ) {
+                    if ( !targetChildBatches( &batchOp,
+                                              _targeter,
+                                              refreshedTargeter,
+                                              _stats.get(),
+                                              &childBatchesOwned,
+                                              &childBatches ) ) {
+                        refreshedTargeter = true;
+                        retargetInRound = false;
                     }
                 }
             }
@@ -328,8 +388,8 @@ namespace mongo {
             // Refresh the targeter if we need to (no-op if nothing stale)
             //
 
-            bool targeterChanged = false;
-            Status refreshStatus = _targeter->refreshIfNeeded( &targeterChanged );
+            bool wasChanged = false;
+            Status refreshStatus = _targeter->refreshIfNeeded( &wasChanged );
 
             if ( !refreshStatus.isOK() ) {
 
@@ -339,6 +399,10 @@ namespace mongo {
                           << endl;
             }
 
+            if ( wasChanged ) {
+                targeterChanged = true;
+            }
+
             //
             // Ensure progress is being made toward completing the batch op
             //
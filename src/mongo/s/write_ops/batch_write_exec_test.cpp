@@ -152,6 +152,59 @@ namespace {
         ASSERT_EQUALS( stats.numRounds, 1 );
     }
 
+    TEST(BatchWriteExecTests, ManyOpsUnordered) {
+
+        //
+        // An unordered batch too big for one child batch is sent its next child batch as soon as
+        // the first one responds, in the same round
+        //
+
+        NamespaceString nss( "foo.bar" );
+
+        MockSingleShardBackend backend( nss );
+
+        BatchedCommandRequest request( BatchedCommandRequest::BatchType_Insert );
+        request.setNS( nss.ns() );
+        request.setOrdered( false );
+        request.setWriteConcern( BSONObj() );
+        for ( size_t i = 0; i < BatchedCommandRequest::kMaxWriteBatchSize + 1u; ++i ) {
+            request.getInsertRequest()->addToDocuments( BSON( "x" << static_cast<int>( i ) ) );
+        }
+
+        BatchedCommandResponse response;
+        backend.exec->executeBatch( request, &response );
+        ASSERT( response.getOk() );
+
+        const BatchWriteExecStats& stats = backend.exec->getStats();
+        ASSERT_EQUALS( stats.numRounds, 1 );
+    }
+
+    TEST(BatchWriteExecTests, ManyOpsOrdered) {
+
+        //
+        // An ordered batch too big for one child batch takes a round per child batch
+        //
+
+        NamespaceString nss( "foo.bar" );
+
+        MockSingleShardBackend backend( nss );
+
+        BatchedCommandRequest request( BatchedCommandRequest::BatchType_Insert );
+        request.setNS( nss.ns() );
+        request.setOrdered( true );
+        request.setWriteConcern( BSONObj() );
+        for ( size_t i = 0; i < BatchedCommandRequest::kMaxWriteBatchSize + 1u; ++i ) {
+            request.getInsertRequest()->addToDocuments( BSON( "x" << static_cast<int>( i ) ) );
+        }
+
+        BatchedCommandResponse response;
+        backend.exec->executeBatch( request, &response );
+        ASSERT( response.getOk() );
+
+        const BatchWriteExecStats& stats = backend.exec->getStats();
+        ASSERT_EQUALS( stats.numRounds, 2 );
+    }
+
     //
     // Test retryable errors
     //
@@ -365,6 +365,11 @@ namespace mongo {
             if (wouldMakeBatchesTooBig(writes, writeSizeBytes, batchSizes)) {
                 invariant(!batchMap.empty());
                 writeOp.cancelWrites(NULL);
+
+                // Unordered writes to other endpoints may still fit in their batches
+                if (!ordered)
+                    continue;
+
                 break;
             }
 
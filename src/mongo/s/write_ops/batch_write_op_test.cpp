@@ -1765,6 +1765,59 @@ namespace {
         ASSERT(batchOp.isFinished());
     }
 
+    TEST(WriteOpLimitTests, TooManyOpsOneEndpointUnordered) {
+
+        //
+        // Unordered batch of 1001 documents for one endpoint and one for another - the full batch
+        // should not hold back the other endpoint
+        //
+
+        NamespaceString nss("foo.bar");
+        ShardEndpoint endpointA("shardA", ChunkVersion::IGNORED());
+        ShardEndpoint endpointB("shardB", ChunkVersion::IGNORED());
+        MockNSTargeter targeter;
+        initTargeterSplitRange(nss, endpointA, endpointB, &targeter);
+
+        BatchedCommandRequest request(BatchedCommandRequest::BatchType_Insert);
+        request.setNS(nss.ns());
+        request.setOrdered(false);
+
+        for (size_t i = 0; i < BatchedCommandRequest::kMaxWriteBatchSize + 1u; ++i) {
+            request.getInsertRequest()->addToDocuments(BSON( "x" << -1 ));
+        }
+        request.getInsertRequest()->addToDocuments(BSON( "x" << 1 ));
+
+        BatchWriteOp batchOp;
+        batchOp.initClientRequest(&request);
+
+        OwnedPointerVector<TargetedWriteBatch> targetedOwned;
+        vector<TargetedWriteBatch*>& targeted = targetedOwned.mutableVector();
+        Status status = batchOp.targetBatch(targeter, false, &targeted);
+        ASSERT(status.isOK());
+        ASSERT_EQUALS(targeted.size(), 2u);
+        sortByEndpoint(&targeted);
+        ASSERT_EQUALS(targeted[0]->getWrites().size(), 1000u);
+        ASSERT_EQUALS(targeted[1]->getWrites().size(), 1u);
+        assertEndpointsEqual(targeted[1]->getEndpoint(), endpointB);
+
+        BatchedCommandResponse response;
+        buildResponse(1, &response);
+
+        batchOp.noteBatchResponse(*targeted[0], response, NULL);
+        batchOp.noteBatchResponse(*targeted[1], response, NULL);
+        ASSERT(!batchOp.isFinished());
+
+        targetedOwned.clear();
+        status = batchOp.targetBatch(targeter, false, &targeted);
+        ASSERT(status.isOK());
+        ASSERT_EQUALS(targeted.size(), 1u);
+        ASSERT_EQUALS(targeted.front()->getWrites().size(), 1u);
+        assertEndpointsEqual(targeted.front()->getEndpoint(), endpointA);
+
+        batchOp.noteBatchResponse(*targeted.front(), response, NULL);
+        ASSERT(batchOp.isFinished());
+    }
+
     TEST(WriteOpLimitTests, UpdateOverheadIncluded) {
 
         //
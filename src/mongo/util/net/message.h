@@ -67,6 +67,7 @@ namespace mongo {
         dbKillCursors = 2007,
         dbCommand = 2008,
         dbCommandReply = 2009,
+        dbCompressed = 2012, /* another message, compressed. see message_compressor.h */
     };
 
     bool doesOpGetAResponse( int op );
@@ -84,6 +85,7 @@ namespace mongo {
         case dbKillCursors: return "killcursors";
         case dbCommand: return "command";
         case dbCommandReply: return "commandReply";
+        case dbCompressed: return "compressed";
         default:
             massert( 16141, str::stream() << "cannot translate opcode " << op, !op );
             return "";
@@ -0,0 +1,327 @@
+/*    Copyright 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/net/message_compressor.h"
+
+#include <snappy.h>
+#include <zlib.h>
+
+#include "mongo/base/data_view.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/server_options.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/net/message.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+namespace {
+
+    const char kCompressionFieldName[] = "compression";
+
+    const int kOriginalOpCodeOffset = 0;
+    const int kUncompressedSizeOffset = kOriginalOpCodeOffset + sizeof(int32_t);
+    const int kCompressorIdOffset = kUncompressedSizeOffset + sizeof(int32_t);
+    const int kCompressedHeaderSize = kCompressorIdOffset + sizeof(uint8_t);
+
+    struct CompressorStats {
+        AtomicInt64 compressorBytesIn;
+        AtomicInt64 compressorBytesOut;
+        AtomicInt64 decompressorBytesIn;
+        AtomicInt64 decompressorBytesOut;
+    };
+
+    const MessageCompressor kAllCompressors[] = {
+        MessageCompressor::kSnappy,
+        MessageCompressor::kZlib,
+    };
+
+    CompressorStats compressorStats[3];
+
+    CompressorStats& statsFor(MessageCompressor compressor) {
+        return compressorStats[static_cast<uint8_t>(compressor)];
+    }
+
+    /**
+     * Returns the compressors enabled for this process, in order of preference.
+     */
+    std::vector<MessageCompressor> getEnabledCompressors() {
+        std::vector<MessageCompressor> compressors;
+        for (const auto& name : serverGlobalParams.networkMessageCompressors) {
+            StatusWith<MessageCompressor> compressor = parseMessageCompressor(name);
+            if (compressor.isOK()) {
+                compressors.push_back(compressor.getValue());
+            }
+        }
+        return compressors;
+    }
+
+}  // namespace
+
+    StringData getMessageCompressorName(MessageCompressor compressor) {
+        switch (compressor) {
+        case MessageCompressor::kNoop: return "noop";
+        case MessageCompressor::kSnappy: return "snappy";
+        case MessageCompressor::kZlib: return "zlib";
+        }
+        return "unknown";
+    }
+
+    StatusWith<MessageCompressor> parseMessageCompressor(StringData name) {
+        for (MessageCompressor compressor : kAllCompressors) {
+            if (name == getMessageCompressorName(compressor)) {
+                return StatusWith<MessageCompressor>(compressor);
+            }
+        }
+        return StatusWith<MessageCompressor>(ErrorCodes::BadValue,
+                                             str::stream() << "unknown network message "
+                                                           << "compressor: " << name);
+    }
+
+    Status compressMessage(MessageCompressor compressor,
+                           const Message& source,
+                           Message* compressed) {
+        const MsgData::View sourceData = source.singleData();
+        const char* input = sourceData.data();
+        const size_t inputLen = sourceData.dataLen();
+
+        size_t maxCompressedLen;
+        switch (compressor) {
+        case MessageCompressor::kSnappy:
+            maxCompressedLen = snappy::MaxCompressedLength(inputLen);
+            break;
+        case MessageCompressor::kZlib:
+            maxCompressedLen = ::compressBound(inputLen);
+            break;
+        default:
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "cannot compress a message with "
+                                        << getMessageCompressorName(compressor));
+        }
+
+        const size_t bufferLen = MsgData::MsgDataHeaderSize + kCompressedHeaderSize
+                                     + maxCompressedLen;
+        MsgData::View out = reinterpret_cast<char*>(mongoMalloc(bufferLen));
+        ScopeGuard guard = MakeGuard(free, out.view2ptr());
+
+        char* outBody = out.data() + kCompressedHeaderSize;
+        size_t compressedLen = maxCompressedLen;
+        if (compressor == MessageCompressor::kSnappy) {
+            snappy::RawCompress(input, inputLen, outBody, &compressedLen);
+        }
+        else {
+            uLongf zlibLen = maxCompressedLen;
+            int ret = ::compress(reinterpret_cast<Bytef*>(outBody), &zlibLen,
+                                 reinterpret_cast<const Bytef*>(input), inputLen);
+            if (ret != Z_OK) {
+                return Status(ErrorCodes::InternalError,
+                              str::stream() << "zlib failed to compress message: " << ret);
+            }
+            compressedLen = zlibLen;
+        }
+
+        out.setLen(MsgData::MsgDataHeaderSize + kCompressedHeaderSize + compressedLen);
+        out.setId(sourceData.getId());
+        out.setResponseTo(sourceData.getResponseTo());
+        out.setOperation(dbCompressed);
+
+        DataView compressedHeader(out.data());
+        compressedHeader.write(tagLittleEndian<int32_t>(sourceData.getOperation()),
+                               kOriginalOpCodeOffset);
+        compressedHeader.write(tagLittleEndian<int32_t>(inputLen), kUncompressedSizeOffset);
+        compressedHeader.write(static_cast<uint8_t>(compressor), kCompressorIdOffset);
+
+        guard.Dismiss();
+        compressed->reset();
+        compressed->setData(out.view2ptr(), true);
+
+        CompressorStats& stats = statsFor(compressor);
+        stats.compressorBytesIn.addAndFetch(inputLen);
+        stats.compressorBytesOut.addAndFetch(compressedLen);
+
+        return Status::OK();
+    }
+
+    Status decompressMessage(const Message& compressed,
+                             Message* decompressed,
+                             MessageCompressor* compressorUsed) {
+        const MsgData::View in = compressed.singleData();
+        invariant(in.getOperation() == dbCompressed);
+
+        if (in.dataLen() < kCompressedHeaderSize) {
+            return Status(ErrorCodes::BadValue, "compressed message is too short");
+        }
+
+        ConstDataView compressedHeader(in.data());
+        const int32_t originalOpCode =
+            compressedHeader.read<LittleEndian<int32_t>>(kOriginalOpCodeOffset);
+        const int32_t uncompressedLen =
+            compressedHeader.read<LittleEndian<int32_t>>(kUncompressedSizeOffset);
+        const MessageCompressor compressor =
+            static_cast<MessageCompressor>(compressedHeader.read<uint8_t>(kCompressorIdOffset));
+
+        if (uncompressedLen < 0 ||
+            static_cast<size_t>(uncompressedLen) + MsgData::MsgDataHeaderSize >
+                MaxMessageSizeBytes) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "invalid uncompressed message length "
+                                        << uncompressedLen);
+        }
+
+        const char* input = in.data() + kCompressedHeaderSize;
+        const size_t inputLen = in.dataLen() - kCompressedHeaderSize;
+
+        const size_t bufferLen = MsgData::MsgDataHeaderSize + uncompressedLen;
+        MsgData::View out = reinterpret_cast<char*>(mongoMalloc(bufferLen));
+        ScopeGuard guard = MakeGuard(free, out.view2ptr());
+
+        switch (compressor) {
+        case MessageCompressor::kSnappy: {
+            size_t actualLen;
+            if (!snappy::GetUncompressedLength(input, inputLen, &actualLen) ||
+                actualLen != static_cast<size_t>(uncompressedLen) ||
+                !snappy::RawUncompress(input, inputLen, out.data())) {
+                return Status(ErrorCodes::BadValue, "invalid snappy compressed message");
+            }
+            break;
+        }
+        case MessageCompressor::kZlib: {
+            uLongf actualLen = uncompressedLen;
+            int ret = ::uncompress(reinterpret_cast<Bytef*>(out.data()), &actualLen,
+                                   reinterpret_cast<const Bytef*>(input), inputLen);
+            if (ret != Z_OK || actualLen != static_cast<uLongf>(uncompressedLen)) {
+                return Status(ErrorCodes::BadValue,
+                              str::stream() << "invalid zlib compressed message: " << ret);
+            }
+            break;
+        }
+        default:
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "unknown message compressor id "
+                                        << static_cast<int>(compressor));
+        }
+
+        out.setLen(bufferLen);
+        out.setId(in.getId());
+        out.setResponseTo(in.getResponseTo());
+        out.setOperation(originalOpCode);
+
+        guard.Dismiss();
+        decompressed->reset();
+        decompressed->setData(out.view2ptr(), true);
+
+        if (compressorUsed) {
+            *compressorUsed = compressor;
+        }
+
+        CompressorStats& stats = statsFor(compressor);
+        stats.decompressorBytesIn.addAndFetch(inputLen);
+        stats.decompressorBytesOut.addAndFetch(uncompressedLen);
+
+        return Status::OK();
+    }
+
+    void appendRequestedCompressors(BSONObjBuilder* isMasterCmd) {
+        const std::vector<MessageCompressor> enabled = getEnabledCompressors();
+        if (enabled.empty()) {
+            return;
+        }
+
+        BSONArrayBuilder arr(isMasterCmd->subarrayStart(kCompressionFieldName));
+        for (MessageCompressor compressor : enabled) {
+            arr.append(getMessageCompressorName(compressor));
+        }
+        arr.doneFast();
+    }
+
+    void appendNegotiatedCompressors(const BSONObj& isMasterCmd, BSONObjBuilder* result) {
+        BSONElement requested = isMasterCmd[kCompressionFieldName];
+        if (requested.type() != Array) {
+            return;
+        }
+
+        const std::vector<MessageCompressor> enabled = getEnabledCompressors();
+
+        BSONArrayBuilder arr(result->subarrayStart(kCompressionFieldName));
+        BSONForEach(elem, requested.Obj()) {
+            if (elem.type() != String) {
+                continue;
+            }
+
+            StatusWith<MessageCompressor> compressor = parseMessageCompressor(elem.valueStringData());
+            if (compressor.isOK() &&
+                std::find(enabled.begin(), enabled.end(), compressor.getValue()) != enabled.end()) {
+                arr.append(elem.valueStringData());
+            }
+        }
+        arr.doneFast();
+    }
+
+    MessageCompressor getNegotiatedCompressor(const BSONObj& isMasterReply) {
+        BSONElement agreed = isMasterReply[kCompressionFieldName];
+        if (agreed.type() != Array) {
+            return MessageCompressor::kNoop;
+        }
+
+        BSONForEach(elem, agreed.Obj()) {
+            if (elem.type() != String) {
+                continue;
+            }
+
+            StatusWith<MessageCompressor> compressor = parseMessageCompressor(elem.valueStringData());
+            if (compressor.isOK()) {
+                return compressor.getValue();
+            }
+        }
+
+        return MessageCompressor::kNoop;
+    }
+
+    void appendMessageCompressionStats(BSONObjBuilder* b) {
+        BSONObjBuilder compression(b->subobjStart(kCompressionFieldName));
+        for (MessageCompressor compressor : kAllCompressors) {
+            const CompressorStats& stats = statsFor(compressor);
+
+            BSONObjBuilder compressorBuilder(
+                compression.subobjStart(getMessageCompressorName(compressor)));
+            {
+                BSONObjBuilder sub(compressorBuilder.subobjStart("compressor"));
+                sub.appendNumber("bytesIn", stats.compressorBytesIn.load());
+                sub.appendNumber("bytesOut", stats.compressorBytesOut.load());
+            }
+            {
+                BSONObjBuilder sub(compressorBuilder.subobjStart("decompressor"));
+                sub.appendNumber("bytesIn", stats.decompressorBytesIn.load());
+                sub.appendNumber("bytesOut", stats.decompressorBytesOut.load());
+            }
+        }
+    }
+
+}  // namespace mongo
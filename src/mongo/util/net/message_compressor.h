@@ -0,0 +1,122 @@
+/*    Copyright 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "mongo/base/status.h"
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+#include "mongo/platform/cstdint.h"
+
+namespace mongo {
+
+    class BSONObj;
+    class BSONObjBuilder;
+    class Message;
+
+    /**
+     * Compression algorithms which may be used for the body of a dbCompressed message.
+     *
+     * A dbCompressed message is laid out as:
+     *     MSGHEADER          header (opCode is dbCompressed)
+     *     int32              opCode of the original message
+     *     int32              length of the original message, excluding its header
+     *     uint8              MessageCompressor used
+     *     char[]             compressed body of the original message
+     *
+     * The numeric values go over the wire and must not change.
+     */
+    enum class MessageCompressor : uint8_t {
+        kNoop = 0,
+        kSnappy = 1,
+        kZlib = 2,
+    };
+
+    /**
+     * Name under which a compressor is negotiated and reported, e.g. "snappy".
+     */
+    StringData getMessageCompressorName(MessageCompressor compressor);
+
+    /**
+     * Parses a compressor name as returned by getMessageCompressorName.
+     */
+    StatusWith<MessageCompressor> parseMessageCompressor(StringData name);
+
+    /**
+     * Compresses "source", which must consist of a single buffer, into a new dbCompressed
+     * message "compressed". The request id and responseTo of "source" are preserved.
+     */
+    Status compressMessage(MessageCompressor compressor,
+                           const Message& source,
+                           Message* compressed);
+
+    /**
+     * Reverses compressMessage. "compressed" must be a dbCompressed message. Returns the
+     * compressor which had been used through "compressorUsed", if not NULL.
+     */
+    Status decompressMessage(const Message& compressed,
+                             Message* decompressed,
+                             MessageCompressor* compressorUsed);
+
+    /**
+     * Compression is negotiated by the connecting side listing the compressors it is willing
+     * to use, in order of preference, in the "compression" array of its isMaster command. The
+     * server answers with the subset of those which it also has enabled, preserving their
+     * order, and the client compresses its requests with the first of them. A server compresses
+     * a reply if and only if the request it answers was compressed, using the same compressor.
+     *
+     * The compressors a process is willing to use are given by
+     * serverGlobalParams.networkMessageCompressors.
+     */
+
+    /**
+     * Adds the "compression" field to an isMaster command about to be sent, if any compressors
+     * are enabled.
+     */
+    void appendRequestedCompressors(BSONObjBuilder* isMasterCmd);
+
+    /**
+     * Adds the "compression" field to the reply to the isMaster command "isMasterCmd".
+     */
+    void appendNegotiatedCompressors(const BSONObj& isMasterCmd, BSONObjBuilder* result);
+
+    /**
+     * Returns the compressor the client should use given the server's reply to isMaster, or
+     * kNoop if none was agreed upon.
+     */
+    MessageCompressor getNegotiatedCompressor(const BSONObj& isMasterReply);
+
+    /**
+     * Appends the number of bytes which went into and came out of each compressor and
+     * decompressor since startup.
+     */
+    void appendMessageCompressionStats(BSONObjBuilder* b);
+
+}  // namespace mongo
@@ -0,0 +1,134 @@
+/*    Copyright 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/server_options.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/net/message.h"
+#include "mongo/util/net/message_compressor.h"
+
+namespace mongo {
+namespace {
+
+    void makeQueryMessage(Message* m) {
+        std::string body(10000, 'x');
+        BSONObj doc = BSON("payload" << body);
+        m->setData(dbQuery, doc.objdata(), doc.objsize());
+        m->header().setId(42);
+        m->header().setResponseTo(7);
+    }
+
+    void checkRoundTrip(MessageCompressor compressor) {
+        Message original;
+        makeQueryMessage(&original);
+
+        Message compressed;
+        ASSERT_OK(compressMessage(compressor, original, &compressed));
+        ASSERT_EQUALS(dbCompressed, compressed.operation());
+        ASSERT_EQUALS(42, compressed.header().getId());
+        ASSERT_EQUALS(7, compressed.header().getResponseTo());
+        ASSERT_LESS_THAN(compressed.size(), original.size());
+
+        Message decompressed;
+        MessageCompressor used = MessageCompressor::kNoop;
+        ASSERT_OK(decompressMessage(compressed, &decompressed, &used));
+        ASSERT(used == compressor);
+        ASSERT_EQUALS(dbQuery, decompressed.operation());
+        ASSERT_EQUALS(42, decompressed.header().getId());
+        ASSERT_EQUALS(7, decompressed.header().getResponseTo());
+        ASSERT_EQUALS(original.size(), decompressed.size());
+        ASSERT_EQUALS(0, memcmp(original.singleData().data(),
+                                decompressed.singleData().data(),
+                                original.dataSize()));
+    }
+
+    TEST(MessageCompressor, SnappyRoundTrip) {
+        checkRoundTrip(MessageCompressor::kSnappy);
+    }
+
+    TEST(MessageCompressor, ZlibRoundTrip) {
+        checkRoundTrip(MessageCompressor::kZlib);
+    }
+
+    TEST(MessageCompressor, ParseNames) {
+        ASSERT(parseMessageCompressor("snappy").getValue() == MessageCompressor::kSnappy);
+        ASSERT(parseMessageCompressor("zlib").getValue() == MessageCompressor::kZlib);
+        ASSERT_EQUALS(ErrorCodes::BadValue, parseMessageCompressor("lz4").getStatus().code());
+        ASSERT_EQUALS(ErrorCodes::BadValue, parseMessageCompressor("noop").getStatus().code());
+    }
+
+    TEST(MessageCompressor, RejectsCorruptBody) {
+        Message original;
+        makeQueryMessage(&original);
+
+        Message compressed;
+        ASSERT_OK(compressMessage(MessageCompressor::kSnappy, original, &compressed));
+
+        // Claim a different uncompressed size than the payload really has.
+        DataView(compressed.singleData().data()).write(tagLittleEndian<int32_t>(10),
+                                                       sizeof(int32_t));
+
+        Message decompressed;
+        ASSERT_NOT_OK(decompressMessage(compressed, &decompressed, NULL));
+    }
+
+    TEST(MessageCompressor, NegotiationKeepsClientOrder) {
+        serverGlobalParams.networkMessageCompressors = {"snappy", "zlib"};
+
+        BSONObj cmd = BSON("isMaster" << 1 << "compression" << BSON_ARRAY("zlib" << "lz4"
+                                                                          << "snappy"));
+        BSONObjBuilder reply;
+        appendNegotiatedCompressors(cmd, &reply);
+        BSONObj replyObj = reply.obj();
+        ASSERT_EQUALS(BSON("compression" << BSON_ARRAY("zlib" << "snappy")), replyObj);
+        ASSERT(getNegotiatedCompressor(replyObj) == MessageCompressor::kZlib);
+
+        serverGlobalParams.networkMessageCompressors.clear();
+    }
+
+    TEST(MessageCompressor, NoNegotiationWhenDisabled) {
+        serverGlobalParams.networkMessageCompressors.clear();
+
+        BSONObjBuilder cmd;
+        cmd.append("isMaster", 1);
+        appendRequestedCompressors(&cmd);
+        ASSERT_EQUALS(BSON("isMaster" << 1), cmd.obj());
+
+        BSONObjBuilder reply;
+        appendNegotiatedCompressors(BSON("isMaster" << 1 << "compression"
+                                                    << BSON_ARRAY("snappy")),
+                                    &reply);
+        BSONObj replyObj = reply.obj();
+        ASSERT(getNegotiatedCompressor(replyObj) == MessageCompressor::kNoop);
+    }
+
+}  // namespace
+}  // namespace mongo
@@ -144,18 +144,24 @@ namespace mongo {
     }
 
     MessagingPort::MessagingPort(int fd, const SockAddr& remote) 
-        : psock( new Socket( fd , remote ) ) , piggyBackData(0) {
+        : psock( new Socket( fd , remote ) ) , piggyBackData(0),
+          _compressor(MessageCompressor::kNoop),
+          _lastRecvCompressor(MessageCompressor::kNoop) {
         ports.insert(this);
     }
 
     MessagingPort::MessagingPort( double timeout, logger::LogSeverity ll ) 
-        : psock( new Socket( timeout, ll ) ) {
+        : psock( new Socket( timeout, ll ) ),
+          _compressor(MessageCompressor::kNoop),
+          _lastRecvCompressor(MessageCompressor::kNoop) {
         ports.insert(this);
         piggyBackData = 0;
     }
 
     MessagingPort::MessagingPort( boost::shared_ptr<Socket> sock )
-        : psock( sock ), piggyBackData( 0 ) {
+        : psock( sock ), piggyBackData( 0 ),
+          _compressor(MessageCompressor::kNoop),
+          _lastRecvCompressor(MessageCompressor::kNoop) {
         ports.insert(this);
     }
 
@@ -244,6 +250,16 @@ again:
 
             guard.Dismiss();
             m.setData(md.view2ptr(), true);
+
+            if (m.operation() == dbCompressed) {
+                Message decompressed;
+                uassertStatusOK(decompressMessage(m, &decompressed, &_lastRecvCompressor));
+                m.reset();
+                m = decompressed;
+            }
+            else {
+                _lastRecvCompressor = MessageCompressor::kNoop;
+            }
             return true;
 
         }
@@ -258,11 +274,11 @@ again:
     }
 
     void MessagingPort::reply(Message& received, Message& response) {
-        say(/*received.from, */response, received.header().getId());
+        _say(/*received.from, */response, received.header().getId(), _lastRecvCompressor);
     }
 
     void MessagingPort::reply(Message& received, Message& response, MSGID responseTo) {
-        say(/*received.from, */response, responseTo);
+        _say(/*received.from, */response, responseTo, _lastRecvCompressor);
     }
 
     bool MessagingPort::call(Message& toSend, Message& response) {
@@ -298,11 +314,28 @@ again:
     }
 
     void MessagingPort::say(Message& toSend, int responseTo) {
+        _say(toSend, responseTo, _compressor);
+    }
+
+    void MessagingPort::_say(Message& toSend, int responseTo, MessageCompressor compressor) {
         verify( !toSend.empty() );
         mmm( log() << "*  say()  thr:" << GetCurrentThreadId() << endl; )
         toSend.header().setId(nextMessageId());
         toSend.header().setResponseTo(responseTo);
 
+        if (compressor != MessageCompressor::kNoop) {
+            // Compress a copy, since callers may still look at the message they sent.
+            toSend.concat();
+            Message compressed;
+            uassertStatusOK(compressMessage(compressor, toSend, &compressed));
+
+            if ( piggyBackData && piggyBackData->len() ) {
+                piggyBackData->flush();
+            }
+            compressed.send( *this, "say" );
+            return;
+        }
+
         if ( piggyBackData && piggyBackData->len() ) {
             mmm( log() << "*     have piggy back" << endl; )
             if ( ( piggyBackData->len() + toSend.header().getLen() ) > 1300 ) {
@@ -35,6 +35,7 @@
 
 #include "mongo/config.h"
 #include "mongo/util/net/message.h"
+#include "mongo/util/net/message_compressor.h"
 #include "mongo/util/net/sock.h"
 
 namespace mongo {
@@ -154,10 +155,23 @@ namespace mongo {
             return psock->getSockCreationMicroSec();
         }
 
+        /**
+         * Sets the compressor used for messages sent with say() and call(), as negotiated
+         * through isMaster. Replies always use the compressor of the last message received.
+         */
+        void setCompressor(MessageCompressor compressor) { _compressor = compressor; }
+        MessageCompressor getCompressor() const { return _compressor; }
+
     private:
+        void _say(Message& toSend, int responseTo, MessageCompressor compressor);
         
         PiggyBackData * piggyBackData;
 
+        MessageCompressor _compressor;
+
+        // Compressor which was used by the last message received, so replies can match it.
+        MessageCompressor _lastRecvCompressor;
+
         // this is the parsed version of remote
         // mutable because its initialized only on call to remote()
         mutable HostAndPort _remoteParsed; 
@@ -69,6 +69,14 @@ namespace mongo {
         virtual void setupSockets() = 0;
     };
 
-    // TODO use a factory here to decide between port and asio variations
+    /**
+     * Creates the message server selected by serverGlobalParams.transportMode: either one
+     * which dedicates a thread to every connection, or an asio based one which services all
+     * connections from a fixed number of threads.
+     */
     MessageServer * createServer( const MessageServer::Options& opts , MessageHandler * handler );
+
+#ifndef _WIN32
+    MessageServer* createAsioServer(const MessageServer::Options& opts, MessageHandler* handler);
+#endif
 }
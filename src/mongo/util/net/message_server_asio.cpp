@@ -0,0 +1,362 @@
+// message_server_asio.cpp
+
+/*    Copyright 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kNetwork
+
+#include "mongo/platform/basic.h"
+
+#ifndef _WIN32
+
+#include <asio.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/client.h"
+#include "mongo/db/server_options.h"
+#include "mongo/db/stats/counters.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/concurrency/synchronization.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/exit.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/net/listen.h"
+#include "mongo/util/net/message.h"
+#include "mongo/util/net/message_port.h"
+#include "mongo/util/net/message_server.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+namespace {
+
+    /**
+     * A client connection serviced by the AsioMessageServer.
+     *
+     * A connection is only ever touched by one thread at a time: either an I/O thread waiting
+     * for the socket to become readable, or a worker thread running the connection's next
+     * request. The connection's Client is detached from the worker between requests and kept
+     * here, so that thread-local state follows the connection rather than the thread.
+     */
+    class AsioConnection {
+        MONGO_DISALLOW_COPYING(AsioConnection);
+
+    public:
+        AsioConnection(asio::io_service& ioService,
+                       const boost::shared_ptr<Socket>& socket,
+                       MessageHandler* handler,
+                       long long connectionId)
+            : port(socket),
+              descriptor(ioService, socket->rawFD()),
+              handler(handler) {
+            port.setConnectionId(connectionId);
+            port.psock->setLogLevel(logger::LogSeverity::Debug(1));
+        }
+
+        ~AsioConnection() {
+            // The socket is owned by the port, so make sure asio does not close it.
+            descriptor.release();
+            Listener::globalTicketHolder.release();
+        }
+
+        MessagingPort port;
+        asio::posix::stream_descriptor descriptor;
+
+        // Not owned.
+        MessageHandler* const handler;
+
+        // Set while no worker thread is running a request for this connection.
+        ServiceContext::UniqueClient client;
+
+        int64_t messageCount = 0;
+    };
+
+    typedef boost::shared_ptr<AsioConnection> AsioConnectionPtr;
+
+    /**
+     * Message server which multiplexes all of its connections over a small number of I/O
+     * threads, and runs each request that arrives on a pool of worker threads. Idle connections
+     * therefore cost a file descriptor and a few hundred bytes instead of a thread.
+     *
+     * Workers block for as long as it takes to receive a request, which is up to a slow client,
+     * and to run it, which for tailable and exhaust cursors or lock waits can be indefinitely.
+     * So that such connections cannot exhaust the pool and stall every other one, a request which
+     * arrives while all the workers are busy gets a thread of its own instead. At worst every
+     * busy connection has a thread, as with the thread-per-connection server.
+     *
+     * The MessageHandler contract is unchanged: connected() is called once per connection
+     * before any call to process(), and calls for one connection never overlap.
+     */
+    class AsioMessageServer : public MessageServer, public Listener {
+    public:
+        /**
+         * @param handler the handler to use. Caller is responsible for managing this object
+         *     and should make sure that it lives longer than this server.
+         */
+        AsioMessageServer(const MessageServer::Options& opts,
+                          MessageHandler* handler,
+                          int ioThreads,
+                          int workerThreads)
+            : Listener("", opts.ipList, opts.port),
+              _handler(handler),
+              _work(_ioService),
+              _ioThreads(ioThreads),
+              _workerThreads(workerThreads),
+              _workers(ThreadPool::DoNotStartThreadsTag(), workerThreads, "connWorker") {
+        }
+
+        virtual void accepted(boost::shared_ptr<Socket> psocket, long long connectionId) {
+            if (!Listener::globalTicketHolder.tryAcquire()) {
+                log() << "connection refused because too many open connections: "
+                      << Listener::globalTicketHolder.used();
+                return;
+            }
+
+            AsioConnectionPtr conn;
+            try {
+                conn.reset(new AsioConnection(_ioService, psocket, _handler, connectionId));
+            }
+            catch (const std::exception& e) {
+                Listener::globalTicketHolder.release();
+                log() << "error registering new socket, closing connection: " << e.what();
+                return;
+            }
+
+            _schedule(&AsioMessageServer::_startConnection, conn);
+        }
+
+        virtual void setAsTimeTracker() {
+            Listener::setAsTimeTracker();
+        }
+
+        virtual void setupSockets() {
+            Listener::setupSockets();
+        }
+
+        void run() {
+            log() << "servicing connections asynchronously with " << _ioThreads
+                  << " I/O threads and a pool of worker threads";
+
+            _workers.startThreads();
+            for (int i = 0; i < _ioThreads; ++i) {
+                _ioThreadGroup.create_thread(stdx::bind(&AsioMessageServer::_runIOThread,
+                                                        this,
+                                                        i));
+            }
+
+            initAndListen();
+        }
+
+        virtual bool useUnixSockets() const { return true; }
+
+    private:
+        typedef void (AsioMessageServer::*ConnectionTask)(const AsioConnectionPtr&);
+
+        void _runIOThread(int threadNumber) {
+            setThreadName(std::string(str::stream() << "connIO" << threadNumber));
+            _ioService.run();
+        }
+
+        /**
+         * Runs "task" for "conn" on a worker if one is free, and on a new thread otherwise.
+         */
+        void _schedule(ConnectionTask task, const AsioConnectionPtr& conn) {
+            if (_busyWorkers.addAndFetch(1) <= _workerThreads) {
+                _workers.schedule(&AsioMessageServer::_runOnWorker, this, task, conn);
+                return;
+            }
+            _busyWorkers.subtractAndFetch(1);
+
+            try {
+                boost::thread(stdx::bind(task, this, conn)).detach();
+            }
+            catch (const boost::thread_resource_error&) {
+                log() << "can't create new thread, closing connection";
+                conn->port.shutdown();
+            }
+        }
+
+        void _runOnWorker(ConnectionTask task, const AsioConnectionPtr& conn) {
+            ON_BLOCK_EXIT([this] { _busyWorkers.subtractAndFetch(1); });
+            (this->*task)(conn);
+        }
+
+        /**
+         * Runs on a worker thread. Announces the new connection to the handler and then waits
+         * for its first request.
+         */
+        void _startConnection(const AsioConnectionPtr& conn) {
+            setThreadName(std::string(str::stream() << "conn" << conn->port.connectionId()));
+
+            try {
+                conn->handler->connected(&conn->port);
+            }
+            catch (const DBException& e) {
+                log() << "DBException accepting connection, closing client connection: " << e;
+                conn->port.shutdown();
+                conn->client = Client::releaseCurrent();
+                return;
+            }
+
+            conn->client = Client::releaseCurrent();
+            _awaitRequest(conn);
+        }
+
+        /**
+         * Arranges for the next request on "conn" to be run on a worker thread once it arrives.
+         */
+        void _awaitRequest(const AsioConnectionPtr& conn) {
+            // Data already decrypted by SSL will not show up as readiness on the socket.
+            if (conn->port.psock->hasBufferedInput()) {
+                _schedule(&AsioMessageServer::_handleRequest, conn);
+                return;
+            }
+
+            conn->descriptor.async_wait(
+                asio::posix::descriptor_base::wait_read,
+                [this, conn](const std::error_code& ec) {
+                    if (ec) {
+                        log() << "error waiting for request, closing client connection: "
+                              << ec.message();
+                        conn->port.shutdown();
+                        return;
+                    }
+                    _schedule(&AsioMessageServer::_handleRequest, conn);
+                });
+        }
+
+        /**
+         * Runs on a worker thread once the socket for "conn" is readable.
+         */
+        void _handleRequest(const AsioConnectionPtr& conn) {
+            if (conn->client) {
+                Client::setCurrent(std::move(conn->client));
+            }
+            else {
+                setThreadName(std::string(str::stream() << "conn" << conn->port.connectionId()));
+            }
+
+            const bool keepOpen = _processMessage(conn.get());
+            conn->client = Client::releaseCurrent();
+
+            if (keepOpen) {
+                _awaitRequest(conn);
+            }
+        }
+
+        /**
+         * Receives and processes one message. Returns false if the connection was closed.
+         */
+        static bool _processMessage(AsioConnection* conn) {
+            if (inShutdown()) {
+                conn->port.shutdown();
+                return false;
+            }
+
+            Message m;
+            try {
+                conn->port.psock->clearCounters();
+
+                if (!conn->port.recv(m)) {
+                    if (!serverGlobalParams.quiet) {
+                        int conns = Listener::globalTicketHolder.used() - 1;
+                        const char* word = (conns == 1 ? " connection" : " connections");
+                        log() << "end connection " << conn->port.psock->remoteString()
+                              << " (" << conns << word << " now open)";
+                    }
+                    conn->port.shutdown();
+                    return false;
+                }
+
+                conn->handler->process(m, &conn->port);
+                networkCounter.hit(conn->port.psock->getBytesIn(),
+                                   conn->port.psock->getBytesOut());
+
+                // Occasionally we want to see if we're using too much memory.
+                if ((conn->messageCount++ & 0xf) == 0) {
+                    markThreadIdle();
+                }
+
+                return true;
+            }
+            catch (AssertionException& e) {
+                log() << "AssertionException handling request, closing client connection: " << e;
+            }
+            catch (SocketException& e) {
+                log() << "SocketException handling request, closing client connection: " << e;
+            }
+            catch (const DBException& e) { // must be right above std::exception to avoid catching subclasses
+                log() << "DBException handling request, closing client connection: " << e;
+            }
+            catch (std::exception& e) {
+                error() << "Uncaught std::exception: " << e.what() << ", terminating";
+                dbexit(EXIT_UNCAUGHT);
+            }
+
+            conn->port.shutdown();
+            return false;
+        }
+
+        MessageHandler* _handler;
+
+        asio::io_service _ioService;
+
+        // Keeps the I/O threads running while there are no connections to wait on.
+        asio::io_service::work _work;
+
+        const int _ioThreads;
+        boost::thread_group _ioThreadGroup;
+
+        // Number of workers in the pool, and how many of them are running or about to run a task.
+        const int _workerThreads;
+        AtomicInt32 _busyWorkers;
+
+        ThreadPool _workers;
+    };
+
+}  // namespace
+
+    MessageServer* createAsioServer(const MessageServer::Options& opts,
+                                    MessageHandler* handler) {
+        int workerThreads = serverGlobalParams.asyncWorkerThreads;
+        if (workerThreads == 0) {
+            // Requests block on locks and disk, so size the pool well beyond the core count.
+            workerThreads = std::max(16, 4 * static_cast<int>(boost::thread::hardware_concurrency()));
+        }
+
+        return new AsioMessageServer(opts, handler, serverGlobalParams.asyncIOThreads,
+                                     workerThreads);
+    }
+
+}  // namespace mongo
+
+#endif  // _WIN32
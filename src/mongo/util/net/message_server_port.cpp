@@ -264,6 +264,14 @@ namespace {
 
 
     MessageServer * createServer( const MessageServer::Options& opts , MessageHandler * handler ) {
+        if (serverGlobalParams.transportMode == ServerGlobalParams::kTransportAsynchronous) {
+#ifndef _WIN32
+            return createAsioServer(opts, handler);
+#else
+            warning() << "asynchronous transportMode is not supported on Windows, "
+                      << "using a thread per connection";
+#endif
+        }
         return new PortMessageServer( opts , handler );
     }
 
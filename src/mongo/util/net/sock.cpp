@@ -846,6 +846,17 @@ namespace mongo {
     // -1 : never check
     const int Socket::errorPollIntervalSecs( 5 );
 
+    // SSL reads whole records, so a readiness poll of the descriptor can miss input which has
+    // already been decrypted into the SSL connection's buffer.
+    bool Socket::hasBufferedInput() const {
+#ifdef MONGO_CONFIG_SSL
+        if (_sslConnection.get()) {
+            return ::SSL_pending(_sslConnection->ssl) > 0;
+        }
+#endif
+        return false;
+    }
+
     // Patch to allow better tolerance of flaky network connections that get broken
     // while we aren't looking.
     // TODO: Remove when better async changes come.
@@ -246,6 +246,13 @@ namespace mongo {
         void setTimeout( double secs );
         bool isStillConnected();
 
+        /**
+         * Returns true if input has already been read off the wire and is buffered in user space
+         * (for example by an SSL connection), so that a readiness poll of rawFD() would not
+         * report it.
+         */
+        bool hasBufferedInput() const;
+
         void setHandshakeReceived() {
             _awaitingHandshake = false;
         }
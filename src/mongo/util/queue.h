@@ -79,6 +79,23 @@ namespace mongo {
             _cvNoLongerEmpty.notify_one();
         }
 
+        /**
+         * Blocks until an item of size 'size' could be pushed without waiting, or until
+         * maxSecondsToWait passes. Returns true if there is room for it.
+         */
+        bool waitForSpace(size_t size, int maxSecondsToWait) {
+            boost::xtime xt;
+            boost::xtime_get(&xt, MONGO_BOOST_TIME_UTC);
+            xt.sec += maxSecondsToWait;
+
+            boost::unique_lock<boost::mutex> l( _lock );
+            while (_currentSize + size > _maxSize) {
+                if ( ! _cvNoLongerFull.timed_wait( l , xt ) )
+                    return _currentSize + size <= _maxSize;
+            }
+            return true;
+        }
+
         bool empty() const {
             boost::lock_guard<boost::mutex> l( _lock );
             return _queue.empty();